@@ -0,0 +1,116 @@
+// Node-RED function node: decode TelemetryCodec binary frames (main/utils/telemetry_codec.hpp).
+// Wire it between an "mqtt in" node (output: "auto-detect") and the existing Temp /
+// Moisture / backlog handling. JSON payloads pass through untouched, so a topic can be
+// switched between Config::Mqtt::PayloadFormat::JSON and BINARY without rewiring.
+//
+// Output shapes match the JSON payloads, so downstream nodes cannot tell them apart:
+//   single sample : {"value": 21.5, "ts": "20251211123045"}            (temperature)
+//                   {"percent": 45.2, "ts": "20251211123045"}          (moisture)
+//   batch         : {"values": [...], "t0_ms": ..., "dt_ms": [...], "n": N, "buffered": 1}
+// ts is UTC YYYYMMDDhhmmss like TimeSync::formatFixedTimestamp(), taken from the
+// sample's capture time; "00000000000000" when the device clock was not synced.
+// t0_ms / dt_ms are omitted in that case. Binary batches carry no flush time, so
+// unlike the JSON batch they have no "ts" (t0_ms / dt_ms are the time reference).
+
+const FRAME_VERSION = 1;
+const FLAG_HAS_TIME = 0x80;
+const UNSYNCED_TS = "00000000000000";
+
+// Epoch ms -> "YYYYMMDDhhmmss" (UTC), the firmware's JSON timestamp format
+function formatTs(epochMs) {
+    const d = new Date(epochMs);
+    const pad = function (v, n) { return String(v).padStart(n, "0"); };
+    return pad(d.getUTCFullYear(), 4) + pad(d.getUTCMonth() + 1, 2) + pad(d.getUTCDate(), 2) +
+           pad(d.getUTCHours(), 2) + pad(d.getUTCMinutes(), 2) + pad(d.getUTCSeconds(), 2);
+}
+
+function decodeFrame(buf) {
+    if (buf.length < 4 || buf[0] !== FRAME_VERSION) {
+        throw new Error("not a telemetry frame (version " + buf[0] + ")");
+    }
+    const kind = buf[1] & 0x03;
+    const hasTime = (buf[1] & FLAG_HAS_TIME) !== 0;
+    const count = buf[2] | (buf[3] << 8);
+    let pos = 4;
+
+    // LEB128 varint as a Number: exact up to 2^53, far above any epoch ms or
+    // deci-unit value (plain arithmetic, since bit operators truncate to 32 bits)
+    function varint() {
+        let result = 0;
+        let scale = 1;
+        for (;;) {
+            if (pos >= buf.length) {
+                throw new Error("truncated frame");
+            }
+            const b = buf[pos++];
+            result += (b & 0x7f) * scale;
+            if ((b & 0x80) === 0) {
+                if (result > Number.MAX_SAFE_INTEGER) {
+                    throw new Error("varint out of range");
+                }
+                return result;
+            }
+            scale *= 128;
+        }
+    }
+    function signed() {
+        const z = varint();
+        return (z % 2 === 1) ? -(z + 1) / 2 : z / 2;
+    }
+
+    const values = [];
+    const times = [];
+    let value = 0;
+    let time = 0;
+    let delta = 0;
+    for (let i = 0; i < count; i++) {
+        if (hasTime) {
+            if (i === 0) {
+                time = varint();
+            } else {
+                delta += signed();
+                time += delta;
+            }
+            times.push(time);
+        }
+        value = (i === 0) ? signed() : value + signed();
+        values.push(value / 10);
+    }
+    return { kind: kind, hasTime: hasTime, values: values, times: times };
+}
+
+if (!Buffer.isBuffer(msg.payload)) {
+    return msg; // JSON (or already parsed) payload
+}
+if (msg.payload.length > 0 && msg.payload[0] === 0x7b) {
+    // '{': JSON delivered as a buffer
+    msg.payload = JSON.parse(msg.payload.toString("utf8"));
+    return msg;
+}
+
+let frame;
+try {
+    frame = decodeFrame(msg.payload);
+} catch (err) {
+    node.warn("telemetry decode failed on " + msg.topic + ": " + err.message);
+    return null;
+}
+
+const key = (frame.kind === 0) ? "value" : "percent";
+if (frame.values.length === 1 && !/\/backlog$/.test(msg.topic || "")) {
+    const out = {};
+    out[key] = frame.values[0];
+    out.ts = frame.hasTime ? formatTs(frame.times[0]) : UNSYNCED_TS;
+    msg.payload = out;
+} else {
+    const out = {};
+    out[(frame.kind === 0) ? "values" : "percent"] = frame.values;
+    if (frame.hasTime) {
+        out.t0_ms = frame.times[0];
+        out.dt_ms = frame.times.map(function (t) { return t - frame.times[0]; });
+    }
+    out.n = frame.values.length;
+    out.buffered = 1;
+    msg.payload = out;
+}
+return msg;
@@ -0,0 +1,116 @@
+// Offline backlog flush: one JSON message per sample (the pre-batching path) versus
+// batches of BATCH_SIZE samples as JSON or binary frames (utils/backlog_format.hpp).
+// Reports messages, payload bytes, MQTT bytes on the wire, format CPU time and the
+// drain-time floor the old path's fixed 50 ms sleep per sample imposed.
+// Network time is not modelled: the batched flush is paced only by outbox depth.
+#include <main/utils/backlog_format.hpp>
+#include <test_support.hpp>
+#include <cstring>
+
+namespace {
+    static constexpr std::size_t SAMPLES = 512;      // one full RAM backlog ring
+    static constexpr std::size_t BATCH_SIZE = 32;    // Config::Tasks::Backlog::batch_size
+    static constexpr uint32_t OLD_SLEEP_MS = 50;     // vTaskDelay per sample before batching
+    static constexpr const char* TOPIC_LIVE = "thermometer/thermo-001/temperature";
+    static constexpr const char* TOPIC_BACKLOG = "thermometer/thermo-001/temperature/backlog";
+
+    static int32_t s_values[SAMPLES];
+    static uint64_t s_epochs[SAMPLES];
+
+    // QoS 1 PUBLISH: fixed header, remaining-length varint, topic, packet id, payload
+    std::size_t wireBytes(const char* topic, std::size_t payload) {
+        const std::size_t remaining = 2 + std::strlen(topic) + 2 + payload;
+        const std::size_t len_bytes = (remaining < 128) ? 1 : (remaining < 16384 ? 2 : 3);
+        return 1 + len_bytes + remaining;
+    }
+
+    struct Result {
+        std::size_t messages = 0;
+        std::size_t payload = 0;
+        std::size_t wire = 0;
+        double ns_per_sample = 0;
+    };
+
+    void print(const char* name, const Result& r, double sleep_floor_s) {
+        std::printf("%-22s %5zu msgs %7zu B payload %7zu B wire %7.0f ns/sample  sleep floor %.1f s\n",
+                    name, r.messages, r.payload, r.wire, r.ns_per_sample, sleep_floor_s);
+    }
+
+    Result perSampleJson(long rounds) {
+        Result r;
+        char payload[160];
+        char ts[16];
+        const double ns = HostTest::nsPerCall(rounds, [&](long) {
+            r = Result{};
+            for (std::size_t i = 0; i < SAMPLES; ++i) {
+                TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+                const int len = std::snprintf(payload, sizeof(payload), "{\"value\":%.2f,\"ts\":\"%s\",\"buffered\":1}",
+                                              s_values[i] / 100.0, ts);
+                HostTest::keep(payload);
+                r.messages++;
+                r.payload += static_cast<std::size_t>(len);
+                r.wire += wireBytes(TOPIC_LIVE, static_cast<std::size_t>(len));
+            }
+        });
+        r.ns_per_sample = ns / SAMPLES;
+        return r;
+    }
+
+    template <typename Format>
+    Result batched(long rounds, Format format) {
+        Result r;
+        const double ns = HostTest::nsPerCall(rounds, [&](long) {
+            r = Result{};
+            for (std::size_t first = 0; first < SAMPLES; first += BATCH_SIZE) {
+                const std::size_t n = (SAMPLES - first < BATCH_SIZE) ? SAMPLES - first : BATCH_SIZE;
+                const int len = format(first, n);
+                if (len < 0) {
+                    std::printf("batch did not fit\n");
+                    std::exit(EXIT_FAILURE);
+                }
+                r.messages++;
+                r.payload += static_cast<std::size_t>(len);
+                r.wire += wireBytes(TOPIC_BACKLOG, static_cast<std::size_t>(len));
+            }
+        });
+        r.ns_per_sample = ns / SAMPLES;
+        return r;
+    }
+}
+
+int main(int argc, char** argv) {
+    const long rounds = HostTest::quick(argc, argv) ? 5 : 2000;
+
+    // 5 s telemetry period, slowly drifting greenhouse temperature
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+        s_values[i] = 2150 + static_cast<int32_t>((i * 7) % 41) - 20;
+        s_epochs[i] = 1765452645120ULL + i * 5000ULL;
+    }
+
+    static char json[160 + BATCH_SIZE * 24]; // same sizing as the cloud task's buffer
+    static uint8_t frame[TelemetryCodec::maxFrameBytes(BATCH_SIZE)];
+
+    const Result old_path = perSampleJson(rounds);
+    const Result batch_json = batched(rounds, [&](std::size_t first, std::size_t n) {
+        return BacklogFormat::formatJson(json, sizeof(json), "values", 2, n,
+                                         [&](std::size_t i) { return s_values[first + i]; }, true,
+                                         [&](std::size_t i) { return s_epochs[first + i]; });
+    });
+    const Result batch_bin = batched(rounds, [&](std::size_t first, std::size_t n) {
+        return BacklogFormat::encodeBinary(frame, sizeof(frame), TelemetryCodec::Kind::TEMPERATURE, n,
+                                           [&](std::size_t i) { return s_values[first + i]; }, true,
+                                           [&](std::size_t i) { return s_epochs[first + i]; });
+    });
+
+    std::printf("backlog of %zu samples, batch size %zu\n", SAMPLES, BATCH_SIZE);
+    print("per-sample JSON (old)", old_path, SAMPLES * OLD_SLEEP_MS / 1000.0);
+    print("batched JSON", batch_json, 0.0);
+    print("batched binary", batch_bin, 0.0);
+
+    // The batched paths must actually be smaller on the wire
+    if (batch_json.wire >= old_path.wire || batch_bin.wire >= batch_json.wire) {
+        std::printf("unexpected size ordering\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
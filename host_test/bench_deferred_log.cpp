@@ -0,0 +1,72 @@
+// Caller-side cost of a LOG_INFO call (utils/logger.hpp): formatted on the calling
+// task, as before DeferredLog::start(), against copied into the deferred ring for the
+// drain task. Deferred calls are timed in batches of half the ring, waiting for the
+// drain between batches (untimed) so no record is dropped; every record must come out.
+// On the host the direct path stops at the formatted line: the device also waits for
+// the UART, which is printed as an estimate alongside.
+#include <main/utils/logger.hpp>
+#include <main/utils/deferred_log.hpp>
+#include <main/config/config.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+#include <chrono>
+#include <thread>
+
+namespace {
+    static const char* TAG = "BENCH";
+    static constexpr std::size_t BATCH = Config::Logging::ring_depth / 2;
+    static constexpr double UART_BAUD = 115200.0;
+
+    // A typical sensor-task line: float, int and a string argument
+    void logOnce(long i) {
+        LOG_INFO(TAG, "T=%.2f C moisture=%d%% state=%s", 21.5 + static_cast<double>(i & 7), static_cast<int>(i & 63),
+                 (i & 1) ? "OK" : "WARN");
+    }
+
+    bool waitForLines(uint32_t count) {
+        for (int i = 0; i < 5000 && HostEnv::logLineCount() < count; ++i) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return HostEnv::logLineCount() >= count;
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool quick = HostTest::quick(argc, argv);
+    const long direct_calls = quick ? 2000 : 2000000;
+    const long batches = quick ? 50 : 20000;
+    HostEnv::setLogOutput(false);
+    Logger::setLevel(LogLevel::INFO);
+
+    const uint32_t direct_before = HostEnv::logLineCount();
+    const double direct_ns = HostTest::nsPerCall(direct_calls, logOnce);
+    CHECK_EQ(HostEnv::logLineCount() - direct_before, static_cast<uint32_t>(direct_calls));
+
+    DeferredLog::start();
+    uint32_t expected = HostEnv::logLineCount();
+    double deferred_total_ns = 0.0;
+    long n = 0;
+    for (long b = 0; b < batches; ++b) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < BATCH; ++k) {
+            logOnce(n++);
+        }
+        deferred_total_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        // Records a slow host thread left uncommitted too long are skipped (and reported)
+        expected += static_cast<uint32_t>(BATCH);
+        CHECK(waitForLines(expected - DeferredLog::abandoned()));
+    }
+    const double deferred_ns = deferred_total_ns / static_cast<double>(n);
+    CHECK_EQ(DeferredLog::dropped(), 0U);
+
+    char line[LOGGER_MAX_MESSAGE_LEN];
+    const int len = std::snprintf(line, sizeof(line), "I (12345) %s: T=%.2f C moisture=%d%% state=%s\n", TAG, 21.5, 43,
+                                  "WARN");
+    const double uart_us = static_cast<double>(len) * 10.0 / UART_BAUD * 1e6; // 8N1
+
+    std::printf("LOG_INFO caller  direct %7.1f ns + UART   deferred %7.1f ns   (%.1fx before the UART)\n", direct_ns,
+                deferred_ns, direct_ns / deferred_ns);
+    std::printf("UART at %.0f baud: ~%.0f us per %d-byte line on the direct path\n", UART_BAUD, uart_us, len);
+    std::printf("skipped as uncommitted: %lu\n", static_cast<unsigned long>(DeferredLog::abandoned()));
+    return HostTest::finish();
+}
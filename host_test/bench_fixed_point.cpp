@@ -0,0 +1,51 @@
+// Per-reading conversion cost: the float formulas the sensors used before against
+// the Q16 kernels in utils/fixed_point.hpp, over a sweep of raw values. Host numbers
+// only show the relative cost; on the ESP32 the float path also pays for soft
+// float formatting further down the pipeline.
+#include <main/utils/fixed_point.hpp>
+#include <main/config/config.hpp>
+#include <test_support.hpp>
+
+namespace {
+    static constexpr uint32_t ADC_MAX = 4095;
+    using TempKernel = FixedPoint::LinearKernel<Config::Hardware::Temperature::adc_full_scale_mv, ADC_MAX,
+                                                Config::Hardware::Temperature::gain_c_per_mv>;
+
+    static uint32_t s_raw[ADC_MAX + 1];
+}
+
+int main(int argc, char** argv) {
+    const long iterations = HostTest::quick(argc, argv) ? 10000 : 50000000;
+    for (uint32_t i = 0; i <= ADC_MAX; ++i) {
+        s_raw[i] = (i * 2654435761U) & ADC_MAX; // scattered, so nothing folds
+    }
+    int32_t sink = 0;
+
+    const double temp_float = HostTest::nsPerCall(iterations, [&](long i) {
+        const float raw = static_cast<float>(s_raw[i & ADC_MAX]);
+        const float mv = (raw / static_cast<float>(ADC_MAX)) * 1.1f * 1000.0f;
+        const float c = mv * Config::Hardware::Temperature::gain_c_per_mv;
+        sink += static_cast<int32_t>(c * 100.0f + 0.5f);
+    });
+    const double temp_q16 = HostTest::nsPerCall(iterations, [&](long i) {
+        sink += TempKernel::toCenti(s_raw[i & ADC_MAX]);
+    });
+
+    const FixedPoint::MoistureScale scale(Config::Hardware::Moisture::raw_dry, Config::Hardware::Moisture::raw_wet);
+    const float dry = Config::Hardware::Moisture::raw_dry;
+    const float wet = Config::Hardware::Moisture::raw_wet;
+    const double moist_float = HostTest::nsPerCall(iterations, [&](long i) {
+        float percent = 100.0f * ((static_cast<float>(s_raw[i & ADC_MAX]) - dry) / (wet - dry));
+        percent = (percent < 0.0f) ? 0.0f : ((percent > 100.0f) ? 100.0f : percent);
+        sink += static_cast<int32_t>(percent * 100.0f + 0.5f);
+    });
+    const double moist_q16 = HostTest::nsPerCall(iterations, [&](long i) {
+        sink += scale.toCenti(s_raw[i & ADC_MAX]);
+    });
+    HostTest::keep(sink);
+
+    std::printf("temperature   float %6.2f ns   q16 %6.2f ns   (%.1fx)\n", temp_float, temp_q16, temp_float / temp_q16);
+    std::printf("moisture      float %6.2f ns   q16 %6.2f ns   (%.1fx)\n", moist_float, moist_q16,
+                moist_float / moist_q16);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,241 @@
+// Cross-task sample hand-off (sensor scheduler -> subscribers): SampleBus, which
+// replaced the planned SPSC ring and the per-subscriber xQueueSend copies, against
+// CircularBuffer behind a mutex and a FreeRTOS queue, in SensorSample ops/sec.
+// - burst: one thread writes BURST samples, then reads them back (no contention)
+// - 2 threads: a producer and a consumer thread, every sample must arrive in order.
+//   The SampleBus producer waits while half the ring is unread, so nothing is lapped.
+// The host queue and mutex are the shims' pthread versions, not the FreeRTOS kernel:
+// compare the ratios, not the absolute numbers.
+#include <main/utils/sample_bus.hpp>
+#include <main/utils/circular_buffer.hpp>
+#include <main/models/sensor_sample.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <test_support.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+    static constexpr std::size_t CAPACITY = 64; // SensorSampleBus
+    static constexpr std::size_t BURST = 16;
+
+    using Bus = SampleBus<SensorSample, CAPACITY>;
+    using Buffer = CircularBuffer<SensorSample, CAPACITY>;
+
+    SensorSample makeSample(uint32_t seq) {
+        SensorSample s{};
+        s.value_centi = static_cast<int32_t>(seq & 0xFFFF);
+        s.ts_ms = seq;
+        s.raw = static_cast<uint16_t>(seq);
+        s.channel = static_cast<uint8_t>(seq & 1U);
+        return s;
+    }
+
+    // CircularBuffer has no locking; a cross-task user needs a mutex around it
+    struct LockedBuffer {
+        Buffer buffer;
+        StaticSemaphore_t mutex_storage;
+        SemaphoreHandle_t mutex = xSemaphoreCreateMutexStatic(&mutex_storage);
+
+        bool push(const SensorSample& s) {
+            (void)xSemaphoreTake(mutex, portMAX_DELAY);
+            const bool ok = buffer.push(s);
+            (void)xSemaphoreGive(mutex);
+            return ok;
+        }
+
+        bool pop(SensorSample& s) {
+            (void)xSemaphoreTake(mutex, portMAX_DELAY);
+            const bool ok = buffer.pop(s);
+            (void)xSemaphoreGive(mutex);
+            return ok;
+        }
+    };
+
+    struct Queue {
+        StaticQueue_t queue_storage;
+        uint8_t storage[CAPACITY * sizeof(SensorSample)];
+        QueueHandle_t handle = xQueueCreateStatic(CAPACITY, sizeof(SensorSample), storage, &queue_storage);
+    };
+
+    // Mops/s of a run that moved items samples
+    template <typename Fn>
+    double mops(uint32_t items, Fn fn) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(items) / us;
+    }
+
+    // Consumer side check: samples arrive complete and in publish order
+    struct OrderCheck {
+        uint32_t expected = 0;
+        uint32_t errors = 0;
+
+        void operator()(const SensorSample& s) {
+            if (s.ts_ms != expected || s.raw != static_cast<uint16_t>(expected)) {
+                errors++;
+            }
+            expected++;
+        }
+    };
+
+    double burstBus(uint32_t items) {
+        static Bus bus;
+        Bus::Subscriber* sub = bus.subscribe("bench");
+        OrderCheck check;
+        const double rate = mops(items, [&] {
+            std::array<SensorSample, BURST> out;
+            for (uint32_t seq = 0; seq < items; seq += BURST) {
+                for (uint32_t k = 0; k < BURST; ++k) {
+                    bus.publish(makeSample(seq + k));
+                }
+                const std::size_t n = bus.poll(*sub, out);
+                for (std::size_t k = 0; k < n; ++k) {
+                    check(out[k]);
+                }
+            }
+        });
+        CHECK_EQ(check.expected, items);
+        CHECK_EQ(check.errors, 0U);
+        return rate;
+    }
+
+    double burstBuffer(uint32_t items) {
+        static LockedBuffer buf;
+        OrderCheck check;
+        const double rate = mops(items, [&] {
+            SensorSample s;
+            for (uint32_t seq = 0; seq < items; seq += BURST) {
+                for (uint32_t k = 0; k < BURST; ++k) {
+                    (void)buf.push(makeSample(seq + k));
+                }
+                while (buf.pop(s)) {
+                    check(s);
+                }
+            }
+        });
+        CHECK_EQ(check.expected, items);
+        CHECK_EQ(check.errors, 0U);
+        return rate;
+    }
+
+    double burstQueue(uint32_t items) {
+        static Queue q;
+        OrderCheck check;
+        const double rate = mops(items, [&] {
+            SensorSample s;
+            for (uint32_t seq = 0; seq < items; seq += BURST) {
+                for (uint32_t k = 0; k < BURST; ++k) {
+                    const SensorSample in = makeSample(seq + k);
+                    (void)xQueueSend(q.handle, &in, 0);
+                }
+                while (xQueueReceive(q.handle, &s, 0) == pdTRUE) {
+                    check(s);
+                }
+            }
+        });
+        CHECK_EQ(check.expected, items);
+        CHECK_EQ(check.errors, 0U);
+        return rate;
+    }
+
+    double threadedBus(uint32_t items) {
+        static Bus bus;
+        Bus::Subscriber* sub = bus.subscribe("bench");
+        OrderCheck check;
+        const double rate = mops(items, [&] {
+            std::thread producer([&] {
+                for (uint32_t seq = 0; seq < items; ++seq) {
+                    while (bus.getStats(0).lag >= CAPACITY / 2) {
+                        std::this_thread::yield();
+                    }
+                    bus.publish(makeSample(seq));
+                }
+            });
+            std::array<SensorSample, BURST> out;
+            while (check.expected < items) {
+                const std::size_t n = bus.poll(*sub, out);
+                for (std::size_t k = 0; k < n; ++k) {
+                    check(out[k]);
+                }
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            producer.join();
+        });
+        CHECK_EQ(check.errors, 0U);
+        CHECK_EQ(bus.getStats(0).overruns, 0U);
+        return rate;
+    }
+
+    double threadedBuffer(uint32_t items) {
+        static LockedBuffer buf;
+        OrderCheck check;
+        const double rate = mops(items, [&] {
+            std::thread producer([&] {
+                for (uint32_t seq = 0; seq < items; ++seq) {
+                    while (!buf.push(makeSample(seq))) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            SensorSample s;
+            while (check.expected < items) {
+                if (buf.pop(s)) {
+                    check(s);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            producer.join();
+        });
+        CHECK_EQ(check.errors, 0U);
+        return rate;
+    }
+
+    double threadedQueue(uint32_t items) {
+        static Queue q;
+        OrderCheck check;
+        const double rate = mops(items, [&] {
+            std::thread producer([&] {
+                for (uint32_t seq = 0; seq < items; ++seq) {
+                    const SensorSample in = makeSample(seq);
+                    (void)xQueueSend(q.handle, &in, portMAX_DELAY);
+                }
+            });
+            SensorSample s;
+            while (check.expected < items) {
+                if (xQueueReceive(q.handle, &s, portMAX_DELAY) == pdTRUE) {
+                    check(s);
+                }
+            }
+            producer.join();
+        });
+        CHECK_EQ(check.errors, 0U);
+        return rate;
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool quick = HostTest::quick(argc, argv);
+    const uint32_t items = quick ? 20000U : 5000000U;
+
+    const double burst_bus = burstBus(items);
+    const double burst_buffer = burstBuffer(items);
+    const double burst_queue = burstQueue(items);
+    const double threaded_bus = threadedBus(items);
+    const double threaded_buffer = threadedBuffer(items);
+    const double threaded_queue = threadedQueue(items);
+
+    std::printf("%u samples, ring of %u, Mops/s        burst  2 threads\n", static_cast<unsigned>(items),
+                static_cast<unsigned>(CAPACITY));
+    std::printf("SampleBus (lock-free)             %8.2f  %8.2f\n", burst_bus, threaded_bus);
+    std::printf("CircularBuffer + mutex            %8.2f  %8.2f\n", burst_buffer, threaded_buffer);
+    std::printf("FreeRTOS queue (host shim)        %8.2f  %8.2f\n", burst_queue, threaded_queue);
+    return HostTest::finish();
+}
@@ -0,0 +1,68 @@
+// Device-side encode cost and size: TelemetryCodec binary frames versus the JSON
+// payloads (live sample and 32-sample backlog batch). Decode cost on the ingest side
+// is measured by test_telemetry_decoder.js --bench.
+#include <main/utils/backlog_format.hpp>
+#include <main/utils/fixed_point.hpp>
+#include <main/utils/telemetry_codec.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+
+namespace {
+    static constexpr std::size_t BATCH = 32;
+    static int32_t s_values[BATCH];
+    static uint64_t s_epochs[BATCH];
+
+    void report(const char* name, double bin_ns, int bin_bytes, double json_ns, int json_bytes) {
+        std::printf("%-14s binary %4d B %7.0f ns   json %4d B %7.0f ns   (%.1fx smaller, %.1fx faster)\n", name,
+                    bin_bytes, bin_ns, json_bytes, json_ns, static_cast<double>(json_bytes) / bin_bytes,
+                    json_ns / bin_ns);
+    }
+}
+
+int main(int argc, char** argv) {
+    const long iterations = HostTest::quick(argc, argv) ? 100 : 1000000;
+    for (std::size_t i = 0; i < BATCH; ++i) {
+        s_values[i] = 2150 + static_cast<int32_t>((i * 37) % 23) - 11;
+        s_epochs[i] = HostEnv::SYNC_EPOCH_MS + i * 5000U;
+    }
+
+    // Live sample, formatted the way the cloud task does
+    uint8_t frame[TelemetryCodec::maxFrameBytes(BATCH)];
+    char json[160 + BATCH * 24];
+    int bin_len = 0;
+    int json_len = 0;
+    const double live_bin = HostTest::nsPerCall(iterations, [&](long i) {
+        TelemetryCodec::FrameEncoder encoder(frame, sizeof(frame), TelemetryCodec::Kind::TEMPERATURE, true);
+        (void)encoder.add(s_values[i % BATCH], s_epochs[i % BATCH]);
+        bin_len = static_cast<int>(encoder.finish());
+        HostTest::keep(frame);
+    });
+    const double live_json = HostTest::nsPerCall(iterations, [&](long i) {
+        char ts[16];
+        char value[16];
+        TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+        (void)FixedPoint::formatCenti(value, sizeof(value), s_values[i % BATCH], 2);
+        json_len = std::snprintf(json, sizeof(json), "{\"value\":%s,\"ts\":\"%s\"}", value, ts);
+        HostTest::keep(json);
+    });
+    report("live sample", live_bin, bin_len, live_json, json_len);
+
+    auto value_at = [](std::size_t i) { return s_values[i]; };
+    auto epoch_at = [](std::size_t i) { return s_epochs[i]; };
+    const double batch_bin = HostTest::nsPerCall(iterations / 10 + 1, [&](long) {
+        bin_len = BacklogFormat::encodeBinary(frame, sizeof(frame), TelemetryCodec::Kind::TEMPERATURE, BATCH,
+                                              value_at, true, epoch_at);
+        HostTest::keep(frame);
+    });
+    const double batch_json = HostTest::nsPerCall(iterations / 10 + 1, [&](long) {
+        json_len = BacklogFormat::formatJson(json, sizeof(json), "values", 2, BATCH, value_at, true, epoch_at);
+        HostTest::keep(json);
+    });
+    report("backlog x32", batch_bin, bin_len, batch_json, json_len);
+
+    if (bin_len <= 0 || json_len <= 0 || bin_len >= json_len) {
+        std::printf("unexpected sizes\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+// Threshold name lookup (state/threshold_table.hpp): the table's binary search on
+// the key as it sits in the JSON buffer against the strcmp chain it replaced, and a
+// whole update_thresholds payload parsed both ways (eight mjson path scans vs one
+// mjson_next walk). Both paths must resolve the same commands, or the run fails.
+#include <main/state/threshold_table.hpp>
+#include <main/utils/third-party/mjson.h>
+#include <test_support.hpp>
+#include <cstring>
+
+namespace {
+    // The lookup update_threshold used before the table (needs a terminated copy)
+    CommandType legacyParseThresholdName(const char* name) {
+        if (std::strcmp(name, "temp_low_warn") == 0) return CommandType::UPDATE_TEMP_LOW_WARN;
+        if (std::strcmp(name, "temp_low_crit") == 0) return CommandType::UPDATE_TEMP_LOW_CRIT;
+        if (std::strcmp(name, "temp_high_warn") == 0) return CommandType::UPDATE_TEMP_HIGH_WARN;
+        if (std::strcmp(name, "temp_high_crit") == 0) return CommandType::UPDATE_TEMP_HIGH_CRIT;
+        if (std::strcmp(name, "moisture_low_warn") == 0) return CommandType::UPDATE_MOISTURE_LOW_WARN;
+        if (std::strcmp(name, "moisture_low_crit") == 0) return CommandType::UPDATE_MOISTURE_LOW_CRIT;
+        if (std::strcmp(name, "moisture_high_warn") == 0) return CommandType::UPDATE_MOISTURE_HIGH_WARN;
+        if (std::strcmp(name, "moisture_high_crit") == 0) return CommandType::UPDATE_MOISTURE_HIGH_CRIT;
+        return static_cast<CommandType>(0);
+    }
+
+    // Keys as they arrive: every threshold plus near misses, unterminated in a buffer
+    static const char* const KEYS[] = {
+        "temp_low_warn",      "temp_low_crit",      "temp_high_warn",    "temp_high_crit",
+        "moisture_low_warn",  "moisture_low_crit",  "moisture_high_warn", "moisture_high_crit",
+        "temp_low",           "moisture_high_critx", "command",           "zzz",
+    };
+    static constexpr std::size_t KEY_COUNT = sizeof(KEYS) / sizeof(KEYS[0]);
+
+    // Sum of command values, 0 for a miss: both paths must agree on it
+    int32_t tableLookup(const char* key, std::size_t len) {
+        const ThresholdTable::Entry* e = ThresholdTable::find(key, len);
+        return (e == nullptr) ? 0 : static_cast<int32_t>(e->command);
+    }
+
+    int32_t legacyLookup(const char* key, std::size_t len) {
+        char name[32];
+        const std::size_t n = (len < sizeof(name) - 1) ? len : sizeof(name) - 1;
+        std::memcpy(name, key, n);
+        name[n] = '\0';
+        return static_cast<int32_t>(legacyParseThresholdName(name));
+    }
+
+    static const char PAYLOAD[] =
+        "{\"command\":\"update_thresholds\",\"temp_high_warn\":30.5,\"temp_high_crit\":35,"
+        "\"moisture_low_warn\":25,\"moisture_low_crit\":15,\"unknown_key\":1}";
+    static const int PAYLOAD_LEN = static_cast<int>(sizeof(PAYLOAD) - 1);
+
+    // Before: one JSONPath scan of the whole payload per known threshold
+    int32_t legacyParse(const char* json, int len) {
+        static const char* const names[] = {
+            "temp_low_warn", "temp_low_crit", "temp_high_warn", "temp_high_crit",
+            "moisture_low_warn", "moisture_low_crit", "moisture_high_warn", "moisture_high_crit",
+        };
+        int32_t sum = 0;
+        for (const char* name : names) {
+            char path[80];
+            std::snprintf(path, sizeof(path), "$.%s", name);
+            double value = 0.0;
+            if (mjson_get_number(json, len, path, &value) == 1) {
+                sum += static_cast<int32_t>(legacyParseThresholdName(name)) * static_cast<int32_t>(value);
+            }
+        }
+        return sum;
+    }
+
+    // After: one walk over the top-level members, each key looked up in the table
+    int32_t tableParse(const char* json, int len) {
+        int32_t sum = 0;
+        int key_off = 0, key_len = 0, val_off = 0, val_len = 0, val_type = 0;
+        int off = 0;
+        while ((off = mjson_next(json, len, off, &key_off, &key_len, &val_off, &val_len, &val_type)) > 0) {
+            if (val_type != MJSON_TOK_NUMBER || key_len < 2) {
+                continue;
+            }
+            const ThresholdTable::Entry* e = ThresholdTable::find(json + key_off + 1, static_cast<std::size_t>(key_len - 2));
+            double value = 0.0;
+            if (e != nullptr && mjson_get_number(json + val_off, val_len, "$", &value) == 1) {
+                sum += static_cast<int32_t>(e->command) * static_cast<int32_t>(value);
+            }
+        }
+        return sum;
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool quick = HostTest::quick(argc, argv);
+    const long lookups = quick ? 10000 : 50000000;
+    const long parses = quick ? 1000 : 2000000;
+    std::size_t lengths[KEY_COUNT];
+    for (std::size_t i = 0; i < KEY_COUNT; ++i) {
+        lengths[i] = std::strlen(KEYS[i]);
+        CHECK_EQ(tableLookup(KEYS[i], lengths[i]), legacyLookup(KEYS[i], lengths[i]));
+    }
+    CHECK_EQ(tableParse(PAYLOAD, PAYLOAD_LEN), legacyParse(PAYLOAD, PAYLOAD_LEN));
+
+    int32_t sink = 0;
+    const double find_ns = HostTest::nsPerCall(lookups, [&](long i) {
+        const std::size_t k = static_cast<std::size_t>(i) % KEY_COUNT;
+        sink += tableLookup(KEYS[k], lengths[k]);
+    });
+    const double chain_ns = HostTest::nsPerCall(lookups, [&](long i) {
+        const std::size_t k = static_cast<std::size_t>(i) % KEY_COUNT;
+        sink += legacyLookup(KEYS[k], lengths[k]);
+    });
+    const double by_command_ns = HostTest::nsPerCall(lookups, [&](long i) {
+        const ThresholdTable::Entry* e = ThresholdTable::byCommand(static_cast<CommandType>(-1 - (i & 7)));
+        sink += static_cast<int32_t>(e->blob_tag);
+    });
+    const double parse_table_ns = HostTest::nsPerCall(parses, [&](long) {
+        sink += tableParse(PAYLOAD, PAYLOAD_LEN);
+    });
+    const double parse_legacy_ns = HostTest::nsPerCall(parses, [&](long) {
+        sink += legacyParse(PAYLOAD, PAYLOAD_LEN);
+    });
+    HostTest::keep(sink);
+
+    std::printf("name lookup      table %7.1f ns   strcmp chain %7.1f ns   (%.1fx)\n", find_ns, chain_ns,
+                chain_ns / find_ns);
+    std::printf("byCommand        %7.1f ns\n", by_command_ns);
+    std::printf("payload parse    walk  %7.1f ns   8 path scans %7.1f ns   (%.1fx)\n", parse_table_ns,
+                parse_legacy_ns, parse_legacy_ns / parse_table_ns);
+    return HostTest::finish();
+}
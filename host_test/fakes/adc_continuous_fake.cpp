@@ -0,0 +1,226 @@
+// Host adc_continuous driver (see adc_continuous_fake.hpp). Handles are never freed,
+// so a call on a deinitialized handle is counted rather than a use-after-free.
+#include <fakes/adc_continuous_fake.hpp>
+#include <main/sim/sim_backends.hpp>
+#include <esp_adc/adc_continuous.h>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+struct adc_continuous_ctx_t {
+    enum class State { INIT, CONFIGURED, RUNNING, DELETED };
+    State state = State::INIT;
+    bool configured = false;
+    adc_continuous_evt_cbs_t cbs = {};
+    void* user_data = nullptr;
+    std::vector<adc_digi_pattern_config_t> pattern;
+    uint32_t frame_bytes = 0;
+    std::size_t pool_frames = 0;
+    std::deque<std::vector<uint8_t>> ready;
+    uint32_t next_pattern = 0;
+};
+
+namespace {
+    using State = adc_continuous_ctx_t::State;
+
+    std::mutex s_lock;
+    std::vector<adc_continuous_ctx_t*> s_handles;
+    uint16_t s_values[8] = {};
+    bool s_fail_next_config = false;
+    bool s_frame_on_next_start = false;
+    AdcContinuousFake::Stats s_stats{};
+
+    // Caller holds s_lock; false (and counted) for a deinitialized handle
+    bool alive(adc_continuous_handle_t handle) {
+        if (handle == nullptr) {
+            return false;
+        }
+        if (handle->state == State::DELETED) {
+            s_stats.dead_handle_calls++;
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace AdcContinuousFake {
+    Stats stats() {
+        std::lock_guard<std::mutex> lock(s_lock);
+        Stats stats = s_stats;
+        stats.live_handles = 0;
+        stats.running_handles = 0;
+        stats.ready_frames = 0;
+        for (const adc_continuous_ctx_t* h : s_handles) {
+            stats.live_handles += (h->state != State::DELETED) ? 1U : 0U;
+            stats.running_handles += (h->state == State::RUNNING) ? 1U : 0U;
+            if (h->state == State::RUNNING) {
+                stats.ready_frames += static_cast<uint32_t>(h->ready.size());
+            }
+        }
+        return stats;
+    }
+
+    void setChannelValue(adc_channel_t ch, uint16_t raw) {
+        std::lock_guard<std::mutex> lock(s_lock);
+        s_values[ch] = raw;
+    }
+
+    void failNextConfig() {
+        std::lock_guard<std::mutex> lock(s_lock);
+        s_fail_next_config = true;
+    }
+
+    void frameOnNextStart() {
+        std::lock_guard<std::mutex> lock(s_lock);
+        s_frame_on_next_start = true;
+    }
+
+    bool completeFrame(bool notify) {
+        adc_continuous_ctx_t* target = nullptr;
+        adc_continuous_evt_data_t edata = {};
+        {
+            std::lock_guard<std::mutex> lock(s_lock);
+            for (adc_continuous_ctx_t* h : s_handles) {
+                if (h->state == State::RUNNING) {
+                    target = h;
+                }
+            }
+            if (target == nullptr || target->pattern.empty()) {
+                return false;
+            }
+            std::vector<uint8_t> frame(target->frame_bytes);
+            for (uint32_t off = 0; off + SOC_ADC_DIGI_RESULT_BYTES <= target->frame_bytes;
+                 off += SOC_ADC_DIGI_RESULT_BYTES) {
+                const adc_digi_pattern_config_t& p = target->pattern[target->next_pattern++ % target->pattern.size()];
+                adc_digi_output_data_t r{};
+                r.type1.channel = p.channel & 0x0F;
+                r.type1.data = s_values[p.channel & 0x07] & 0x0FFF;
+                std::memcpy(frame.data() + off, &r, SOC_ADC_DIGI_RESULT_BYTES);
+            }
+            if (target->ready.size() == target->pool_frames) {
+                target->ready.pop_front(); // pool full: the driver drops the oldest
+                if (target->cbs.on_pool_ovf != nullptr) {
+                    (void)target->cbs.on_pool_ovf(target, &edata, target->user_data);
+                }
+            }
+            target->ready.push_back(std::move(frame));
+            s_stats.frames++;
+            edata.size = target->frame_bytes;
+        }
+        if (notify && target->cbs.on_conv_done != nullptr) {
+            (void)target->cbs.on_conv_done(target, &edata, target->user_data);
+        }
+        return true;
+    }
+}
+
+// adc_engine.cpp's simulate_hardware path links against this; never taken here
+namespace SimBackends {
+    int adcRead(adc_channel_t channel) {
+        return s_values[channel];
+    }
+}
+
+extern "C" {
+    esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t* cfg, adc_continuous_handle_t* ret_handle) {
+        std::lock_guard<std::mutex> lock(s_lock);
+        adc_continuous_ctx_t* h = new adc_continuous_ctx_t();
+        h->frame_bytes = cfg->conv_frame_size;
+        h->pool_frames = (cfg->conv_frame_size > 0) ? cfg->max_store_buf_size / cfg->conv_frame_size : 0;
+        s_handles.push_back(h);
+        s_stats.handles_created++;
+        *ret_handle = h;
+        return ESP_OK;
+    }
+
+    esp_err_t adc_continuous_register_event_callbacks(adc_continuous_handle_t handle, const adc_continuous_evt_cbs_t* cbs,
+                                                      void* user_data) {
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (!alive(handle) || handle->state != State::INIT) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        handle->cbs = *cbs;
+        handle->user_data = user_data;
+        return ESP_OK;
+    }
+
+    esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t* config) {
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (!alive(handle)) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (handle->configured || handle->state != State::INIT) {
+            s_stats.reconfigs++;
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (s_fail_next_config) {
+            s_fail_next_config = false;
+            return ESP_FAIL;
+        }
+        handle->pattern.assign(config->adc_pattern, config->adc_pattern + config->pattern_num);
+        handle->configured = true;
+        handle->state = State::CONFIGURED;
+        return ESP_OK;
+    }
+
+    esp_err_t adc_continuous_start(adc_continuous_handle_t handle) {
+        bool frame_now = false;
+        {
+            std::lock_guard<std::mutex> lock(s_lock);
+            if (!alive(handle) || handle->state != State::CONFIGURED) {
+                return ESP_ERR_INVALID_STATE;
+            }
+            handle->state = State::RUNNING;
+            frame_now = s_frame_on_next_start;
+            s_frame_on_next_start = false;
+        }
+        if (frame_now) {
+            (void)AdcContinuousFake::completeFrame();
+        }
+        return ESP_OK;
+    }
+
+    esp_err_t adc_continuous_stop(adc_continuous_handle_t handle) {
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (!alive(handle) || handle->state != State::RUNNING) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        // Stopped handles go back to INIT in the driver, but keep "configured" here
+        handle->state = State::INIT;
+        return ESP_OK;
+    }
+
+    esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t* buf, uint32_t length_max,
+                                  uint32_t* out_length, uint32_t timeout_ms) {
+        (void)timeout_ms;
+        std::lock_guard<std::mutex> lock(s_lock);
+        *out_length = 0;
+        if (!alive(handle)) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (handle->ready.empty()) {
+            return ESP_ERR_TIMEOUT;
+        }
+        const std::vector<uint8_t>& frame = handle->ready.front();
+        const uint32_t n = (frame.size() < length_max) ? static_cast<uint32_t>(frame.size()) : length_max;
+        std::memcpy(buf, frame.data(), n);
+        handle->ready.pop_front();
+        *out_length = n;
+        return ESP_OK;
+    }
+
+    esp_err_t adc_continuous_deinit(adc_continuous_handle_t handle) {
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (!alive(handle)) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (handle->state == State::RUNNING) {
+            s_stats.deinit_while_running++;
+            return ESP_ERR_INVALID_STATE;
+        }
+        handle->state = State::DELETED;
+        handle->ready.clear();
+        return ESP_OK;
+    }
+}
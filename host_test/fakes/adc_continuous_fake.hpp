@@ -0,0 +1,43 @@
+// Fake adc_continuous driver for hardware/adc_engine.cpp. It follows the driver's
+// handle lifecycle strictly (configure once, before start; read and deinit only on
+// a live handle) and counts every violation instead of crashing, so a test can
+// assert there were none. Frames are produced on demand by the test, standing in
+// for the DMA interrupt.
+#ifndef ADC_CONTINUOUS_FAKE_HPP
+#define ADC_CONTINUOUS_FAKE_HPP
+
+#include <hal/adc_types.h>
+#include <cstdint>
+
+namespace AdcContinuousFake {
+    struct Stats {
+        uint32_t handles_created;
+        uint32_t live_handles;        // created and not deinitialized
+        uint32_t running_handles;
+        uint32_t reconfigs;           // adc_continuous_config() on a started or configured handle
+        uint32_t dead_handle_calls;   // any call on a deinitialized handle
+        uint32_t deinit_while_running;
+        uint32_t frames;
+        uint32_t ready_frames;        // completed on the running handle, not yet read
+    };
+
+    Stats stats();
+
+    // Raw value every conversion of ch reads from now on
+    void setChannelValue(adc_channel_t ch, uint16_t raw);
+
+    // Make the next adc_continuous_config() fail with ESP_FAIL
+    void failNextConfig();
+
+    // Make the next adc_continuous_start() complete a frame (and call on_conv_done)
+    // before it returns, as when the first DMA interrupt beats the caller
+    void frameOnNextStart();
+
+    // One DMA frame on the running handle, cycling through its pattern, then the
+    // on_conv_done callback (as from the ISR). With notify false the callback is
+    // skipped, as when the task has not yet taken an earlier notification and the
+    // two coalesce. False if no handle is running.
+    bool completeFrame(bool notify = true);
+}
+
+#endif // ADC_CONTINUOUS_FAKE_HPP
@@ -0,0 +1,238 @@
+// Host versions of the sensors, link, state and sleep entry used by
+// utils/deep_sleep_cycle.cpp, driven by ProbeFakes::Script (see probe_fakes.hpp)
+#include <fakes/probe_fakes.hpp>
+#include <main/utils/deep_sleep_cycle.hpp>
+#include <main/hardware/temperature_sensor.hpp>
+#include <main/hardware/soil_moisture_sensor.hpp>
+#include <main/network/wifi_manager.hpp>
+#include <main/network/mqtt_client.hpp>
+#include <main/state/calibration.hpp>
+#include <main/config/config.hpp>
+#include <host_env.hpp>
+#include <esp_sleep.h>
+#include <esp_wifi.h>
+#include <cstring>
+
+namespace {
+    ProbeFakes::Script s_script;
+    ProbeFakes::Record s_record;
+    RuntimeThresholds::Values s_thresholds = {
+        Config::Monitoring::temp_low_warn_c,       Config::Monitoring::temp_low_crit_c,
+        Config::Monitoring::temp_high_warn_c,      Config::Monitoring::temp_high_crit_c,
+        Config::Monitoring::moisture_low_warn_pct, Config::Monitoring::moisture_low_crit_pct,
+        Config::Monitoring::moisture_high_warn_pct, Config::Monitoring::moisture_high_crit_pct,
+    };
+
+    // Link timeline for the current wake, in virtual us (-1 = not started)
+    int64_t s_wifi_start_us = -1;
+    int64_t s_mqtt_start_us = -1;
+    int64_t s_last_publish_us = -1;
+    int s_outbox_bytes = 0;
+    int s_next_msg_id = 1;
+
+    // The IP event handler WiFiManager::init() registered, as esp_event would hold it
+    void (*s_ip_handler)(void*, esp_event_base_t, int32_t, void*) = nullptr;
+    void* s_ip_handler_arg = nullptr;
+
+    bool elapsed(int64_t start_us, uint32_t after_ms) {
+        return start_us >= 0 && after_ms != ProbeFakes::NEVER &&
+               HostEnv::nowUs() >= start_us + static_cast<int64_t>(after_ms) * 1000;
+    }
+
+    // Runs on every vTaskDelay(): raise IP_EVENT_STA_GOT_IP once the script says so
+    void deliverLinkEvents() {
+        if (s_ip_handler != nullptr && elapsed(s_wifi_start_us, s_script.wifi_ip_ms)) {
+            s_ip_handler(s_ip_handler_arg, "IP_EVENT", 0, nullptr);
+            s_ip_handler = nullptr;
+        }
+    }
+}
+
+namespace ProbeFakes {
+    Script& script() {
+        return s_script;
+    }
+
+    const Record& record() {
+        return s_record;
+    }
+
+    RuntimeThresholds::Values& thresholds() {
+        return s_thresholds;
+    }
+
+    uint32_t wake() {
+        HostEnv::advanceUs(-HostEnv::nowUs()); // esp_timer restarts with the app
+        HostEnv::setDelayHook(deliverLinkEvents);
+        s_record = Record{};
+        s_wifi_start_us = -1;
+        s_mqtt_start_us = -1;
+        s_last_publish_us = -1;
+        s_outbox_bytes = 0;
+        s_ip_handler = nullptr;
+        try {
+            DeepSleepCycle::run();
+        } catch (const Slept&) {
+        }
+        HostEnv::setDelayHook(nullptr);
+        return static_cast<uint32_t>(s_record.slept_at_us / 1000);
+    }
+
+    std::size_t count(const char* needle) {
+        std::size_t n = 0;
+        for (const Message& m : s_record.published) {
+            n += (m.topic.find(needle) != std::string::npos) ? 1U : 0U;
+        }
+        return n;
+    }
+}
+
+// Sensors: fixed readings, each read costs script().sensor_read_ms
+TemperatureSensor::TemperatureSensor(gpio_num_t sensor_pin)
+    : pin(sensor_pin), adc_channel(ADC_CHANNEL_0), adc_handle(nullptr), engine_slot(-1), initialized(false) {}
+
+bool TemperatureSensor::init() {
+    initialized = true;
+    return true;
+}
+
+bool TemperatureSensor::readTemperature(int16_t& out_centi_c) {
+    HostEnv::advanceMs(s_script.sensor_read_ms);
+    out_centi_c = s_script.temp_centi;
+    return true;
+}
+
+AdcMillivoltTable::AdcMillivoltTable() : table{}, valid(false) {}
+
+SoilMoistureSensor::SoilMoistureSensor(const Config& config)
+    : cfg(config), scale(config.raw_dry, config.raw_wet), adc_handle(nullptr), engine_slot(-1), simulated(true) {}
+
+bool SoilMoistureSensor::init() {
+    return true;
+}
+
+void SoilMoistureSensor::setCalibration(uint16_t raw_dry, uint16_t raw_wet) {
+    cfg.raw_dry = raw_dry;
+    cfg.raw_wet = raw_wet;
+}
+
+bool SoilMoistureSensor::read(MoistureData& out_data) {
+    HostEnv::advanceMs(s_script.sensor_read_ms);
+    out_data = MoistureData{};
+    out_data.moisture_centi_pct = s_script.moisture_centi;
+    return true;
+}
+
+// WiFi: IP arrives script().wifi_ip_ms after init(), through the registered handler
+WiFiManager::WiFiManager()
+    : initialized(false), connected(false), got_ip(false), retry_count(0), on_link(nullptr),
+      wifi_any_id_instance(nullptr), ip_got_ip_instance(nullptr) {}
+
+bool WiFiManager::init() {
+    s_record.wifi_inits++;
+    initialized = true;
+    connected = false;
+    got_ip = false;
+    s_wifi_start_us = HostEnv::nowUs();
+    s_ip_handler = &WiFiManager::ipEventHandler;
+    s_ip_handler_arg = this;
+    return true;
+}
+
+bool WiFiManager::connect() {
+    return initialized;
+}
+
+void WiFiManager::disconnect() {
+    connected = false;
+    got_ip = false;
+    s_ip_handler = nullptr;
+}
+
+void WiFiManager::ipEventHandler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
+    (void)event_base;
+    (void)event_id;
+    (void)event_data;
+    WiFiManager* self = static_cast<WiFiManager*>(arg);
+    self->connected = true;
+    self->got_ip = true;
+}
+
+// MQTT: connected script().mqtt_connect_ms after connect(); the outbox empties
+// script().ack_ms after the last accepted publish
+MqttClient::MqttClient()
+    : client(nullptr), host(""), port(0), client_id(""), connected(false), on_message(nullptr),
+      on_connection(nullptr) {}
+
+bool MqttClient::init() {
+    return true;
+}
+
+bool MqttClient::connect() {
+    s_mqtt_start_us = HostEnv::nowUs();
+    return true;
+}
+
+void MqttClient::disconnect() {
+    s_mqtt_start_us = -1;
+}
+
+bool MqttClient::isConnected() const {
+    return elapsed(s_mqtt_start_us, s_script.mqtt_connect_ms);
+}
+
+int MqttClient::publish(const char* topic, const char* payload, int qos, bool retain) {
+    return publish(topic, reinterpret_cast<const uint8_t*>(payload), static_cast<int>(std::strlen(payload)), qos,
+                   retain);
+}
+
+int MqttClient::publish(const char* topic, const uint8_t* data, int length, int qos, bool retain) {
+    (void)qos;
+    (void)retain;
+    if (!isConnected() || (!s_script.refuse_topic.empty() && std::strstr(topic, s_script.refuse_topic.c_str()))) {
+        return -1;
+    }
+    s_record.published.push_back({topic, std::string(reinterpret_cast<const char*>(data), length)});
+    s_last_publish_us = HostEnv::nowUs();
+    s_outbox_bytes += length;
+    return s_next_msg_id++;
+}
+
+int MqttClient::outboxBytes() const {
+    if (elapsed(s_last_publish_us, s_script.ack_ms)) {
+        s_outbox_bytes = 0;
+    }
+    return s_outbox_bytes;
+}
+
+// State: thresholds from ProbeFakes::thresholds(), default moisture calibration
+namespace RuntimeThresholds {
+    Values snapshot(uint32_t* out_generation) {
+        if (out_generation != nullptr) {
+            *out_generation = 0;
+        }
+        return s_thresholds;
+    }
+}
+
+namespace Calibration {
+    Moisture getMoisture() {
+        return Moisture{Config::Hardware::Moisture::raw_dry, Config::Hardware::Moisture::raw_wet};
+    }
+}
+
+extern "C" {
+    esp_err_t esp_wifi_stop(void) {
+        return ESP_OK;
+    }
+
+    esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+        s_record.sleep_timer_us = time_in_us;
+        return ESP_OK;
+    }
+
+    void esp_deep_sleep_start(void) {
+        s_record.slept_at_us = HostEnv::nowUs();
+        throw ProbeFakes::Slept{};
+    }
+}
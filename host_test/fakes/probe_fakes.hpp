@@ -0,0 +1,54 @@
+// Scripted stand-ins for what the deep-sleep probe cycle (utils/deep_sleep_cycle.cpp)
+// touches: both sensors, the WiFi and MQTT link, RuntimeThresholds, Calibration and
+// the sleep entry. Link delays are on the virtual clock, so a wake's duration comes
+// out of the cycle's own waits (vTaskDelay) and can be checked exactly.
+#ifndef PROBE_FAKES_HPP
+#define PROBE_FAKES_HPP
+
+#include <main/state/runtime_thresholds.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ProbeFakes {
+    static constexpr uint32_t NEVER = UINT32_MAX;
+
+    // Thrown by esp_deep_sleep_start()
+    struct Slept {};
+
+    struct Message {
+        std::string topic;
+        std::string payload;
+    };
+
+    struct Script {
+        int16_t temp_centi = 2150;
+        uint16_t moisture_centi = 4500;
+        uint32_t sensor_read_ms = 20;     // virtual time per sensor read
+        uint32_t wifi_ip_ms = 1200;       // WiFi init -> IP (NEVER: no IP)
+        uint32_t mqtt_connect_ms = 300;   // MQTT connect -> connected (NEVER: refused)
+        uint32_t ack_ms = 150;            // last publish -> outbox empty (NEVER: no acks)
+        std::string refuse_topic;         // publish() returns -1 for topics containing this
+    };
+
+    struct Record {
+        std::vector<Message> published;   // accepted messages, this wake
+        uint32_t wifi_inits = 0;          // this wake
+        uint64_t sleep_timer_us = 0;      // esp_sleep_enable_timer_wakeup()
+        int64_t slept_at_us = -1;         // esp_timer at esp_deep_sleep_start()
+    };
+
+    Script& script();
+    const Record& record();
+    RuntimeThresholds::Values& thresholds();
+
+    // One timer wake: esp_timer restarts at 0 (RTC_DATA_ATTR state carries over),
+    // DeepSleepCycle::run() executes until it enters deep sleep.
+    // Returns the wake-to-sleep time in ms.
+    uint32_t wake();
+
+    // Messages accepted this wake whose topic contains needle
+    std::size_t count(const char* needle);
+}
+
+#endif // PROBE_FAKES_HPP
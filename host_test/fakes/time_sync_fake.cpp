@@ -0,0 +1,36 @@
+// Host stand-in for utils/time_sync.cpp: a fixed wall clock, synced unless a test
+// says otherwise (HostEnv::setClockSynced)
+#include <main/utils/time_sync.hpp>
+#include <host_env.hpp>
+#include <cstdio>
+
+namespace TimeSync {
+    void init() {}
+
+    bool isSynced() {
+        return HostEnv::clockSynced();
+    }
+
+    bool clockIsValid() {
+        return HostEnv::clockSynced();
+    }
+
+    bool waitForSync(unsigned int timeout_ms) {
+        (void)timeout_ms;
+        return HostEnv::clockSynced();
+    }
+
+    void formatFixedTimestamp(char* out, std::size_t out_size) {
+        if (out_size > 0) {
+            std::snprintf(out, out_size, "%s", "20251211123045");
+        }
+    }
+
+    bool monotonicToEpochMs(uint32_t mono_ms, uint64_t& out_epoch_ms) {
+        if (!HostEnv::clockSynced()) {
+            return false;
+        }
+        out_epoch_ms = HostEnv::SYNC_EPOCH_MS + mono_ms;
+        return true;
+    }
+}
@@ -0,0 +1,121 @@
+// Writes TelemetryCodec round-trip fixtures for test_telemetry_decoder.js: each line
+// holds a binary frame (hex) and the JSON payload the firmware sends for the same
+// samples, so the Node-RED decoder's output can be checked against the JSON path.
+//   gen_codec_fixtures <out.jsonl>
+#include <main/utils/backlog_format.hpp>
+#include <main/utils/fixed_point.hpp>
+#include <main/utils/telemetry_codec.hpp>
+#include <host_env.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+namespace {
+    static constexpr const char* TOPIC_TEMP = "thermometer/thermo-001/temperature";
+    static constexpr const char* TOPIC_MOIST = "thermometer/thermo-001/moisture";
+    static constexpr const char* TOPIC_TEMP_BACKLOG = "thermometer/thermo-001/temperature/backlog";
+    static constexpr const char* TOPIC_MOIST_BACKLOG = "thermometer/thermo-001/moisture/backlog";
+
+    void writeLine(std::FILE* f, const char* topic, const uint8_t* frame, std::size_t len, const char* json) {
+        std::fprintf(f, "{\"topic\":\"%s\",\"frame\":\"", topic);
+        for (std::size_t i = 0; i < len; ++i) {
+            std::fprintf(f, "%02x", frame[i]);
+        }
+        std::fprintf(f, "\",\"json\":%s}\n", json);
+    }
+
+    // TimeSync::formatFixedTimestamp() for a given epoch (or unsynced)
+    void formatTs(char* out, std::size_t size, bool synced, uint64_t epoch_ms) {
+        if (!synced) {
+            std::snprintf(out, size, "%s", "00000000000000");
+            return;
+        }
+        const std::time_t t = static_cast<std::time_t>(epoch_ms / 1000U);
+        std::tm tm_utc;
+        gmtime_r(&t, &tm_utc);
+        std::strftime(out, size, "%Y%m%d%H%M%S", &tm_utc);
+    }
+
+    // Live sample: frame from FrameEncoder, JSON with the cloud task's format strings
+    void liveSample(std::FILE* f, TelemetryCodec::Kind kind, int32_t centi, bool synced, uint64_t epoch_ms) {
+        uint8_t frame[TelemetryCodec::maxFrameBytes(1)];
+        TelemetryCodec::FrameEncoder encoder(frame, sizeof(frame), kind, synced);
+        (void)encoder.add(centi, epoch_ms);
+        const std::size_t len = encoder.finish();
+
+        const bool temp = kind == TelemetryCodec::Kind::TEMPERATURE;
+        char ts[16];
+        char value[16];
+        char json[160];
+        formatTs(ts, sizeof(ts), synced, epoch_ms);
+        (void)FixedPoint::formatCenti(value, sizeof(value), centi, temp ? 2U : 1U);
+        std::snprintf(json, sizeof(json), temp ? "{\"value\":%s,\"ts\":\"%s\"}" : "{\"percent\":%s,\"ts\":\"%s\"}",
+                      value, ts);
+        writeLine(f, temp ? TOPIC_TEMP : TOPIC_MOIST, frame, len, json);
+    }
+
+    // Backlog batch: both payloads from BacklogFormat, as the cloud task builds them
+    template <std::size_t N>
+    void backlogBatch(std::FILE* f, TelemetryCodec::Kind kind, const int32_t (&centi)[N], bool synced,
+                      const uint64_t (&epoch_ms)[N]) {
+        const bool temp = kind == TelemetryCodec::Kind::TEMPERATURE;
+        auto value_at = [&](std::size_t i) { return centi[i]; };
+        auto epoch_at = [&](std::size_t i) { return epoch_ms[i]; };
+        static uint8_t frame[TelemetryCodec::maxFrameBytes(64)];
+        static char json[160 + 64 * 24];
+        const int len = BacklogFormat::encodeBinary(frame, sizeof(frame), kind, N, value_at, synced, epoch_at);
+        const int json_len = BacklogFormat::formatJson(json, sizeof(json), temp ? "values" : "percent", temp ? 2U : 1U,
+                                                       N, value_at, synced, epoch_at);
+        if (len < 0 || json_len < 0) {
+            std::fprintf(stderr, "fixture batch did not fit\n");
+            std::exit(EXIT_FAILURE);
+        }
+        writeLine(f, temp ? TOPIC_TEMP_BACKLOG : TOPIC_MOIST_BACKLOG, frame, static_cast<std::size_t>(len), json);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <out.jsonl>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::FILE* f = std::fopen(argv[1], "w");
+    if (f == nullptr) {
+        std::perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    const uint64_t epoch = HostEnv::SYNC_EPOCH_MS + 120U;
+
+    liveSample(f, TelemetryCodec::Kind::TEMPERATURE, 2150, true, epoch);
+    liveSample(f, TelemetryCodec::Kind::TEMPERATURE, 2153, true, epoch + 59999U);   // 0.1 degC quantization
+    liveSample(f, TelemetryCodec::Kind::TEMPERATURE, -530, true, epoch);            // below zero
+    liveSample(f, TelemetryCodec::Kind::TEMPERATURE, 2150, false, 0);               // clock never synced
+    liveSample(f, TelemetryCodec::Kind::MOISTURE, 4520, true, epoch + 1000U);
+    liveSample(f, TelemetryCodec::Kind::MOISTURE, 0, false, 0);
+
+    // 5 s period with jitter, slowly drifting values
+    int32_t temps[32];
+    uint64_t temp_times[32];
+    for (std::size_t i = 0; i < 32; ++i) {
+        temps[i] = 2150 + static_cast<int32_t>((i * 37) % 23) - 11;
+        temp_times[i] = epoch + i * 5000U + (i % 3) * 7U;
+    }
+    backlogBatch(f, TelemetryCodec::Kind::TEMPERATURE, temps, true, temp_times);
+
+    // Large steps and a gap (reconnect after an outage)
+    const int32_t steps[] = {-4000, 12500, 12490, -120, 0, 3300};
+    const uint64_t step_times[] = {epoch, epoch + 5000U, epoch + 10000U, epoch + 3600000U, epoch + 3605000U,
+                                   epoch + 3610000U};
+    backlogBatch(f, TelemetryCodec::Kind::TEMPERATURE, steps, true, step_times);
+
+    const int32_t moist[] = {4520, 4510, 4490, 4490, 4470};
+    const uint64_t moist_times[] = {0, 0, 0, 0, 0};
+    backlogBatch(f, TelemetryCodec::Kind::MOISTURE, moist, false, moist_times);
+
+    const int32_t one[] = {2210};
+    const uint64_t one_time[] = {epoch};
+    backlogBatch(f, TelemetryCodec::Kind::TEMPERATURE, one, true, one_time); // 1-sample backlog stays a batch
+
+    std::fclose(f);
+    return EXIT_SUCCESS;
+}
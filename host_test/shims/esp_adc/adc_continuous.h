@@ -0,0 +1,83 @@
+// Host stand-in for ESP-IDF's esp_adc/adc_continuous.h, ESP32 layout (TYPE1
+// results, 2 bytes each). The driver itself is a fake the test drives
+// (fakes/adc_continuous_fake.cpp).
+#pragma once
+
+#include <esp_err.h>
+#include <hal/adc_types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SOC_ADC_DIGI_RESULT_BYTES 2
+#define SOC_ADC_DIGI_MAX_BITWIDTH 12
+
+typedef struct adc_continuous_ctx_t* adc_continuous_handle_t;
+
+typedef enum { ADC_DIGI_OUTPUT_FORMAT_TYPE1, ADC_DIGI_OUTPUT_FORMAT_TYPE2 } adc_digi_output_format_t;
+typedef enum { ADC_CONV_SINGLE_UNIT_1 = 1, ADC_CONV_SINGLE_UNIT_2, ADC_CONV_BOTH_UNIT, ADC_CONV_ALTER_UNIT } adc_digi_convert_mode_t;
+
+typedef struct {
+    uint8_t atten;
+    uint8_t channel;
+    uint8_t unit;
+    uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+    union {
+        struct {
+            uint16_t data : 12;
+            uint16_t channel : 4;
+        } type1;
+        struct {
+            uint16_t data : 11;
+            uint16_t channel : 4;
+            uint16_t unit : 1;
+        } type2;
+        uint16_t val;
+    };
+} adc_digi_output_data_t;
+
+typedef struct {
+    uint32_t max_store_buf_size;
+    uint32_t conv_frame_size;
+} adc_continuous_handle_cfg_t;
+
+typedef struct {
+    uint32_t pattern_num;
+    adc_digi_pattern_config_t* adc_pattern;
+    uint32_t sample_freq_hz;
+    adc_digi_convert_mode_t conv_mode;
+    adc_digi_output_format_t format;
+} adc_continuous_config_t;
+
+typedef struct {
+    uint8_t* conv_frame_buffer;
+    uint32_t size;
+} adc_continuous_evt_data_t;
+
+typedef bool (*adc_continuous_callback_t)(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* edata,
+                                          void* user_data);
+
+typedef struct {
+    adc_continuous_callback_t on_conv_done;
+    adc_continuous_callback_t on_pool_ovf;
+} adc_continuous_evt_cbs_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t* cfg, adc_continuous_handle_t* ret_handle);
+esp_err_t adc_continuous_register_event_callbacks(adc_continuous_handle_t handle, const adc_continuous_evt_cbs_t* cbs,
+                                                  void* user_data);
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t* config);
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle);
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle);
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t* buf, uint32_t length_max, uint32_t* out_length,
+                              uint32_t timeout_ms);
+esp_err_t adc_continuous_deinit(adc_continuous_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,7 @@
+// Host stand-in for ESP-IDF's esp_adc/adc_oneshot.h: the handle type only, for
+// sensor class declarations (their host versions live in fakes/)
+#pragma once
+
+#include <hal/adc_types.h>
+
+typedef struct adc_oneshot_unit_ctx_t* adc_oneshot_unit_handle_t;
@@ -0,0 +1,20 @@
+// Host stand-in for ESP-IDF's esp_app_desc.h
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    char version[32];
+    char project_name[32];
+    uint8_t app_elf_sha256[32];
+} esp_app_desc_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const esp_app_desc_t* esp_app_get_description(void);
+
+#ifdef __cplusplus
+}
+#endif
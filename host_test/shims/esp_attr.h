@@ -0,0 +1,9 @@
+// Host stand-in for ESP-IDF's esp_attr.h: placement attributes are meaningless off-target
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_FAST_ATTR
+#define __NOINIT_ATTR
@@ -0,0 +1,8 @@
+// Host stand-in for ESP-IDF's esp_event.h: types used in class declarations
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+typedef const char* esp_event_base_t;
+typedef void* esp_event_handler_instance_t;
@@ -0,0 +1,4 @@
+// Host stand-in for ESP-IDF's esp_netif.h (nothing the host build calls)
+#pragma once
+
+#include <esp_err.h>
@@ -0,0 +1,14 @@
+// Host stand-in for ESP-IDF's esp_random.h (deterministic sequence)
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
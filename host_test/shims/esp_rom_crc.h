@@ -0,0 +1,24 @@
+// Host stand-in for ESP-IDF's esp_rom_crc.h: bitwise CRC-32 (IEEE, reflected),
+// same results as the ROM's esp_rom_crc32_le().
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const* buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; ++i) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+// Host stand-in for ESP-IDF's esp_sleep.h. esp_deep_sleep_start() does not return
+// on the chip; the host version (fakes/probe_fakes.cpp) throws ProbeFakes::Slept, so a
+// test can run wake after wake in one process.
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+__attribute__((noreturn)) void esp_deep_sleep_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+// Host stand-in for ESP-IDF's esp_timer.h, on the virtual clock (HostEnv::advanceUs)
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
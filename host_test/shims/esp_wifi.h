@@ -0,0 +1,16 @@
+// Host stand-in for ESP-IDF's esp_wifi.h; the WiFi link itself is faked at the
+// WiFiManager level (fakes/probe_fakes.cpp)
+#pragma once
+
+#include <esp_err.h>
+#include <esp_event.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_wifi_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,4 @@
+// Host stand-in for FreeRTOS portmacro.h (everything lives in FreeRTOS.h)
+#pragma once
+
+#include <freertos/FreeRTOS.h>
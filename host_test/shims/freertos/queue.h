@@ -0,0 +1,26 @@
+// Host stand-in for FreeRTOS queue.h: a copy-in/copy-out ring in the caller's
+// static storage, safe across host threads. Blocking sends and receives wait in
+// wall time (they synchronize real threads), not on the virtual clock.
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+typedef struct HostQueue* QueueHandle_t;
+typedef struct {
+    alignas(16) uint8_t opaque[256];
+} StaticQueue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t* storage, StaticQueue_t* buffer);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks_to_wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks_to_wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define xQueueSendToBack(queue, item, ticks) xQueueSend((queue), (item), (ticks))
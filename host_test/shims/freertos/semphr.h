@@ -0,0 +1,22 @@
+// Host stand-in for FreeRTOS semphr.h: mutexes only, safe across host threads.
+// Blocking takes wait in wall time, like queue.h.
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+typedef struct HostMutex* SemaphoreHandle_t;
+typedef struct {
+    alignas(16) uint8_t opaque[128];
+} StaticSemaphore_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,31 @@
+// Host stand-in for FreeRTOS task.h. Tasks run as detached host threads; delays
+// advance the virtual clock instead of sleeping, so timing tests run instantly.
+// Notification waits, like queue waits, block in wall time.
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+typedef struct HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+typedef struct {
+    uint8_t opaque[64];
+} StaticTask_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                               UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                                           UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb, BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_task_woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
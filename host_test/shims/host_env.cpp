@@ -0,0 +1,655 @@
+// Host implementations of the ESP-IDF / FreeRTOS functions the host-built modules
+// call, and the test controls declared in support/host_env.hpp
+#include <host_env.hpp>
+#include <esp_app_desc.h>
+#include <esp_err.h>
+#include <esp_partition.h>
+#include <esp_random.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <nvs_flash.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    static constexpr std::size_t SECTOR_BYTES = 4096;
+
+    // Contents and fault state live in a MAP_SHARED mapping, so they survive into (and
+    // out of) HostTest::isolated() children the way flash survives a reset
+    struct FlashState {
+        uint32_t erases;
+        int faulted;
+        long write_budget; // bytes the next write may store before the cut; -1 = no fault armed
+        uint8_t data[];
+    };
+
+    struct Partition {
+        esp_partition_t desc;
+        FlashState* flash = nullptr;
+        std::size_t mapped = 0;
+
+        ~Partition() {
+            if (flash != nullptr) {
+                munmap(flash, mapped);
+            }
+        }
+    };
+
+    std::atomic<int64_t> s_now_us{0};
+    std::atomic<void (*)()> s_delay_hook{nullptr};
+    std::atomic<uint32_t> s_null_notifies{0};
+    std::atomic<uint32_t> s_task_wakeups{0};
+    std::recursive_mutex s_critical;
+    std::map<std::string, std::unique_ptr<Partition>>& partitions() {
+        static std::map<std::string, std::unique_ptr<Partition>> map;
+        return map;
+    }
+    std::map<std::string, esp_log_level_t>& logLevels() {
+        static std::map<std::string, esp_log_level_t> map;
+        return map;
+    }
+    bool s_log_output = true;
+    std::atomic<uint32_t> s_log_lines{0};
+    std::mutex s_log_lock;
+    char s_last_line[512];
+    esp_reset_reason_t s_reset_reason = ESP_RST_POWERON;
+    bool s_clock_synced = true;
+    uint32_t s_random = 0x2545F491;
+
+    Partition* find(const esp_partition_t* desc) {
+        for (auto& entry : partitions()) {
+            if (&entry.second->desc == desc) {
+                return entry.second.get();
+            }
+        }
+        return nullptr;
+    }
+
+    Partition* find(const char* label) {
+        auto it = partitions().find(label);
+        return (it == partitions().end()) ? nullptr : it->second.get();
+    }
+
+    bool inRange(const Partition* p, std::size_t offset, std::size_t size) {
+        return p != nullptr && offset <= p->desc.size && size <= p->desc.size - offset;
+    }
+
+    // Blocking waits: ticks map to wall-clock milliseconds (portMAX_DELAY = forever).
+    // A wait that times out moves the virtual clock by its ticks, as the tick count
+    // would have on the target.
+    template <typename Pred>
+    bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, TickType_t ticks, Pred ready) {
+        if (ticks == portMAX_DELAY) {
+            cv.wait(lock, ready);
+            return true;
+        }
+        if (ticks == 0) {
+            return ready(); // polling call: no timed wait (and no syscall), like FreeRTOS
+        }
+        if (cv.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready)) {
+            return true;
+        }
+        s_now_us.fetch_add(static_cast<int64_t>(ticks) * (1000000 / configTICK_RATE_HZ));
+        return false;
+    }
+
+    // Task notification counters, keyed by task handle. The lock and condition are
+    // never destroyed: task threads may still be blocked on them when main() returns.
+    std::mutex& s_notify_lock = *new std::mutex;
+    std::condition_variable& s_notify_cv = *new std::condition_variable;
+    std::map<TaskHandle_t, uint32_t>& notifyCounts() {
+        static std::map<TaskHandle_t, uint32_t> map;
+        return map;
+    }
+    thread_local TaskHandle_t s_current_task = nullptr;
+
+    // NVS: namespace -> key -> blob, and the namespace behind each open handle
+    struct NvsHandle {
+        std::string ns;
+        bool writable;
+    };
+    std::mutex s_nvs_lock;
+    std::map<std::string, std::map<std::string, std::vector<uint8_t>>> s_nvs;
+    std::map<nvs_handle_t, NvsHandle> s_nvs_handles;
+    nvs_handle_t s_nvs_next_handle = 1;
+    bool s_nvs_fail_writes = false;
+    uint32_t s_nvs_writes = 0;
+    std::atomic<uint32_t> s_nvs_latency_us{0};
+
+    // Caller holds s_nvs_lock
+    NvsHandle* nvsHandle(nvs_handle_t handle) {
+        auto it = s_nvs_handles.find(handle);
+        return (it == s_nvs_handles.end()) ? nullptr : &it->second;
+    }
+}
+
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    uint8_t* storage;
+    std::size_t length;
+    std::size_t item_size;
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
+static_assert(sizeof(HostQueue) <= sizeof(StaticQueue_t), "StaticQueue_t too small for HostQueue");
+
+struct HostMutex {
+    std::timed_mutex lock;
+};
+static_assert(sizeof(HostMutex) <= sizeof(StaticSemaphore_t), "StaticSemaphore_t too small for HostMutex");
+
+namespace HostEnv {
+    int64_t nowUs() {
+        return s_now_us.load();
+    }
+
+    void advanceUs(int64_t us) {
+        s_now_us.fetch_add(us);
+    }
+
+    void advanceMs(uint32_t ms) {
+        advanceUs(static_cast<int64_t>(ms) * 1000);
+    }
+
+    void setDelayHook(void (*hook)()) {
+        s_delay_hook = hook;
+    }
+
+    void createPartition(const char* label, std::size_t size) {
+        auto p = std::make_unique<Partition>();
+        std::memset(&p->desc, 0, sizeof(p->desc));
+        p->desc.type = ESP_PARTITION_TYPE_DATA;
+        p->desc.subtype = ESP_PARTITION_SUBTYPE_ANY;
+        p->desc.size = static_cast<uint32_t>(size);
+        p->desc.erase_size = SECTOR_BYTES;
+        std::snprintf(p->desc.label, sizeof(p->desc.label), "%s", label);
+        p->mapped = sizeof(FlashState) + size;
+        void* mem = mmap(nullptr, p->mapped, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            std::perror("mmap");
+            std::abort();
+        }
+        p->flash = static_cast<FlashState*>(mem);
+        p->flash->erases = 0;
+        p->flash->faulted = 0;
+        p->flash->write_budget = -1;
+        std::memset(p->flash->data, 0xFF, size);
+        partitions()[label] = std::move(p);
+    }
+
+    void removePartition(const char* label) {
+        partitions().erase(label);
+    }
+
+    uint8_t* partitionData(const char* label) {
+        Partition* p = find(label);
+        return (p == nullptr) ? nullptr : p->flash->data;
+    }
+
+    void failWriteAfter(const char* label, std::size_t bytes) {
+        if (Partition* p = find(label)) {
+            p->flash->write_budget = static_cast<long>(bytes);
+        }
+    }
+
+    void clearFaults(const char* label) {
+        if (Partition* p = find(label)) {
+            p->flash->faulted = 0;
+            p->flash->write_budget = -1;
+        }
+    }
+
+    uint32_t eraseCount(const char* label) {
+        Partition* p = find(label);
+        return (p == nullptr) ? 0U : p->flash->erases;
+    }
+
+    void nvsErase() {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        s_nvs.clear();
+    }
+
+    void nvsPutBlob(const char* ns, const char* key, const void* data, std::size_t size) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        s_nvs[ns][key].assign(bytes, bytes + size);
+    }
+
+    bool nvsGetBlob(const char* ns, const char* key, void* out, std::size_t& size) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        auto space = s_nvs.find(ns);
+        if (space == s_nvs.end() || space->second.count(key) == 0) {
+            return false;
+        }
+        const std::vector<uint8_t>& blob = space->second[key];
+        std::memcpy(out, blob.data(), (blob.size() < size) ? blob.size() : size);
+        size = blob.size();
+        return true;
+    }
+
+    void nvsFailWrites(bool fail) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        s_nvs_fail_writes = fail;
+    }
+
+    uint32_t nvsWriteCount() {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        return s_nvs_writes;
+    }
+
+    void nvsWriteLatencyUs(uint32_t us) {
+        s_nvs_latency_us = us;
+    }
+
+    void setResetReason(esp_reset_reason_t reason) {
+        s_reset_reason = reason;
+    }
+
+    void setClockSynced(bool synced) {
+        s_clock_synced = synced;
+    }
+
+    bool clockSynced() {
+        return s_clock_synced;
+    }
+
+    esp_log_level_t espLogLevel(const char* tag) {
+        auto it = logLevels().find(tag);
+        return (it == logLevels().end()) ? ESP_LOG_NONE : it->second;
+    }
+
+    void resetEspLogLevels() {
+        logLevels().clear();
+    }
+
+    void setLogOutput(bool enabled) {
+        s_log_output = enabled;
+    }
+
+    uint32_t logLineCount() {
+        return s_log_lines.load();
+    }
+
+    void lastLogLine(char* out, std::size_t cap) {
+        std::lock_guard<std::mutex> lock(s_log_lock);
+        std::snprintf(out, cap, "%s", s_last_line);
+    }
+
+    uint32_t nullNotifies() {
+        return s_null_notifies.load();
+    }
+
+    uint32_t taskWakeups() {
+        return s_task_wakeups.load();
+    }
+}
+
+extern "C" {
+    const char* esp_err_to_name(esp_err_t code) {
+        return (code == ESP_OK) ? "ESP_OK" : "ESP_ERR";
+    }
+
+    int64_t esp_timer_get_time(void) {
+        return s_now_us.load();
+    }
+
+    uint32_t esp_random(void) {
+        // xorshift32, reseeded per process so each HostTest::isolated() boot differs
+        static pid_t seeded_for = 0;
+        if (seeded_for != getpid()) {
+            seeded_for = getpid();
+            s_random = 0x2545F491U ^ (static_cast<uint32_t>(seeded_for) * 2654435761U);
+        }
+        s_random ^= s_random << 13;
+        s_random ^= s_random >> 17;
+        s_random ^= s_random << 5;
+        return s_random;
+    }
+
+    esp_reset_reason_t esp_reset_reason(void) {
+        return s_reset_reason;
+    }
+
+    const esp_app_desc_t* esp_app_get_description(void) {
+        static const esp_app_desc_t desc = {"host", "thermometer", {0x48, 0x4F, 0x53, 0x54}};
+        return &desc;
+    }
+
+    void esp_log_level_set(const char* tag, esp_log_level_t level) {
+        // As in ESP-IDF, the "*" default also forgets every per-tag level
+        if (std::strcmp(tag, "*") == 0) {
+            logLevels().clear();
+        }
+        logLevels()[tag] = level;
+    }
+
+    void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+        (void)level;
+        (void)tag;
+        s_log_lines.fetch_add(1);
+        if (!s_log_output) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(s_log_lock);
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(s_last_line, sizeof(s_last_line), format, args);
+        va_end(args);
+        std::fputs(s_last_line, stdout);
+        const std::size_t n = std::strlen(s_last_line);
+        if (n > 0 && s_last_line[n - 1] == '\n') {
+            s_last_line[n - 1] = '\0';
+        }
+    }
+
+    const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                    const char* label) {
+        (void)subtype;
+        for (auto& entry : partitions()) {
+            Partition& p = *entry.second;
+            if ((type == ESP_PARTITION_TYPE_ANY || p.desc.type == type) &&
+                (label == nullptr || entry.first == label)) {
+                return &p.desc;
+            }
+        }
+        return nullptr;
+    }
+
+    esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size) {
+        Partition* p = find(partition);
+        if (!inRange(p, src_offset, size)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        std::memcpy(dst, p->flash->data + src_offset, size);
+        return ESP_OK;
+    }
+
+    esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size) {
+        Partition* p = find(partition);
+        if (!inRange(p, dst_offset, size)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        FlashState& f = *p->flash;
+        if (f.faulted) {
+            return ESP_FAIL;
+        }
+        std::size_t n = size;
+        if (f.write_budget >= 0) {
+            n = (static_cast<std::size_t>(f.write_budget) < size) ? static_cast<std::size_t>(f.write_budget) : size;
+            f.faulted = 1;
+        }
+        const uint8_t* in = static_cast<const uint8_t*>(src);
+        for (std::size_t i = 0; i < n; ++i) {
+            f.data[dst_offset + i] &= in[i]; // NOR: program clears bits only
+        }
+        return f.faulted ? ESP_FAIL : ESP_OK;
+    }
+
+    esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+        Partition* p = find(partition);
+        if (!inRange(p, offset, size) || offset % SECTOR_BYTES != 0 || size % SECTOR_BYTES != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (p->flash->faulted) {
+            return ESP_FAIL;
+        }
+        std::memset(p->flash->data + offset, 0xFF, size);
+        p->flash->erases += static_cast<uint32_t>(size / SECTOR_BYTES);
+        return ESP_OK;
+    }
+
+    esp_err_t nvs_flash_init(void) {
+        return ESP_OK;
+    }
+
+    esp_err_t nvs_flash_erase(void) {
+        HostEnv::nvsErase();
+        return ESP_OK;
+    }
+
+    esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        if (open_mode == NVS_READONLY && s_nvs.count(name) == 0) {
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+        if (open_mode == NVS_READWRITE) {
+            (void)s_nvs[name];
+        }
+        *out_handle = s_nvs_next_handle++;
+        s_nvs_handles[*out_handle] = NvsHandle{name, open_mode == NVS_READWRITE};
+        return ESP_OK;
+    }
+
+    void nvs_close(nvs_handle_t handle) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        s_nvs_handles.erase(handle);
+    }
+
+    esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        const NvsHandle* h = nvsHandle(handle);
+        if (h == nullptr) {
+            return ESP_ERR_NVS_INVALID_HANDLE;
+        }
+        auto& space = s_nvs[h->ns];
+        auto it = space.find(key);
+        if (it == space.end()) {
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+        if (length == nullptr) {
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        // As in the driver: a null buffer queries the size, a short one fails with it
+        const std::size_t stored = it->second.size();
+        if (out_value != nullptr && *length < stored) {
+            *length = stored;
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        if (out_value != nullptr) {
+            std::memcpy(out_value, it->second.data(), stored);
+        }
+        *length = stored;
+        return ESP_OK;
+    }
+
+    esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+        if (const uint32_t us = s_nvs_latency_us.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        }
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        const NvsHandle* h = nvsHandle(handle);
+        if (h == nullptr) {
+            return ESP_ERR_NVS_INVALID_HANDLE;
+        }
+        if (!h->writable) {
+            return ESP_ERR_NVS_READ_ONLY;
+        }
+        if (s_nvs_fail_writes) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        s_nvs[h->ns][key].assign(bytes, bytes + length);
+        s_nvs_writes++;
+        return ESP_OK;
+    }
+
+    esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        const NvsHandle* h = nvsHandle(handle);
+        if (h == nullptr) {
+            return ESP_ERR_NVS_INVALID_HANDLE;
+        }
+        if (!h->writable) {
+            return ESP_ERR_NVS_READ_ONLY;
+        }
+        if (s_nvs_fail_writes) {
+            return ESP_FAIL;
+        }
+        return (s_nvs[h->ns].erase(key) != 0) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    esp_err_t nvs_commit(nvs_handle_t handle) {
+        std::lock_guard<std::mutex> lock(s_nvs_lock);
+        return (nvsHandle(handle) != nullptr) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+    }
+
+    void vPortEnterCritical(portMUX_TYPE* mux) {
+        s_critical.lock();
+        mux->count++;
+    }
+
+    void vPortExitCritical(portMUX_TYPE* mux) {
+        mux->count--;
+        s_critical.unlock();
+    }
+
+    TickType_t xTaskGetTickCount(void) {
+        return static_cast<TickType_t>(s_now_us.load() / (1000000 / configTICK_RATE_HZ));
+    }
+
+    void vTaskDelay(TickType_t ticks) {
+        s_now_us.fetch_add(static_cast<int64_t>(ticks) * (1000000 / configTICK_RATE_HZ));
+        if (void (*hook)() = s_delay_hook.load()) {
+            hook();
+        }
+        s_task_wakeups++;
+        std::this_thread::yield();
+    }
+
+    TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                                   UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb) {
+        (void)name;
+        (void)stack_depth;
+        (void)priority;
+        (void)stack;
+        const TaskHandle_t handle = reinterpret_cast<TaskHandle_t>(tcb);
+        std::thread([fn, param, handle] {
+            s_current_task = handle;
+            fn(param);
+        }).detach();
+        return handle;
+    }
+
+    TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                                               UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb,
+                                               BaseType_t core) {
+        (void)core;
+        return xTaskCreateStatic(fn, name, stack_depth, param, priority, stack, tcb);
+    }
+
+    TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+        static thread_local uint8_t marker;
+        return (s_current_task != nullptr) ? s_current_task : reinterpret_cast<TaskHandle_t>(&marker);
+    }
+
+    BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+        if (task == nullptr) {
+            s_null_notifies++; // configASSERT on the target
+            return pdFAIL;
+        }
+        {
+            std::lock_guard<std::mutex> lock(s_notify_lock);
+            notifyCounts()[task]++;
+        }
+        s_notify_cv.notify_all();
+        return pdPASS;
+    }
+
+    void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_task_woken) {
+        (void)xTaskNotifyGive(task);
+        if (higher_priority_task_woken != nullptr) {
+            *higher_priority_task_woken = pdFALSE;
+        }
+    }
+
+    uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+        const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+        std::unique_lock<std::mutex> lock(s_notify_lock);
+        uint32_t& count = notifyCounts()[self];
+        (void)waitFor(s_notify_cv, lock, ticks_to_wait, [&count] { return count != 0; });
+        if (ticks_to_wait != 0) {
+            s_task_wakeups++;
+        }
+        const uint32_t value = count;
+        if (value != 0) {
+            count = (clear_on_exit == pdTRUE) ? 0 : value - 1;
+        }
+        return value;
+    }
+
+    QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t* storage,
+                                     StaticQueue_t* buffer) {
+        HostQueue* q = new (buffer) HostQueue();
+        q->storage = storage;
+        q->length = length;
+        q->item_size = item_size;
+        return q;
+    }
+
+    BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks_to_wait) {
+        std::unique_lock<std::mutex> lock(queue->lock);
+        if (!waitFor(queue->not_full, lock, ticks_to_wait, [queue] { return queue->count < queue->length; })) {
+            return pdFAIL; // errQUEUE_FULL
+        }
+        const std::size_t slot = (queue->head + queue->count) % queue->length;
+        std::memcpy(queue->storage + slot * queue->item_size, item, queue->item_size);
+        queue->count++;
+        lock.unlock();
+        queue->not_empty.notify_one();
+        return pdPASS;
+    }
+
+    BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks_to_wait) {
+        std::unique_lock<std::mutex> lock(queue->lock);
+        if (!waitFor(queue->not_empty, lock, ticks_to_wait, [queue] { return queue->count != 0; })) {
+            return pdFAIL;
+        }
+        std::memcpy(item, queue->storage + queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        lock.unlock();
+        queue->not_full.notify_one();
+        return pdPASS;
+    }
+
+    UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+        std::lock_guard<std::mutex> lock(queue->lock);
+        return static_cast<UBaseType_t>(queue->count);
+    }
+
+    SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer) {
+        return new (buffer) HostMutex();
+    }
+
+    BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            mutex->lock.lock();
+            return pdPASS;
+        }
+        return mutex->lock.try_lock_for(std::chrono::milliseconds(ticks_to_wait * portTICK_PERIOD_MS)) ? pdPASS
+                                                                                                       : pdFAIL;
+    }
+
+    BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+        mutex->lock.unlock();
+        return pdPASS;
+    }
+}
@@ -0,0 +1,2 @@
+// Host stand-in for the untracked main/secrets.hpp: the template values
+#include <main/secrets.hpp.defaults>
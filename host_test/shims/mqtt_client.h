@@ -0,0 +1,8 @@
+// Host stand-in for esp-mqtt's mqtt_client.h: handle types for MqttClient's
+// declaration (the client itself is faked in fakes/probe_fakes.cpp)
+#pragma once
+
+#include <esp_event.h>
+
+typedef struct esp_mqtt_client* esp_mqtt_client_handle_t;
+typedef struct esp_mqtt_event_t* esp_mqtt_event_handle_t;
@@ -0,0 +1,15 @@
+// Host stand-in for ESP-IDF's nvs_flash.h (see nvs.h)
+#pragma once
+
+#include <nvs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_erase(void);
+
+#ifdef __cplusplus
+}
+#endif
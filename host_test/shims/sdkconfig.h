@@ -0,0 +1,9 @@
+// Host stand-in for the generated sdkconfig.h: only the options the host-built
+// modules read, at their sdkconfig.defaults values
+#pragma once
+
+#define CONFIG_IDF_TARGET_ESP32 1
+#define CONFIG_FREERTOS_HZ 1000
+#define CONFIG_LOG_DEFAULT_LEVEL 3
+#define CONFIG_LOG_MAXIMUM_LEVEL 4
+#define CONFIG_FREERTOS_NUMBER_OF_CORES 2
@@ -0,0 +1,74 @@
+// Test-side controls for the ESP-IDF / FreeRTOS host shims (shims/host_env.cpp):
+// the virtual clock, simulated flash partitions with fault injection, simulated NVS,
+// the reset reason and the levels handed to esp_log_level_set().
+#ifndef HOST_ENV_HPP
+#define HOST_ENV_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <esp_log.h>
+#include <esp_system.h>
+
+namespace HostEnv {
+    // Virtual clock behind esp_timer_get_time() and xTaskGetTickCount(); starts at 0
+    // and only moves when a test, vTaskDelay or a timed-out blocking wait advances it
+    int64_t nowUs();
+    void advanceUs(int64_t us);
+    void advanceMs(uint32_t ms);
+    // Called after vTaskDelay() moves the clock: lets fakes deliver events (link up,
+    // acks) on the virtual clock while firmware code polls. nullptr to remove.
+    void setDelayHook(void (*hook)());
+
+    // Create (or re-create, erased to 0xFF) a data partition of size bytes
+    void createPartition(const char* label, std::size_t size);
+    void removePartition(const char* label);
+    uint8_t* partitionData(const char* label);
+    // Power cut: the next write stores only its first `bytes` bytes and fails, and
+    // every later write and erase fails until clearFaults()
+    void failWriteAfter(const char* label, std::size_t bytes);
+    void clearFaults(const char* label);
+    uint32_t eraseCount(const char* label);
+
+    // NVS blobs live in process memory: an isolated() child starts from a copy and its
+    // writes do not come back. nvsErase() is nvs_flash_erase().
+    void nvsErase();
+    // Store bytes under namespace/key behind the firmware's back (old or foreign blobs)
+    void nvsPutBlob(const char* ns, const char* key, const void* data, std::size_t size);
+    // Copy of a stored blob; size is the capacity in, the stored size out. False if absent.
+    bool nvsGetBlob(const char* ns, const char* key, void* out, std::size_t& size);
+    // While set, nvs_set_blob() and nvs_erase_key() fail (full or worn flash)
+    void nvsFailWrites(bool fail);
+    // Successful nvs_set_blob() calls since start
+    uint32_t nvsWriteCount();
+    // Wall-clock time nvs_set_blob() takes before storing (flash programming), so
+    // concurrent writers overlap as on the chip; 0 (default) returns at once
+    void nvsWriteLatencyUs(uint32_t us);
+
+    void setResetReason(esp_reset_reason_t reason);
+
+    // Wall clock seen through the TimeSync fake (fakes/time_sync_fake.cpp): when synced,
+    // monotonic ms m maps to epoch ms SYNC_EPOCH_MS + m
+    static constexpr uint64_t SYNC_EPOCH_MS = 1765452645000ULL;
+    void setClockSynced(bool synced);
+    bool clockSynced();
+
+    // Last level set for tag ("*" for the default, which clears the per-tag levels as
+    // ESP-IDF does); ESP_LOG_NONE if never set
+    esp_log_level_t espLogLevel(const char* tag);
+    void resetEspLogLevels();
+    // Silence the stdout log lines (tests that deliberately log a lot)
+    void setLogOutput(bool enabled);
+    // Lines written through esp_log_write() since start, counted with output off too
+    uint32_t logLineCount();
+    // Last line printed (output on), without its newline; "" if none
+    void lastLogLine(char* out, std::size_t cap);
+
+    // Task notifications (xTaskNotifyGive / vTaskNotifyGiveFromISR) sent to a null
+    // handle: configASSERT on the target, counted and ignored here
+    uint32_t nullNotifies();
+    // Times a task came back from vTaskDelay() or a blocking ulTaskNotifyTake(), all
+    // tasks together: an idle task that polls keeps raising it
+    uint32_t taskWakeups();
+}
+
+#endif // HOST_ENV_HPP
@@ -0,0 +1,108 @@
+// Check macros and timing helpers for the host tests and benchmarks.
+// No framework: each test file calls HostTest::run() per case from main() and
+// returns HostTest::finish().
+#ifndef TEST_SUPPORT_HPP
+#define TEST_SUPPORT_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace HostTest {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void fail(const char* file, int line, const char* what) {
+        std::printf("  FAIL %s:%d: %s\n", file, line, what);
+        failures()++;
+    }
+
+    template <typename Fn>
+    void run(const char* name, Fn fn) {
+        const int before = failures();
+        fn();
+        std::printf("%s %s\n", (failures() == before) ? "PASS" : "FAIL", name);
+    }
+
+    inline int finish() {
+        if (failures() != 0) {
+            std::printf("%d check(s) failed\n", failures());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Run fn in a forked child: a fresh copy of every firmware static, as after a
+    // reset. Simulated flash (HostEnv partitions) is shared, so it persists across
+    // calls. Checks failing in the child count as one failure here.
+    template <typename Fn>
+    bool isolated(Fn fn) {
+        std::fflush(stdout);
+        const int before = failures();
+        const pid_t pid = fork();
+        if (pid == 0) {
+            fn();
+            std::fflush(stdout);
+            _exit(failures() == before ? 0 : 1); // earlier cases' failures are not this boot's
+        }
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fail(__FILE__, __LINE__, "isolated boot failed");
+            return false;
+        }
+        return true;
+    }
+
+    // Benchmarks: "--quick" (as ctest runs them) cuts the iteration count
+    inline bool quick(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--quick") == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Keep a benchmarked result alive so the optimizer cannot drop the work
+    template <typename T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    // Mean wall time of fn() in nanoseconds over iterations calls
+    template <typename Fn>
+    double nsPerCall(long iterations, Fn fn) {
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; ++i) {
+            fn(i);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+    }
+}
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            HostTest::fail(__FILE__, __LINE__, #expr); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const auto check_a_ = (actual); \
+        const auto check_e_ = (expected); \
+        if (!(check_a_ == check_e_)) { \
+            char check_msg_[160]; \
+            std::snprintf(check_msg_, sizeof(check_msg_), "%s == %s (got %lld, expected %lld)", #actual, #expected, \
+                          static_cast<long long>(check_a_), static_cast<long long>(check_e_)); \
+            HostTest::fail(__FILE__, __LINE__, check_msg_); \
+        } \
+    } while (0)
+
+#endif // TEST_SUPPORT_HPP
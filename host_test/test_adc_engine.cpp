@@ -0,0 +1,182 @@
+// Continuous ADC engine (hardware/adc_engine.cpp) on a fake adc_continuous driver:
+// channels attached after the first start get a fresh driver handle rather than a
+// reconfigured running one, attaching while frames stream never touches a freed
+// handle, each slot reads its own channel, and frames that complete behind one
+// wake-up are all drained so the newest is published, including a frame that
+// completes before the first adc_continuous_start() returns. Each case is a fresh boot
+// (HostTest::isolated), since the engine keeps its handle and task for life.
+#include <main/hardware/adc_engine.hpp>
+#include <fakes/adc_continuous_fake.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+    static constexpr uint16_t TEMP_RAW = 310;      // ADC1_CH0, LM35
+    static constexpr uint16_t MOISTURE_RAW = 2630; // ADC1_CH6, soil probe
+    static constexpr uint16_t SPARE_RAW = 1234;    // ADC1_CH3
+
+    // Produce one frame and wait (wall time) until the engine task has published it
+    bool pumpFrame() {
+        const uint32_t before = AdcEngine::getStats().frames;
+        if (!AdcContinuousFake::completeFrame()) {
+            return false;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (AdcEngine::getStats().frames == before) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return true;
+    }
+
+    uint16_t mean(int slot) {
+        uint16_t raw = 0;
+        return AdcEngine::readMean(slot, raw) ? raw : 0;
+    }
+
+    void setValues() {
+        AdcContinuousFake::setChannelValue(ADC_CHANNEL_0, TEMP_RAW);
+        AdcContinuousFake::setChannelValue(ADC_CHANNEL_6, MOISTURE_RAW);
+        AdcContinuousFake::setChannelValue(ADC_CHANNEL_3, SPARE_RAW);
+    }
+
+    void checkNoLifecycleViolations() {
+        const AdcContinuousFake::Stats stats = AdcContinuousFake::stats();
+        CHECK_EQ(stats.reconfigs, 0U);
+        CHECK_EQ(stats.dead_handle_calls, 0U);
+        CHECK_EQ(stats.deinit_while_running, 0U);
+        CHECK_EQ(stats.live_handles, 1U);
+        CHECK_EQ(stats.running_handles, 1U);
+    }
+
+    void testLateChannelGetsFreshHandle() {
+        HostTest::isolated([] {
+            setValues();
+            const int temp = AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0);
+            CHECK_EQ(temp, 0);
+            CHECK(pumpFrame());
+            CHECK_EQ(mean(temp), TEMP_RAW);
+
+            const int moisture = AdcEngine::attach(ADC_CHANNEL_6, ADC_ATTEN_DB_12);
+            CHECK_EQ(moisture, 1);
+            CHECK_EQ(AdcContinuousFake::stats().handles_created, 2U);
+            checkNoLifecycleViolations();
+            CHECK(pumpFrame());
+            CHECK_EQ(mean(temp), TEMP_RAW);
+            CHECK_EQ(mean(moisture), MOISTURE_RAW);
+        });
+    }
+
+    void testAttachWhileStreaming() {
+        HostTest::isolated([] {
+            setValues();
+            std::atomic<bool> stop{false};
+            (void)AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0);
+            // DMA interrupts keep arriving while the other sensor tasks initialize
+            std::thread dma([&stop] {
+                while (!stop) {
+                    (void)AdcContinuousFake::completeFrame();
+                    std::this_thread::yield();
+                }
+            });
+            int moisture = -1;
+            int spare = -1;
+            std::thread a([&moisture] { moisture = AdcEngine::attach(ADC_CHANNEL_6, ADC_ATTEN_DB_12); });
+            std::thread b([&spare] { spare = AdcEngine::attach(ADC_CHANNEL_3, ADC_ATTEN_DB_12); });
+            a.join();
+            b.join();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            stop = true;
+            dma.join();
+
+            CHECK(moisture > 0 && spare > 0 && moisture != spare);
+            checkNoLifecycleViolations();
+            CHECK(pumpFrame());
+            CHECK_EQ(mean(0), TEMP_RAW);
+            CHECK_EQ(mean(moisture), MOISTURE_RAW);
+            CHECK_EQ(mean(spare), SPARE_RAW);
+        });
+    }
+
+    void testReattachAndFullPattern() {
+        HostTest::isolated([] {
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0), 0);
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0), 0);
+            CHECK_EQ(AdcContinuousFake::stats().handles_created, 1U); // same channel: driver untouched
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_1, ADC_ATTEN_DB_0), 1);
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_2, ADC_ATTEN_DB_0), 2);
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_3, ADC_ATTEN_DB_0), 3);
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_4, ADC_ATTEN_DB_0), -1);
+            CHECK_EQ(AdcContinuousFake::stats().handles_created, 4U);
+            checkNoLifecycleViolations();
+        });
+    }
+
+    void testFailedAttachKeepsEarlierChannels() {
+        HostTest::isolated([] {
+            setValues();
+            const int temp = AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0);
+            AdcContinuousFake::failNextConfig();
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_6, ADC_ATTEN_DB_12), -1);
+            checkNoLifecycleViolations();
+            CHECK(pumpFrame());
+            CHECK_EQ(mean(temp), TEMP_RAW);
+            // The slot was released: a retry succeeds
+            CHECK_EQ(AdcEngine::attach(ADC_CHANNEL_6, ADC_ATTEN_DB_12), 1);
+        });
+    }
+
+    void testFrameDuringFirstStart() {
+        HostTest::isolated([] {
+            setValues();
+            AdcContinuousFake::frameOnNextStart();
+            const int temp = AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0);
+            CHECK_EQ(temp, 0);
+            // The engine task exists before the driver starts, so the ISR has a target
+            CHECK_EQ(HostEnv::nullNotifies(), 0U);
+            // The early frame is not lost either
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (AdcEngine::getStats().frames == 0 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            CHECK_EQ(mean(temp), TEMP_RAW);
+        });
+    }
+
+    void testCoalescedWakeReadsNewestFrame() {
+        HostTest::isolated([] {
+            setValues();
+            const int temp = AdcEngine::attach(ADC_CHANNEL_0, ADC_ATTEN_DB_0);
+            CHECK(pumpFrame());
+            // Two frames complete before the task runs; their notifications coalesce
+            AdcContinuousFake::setChannelValue(ADC_CHANNEL_0, TEMP_RAW + 100);
+            CHECK(AdcContinuousFake::completeFrame(false));
+            AdcContinuousFake::setChannelValue(ADC_CHANNEL_0, TEMP_RAW + 200);
+            const uint32_t before = AdcEngine::getStats().frames;
+            CHECK(pumpFrame());
+            CHECK_EQ(AdcEngine::getStats().frames, before + 1U);
+            CHECK_EQ(mean(temp), TEMP_RAW + 200);
+            CHECK_EQ(AdcContinuousFake::stats().ready_frames, 0U);
+            // The next wake publishes the next frame, not a left-over one
+            AdcContinuousFake::setChannelValue(ADC_CHANNEL_0, TEMP_RAW + 300);
+            CHECK(pumpFrame());
+            CHECK_EQ(mean(temp), TEMP_RAW + 300);
+        });
+    }
+}
+
+int main() {
+    HostEnv::setLogOutput(false);
+    HostTest::run("late channel gets a fresh driver handle", testLateChannelGetsFreshHandle);
+    HostTest::run("attach while frames are streaming", testAttachWhileStreaming);
+    HostTest::run("re-attach keeps its slot, full pattern is refused", testReattachAndFullPattern);
+    HostTest::run("failed attach keeps earlier channels running", testFailedAttachKeepsEarlierChannels);
+    HostTest::run("coalesced wake-up reads the newest frame", testCoalescedWakeReadsNewestFrame);
+    HostTest::run("frame completing inside the first start", testFrameDuringFirstStart);
+    return HostTest::finish();
+}
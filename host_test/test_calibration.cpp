@@ -0,0 +1,264 @@
+// Moisture calibration (state/calibration.cpp) on simulated NVS: resolving the
+// "calibrate" command value (explicit counts, capture, rejects), persisting and
+// reloading the endpoints (ConfigBlob layouts from older and newer builds, the v1
+// raw struct), and the percent scale the sensor builds from them. Each
+// case is a fresh boot (HostTest::isolated) so the module's statics start clean.
+#include <main/state/calibration.hpp>
+#include <main/storage/config_blob.hpp>
+#include <main/utils/fixed_point.hpp>
+#include <main/config/config.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+    // calib/cfg ConfigBlob tags
+    static constexpr uint8_t TAG_DRY = 1;
+    static constexpr uint8_t TAG_WET = 2;
+
+    // Layout of the pre-ConfigBlob "calib"/"data" blob
+    struct Legacy {
+        uint16_t raw_dry;
+        uint16_t raw_wet;
+    };
+
+    void storeBlob(uint16_t version, ConfigBlob::Field* fields, std::size_t count) {
+        std::vector<uint8_t> blob(ConfigBlob::encodedSize(fields, count));
+        (void)ConfigBlob::encode(version, fields, count, blob.data(), blob.size());
+        HostEnv::nvsPutBlob("calib", "cfg", blob.data(), blob.size());
+    }
+
+    // calib/cfg as stored: false if it is missing or not a valid ConfigBlob
+    bool readBlob(ConfigBlob::Field* fields, std::size_t count, std::size_t& applied) {
+        uint8_t blob[256];
+        std::size_t size = sizeof(blob);
+        uint16_t version = 0;
+        return HostEnv::nvsGetBlob("calib", "cfg", blob, size) &&
+               ConfigBlob::decode(blob, size, fields, count, version, &applied) == ConfigBlob::Status::OK;
+    }
+
+    bool resolves(float value, uint16_t expected) {
+        uint16_t raw = 0xFFFF;
+        return Calibration::resolveMoistureRaw(value, raw) && raw == expected;
+    }
+
+    bool rejects(float value) {
+        uint16_t raw = 0;
+        return !Calibration::resolveMoistureRaw(value, raw);
+    }
+
+    void testResolveExplicitCounts() {
+        HostTest::isolated([] {
+            CHECK(resolves(0.0f, 0));
+            CHECK(resolves(2710.0f, 2710));
+            CHECK(resolves(2710.4f, 2710));
+            CHECK(resolves(2710.5f, 2711));
+            CHECK(resolves(4095.0f, 4095));
+            // Negative counts are an error, never a request to capture
+            CHECK(rejects(-1.0f));
+            CHECK(rejects(-0.4f));
+            CHECK(rejects(-4096.0f));
+            CHECK(rejects(4095.4f));
+            CHECK(rejects(65536.0f));
+            CHECK(rejects(std::numeric_limits<float>::infinity()));
+            CHECK(rejects(-std::numeric_limits<float>::infinity()));
+        });
+    }
+
+    void testResolveCapture() {
+        HostTest::isolated([] {
+            CHECK(std::isnan(Calibration::CAPTURE_CURRENT));
+            CHECK(rejects(Calibration::CAPTURE_CURRENT)); // nothing read yet
+            Calibration::noteMoistureRaw(0);
+            CHECK(resolves(Calibration::CAPTURE_CURRENT, 0));
+            Calibration::noteMoistureRaw(2634);
+            CHECK(resolves(Calibration::CAPTURE_CURRENT, 2634));
+            // A reading noted earlier does not make a negative value valid
+            CHECK(rejects(-1.0f));
+        });
+    }
+
+    void testPersistAndReload() {
+        HostEnv::nvsErase();
+        HostTest::isolated([] {
+            Calibration::init();
+            Calibration::Moisture m = Calibration::getMoisture();
+            CHECK_EQ(m.raw_dry, Config::Hardware::Moisture::raw_dry);
+            CHECK_EQ(m.raw_wet, Config::Hardware::Moisture::raw_wet);
+
+            const uint32_t gen = Calibration::generation();
+            CHECK(Calibration::setMoistureDry(3010));
+            CHECK(Calibration::setMoistureWet(1240));
+            CHECK_EQ(Calibration::generation(), gen + 2);
+            m = Calibration::getMoisture();
+            CHECK_EQ(m.raw_dry, 3010);
+            CHECK_EQ(m.raw_wet, 1240);
+
+            uint16_t dry = 0;
+            uint16_t wet = 0;
+            ConfigBlob::Field fields[] = {{TAG_DRY, sizeof(dry), &dry}, {TAG_WET, sizeof(wet), &wet}};
+            std::size_t applied = 0;
+            CHECK(readBlob(fields, 2, applied));
+            CHECK_EQ(applied, 2U);
+            CHECK_EQ(dry, 3010);
+            CHECK_EQ(wet, 1240);
+            CHECK(!Calibration::setMoistureDry(4096));
+        });
+
+        // Next boot loads what the last one saved (NVS seeded as that boot left it)
+        uint16_t dry = 3010;
+        uint16_t wet = 1240;
+        ConfigBlob::Field saved[] = {{TAG_DRY, sizeof(dry), &dry}, {TAG_WET, sizeof(wet), &wet}};
+        storeBlob(2, saved, 2);
+        HostTest::isolated([] {
+            Calibration::init();
+            const Calibration::Moisture m = Calibration::getMoisture();
+            CHECK_EQ(m.raw_dry, 3010);
+            CHECK_EQ(m.raw_wet, 1240);
+        });
+
+        // A blob that is not a ConfigBlob is ignored in favour of the defaults, and
+        // never overwritten
+        const uint8_t odd[3] = {1, 2, 3};
+        HostEnv::nvsPutBlob("calib", "cfg", odd, sizeof(odd));
+        HostTest::isolated([] {
+            Calibration::init();
+            CHECK_EQ(Calibration::getMoisture().raw_dry, Config::Hardware::Moisture::raw_dry);
+            CHECK(!Calibration::setMoistureDry(3000));
+            uint8_t left[3] = {};
+            std::size_t size = sizeof(left);
+            CHECK(HostEnv::nvsGetBlob("calib", "cfg", left, size));
+            CHECK_EQ(size, sizeof(odd));
+            CHECK_EQ(left[2], 3);
+        });
+        HostEnv::nvsErase();
+    }
+
+    void testOlderAndNewerLayouts() {
+        // Older schema that stored only the dry point: wet keeps its default
+        HostEnv::nvsErase();
+        uint16_t dry = 2900;
+        ConfigBlob::Field older[] = {{TAG_DRY, sizeof(dry), &dry}};
+        storeBlob(1, older, 1);
+        HostTest::isolated([] {
+            Calibration::init();
+            const Calibration::Moisture m = Calibration::getMoisture();
+            CHECK_EQ(m.raw_dry, 2900);
+            CHECK_EQ(m.raw_wet, Config::Hardware::Moisture::raw_wet);
+        });
+
+        // Newer schema: a third probe field this build does not know, and the wet
+        // point widened to 4 bytes (a known tag at another size is skipped too)
+        HostEnv::nvsErase();
+        dry = 3100;
+        uint32_t wide_wet = 1100;
+        uint16_t offset = 77;
+        ConfigBlob::Field newer[] = {{TAG_DRY, sizeof(dry), &dry}, {TAG_WET, sizeof(wide_wet), &wide_wet},
+                                     {9, sizeof(offset), &offset}};
+        storeBlob(7, newer, 3);
+        HostTest::isolated([] {
+            Calibration::init();
+            Calibration::Moisture m = Calibration::getMoisture();
+            CHECK_EQ(m.raw_dry, 3100);
+            CHECK_EQ(m.raw_wet, Config::Hardware::Moisture::raw_wet);
+
+            // A save carries the unknown entry over, value intact
+            CHECK(Calibration::setMoistureWet(1500));
+            uint16_t stored_dry = 0;
+            uint16_t stored_wet = 0;
+            uint16_t stored_offset = 0;
+            ConfigBlob::Field fields[] = {{TAG_DRY, sizeof(stored_dry), &stored_dry},
+                                          {TAG_WET, sizeof(stored_wet), &stored_wet},
+                                          {9, sizeof(stored_offset), &stored_offset}};
+            std::size_t applied = 0;
+            CHECK(readBlob(fields, 3, applied));
+            CHECK_EQ(applied, 3U);
+            CHECK_EQ(stored_dry, 3100);
+            CHECK_EQ(stored_wet, 1500);
+            CHECK_EQ(stored_offset, 77);
+        });
+
+        // v1 raw struct: migrated to calib/cfg, then erased
+        HostEnv::nvsErase();
+        const Legacy legacy{2800, 1300};
+        HostEnv::nvsPutBlob("calib", "data", &legacy, sizeof(legacy));
+        HostTest::isolated([] {
+            Calibration::init();
+            const Calibration::Moisture m = Calibration::getMoisture();
+            CHECK_EQ(m.raw_dry, 2800);
+            CHECK_EQ(m.raw_wet, 1300);
+            uint16_t stored_wet = 0;
+            ConfigBlob::Field fields[] = {{TAG_WET, sizeof(stored_wet), &stored_wet}};
+            std::size_t applied = 0;
+            CHECK(readBlob(fields, 1, applied));
+            CHECK_EQ(stored_wet, 1300);
+            Legacy left{};
+            std::size_t size = sizeof(left);
+            CHECK(!HostEnv::nvsGetBlob("calib", "data", &left, size));
+        });
+        HostEnv::nvsErase();
+    }
+
+    void testFailedWriteKeepsOldValues() {
+        HostTest::isolated([] {
+            Calibration::init();
+            CHECK(Calibration::setMoistureWet(1300));
+            const uint32_t gen = Calibration::generation();
+            HostEnv::nvsFailWrites(true);
+            // Not persisted, so not applied: a reset would otherwise revert it
+            CHECK(!Calibration::setMoistureWet(900));
+            HostEnv::nvsFailWrites(false);
+            CHECK_EQ(Calibration::getMoisture().raw_wet, 1300);
+            CHECK_EQ(Calibration::generation(), gen);
+        });
+    }
+
+    void testScaleFromEndpoints() {
+        HostTest::isolated([] {
+            Calibration::init();
+            // Capacitive probe: reads lower when wet
+            CHECK(Calibration::setMoistureDry(3000));
+            CHECK(Calibration::setMoistureWet(1200));
+            Calibration::Moisture m = Calibration::getMoisture();
+            FixedPoint::MoistureScale scale(m.raw_dry, m.raw_wet);
+            CHECK_EQ(scale.toCenti(3000), 0);
+            CHECK_EQ(scale.toCenti(3500), 0);    // drier than the dry point
+            CHECK_EQ(scale.toCenti(2100), 5000);
+            CHECK_EQ(scale.toCenti(1650), 7500);
+            CHECK_EQ(scale.toCenti(1200), 10000);
+            CHECK_EQ(scale.toCenti(0), 10000);   // wetter than the wet point
+            for (uint32_t raw = 0; raw <= 4095; ++raw) {
+                CHECK(std::abs(scale.toCenti(raw) - static_cast<int32_t>(std::lround(scale.reference(raw) * 100.0))) <= 1);
+            }
+
+            // Resistive probe: reads higher when wet
+            CHECK(Calibration::setMoistureDry(800));
+            CHECK(Calibration::setMoistureWet(2800));
+            m = Calibration::getMoisture();
+            scale = FixedPoint::MoistureScale(m.raw_dry, m.raw_wet);
+            CHECK_EQ(scale.toCenti(800), 0);
+            CHECK_EQ(scale.toCenti(1300), 2500);
+            CHECK_EQ(scale.toCenti(2800), 10000);
+
+            // Both points captured at the same reading: uncalibrated, reads 0 %
+            CHECK(Calibration::setMoistureDry(2800));
+            m = Calibration::getMoisture();
+            scale = FixedPoint::MoistureScale(m.raw_dry, m.raw_wet);
+            CHECK_EQ(scale.span, 0U);
+            CHECK_EQ(scale.toCenti(2800), 0);
+        });
+    }
+}
+
+int main() {
+    HostEnv::setLogOutput(false);
+    HostTest::run("explicit counts resolve, negatives are rejected", testResolveExplicitCounts);
+    HostTest::run("capture takes the latest reading", testResolveCapture);
+    HostTest::run("endpoints persist and reload", testPersistAndReload);
+    HostTest::run("older and newer blob layouts", testOlderAndNewerLayouts);
+    HostTest::run("failed NVS write keeps the old endpoints", testFailedWriteKeepsOldValues);
+    HostTest::run("percent scale from calibrated endpoints", testScaleFromEndpoints);
+    return HostTest::finish();
+}
@@ -0,0 +1,119 @@
+// Deep-sleep probe cycle (utils/deep_sleep_cycle.cpp) wake by wake: wake-to-sleep
+// time for quiet, upload and failing-link wakes, and that a threshold crossing only
+// settles once its alert was accepted and acked. Each HostTest::isolated() call is a
+// power-on; ProbeFakes::wake() is one timer wake within it (RTC memory carries over).
+#include <main/config/config.hpp>
+#include <fakes/probe_fakes.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+
+namespace {
+    using ProbeFakes::NEVER;
+
+    static constexpr uint32_t SAMPLE_MS = 2 * 20; // two sensor reads per wake
+    static constexpr uint32_t UPLOAD_MS = SAMPLE_MS + 1200 + 300 + 150; // + IP, MQTT connect, acks
+    static constexpr uint32_t WAKE_BUDGET_MS =
+        SAMPLE_MS + Config::DeepSleep::link_timeout_ms + Config::DeepSleep::drain_timeout_ms;
+    static constexpr int16_t TEMP_CRIT = 3300; // above Config::Monitoring::temp_high_crit_c
+
+    void testQuietWakeStaysOffline() {
+        HostTest::isolated([] {
+            CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS);
+            CHECK_EQ(ProbeFakes::record().wifi_inits, 0U);
+            CHECK(ProbeFakes::record().published.empty());
+            CHECK_EQ(ProbeFakes::record().sleep_timer_us, Config::DeepSleep::wake_period_s * 1000000ULL);
+        });
+    }
+
+    void testScheduledUploadTiming() {
+        HostTest::isolated([] {
+            for (uint32_t i = 1; i < Config::DeepSleep::publish_every_n_wakes; ++i) {
+                CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS);
+            }
+            // The link is polled every 50 ms; the script's delays are multiples of it
+            CHECK_EQ(ProbeFakes::wake(), UPLOAD_MS);
+            CHECK_EQ(ProbeFakes::record().wifi_inits, 1U);
+            CHECK_EQ(ProbeFakes::count("/temperature/backlog"), 1U);
+            CHECK_EQ(ProbeFakes::count("/moisture/backlog"), 1U);
+            CHECK_EQ(ProbeFakes::count("/status"), 1U);
+            CHECK_EQ(ProbeFakes::count("/alert"), 0U);
+            // The status message reports the quiet wakes' timing
+            const std::string& status = ProbeFakes::record().published.back().payload;
+            CHECK(status.find("\"samples\":12") != std::string::npos);
+            CHECK(status.find("\"awake_ms_max\":40") != std::string::npos);
+            // Uploaded: the next wake is quiet again
+            CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS);
+            CHECK_EQ(ProbeFakes::record().wifi_inits, 0U);
+        });
+    }
+
+    void testRefusedAlertRetriedNextWake() {
+        HostTest::isolated([] {
+            ProbeFakes::script().temp_centi = TEMP_CRIT;
+            ProbeFakes::script().refuse_topic = "/alert";
+            (void)ProbeFakes::wake();
+            CHECK_EQ(ProbeFakes::record().wifi_inits, 1U);
+            CHECK_EQ(ProbeFakes::count("/alert"), 0U);
+
+            // The crossing is still open: the next wake connects and sends it
+            ProbeFakes::script().refuse_topic.clear();
+            CHECK_EQ(ProbeFakes::wake(), UPLOAD_MS);
+            CHECK_EQ(ProbeFakes::count("/alert"), 1U);
+            CHECK(ProbeFakes::record().published.size() > 1);
+            CHECK(ProbeFakes::record().published[2].payload.find("\"state\":\"CRITICAL\"") != std::string::npos);
+
+            // Settled: still critical, but nothing new to report
+            CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS);
+            CHECK_EQ(ProbeFakes::record().wifi_inits, 0U);
+        });
+    }
+
+    void testUnackedAlertBoundedAndRetried() {
+        HostTest::isolated([] {
+            ProbeFakes::script().temp_centi = TEMP_CRIT;
+            ProbeFakes::script().ack_ms = NEVER;
+            const uint32_t awake = ProbeFakes::wake();
+            CHECK_EQ(ProbeFakes::count("/alert"), 1U);
+            // Waited the full drain timeout for acks, and no longer
+            CHECK_EQ(awake, UPLOAD_MS - 150 + Config::DeepSleep::drain_timeout_ms);
+            CHECK(awake <= WAKE_BUDGET_MS);
+
+            // Accepted but never acked: sent again, and settled once acked
+            ProbeFakes::script().ack_ms = 150;
+            CHECK_EQ(ProbeFakes::wake(), UPLOAD_MS);
+            CHECK_EQ(ProbeFakes::count("/alert"), 1U);
+            CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS);
+            CHECK_EQ(ProbeFakes::count("/alert"), 0U);
+        });
+    }
+
+    void testNoLinkGivesUpAtTimeout() {
+        HostTest::isolated([] {
+            ProbeFakes::script().temp_centi = TEMP_CRIT;
+            ProbeFakes::script().wifi_ip_ms = NEVER;
+            CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS + Config::DeepSleep::link_timeout_ms);
+            CHECK(ProbeFakes::record().published.empty());
+
+            ProbeFakes::script().mqtt_connect_ms = NEVER;
+            ProbeFakes::script().wifi_ip_ms = 1200;
+            CHECK_EQ(ProbeFakes::wake(), SAMPLE_MS + Config::DeepSleep::link_timeout_ms);
+            CHECK(ProbeFakes::record().published.empty());
+
+            // Link back: the crossing (and every held reading) goes out
+            ProbeFakes::script().mqtt_connect_ms = 300;
+            CHECK_EQ(ProbeFakes::wake(), UPLOAD_MS);
+            CHECK_EQ(ProbeFakes::count("/alert"), 1U);
+            CHECK(ProbeFakes::record().published.back().payload.find("\"samples\":3") != std::string::npos);
+        });
+    }
+}
+
+int main() {
+    HostEnv::setLogOutput(false);
+    HostTest::run("quiet wake stays offline", testQuietWakeStaysOffline);
+    HostTest::run("scheduled upload wake-to-sleep time", testScheduledUploadTiming);
+    HostTest::run("refused alert is retried next wake", testRefusedAlertRetriedNextWake);
+    HostTest::run("unacked alert: bounded wait, retried", testUnackedAlertBoundedAndRetried);
+    HostTest::run("no link gives up at the timeout", testNoLinkGivesUpAtTimeout);
+    return HostTest::finish();
+}
@@ -0,0 +1,139 @@
+// Integer conversion kernels (utils/fixed_point.hpp) against the float code they
+// replaced, over every raw ADC value: the LM35 kernel with the shipped calibration,
+// the millivolt kernel, and two-point moisture scales in both orientations. Also
+// the float -> centi rounding and the centi formatter.
+#include <main/utils/fixed_point.hpp>
+#include <main/config/config.hpp>
+#include <test_support.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    static constexpr uint32_t ADC_MAX = 4095;
+    using TempKernel = FixedPoint::LinearKernel<Config::Hardware::Temperature::adc_full_scale_mv, ADC_MAX,
+                                                Config::Hardware::Temperature::gain_c_per_mv>;
+    using TempMvKernel = FixedPoint::MillivoltKernel<Config::Hardware::Temperature::gain_c_per_mv>;
+
+    int32_t roundCenti(float value) {
+        return static_cast<int32_t>(std::lround(value * 100.0f));
+    }
+
+    // TemperatureSensor::readTemperature() before the integer path
+    float floatCelsius(uint32_t raw) {
+        const float voltage_mv = (static_cast<float>(raw) / static_cast<float>(ADC_MAX)) *
+                                 (static_cast<float>(Config::Hardware::Temperature::adc_full_scale_mv) / 1000.0f) *
+                                 1000.0f;
+        return voltage_mv * Config::Hardware::Temperature::gain_c_per_mv;
+    }
+
+    // SoilMoistureSensor::convertToPercent() before the integer path
+    float floatPercent(int raw, int dry, int wet) {
+        if (dry == wet) {
+            return 0.0f;
+        }
+        float percent = (dry > wet) ? 100.0f * (static_cast<float>(dry - raw) / static_cast<float>(dry - wet))
+                                    : 100.0f * (static_cast<float>(raw - dry) / static_cast<float>(wet - dry));
+        return (percent < 0.0f) ? 0.0f : ((percent > 100.0f) ? 100.0f : percent);
+    }
+
+    void testTemperatureSweep() {
+        int32_t worst = 0;
+        int32_t previous = -1;
+        for (uint32_t raw = 0; raw <= ADC_MAX; ++raw) {
+            const int32_t centi = TempKernel::toCenti(raw);
+            worst = std::max(worst, std::abs(centi - roundCenti(floatCelsius(raw))));
+            CHECK(centi >= previous); // monotonic
+            previous = centi;
+        }
+        CHECK(worst <= 1);
+        CHECK_EQ(TempKernel::toCenti(0), 0);
+        CHECK_EQ(TempKernel::toCenti(ADC_MAX), 11000);
+        CHECK_EQ(TempKernel::toCenti(ADC_MAX + 1), 11000);  // clamped, not wrapped
+        CHECK_EQ(TempKernel::toCenti(UINT32_MAX), 11000);
+    }
+
+    void testMillivoltSweep() {
+        for (uint32_t mv = 0; mv <= TempMvKernel::MV_MAX; ++mv) {
+            CHECK_EQ(TempMvKernel::toCenti(mv), roundCenti(static_cast<float>(mv) * 0.1f));
+        }
+        CHECK_EQ(TempMvKernel::toCenti(TempMvKernel::MV_MAX + 500), TempMvKernel::toCenti(TempMvKernel::MV_MAX));
+    }
+
+    void checkMoistureSweep(uint16_t dry, uint16_t wet) {
+        const FixedPoint::MoistureScale scale(dry, wet);
+        int32_t worst = 0;
+        for (uint32_t raw = 0; raw <= ADC_MAX; ++raw) {
+            const int32_t centi = scale.toCenti(raw);
+            CHECK(centi >= 0 && centi <= FixedPoint::PERCENT_CENTI_MAX);
+            worst = std::max(worst, std::abs(centi - roundCenti(floatPercent(static_cast<int>(raw), dry, wet))));
+        }
+        if (worst > 1) {
+            std::printf("  dry=%u wet=%u: worst error %d centi-%%\n", dry, wet, worst);
+        }
+        CHECK(worst <= 1);
+        CHECK_EQ(scale.toCenti(dry), 0);
+        CHECK_EQ(scale.toCenti(wet), (dry == wet) ? 0 : FixedPoint::PERCENT_CENTI_MAX);
+    }
+
+    void testMoistureSweeps() {
+        checkMoistureSweep(Config::Hardware::Moisture::raw_dry, Config::Hardware::Moisture::raw_wet);
+        checkMoistureSweep(3000, 1200); // capacitive probe: lower when wet
+        checkMoistureSweep(0, 4095);
+        checkMoistureSweep(4095, 0);
+        checkMoistureSweep(2000, 2001); // one-count span
+        checkMoistureSweep(1000, 1007);
+        checkMoistureSweep(1500, 1500); // uncalibrated
+    }
+
+    void testFloatToCenti() {
+        CHECK_EQ(FixedPoint::toCenti(28.0f), 2800);
+        CHECK_EQ(FixedPoint::toCenti(-5.5f), -550);
+        CHECK_EQ(FixedPoint::toCenti(0.004f), 0);
+        CHECK_EQ(FixedPoint::toCenti(0.006f), 1);
+        CHECK_EQ(FixedPoint::toCenti(-0.006f), -1);
+        CHECK_EQ(FixedPoint::toCenti(NAN), INT32_MIN);
+        CHECK_EQ(FixedPoint::toCenti(1e30f), INT32_MAX);
+        CHECK_EQ(FixedPoint::toCenti(-1e30f), INT32_MIN);
+    }
+
+    void checkFormat(int32_t centi, unsigned decimals, const char* want) {
+        char out[24];
+        const int len = FixedPoint::formatCenti(out, sizeof(out), centi, decimals);
+        if (std::strcmp(out, want) != 0 || len != static_cast<int>(std::strlen(want))) {
+            std::printf("  formatCenti(%d, %u) = \"%s\", expected \"%s\"\n", centi, decimals, out, want);
+            HostTest::fail(__FILE__, __LINE__, "formatCenti");
+        }
+    }
+
+    void testFormatAndDeci() {
+        checkFormat(2150, 2, "21.50");
+        checkFormat(-325, 2, "-3.25");
+        checkFormat(-1, 2, "-0.01");
+        checkFormat(0, 2, "0.00");
+        checkFormat(4155, 1, "41.6");  // half away from zero
+        checkFormat(-4155, 1, "-41.6");
+        checkFormat(-4, 1, "0.0");
+        checkFormat(-5, 1, "-0.1");
+        checkFormat(INT32_MIN, 2, "-21474836.48");
+        // Every value formats back to itself
+        for (int32_t centi = -20000; centi <= 20000; ++centi) {
+            char out[24];
+            (void)FixedPoint::formatCenti(out, sizeof(out), centi, 2);
+            CHECK_EQ(std::lround(std::strtod(out, nullptr) * 100.0), centi);
+        }
+        CHECK_EQ(FixedPoint::centiToDeci(2155), 216);
+        CHECK_EQ(FixedPoint::centiToDeci(-2155), -216);
+        CHECK_EQ(FixedPoint::centiToDeci(2154), 215);
+    }
+}
+
+int main() {
+    HostTest::run("LM35 kernel over the full raw range", testTemperatureSweep);
+    HostTest::run("millivolt kernel over the calibrated range", testMillivoltSweep);
+    HostTest::run("moisture scales over the full raw range", testMoistureSweeps);
+    HostTest::run("float thresholds to centi-units", testFloatToCenti);
+    HostTest::run("centi formatting and deci rounding", testFormatAndDeci);
+    return HostTest::finish();
+}
@@ -0,0 +1,237 @@
+// Logging (utils/logger.hpp, utils/deferred_log.hpp): deferred records replayed through
+// format() must read as printf would have printed the call, the drain must sleep while
+// the ring is empty and keep going when a producer stops between claim() and commit(),
+// and runtime levels must reach
+// ESP-IDF's filter too. The crash ring keeps only calls at its capture level, and
+// renders them within its documented limits. The drain runs as a real thread and
+// levels and rings are process-wide, so those cases are isolated boots.
+#include <main/utils/deferred_log.hpp>
+#include <main/utils/logger.hpp>
+#include <main/utils/crash_log.hpp>
+#include <main/config/config.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+    template <typename... Args>
+    void render(char* out, std::size_t cap, const char* fmt, Args... args) {
+        DeferredLog::Record r{};
+        r.tag = "TEST";
+        r.fmt = fmt;
+        r.arg_count = static_cast<uint8_t>(sizeof...(Args));
+        std::size_t i = 0;
+        (DeferredLog::detail::add(r, i++, args), ...);
+        DeferredLog::format(r, out, cap);
+    }
+
+    // Same text as snprintf for the same call
+    template <typename... Args>
+    bool matchesPrintf(const char* fmt, Args... args) {
+        char got[LOGGER_MAX_MESSAGE_LEN];
+        char expected[LOGGER_MAX_MESSAGE_LEN];
+        render(got, sizeof(got), fmt, args...);
+        std::snprintf(expected, sizeof(expected), fmt, args...);
+        if (std::strcmp(got, expected) != 0) {
+            std::printf("  got \"%s\", expected \"%s\"\n", got, expected);
+            return false;
+        }
+        return true;
+    }
+
+    // Wall-clock wait for the drain thread; false after two seconds
+    bool waitForLines(uint32_t count) {
+        for (int i = 0; i < 2000 && HostEnv::logLineCount() < count; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return HostEnv::logLineCount() >= count;
+    }
+
+    bool lastLineIs(const char* expected) {
+        char line[LOGGER_MAX_MESSAGE_LEN + 32];
+        HostEnv::lastLogLine(line, sizeof(line));
+        return std::strcmp(line, expected) == 0;
+    }
+
+    void testFormatMatchesPrintf() {
+        const char* name = "sensor_task";
+        char buffer[] = "mutable";
+        int local = 0;
+        CHECK(matchesPrintf("plain"));
+        CHECK(matchesPrintf("%d %i %u %x %X %o %c %%", -42, 7, 42U, 0xBEEFU, 0xBEEFU, 8U, 'k'));
+        CHECK(matchesPrintf("%ld %lu %lld %llu %zu", -5L, 5UL, -(1LL << 40), 1ULL << 40, sizeof(local)));
+        CHECK(matchesPrintf("%.2f %8.3e %g", 21.456, 1234.5, 0.0001));
+        CHECK(matchesPrintf("[%-8s] [%8s] [%.3s]", "ab", "cd", "efghij"));
+        CHECK(matchesPrintf("%*d|%-*d", 6, 42, 4, 7));
+        CHECK(matchesPrintf("%p", static_cast<const void*>(&local)));
+        // A string argument is copied for %s, but %p prints the pointer the caller passed
+        CHECK(matchesPrintf("%s at %p", name, name));
+        CHECK(matchesPrintf("%p %s", buffer, buffer));
+        CHECK(matchesPrintf("%p", static_cast<const char*>(nullptr)));
+    }
+
+    void testStringsCopiedAtCallTime() {
+        char buffer[16] = "before";
+        DeferredLog::Record r{};
+        r.fmt = "%s/%s";
+        r.arg_count = 2;
+        DeferredLog::detail::add(r, 0, static_cast<char*>(buffer));
+        DeferredLog::detail::add(r, 1, static_cast<const char*>(nullptr));
+        std::strcpy(buffer, "after");
+        char out[64];
+        DeferredLog::format(r, out, sizeof(out));
+        CHECK(std::strcmp(out, "before/(null)") == 0);
+    }
+
+    void testIdleDrainSleeps() {
+        HostTest::isolated([] {
+            DeferredLog::start();
+            const uint32_t lines = HostEnv::logLineCount();
+            CHECK(DeferredLog::push(2, "TEST", "first %d", 1));
+            CHECK(waitForLines(lines + 1));
+
+            // Nothing logged: the drain stays blocked on its notification
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            const uint32_t idle_wakeups = HostEnv::taskWakeups();
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            CHECK_EQ(HostEnv::taskWakeups(), idle_wakeups);
+            CHECK_EQ(HostEnv::nowUs(), static_cast<int64_t>(0));
+
+            // A commit wakes it straight away
+            CHECK(DeferredLog::push(2, "TEST", "second %d", 2));
+            CHECK(waitForLines(lines + 2));
+            CHECK(lastLineIs("I (TEST) second 2"));
+            const uint32_t woken = HostEnv::taskWakeups() - idle_wakeups;
+            CHECK(woken >= 1U && woken <= 2U);
+        });
+    }
+
+    void testStalledProducerIsSkipped() {
+        HostTest::isolated([] {
+            DeferredLog::start();
+            const uint32_t lines = HostEnv::logLineCount();
+
+            // A task preempted after claim(): its slot stays uncommitted
+            DeferredLog::Record* stalled = DeferredLog::claim();
+            CHECK(stalled != nullptr);
+            CHECK(DeferredLog::push(2, "TEST", "after %d", 1));
+            CHECK(DeferredLog::push(2, "TEST", "after %d", 2));
+            // Both records behind it come out, plus the skip report
+            CHECK(waitForLines(lines + 3));
+            CHECK_EQ(DeferredLog::abandoned(), 1U);
+            CHECK(lastLineIs("I (TEST) after 2"));
+
+            // The late commit is not printed, and it frees the slot for the next lap
+            stalled->tag = "TEST";
+            stalled->fmt = "late";
+            stalled->level = 2;
+            stalled->arg_count = 0;
+            stalled->string_used = 0;
+            DeferredLog::commit(stalled);
+            uint32_t expected = HostEnv::logLineCount();
+            for (int lap = 0; lap < 4; ++lap) {
+                for (std::size_t n = 0; n < Config::Logging::ring_depth / 2; ++n) {
+                    CHECK(DeferredLog::push(2, "TEST", "lap %d record %u", lap, static_cast<unsigned>(n)));
+                }
+                expected += static_cast<uint32_t>(Config::Logging::ring_depth / 2);
+                CHECK(waitForLines(expected));
+            }
+            CHECK_EQ(DeferredLog::dropped(), 0U);
+            CHECK_EQ(DeferredLog::abandoned(), 1U);
+            char last[48];
+            std::snprintf(last, sizeof(last), "I (TEST) lap 3 record %u",
+                          static_cast<unsigned>(Config::Logging::ring_depth / 2 - 1));
+            CHECK(lastLineIs(last));
+            CHECK_EQ(HostEnv::logLineCount(), expected);
+        });
+    }
+
+    bool gateOpen(LogLevel level, const char* tag) {
+        std::atomic<uint8_t> tag_id{Logger::UNRESOLVED_TAG};
+        return Logger::enabled(level, tag, tag_id);
+    }
+
+    void testLevelsReachEspIdf() {
+        HostTest::isolated([] {
+            HostEnv::resetEspLogLevels();
+            Logger::setLevel(LogLevel::INFO);
+            CHECK(HostEnv::espLogLevel("*") == ESP_LOG_INFO);
+            CHECK(Logger::setTagLevel("CLOUD_TASK", LogLevel::DEBUG));
+            CHECK(Logger::setTagLevel("SENSOR", LogLevel::ERROR));
+            CHECK(HostEnv::espLogLevel("CLOUD_TASK") == ESP_LOG_DEBUG);
+
+            // A global change sets ESP-IDF's default and keeps both overrides there
+            Logger::setLevel(LogLevel::DEBUG);
+            CHECK(HostEnv::espLogLevel("*") == ESP_LOG_DEBUG);
+            CHECK(HostEnv::espLogLevel("CLOUD_TASK") == ESP_LOG_DEBUG);
+            CHECK(HostEnv::espLogLevel("SENSOR") == ESP_LOG_ERROR);
+            CHECK(gateOpen(LogLevel::DEBUG, "MONITOR"));
+            CHECK(!gateOpen(LogLevel::WARN, "SENSOR"));
+
+            Logger::setLevel(LogLevel::WARN);
+            CHECK(HostEnv::espLogLevel("*") == ESP_LOG_WARN);
+            CHECK(HostEnv::espLogLevel("CLOUD_TASK") == ESP_LOG_DEBUG);
+            CHECK(gateOpen(LogLevel::DEBUG, "CLOUD_TASK"));
+            CHECK(!gateOpen(LogLevel::INFO, "MONITOR"));
+
+            // Dropping an override puts the tag back on the global level in both places
+            CHECK(Logger::clearTagLevel("CLOUD_TASK"));
+            CHECK(HostEnv::espLogLevel("CLOUD_TASK") == ESP_LOG_WARN);
+            CHECK(!gateOpen(LogLevel::INFO, "CLOUD_TASK"));
+            Logger::setLevel(LogLevel::INFO);
+            CHECK(HostEnv::espLogLevel("CLOUD_TASK") == ESP_LOG_NONE); // follows "*" again
+            CHECK(HostEnv::espLogLevel("SENSOR") == ESP_LOG_ERROR);
+        });
+    }
+
+    void testCrashLogCaptureLevel() {
+        HostTest::isolated([] {
+            static const char* TAG = "TEST";
+            static const char* name = "sensor_task_main";
+            HostEnv::setLogOutput(false);
+            HostEnv::setResetReason(ESP_RST_POWERON);
+            CrashLog::init();
+            Logger::setLevel(LogLevel::DEBUG);
+            LOG_DEBUG(TAG, "debug %d", 3);
+            LOG_INFO(TAG, "info %d", 2);
+            LOG_WARN(TAG, "warn %d", 1);
+            LOG_ERROR(TAG, "error %d", 0);
+            // Five arguments: the fifth is not kept, the 64-bit one keeps its low word
+            LOG_ERROR(TAG, "%d %s %p %lld %d", -7, name, name, 5000000000LL, 9);
+            HostEnv::setLogOutput(true);
+
+            // The next boot adopts what this one captured
+            HostEnv::setResetReason(ESP_RST_TASK_WDT);
+            CrashLog::init();
+            CHECK_EQ(CrashLog::pendingCount(), Config::Logging::crash_capture_level + 2U); // one per level, + 1 ERROR
+            char text[LOGGER_MAX_MESSAGE_LEN];
+            for (std::size_t i = 0; i < CrashLog::pendingCount(); ++i) {
+                CHECK(CrashLog::pending(i).level <= Config::Logging::crash_capture_level);
+            }
+            const CrashLog::Record& last = CrashLog::pending(CrashLog::pendingCount() - 1);
+            CHECK_EQ(last.arg_count, 5);
+            CrashLog::format(last, text, sizeof(text));
+            char expected[LOGGER_MAX_MESSAGE_LEN];
+            const void* kept_pointer = reinterpret_cast<const void*>(
+                static_cast<uintptr_t>(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(name))));
+            std::snprintf(expected, sizeof(expected), "-7 sensor_task %p %lld <?>", kept_pointer,
+                          static_cast<long long>(static_cast<int32_t>(5000000000LL & 0xFFFFFFFFLL)));
+            if (std::strcmp(text, expected) != 0) {
+                std::printf("  got \"%s\", expected \"%s\"\n", text, expected);
+                CHECK(false);
+            }
+        });
+    }
+}
+
+int main() {
+    HostTest::run("format() replays printf conversions", testFormatMatchesPrintf);
+    HostTest::run("%s arguments are copied when logged", testStringsCopiedAtCallTime);
+    HostTest::run("drain sleeps while the ring is empty", testIdleDrainSleeps);
+    HostTest::run("drain skips a record its producer never commits", testStalledProducerIsSkipped);
+    HostTest::run("runtime levels reach ESP-IDF, overrides survive", testLevelsReachEspIdf);
+    HostTest::run("crash ring keeps WARN and above, within its limits", testCrashLogCaptureLevel);
+    return HostTest::finish();
+}
@@ -0,0 +1,281 @@
+// Stress test for the monitor -> cloud alert path (alert_queue, AlertRequest) and
+// the cloud -> command task path (command_queue, Command), through the firmware's
+// own send / drain / batch functions (tasks/task_channels.hpp) and the queue depths
+// of main.cpp. An MQTT command flood must not cost alerts, nothing crosses between
+// the queues, each arrives in order, and every loss is a send failure the producer saw.
+// Runs on real host threads, so it also exercises the queue and notify shims.
+#include <main/tasks/task_channels.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <test_support.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr UBaseType_t ALERT_DEPTH = 8;    // main.cpp
+    static constexpr UBaseType_t COMMAND_DEPTH = 16; // main.cpp
+    static constexpr uint32_t ALERTS = 1000;
+    static constexpr uint32_t COMMANDS = 50000;
+
+    static uint8_t s_alert_storage[ALERT_DEPTH * sizeof(AlertRequest)];
+    static StaticQueue_t s_alert_tcb;
+    static uint8_t s_command_storage[COMMAND_DEPTH * sizeof(Command)];
+    static StaticQueue_t s_command_tcb;
+    static StaticTask_t s_cloud_tcb;
+    static StaticTask_t s_command_tcb_task;
+
+    static QueueHandle_t s_alert_queue = nullptr;
+    static QueueHandle_t s_command_queue = nullptr;
+    static TaskHandle_t s_cloud_task = nullptr;
+
+    // Test bookkeeping: AlertRequest::timestamp_ms and Command::value carry a
+    // sequence number instead of the tick time / threshold
+    static Clock::time_point s_alert_sent_at[ALERTS];
+    static std::vector<double> s_alert_latency_us;
+    static std::atomic<bool> s_stop{false};
+    static std::atomic<int> s_consumers_running{0};
+    static std::atomic<uint32_t> s_alerts_received{0};
+    static std::atomic<uint32_t> s_commands_received{0};
+    static std::atomic<uint32_t> s_order_errors{0};
+    static std::atomic<uint32_t> s_cross_deliveries{0};
+    static uint32_t s_next_alert = 0;
+    static uint32_t s_next_command = 0;
+
+    void resetCounters() {
+        s_stop = false;
+        s_alerts_received = 0;
+        s_commands_received = 0;
+        s_order_errors = 0;
+        s_cross_deliveries = 0;
+        s_next_alert = 0;
+        s_next_command = 0;
+        s_alert_latency_us.clear();
+        s_alert_queue = xQueueCreateStatic(ALERT_DEPTH, sizeof(AlertRequest), s_alert_storage, &s_alert_tcb);
+        s_command_queue = xQueueCreateStatic(COMMAND_DEPTH, sizeof(Command), s_command_storage, &s_command_tcb);
+    }
+
+    // CloudCommunicationTask::notify() stand-in
+    void wakeCloud() {
+        (void)xTaskNotifyGive(s_cloud_task);
+    }
+
+    // The monitor's requestAlert() with a sequence number for a timestamp
+    bool requestAlert(uint32_t seq) {
+        AlertRequest req{};
+        req.timestamp_ms = seq;
+        req.state = (seq % 2 == 0) ? AlertState::WARNING : AlertState::OK;
+        req.reason = (seq % 2 == 0) ? AlertReason::TEMP_HIGH : AlertReason::CLEAR;
+        s_alert_sent_at[seq] = Clock::now();
+        return TaskChannels::sendAlert(s_alert_queue, req, wakeCloud);
+    }
+
+    // The MQTT handler's threshold command, cycling through the command types
+    bool enqueueCommand(uint32_t seq) {
+        const auto type = static_cast<CommandType>(static_cast<int32_t>(CommandType::UPDATE_TEMP_LOW_WARN) -
+                                                   static_cast<int32_t>(seq % 10));
+        return TaskChannels::sendCommand(s_command_queue, type, static_cast<double>(seq));
+    }
+
+    bool validAlert(const AlertRequest& req) {
+        return req.timestamp_ms < ALERTS && static_cast<uint8_t>(req.state) <= 2 && static_cast<uint8_t>(req.reason) <= 4;
+    }
+
+    // TaskChannels::AlertHandler: the cloud task's publishAlert()
+    void onAlert(const AlertRequest& alert) {
+        const auto now = Clock::now();
+        if (!validAlert(alert)) {
+            s_cross_deliveries++;
+            return;
+        }
+        if (alert.timestamp_ms < s_next_alert) {
+            s_order_errors++;
+        }
+        s_next_alert = alert.timestamp_ms + 1;
+        s_alert_latency_us.push_back(
+            std::chrono::duration<double, std::micro>(now - s_alert_sent_at[alert.timestamp_ms]).count());
+        s_alerts_received++;
+    }
+
+    // TaskChannels::CommandHandler: the command task's stageCommand(), slow per
+    // command (NVS write stand-in)
+    void onCommand(const Command& cmd, void* ctx) {
+        (void)ctx;
+        const int32_t lowest = static_cast<int32_t>(CommandType::CALIBRATE_MOISTURE_WET);
+        const uint32_t seq = static_cast<uint32_t>(cmd.value);
+        if (cmd.type >= 0 || cmd.type < lowest || cmd.value != static_cast<float>(seq) || seq >= COMMANDS) {
+            s_cross_deliveries++;
+            return;
+        }
+        if (seq < s_next_command) {
+            s_order_errors++;
+        }
+        s_next_command = seq + 1;
+        s_commands_received++;
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+
+    // Cloud task loop: woken by notification, drains the alert queue
+    void cloudTask(void*) {
+        while (!s_stop) {
+            (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            (void)TaskChannels::drainAlerts(s_alert_queue, onAlert);
+        }
+        s_consumers_running--;
+    }
+
+    // Command task loop: batch windows as in command_task.cpp
+    void commandTask(void*) {
+        while (!s_stop) {
+            (void)TaskChannels::receiveCommandBatch(s_command_queue, pdMS_TO_TICKS(10), pdMS_TO_TICKS(50),
+                                                    pdMS_TO_TICKS(5), onCommand, nullptr);
+        }
+        s_consumers_running--;
+    }
+
+    void startConsumers(bool with_cloud) {
+        if (with_cloud) {
+            s_consumers_running++;
+            s_cloud_task = xTaskCreateStatic(cloudTask, "cloud_comm", 0, nullptr, 5, nullptr, &s_cloud_tcb);
+        }
+        s_consumers_running++;
+        (void)xTaskCreateStatic(commandTask, "command", 0, nullptr, 5, nullptr, &s_command_tcb_task);
+    }
+
+    void stopConsumers() {
+        s_stop = true;
+        while (s_consumers_running != 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Wait until the consumers have taken everything that was accepted
+    void settle(uint32_t alerts, uint32_t commands) {
+        const auto deadline = Clock::now() + std::chrono::seconds(10);
+        while ((s_alerts_received < alerts || s_commands_received < commands) && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    double percentile(std::vector<double> v, double p) {
+        if (v.empty()) {
+            return 0.0;
+        }
+        std::sort(v.begin(), v.end());
+        return v[static_cast<std::size_t>(p * static_cast<double>(v.size() - 1))];
+    }
+
+    void testAlertsSurviveCommandFlood() {
+        resetCounters();
+        startConsumers(true);
+
+        std::atomic<uint32_t> commands_accepted{0};
+        std::thread mqtt([&commands_accepted] {
+            for (uint32_t i = 0; i < COMMANDS; ++i) {
+                if (enqueueCommand(i)) {
+                    commands_accepted++;
+                }
+                if (i % COMMAND_DEPTH == 0) {
+                    // Bursts of a queue's worth, so the command task keeps taking some
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            }
+        });
+        uint32_t alerts_accepted = 0;
+        uint32_t alerts_rejected = 0;
+        std::thread monitor([&] {
+            for (uint32_t i = 0; i < ALERTS; ++i) {
+                if (requestAlert(i)) {
+                    alerts_accepted++;
+                } else {
+                    alerts_rejected++;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1)); // faster than any real alert rate
+            }
+        });
+        mqtt.join();
+        monitor.join();
+        settle(alerts_accepted, commands_accepted);
+        stopConsumers();
+
+        CHECK_EQ(s_cross_deliveries.load(), 0U);
+        CHECK_EQ(s_order_errors.load(), 0U);
+        // Every loss is a send the producer saw fail (and logged)
+        CHECK_EQ(s_alerts_received.load(), alerts_accepted);
+        CHECK_EQ(alerts_accepted + alerts_rejected, ALERTS);
+        CHECK_EQ(s_commands_received.load(), commands_accepted.load());
+        // The flood overflows command_queue, but the monitor's queue has its own room
+        CHECK(commands_accepted < COMMANDS);
+        CHECK_EQ(alerts_rejected, 0U);
+
+        const double p50 = percentile(s_alert_latency_us, 0.50);
+        const double p99 = percentile(s_alert_latency_us, 0.99);
+        const double worst = percentile(s_alert_latency_us, 1.0);
+        std::printf("  alerts %u/%u delivered, latency p50 %.0f us, p99 %.0f us, max %.0f us; "
+                    "commands %u/%u accepted\n",
+                    s_alerts_received.load(), ALERTS, p50, p99, worst, commands_accepted.load(), COMMANDS);
+        // Notification wake-up, not the 10 ms fallback timeout, delivers alerts
+        CHECK(p50 < 5000.0);
+    }
+
+    void testStalledCloudDropsOnlyCountedAlerts() {
+        resetCounters();
+        startConsumers(false); // cloud task not draining (e.g. MQTT down)
+        s_cloud_task = xTaskGetCurrentTaskHandle();
+
+        uint32_t accepted = 0;
+        for (uint32_t i = 0; i < 3 * ALERT_DEPTH; ++i) {
+            if (requestAlert(i)) {
+                accepted++;
+            }
+        }
+        for (uint32_t i = 0; i < 100; ++i) {
+            (void)enqueueCommand(i);
+        }
+        CHECK_EQ(accepted, ALERT_DEPTH);
+        CHECK_EQ(uxQueueMessagesWaiting(s_alert_queue), ALERT_DEPTH);
+        stopConsumers();
+
+        // The oldest requests are the ones kept, in order
+        AlertRequest alert{};
+        for (uint32_t i = 0; i < ALERT_DEPTH; ++i) {
+            CHECK(xQueueReceive(s_alert_queue, &alert, 0) == pdTRUE);
+            CHECK_EQ(alert.timestamp_ms, i);
+        }
+        CHECK(xQueueReceive(s_alert_queue, &alert, 0) == pdFALSE);
+        CHECK_EQ(s_cross_deliveries.load(), 0U);
+        // One wake-up per accepted request is pending for the cloud task
+        CHECK_EQ(ulTaskNotifyTake(pdTRUE, 0), ALERT_DEPTH);
+    }
+
+    void testCommandBatchKeepsOrder() {
+        resetCounters();
+        for (uint32_t i = 0; i < COMMAND_DEPTH; ++i) {
+            CHECK(enqueueCommand(i));
+        }
+        CHECK(!enqueueCommand(COMMAND_DEPTH)); // full: the sender sees the drop
+        // One window takes the whole burst, in order
+        const std::size_t batch =
+            TaskChannels::receiveCommandBatch(s_command_queue, 0, pdMS_TO_TICKS(50), pdMS_TO_TICKS(5), onCommand, nullptr);
+        CHECK_EQ(batch, static_cast<std::size_t>(COMMAND_DEPTH));
+        CHECK_EQ(s_commands_received.load(), static_cast<uint32_t>(COMMAND_DEPTH));
+        CHECK_EQ(s_order_errors.load(), 0U);
+        CHECK_EQ(s_cross_deliveries.load(), 0U);
+        // Nothing queued: no batch
+        const std::size_t none =
+            TaskChannels::receiveCommandBatch(s_command_queue, 0, pdMS_TO_TICKS(50), pdMS_TO_TICKS(5), onCommand, nullptr);
+        CHECK_EQ(none, static_cast<std::size_t>(0));
+    }
+}
+
+int main() {
+    HostTest::run("alerts survive an MQTT command flood", testAlertsSurviveCommandFlood);
+    HostTest::run("stalled cloud task drops only counted alerts", testStalledCloudDropsOnlyCountedAlerts);
+    HostTest::run("command batch window keeps order", testCommandBatchKeepsOrder);
+    return HostTest::finish();
+}
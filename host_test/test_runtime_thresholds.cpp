@@ -0,0 +1,334 @@
+// Runtime thresholds (state/runtime_thresholds.cpp) on simulated NVS: what
+// writePending() reports around a deferred write, flush() racing itself from
+// several tasks without the flash falling behind what s_saved_gen claims, and how
+// blobs written by other builds survive a save (unknown fields kept, oversized or
+// unparseable blobs never overwritten). Each case is a fresh boot
+// (HostTest::isolated): init() starts the deferred writer task.
+#include <main/state/runtime_thresholds.hpp>
+#include <main/state/threshold_table.hpp>
+#include <main/storage/config_blob.hpp>
+#include <main/config/config.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+#include <atomic>
+#include <barrier>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Values = RuntimeThresholds::Values;
+
+    // Decode the stored "thresholds"/"cfg" blob; false if absent or malformed
+    bool stored(Values& out) {
+        uint8_t blob[1024];
+        std::size_t size = sizeof(blob);
+        if (!HostEnv::nvsGetBlob("thresholds", "cfg", blob, size)) {
+            return false;
+        }
+        ConfigBlob::Field fields[ThresholdTable::COUNT];
+        for (std::size_t i = 0; i < ThresholdTable::COUNT; ++i) {
+            const ThresholdTable::Entry& e = ThresholdTable::ENTRIES[i];
+            fields[i] = ConfigBlob::Field{e.blob_tag, sizeof(float), &(out.*e.field)};
+        }
+        uint16_t version = 0;
+        return ConfigBlob::decode(blob, size, fields, ThresholdTable::COUNT, version) == ConfigBlob::Status::OK;
+    }
+
+    bool same(const Values& a, const Values& b) {
+        for (const ThresholdTable::Entry& e : ThresholdTable::ENTRIES) {
+            if (a.*e.field != b.*e.field) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A blob as another build would write it: our fields with values v, plus one
+    // extra entry per tag in extra_tags holding extra_len bytes of (tag ^ i)
+    std::vector<uint8_t> foreignBlob(uint16_t version, Values v, const std::vector<uint8_t>& extra_tags,
+                                     uint8_t extra_len) {
+        static uint8_t extra[8][ConfigBlob::MAX_VALUE_BYTES];
+        std::vector<ConfigBlob::Field> fields;
+        for (const ThresholdTable::Entry& e : ThresholdTable::ENTRIES) {
+            fields.push_back(ConfigBlob::Field{e.blob_tag, sizeof(float), &(v.*e.field)});
+        }
+        for (std::size_t k = 0; k < extra_tags.size(); ++k) {
+            for (std::size_t i = 0; i < extra_len; ++i) {
+                extra[k][i] = static_cast<uint8_t>(extra_tags[k] ^ i);
+            }
+            fields.push_back(ConfigBlob::Field{extra_tags[k], extra_len, extra[k]});
+        }
+        std::vector<uint8_t> blob(ConfigBlob::encodedSize(fields.data(), fields.size()));
+        (void)ConfigBlob::encode(version, fields.data(), fields.size(), blob.data(), blob.size());
+        return blob;
+    }
+
+    std::vector<uint8_t> storedBytes() {
+        std::vector<uint8_t> blob(4096);
+        std::size_t size = blob.size();
+        if (!HostEnv::nvsGetBlob("thresholds", "cfg", blob.data(), size)) {
+            return {};
+        }
+        blob.resize(size);
+        return blob;
+    }
+
+    // True if the stored blob has an entry tag holding len bytes of (tag ^ i)
+    bool storedHasExtra(uint8_t tag, uint8_t len) {
+        uint8_t value[ConfigBlob::MAX_VALUE_BYTES] = {};
+        ConfigBlob::Field field{tag, len, value};
+        const std::vector<uint8_t> blob = storedBytes();
+        uint16_t version = 0;
+        std::size_t applied = 0;
+        if (blob.empty() || ConfigBlob::decode(blob.data(), blob.size(), &field, 1, version, &applied) !=
+                                ConfigBlob::Status::OK || applied != 1) {
+            return false;
+        }
+        for (std::size_t i = 0; i < len; ++i) {
+            if (value[i] != static_cast<uint8_t>(tag ^ i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Values defaults() {
+        using namespace Config::Monitoring;
+        return Values{temp_low_warn_c,       temp_low_crit_c,       temp_high_warn_c,       temp_high_crit_c,
+                      moisture_low_warn_pct, moisture_low_crit_pct, moisture_high_warn_pct, moisture_high_crit_pct};
+    }
+
+    void testEncodeCarriesUnknownEntries() {
+        float a = 1.0f;
+        float b = 2.0f;
+        uint8_t extra[3] = {7, 8, 9};
+        ConfigBlob::Field old_fields[] = {{1, sizeof(a), &a}, {2, sizeof(b), &b}, {40, sizeof(extra), extra}};
+        uint8_t previous[64];
+        const std::size_t previous_len = ConfigBlob::encode(3, old_fields, 3, previous, sizeof(previous));
+        CHECK(previous_len > 0);
+
+        // Rewritten by a build that knows tags 1 and 2 only
+        float a2 = 5.0f;
+        float b2 = 6.0f;
+        ConfigBlob::Field fields[] = {{1, sizeof(a2), &a2}, {2, sizeof(b2), &b2}};
+        uint8_t out[64];
+        const std::size_t len = ConfigBlob::encode(2, fields, 2, out, sizeof(out), previous, previous_len);
+        CHECK_EQ(len, previous_len);
+
+        float ra = 0.0f;
+        float rb = 0.0f;
+        uint8_t rextra[3] = {};
+        ConfigBlob::Field read[] = {{1, sizeof(ra), &ra}, {2, sizeof(rb), &rb}, {40, sizeof(rextra), rextra}};
+        uint16_t version = 0;
+        std::size_t applied = 0;
+        CHECK(ConfigBlob::decode(out, len, read, 3, version, &applied) == ConfigBlob::Status::OK);
+        CHECK_EQ(applied, 3U);
+        CHECK_EQ(version, 2);
+        CHECK_EQ(ra, 5.0f); // replaced, not duplicated
+        CHECK_EQ(rb, 6.0f);
+        CHECK(std::memcmp(rextra, extra, sizeof(extra)) == 0);
+
+        // No room for the carried entry, or a previous blob that does not decode
+        CHECK_EQ(ConfigBlob::encode(2, fields, 2, out, len - 1, previous, previous_len), 0U);
+        previous[previous_len - 1] ^= 0xFF;
+        CHECK_EQ(ConfigBlob::encode(2, fields, 2, out, sizeof(out), previous, previous_len), 0U);
+    }
+
+    void testWritePendingUntilFlushed() {
+        HostEnv::nvsErase();
+        HostTest::isolated([] {
+            RuntimeThresholds::init();
+            CHECK(!RuntimeThresholds::writePending()); // defaults saved at first boot
+            const uint32_t commits = RuntimeThresholds::flashCommits();
+
+            RuntimeThresholds::Batch batch;
+            CHECK(batch.set(&Values::temp_high_warn_c, 29.5f));
+            CHECK(batch.set(&Values::moisture_low_crit_pct, 12.0f));
+            CHECK(RuntimeThresholds::commit(batch));
+            // Applied at once, in flash only after the deferred write
+            CHECK_EQ(RuntimeThresholds::snapshot().temp_high_warn_c, 29.5f);
+            CHECK(RuntimeThresholds::writePending());
+            Values on_flash{};
+            CHECK(stored(on_flash));
+            CHECK_EQ(on_flash.temp_high_warn_c, Config::Monitoring::temp_high_warn_c);
+
+            CHECK(RuntimeThresholds::flush());
+            CHECK(!RuntimeThresholds::writePending());
+            CHECK_EQ(RuntimeThresholds::flashCommits(), commits + 1);
+            CHECK(stored(on_flash));
+            CHECK(same(on_flash, RuntimeThresholds::snapshot()));
+            // Nothing new: no second write
+            CHECK(RuntimeThresholds::flush());
+            CHECK_EQ(RuntimeThresholds::flashCommits(), commits + 1);
+
+            // A failed write leaves the change pending
+            CHECK(RuntimeThresholds::setTempLowWarn(11.0f));
+            HostEnv::nvsFailWrites(true);
+            CHECK(!RuntimeThresholds::flush());
+            CHECK(RuntimeThresholds::writePending());
+            HostEnv::nvsFailWrites(false);
+            CHECK(RuntimeThresholds::flush());
+            CHECK(!RuntimeThresholds::writePending());
+        });
+    }
+
+    void testConcurrentFlushKeepsFlashCurrent() {
+        static constexpr int THREADS = 4;
+        static constexpr int ROUNDS = 400;
+        HostEnv::nvsErase();
+        HostTest::isolated([] {
+            HostEnv::setLogOutput(false);
+            HostEnv::nvsWriteLatencyUs(200);
+            RuntimeThresholds::init();
+            const uint32_t writes_before = HostEnv::nvsWriteCount();
+            const uint32_t commits_before = RuntimeThresholds::flashCommits();
+            // Each round every task commits and flushes at once; then, with all of them
+            // parked, whatever is reported saved must be what flash holds
+            std::atomic<int> lost{0};
+            std::barrier round(THREADS);
+            std::vector<std::thread> tasks;
+            for (int t = 0; t < THREADS; ++t) {
+                tasks.emplace_back([t, &lost, &round] {
+                    for (int i = 0; i < ROUNDS; ++i) {
+                        (void)RuntimeThresholds::setTempHighWarn(20.0f + static_cast<float>(t * ROUNDS + i) / 100.0f);
+                        (void)RuntimeThresholds::flush();
+                        round.arrive_and_wait();
+                        Values on_flash{};
+                        if (t == 0 && !RuntimeThresholds::writePending() &&
+                            (!stored(on_flash) || !same(on_flash, RuntimeThresholds::snapshot()))) {
+                            lost++;
+                        }
+                        round.arrive_and_wait();
+                    }
+                });
+            }
+            for (std::thread& t : tasks) {
+                t.join();
+            }
+            CHECK_EQ(lost.load(), 0);
+            CHECK(RuntimeThresholds::flush());
+            CHECK(!RuntimeThresholds::writePending());
+            Values on_flash{};
+            CHECK(stored(on_flash));
+            CHECK(same(on_flash, RuntimeThresholds::snapshot()));
+            // Every counted commit is one NVS write, and no generation was written twice
+            CHECK_EQ(HostEnv::nvsWriteCount() - writes_before, RuntimeThresholds::flashCommits() - commits_before);
+            CHECK(RuntimeThresholds::flashCommits() - commits_before <= static_cast<uint32_t>(THREADS * ROUNDS));
+        });
+    }
+    void testSaveKeepsNewerFields() {
+        // Written by a newer build: schema v3, two fields this build does not know
+        Values v = defaults();
+        v.temp_high_warn_c = 31.0f;
+        const std::vector<uint8_t> newer = foreignBlob(3, v, {40, 41}, 16);
+        HostEnv::nvsErase();
+        HostEnv::nvsPutBlob("thresholds", "cfg", newer.data(), newer.size());
+        HostTest::isolated([] {
+            RuntimeThresholds::init();
+            CHECK_EQ(RuntimeThresholds::snapshot().temp_high_warn_c, 31.0f);
+            CHECK(RuntimeThresholds::setTempLowWarn(9.0f));
+            CHECK(RuntimeThresholds::flush());
+            Values on_flash{};
+            CHECK(stored(on_flash));
+            CHECK_EQ(on_flash.temp_low_warn_c, 9.0f);
+            CHECK_EQ(on_flash.temp_high_warn_c, 31.0f);
+            CHECK(storedHasExtra(40, 16));
+            CHECK(storedHasExtra(41, 16));
+        });
+    }
+
+    void testLargeBlobIsReadWhole() {
+        // Bigger than the old fixed 128-byte read buffer, within BLOB_MAX
+        Values v = defaults();
+        v.moisture_low_crit_pct = 17.0f;
+        const std::vector<uint8_t> big = foreignBlob(3, v, {40, 41}, 120);
+        CHECK(big.size() > 128U && big.size() <= 512U);
+        HostEnv::nvsErase();
+        HostEnv::nvsPutBlob("thresholds", "cfg", big.data(), big.size());
+        HostTest::isolated([] {
+            RuntimeThresholds::init();
+            CHECK_EQ(RuntimeThresholds::snapshot().moisture_low_crit_pct, 17.0f);
+            CHECK(RuntimeThresholds::setMoistureLowCrit(18.0f));
+            CHECK(RuntimeThresholds::flush());
+            Values on_flash{};
+            CHECK(stored(on_flash));
+            CHECK_EQ(on_flash.moisture_low_crit_pct, 18.0f);
+            CHECK(storedHasExtra(40, 120));
+            CHECK(storedHasExtra(41, 120));
+        });
+    }
+
+    // Blobs this build cannot parse: defaults in RAM, flash left exactly as it was
+    void checkNeverOverwritten(const std::vector<uint8_t>& blob) {
+        HostEnv::nvsErase();
+        HostEnv::nvsPutBlob("thresholds", "cfg", blob.data(), blob.size());
+        HostTest::isolated([&blob] {
+            HostEnv::setLogOutput(false);
+            RuntimeThresholds::init();
+            CHECK(same(RuntimeThresholds::snapshot(), defaults()));
+            CHECK(storedBytes() == blob);
+            CHECK(RuntimeThresholds::setTempHighCrit(33.0f));
+            CHECK_EQ(RuntimeThresholds::snapshot().temp_high_crit_c, 33.0f); // still applied
+            CHECK(!RuntimeThresholds::flush());
+            CHECK(RuntimeThresholds::writePending());
+            CHECK(storedBytes() == blob);
+            CHECK_EQ(RuntimeThresholds::flashCommits(), 0U);
+        });
+    }
+
+    void testUnparseableBlobIsKept() {
+        Values v = defaults();
+        std::vector<uint8_t> blob = foreignBlob(2, v, {}, 0);
+        std::vector<uint8_t> bad_crc = blob;
+        bad_crc.back() ^= 0x01;
+        checkNeverOverwritten(bad_crc);
+
+        std::vector<uint8_t> other_format = blob;
+        other_format[3] = '2'; // "CFG2"
+        checkNeverOverwritten(other_format);
+
+        checkNeverOverwritten(std::vector<uint8_t>(blob.begin(), blob.begin() + 6)); // truncated header
+
+        // Well-formed but over BLOB_MAX
+        checkNeverOverwritten(foreignBlob(3, v, {40, 41, 42}, 250));
+    }
+
+    void testFirstBootAndLegacyMigration() {
+        HostEnv::nvsErase();
+        HostTest::isolated([] {
+            RuntimeThresholds::init();
+            Values on_flash{};
+            CHECK(stored(on_flash));
+            CHECK(same(on_flash, defaults()));
+        });
+
+        Values legacy = defaults();
+        legacy.temp_low_crit_c = 4.0f;
+        HostEnv::nvsErase();
+        HostEnv::nvsPutBlob("thresholds", "data", &legacy, sizeof(legacy));
+        HostTest::isolated([] {
+            RuntimeThresholds::init();
+            CHECK_EQ(RuntimeThresholds::snapshot().temp_low_crit_c, 4.0f);
+            Values on_flash{};
+            CHECK(stored(on_flash));
+            CHECK_EQ(on_flash.temp_low_crit_c, 4.0f);
+            Values gone{};
+            std::size_t size = sizeof(gone);
+            CHECK(!HostEnv::nvsGetBlob("thresholds", "data", &gone, size));
+        });
+        HostEnv::nvsErase();
+    }
+
+}
+
+int main() {
+    HostTest::run("encode carries unknown entries through", testEncodeCarriesUnknownEntries);
+    HostTest::run("writePending() until the deferred write lands", testWritePendingUntilFlushed);
+    HostTest::run("concurrent flush() keeps flash current", testConcurrentFlushKeepsFlashCurrent);
+    HostTest::run("save keeps a newer build's fields", testSaveKeepsNewerFields);
+    HostTest::run("blob over 128 bytes is read whole", testLargeBlobIsReadWhole);
+    HostTest::run("unparseable blob is never overwritten", testUnparseableBlobIsKept);
+    HostTest::run("first boot and v1 migration", testFirstBootAndLegacyMigration);
+    return HostTest::finish();
+}
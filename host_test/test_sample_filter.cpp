@@ -0,0 +1,217 @@
+// Sample filter chain (utils/sample_filter.hpp) on replayed noise traces: ADC noise
+// around a set point, isolated spikes, a genuine step change and a slow ramp. Each
+// stage is checked against a straightforward reference, and the chain as the sensor
+// tasks configure it (Config::Tasks::Filter) against the monitor's thresholds.
+#include <main/utils/sample_filter.hpp>
+#include <main/utils/fixed_point.hpp>
+#include <main/config/config.hpp>
+#include <test_support.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+    namespace TempFilter = Config::Tasks::Filter::Temperature;
+    using TempChain = SampleFilter::Chain<TempFilter::median_window, TempFilter::ema_shift>;
+
+    static constexpr int32_t BASE = 2150;       // 21.50 degC
+    static constexpr int32_t STEP_TO = 2750;    // +6 degC, beyond max_step_centi: a real change
+    static constexpr std::size_t STEP_AT = 600;
+    static constexpr std::size_t SPIKE_EVERY = 37;
+    static constexpr std::size_t SAMPLES = 1200;
+
+    struct Trace {
+        std::vector<int32_t> truth;  // signal without noise or glitches
+        std::vector<int32_t> raw;    // what the ADC path delivers
+        std::vector<bool> spike;
+    };
+
+    // Deterministic noise: xorshift32, roughly Gaussian from a sum of four uniforms
+    struct Noise {
+        uint32_t state = 0x9E3779B9U;
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        int32_t sample(int32_t amplitude) {
+            int32_t sum = 0;
+            for (int i = 0; i < 4; ++i) {
+                sum += static_cast<int32_t>(next() % static_cast<uint32_t>(2 * amplitude + 1)) - amplitude;
+            }
+            return sum / 2;
+        }
+    };
+
+    // Set point with +-0.25 degC noise, a spike every SPIKE_EVERY samples (alternating
+    // sign, up to 20 degC), a step at STEP_AT and a 0.5 degC/100-sample ramp after it
+    Trace makeTrace() {
+        Trace t;
+        Noise noise;
+        for (std::size_t i = 0; i < SAMPLES; ++i) {
+            int32_t truth = (i < STEP_AT) ? BASE : STEP_TO + static_cast<int32_t>((i - STEP_AT) / 2);
+            const bool spike = (i % SPIKE_EVERY) == SPIKE_EVERY - 1 && i != STEP_AT;
+            int32_t raw = truth + noise.sample(25);
+            if (spike) {
+                raw += ((i / SPIKE_EVERY) % 2 == 0 ? 1 : -1) * (500 + static_cast<int32_t>(noise.next() % 1500));
+            }
+            t.truth.push_back(truth);
+            t.raw.push_back(raw);
+            t.spike.push_back(spike);
+        }
+        return t;
+    }
+
+    double rmsError(const std::vector<int32_t>& got, const std::vector<int32_t>& truth, std::size_t from,
+                    std::size_t to) {
+        double sum = 0.0;
+        for (std::size_t i = from; i < to; ++i) {
+            const double e = static_cast<double>(got[i]) - truth[i];
+            sum += e * e;
+        }
+        return std::sqrt(sum / static_cast<double>(to - from));
+    }
+
+    void testSlewGateRejectsSpikesOnly() {
+        const Trace t = makeTrace();
+        SampleFilter::SlewGate gate(TempFilter::max_step_centi, TempFilter::max_rejects);
+        std::size_t spikes = 0;
+        std::size_t rejected = 0;
+        std::size_t reseeds = 0;
+        for (std::size_t i = 0; i < SAMPLES; ++i) {
+            const SampleFilter::SlewGate::Verdict v = gate.check(t.raw[i]);
+            spikes += t.spike[i] ? 1U : 0U;
+            if (v == SampleFilter::SlewGate::Verdict::REJECT) {
+                rejected++;
+                // Only spikes and the first samples after the step are dropped
+                CHECK(t.spike[i] || (i >= STEP_AT && i < STEP_AT + TempFilter::max_rejects));
+            } else {
+                CHECK(!t.spike[i]);
+            }
+            if (v == SampleFilter::SlewGate::Verdict::RESEED) {
+                reseeds++;
+                CHECK_EQ(i, STEP_AT + TempFilter::max_rejects); // the step is taken as real
+            }
+        }
+        CHECK_EQ(rejected, spikes + TempFilter::max_rejects);
+        CHECK_EQ(reseeds, 1U);
+
+        SampleFilter::SlewGate off(0, TempFilter::max_rejects);
+        for (std::size_t i = 0; i < SAMPLES; ++i) {
+            CHECK(off.check(t.raw[i]) == SampleFilter::SlewGate::Verdict::ACCEPT);
+        }
+    }
+
+    template <std::size_t N>
+    void checkMedianAgainstSort(const std::vector<int32_t>& input) {
+        SampleFilter::RollingMedian<N> median;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            const std::size_t first = (i + 1 >= N) ? i + 1 - N : 0;
+            std::vector<int32_t> window(input.begin() + static_cast<long>(first), input.begin() + static_cast<long>(i + 1));
+            std::sort(window.begin(), window.end());
+            CHECK_EQ(median.push(input[i]), window[window.size() / 2]);
+        }
+    }
+
+    void testMedianMatchesReference() {
+        const Trace t = makeTrace();
+        checkMedianAgainstSort<1>(t.raw);
+        checkMedianAgainstSort<3>(t.raw);
+        checkMedianAgainstSort<5>(t.raw);
+        checkMedianAgainstSort<15>(t.raw);
+
+        // Isolated spikes never reach the output of a 5-sample median
+        SampleFilter::RollingMedian<5> median;
+        for (std::size_t i = 0; i < STEP_AT; ++i) {
+            CHECK(std::abs(median.push(t.raw[i]) - BASE) <= 100);
+        }
+    }
+
+    template <unsigned SHIFT>
+    void checkEmaAgainstDouble(const std::vector<int32_t>& input) {
+        SampleFilter::Ema<SHIFT> ema;
+        double ref = input[0];
+        int32_t worst = 0;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            if (i > 0) {
+                ref += (input[i] - ref) / static_cast<double>(1U << SHIFT);
+            }
+            const int32_t got = ema.push(input[i]);
+            worst = std::max(worst, static_cast<int32_t>(std::lround(std::fabs(got - ref))));
+        }
+        CHECK(worst <= 1);
+    }
+
+    void testEmaMatchesReference() {
+        const Trace t = makeTrace();
+        checkEmaAgainstDouble<0>(t.raw);
+        checkEmaAgainstDouble<2>(t.raw);
+        checkEmaAgainstDouble<4>(t.raw);
+        std::vector<int32_t> negative(t.raw);
+        for (int32_t& v : negative) {
+            v -= 4000; // below zero
+        }
+        checkEmaAgainstDouble<2>(negative);
+
+        // A constant input comes back exactly, with no rounding drift
+        SampleFilter::Ema<4> ema;
+        for (int i = 0; i < 1000; ++i) {
+            CHECK_EQ(ema.push(-531), -531);
+        }
+    }
+
+    void testChainOnTrace() {
+        const Trace t = makeTrace();
+        TempChain chain(TempFilter::max_step_centi, TempFilter::max_rejects);
+        std::vector<int32_t> out(SAMPLES, 0);
+        int32_t last = 0;
+        int32_t peak_before_step = INT32_MIN;
+        for (std::size_t i = 0; i < SAMPLES; ++i) {
+            int32_t y = 0;
+            if (chain.push(t.raw[i], y)) {
+                last = y;
+            }
+            out[i] = last; // the monitor keeps the last published value
+            if (i < STEP_AT) {
+                peak_before_step = std::max(peak_before_step, last);
+            }
+        }
+        // A glitch alone never gets near the warning threshold
+        CHECK(peak_before_step < FixedPoint::toCenti(Config::Monitoring::temp_high_warn_c));
+        // Noise is attenuated well below the raw trace's
+        const double raw_rms = rmsError(t.raw, t.truth, 20, STEP_AT);
+        const double out_rms = rmsError(out, t.truth, 20, STEP_AT);
+        std::printf("  steady rms: raw %.1f, filtered %.1f centi-degC\n", raw_rms, out_rms);
+        CHECK(out_rms < raw_rms / 2.0);
+        // The real step comes through within a few samples of being accepted
+        const std::size_t settle = STEP_AT + TempFilter::max_rejects + TempFilter::median_window;
+        CHECK(std::abs(out[settle] - t.truth[settle]) <= 50);
+        CHECK(rmsError(out, t.truth, settle, SAMPLES) < 40.0);
+
+        const SampleFilter::Stats& stats = chain.getStats();
+        CHECK_EQ(stats.reseeds, 1U);
+        CHECK_EQ(stats.accepted + stats.rejected, static_cast<uint32_t>(SAMPLES));
+    }
+
+    void testChainReset() {
+        TempChain chain(TempFilter::max_step_centi, TempFilter::max_rejects);
+        int32_t y = 0;
+        for (int i = 0; i < 10; ++i) {
+            (void)chain.push(BASE, y);
+        }
+        chain.reset();
+        // After reset (e.g. recalibration) the first sample is taken as is
+        CHECK(chain.push(BASE + 2000, y));
+        CHECK_EQ(y, BASE + 2000);
+    }
+}
+
+int main() {
+    HostTest::run("slew gate drops spikes, keeps a real step", testSlewGateRejectsSpikesOnly);
+    HostTest::run("rolling median matches a sorted window", testMedianMatchesReference);
+    HostTest::run("EMA tracks the double-precision average", testEmaMatchesReference);
+    HostTest::run("temperature chain on a noisy trace", testChainOnTrace);
+    HostTest::run("chain reset reseeds from the next sample", testChainReset);
+    return HostTest::finish();
+}
@@ -0,0 +1,108 @@
+// Round trip for Node_Red_Json/telemetry_decoder.js: binary frames written by the
+// firmware encoder (gen_codec_fixtures) must decode to the same payload the JSON path
+// sends for the same samples. Values may differ by the 0.1-unit binary quantization;
+// keys, timestamps and counts must match exactly. Binary batches carry no flush time,
+// so the JSON batch's "ts" is the one key not compared.
+//   node test_telemetry_decoder.js <fixtures.jsonl> [--bench [--quick]]
+// --bench also times decoding against JSON.parse of the equivalent JSON payload.
+"use strict";
+
+const fs = require("fs");
+const path = require("path");
+
+const DECODER = path.join(__dirname, "..", "Node_Red_Json", "telemetry_decoder.js");
+const QUANTUM = 0.05 + 1e-9; // half a deci-unit
+
+const decoderBody = fs.readFileSync(DECODER, "utf8");
+const warnings = [];
+const node = { warn: function (text) { warnings.push(text); } };
+const decode = new Function("msg", "node", decoderBody);
+
+const args = process.argv.slice(2);
+const fixtures = fs.readFileSync(args[0], "utf8").trim().split("\n").map(function (line) {
+    return JSON.parse(line);
+});
+
+let failures = 0;
+function fail(name, text) {
+    console.log("  FAIL " + name + ": " + text);
+    failures++;
+}
+
+function same(name, key, got, want) {
+    if (typeof want === "number") {
+        if (typeof got !== "number" || Math.abs(got - want) > QUANTUM) {
+            fail(name, key + ": got " + got + ", expected " + want);
+        }
+    } else if (Array.isArray(want)) {
+        if (!Array.isArray(got) || got.length !== want.length) {
+            fail(name, key + ": got " + JSON.stringify(got) + ", expected " + JSON.stringify(want));
+            return;
+        }
+        for (let i = 0; i < want.length; i++) {
+            same(name, key + "[" + i + "]", got[i], want[i]);
+        }
+    } else if (got !== want) {
+        fail(name, key + ": got " + JSON.stringify(got) + ", expected " + JSON.stringify(want));
+    }
+}
+
+function decodeFixture(f) {
+    return decode({ topic: f.topic, payload: Buffer.from(f.frame, "hex") }, node);
+}
+
+fixtures.forEach(function (f, index) {
+    const name = "fixture " + index + " (" + f.topic.split("/").slice(2).join("/") + ")";
+    const before = failures;
+    const msg = decodeFixture(f);
+    if (msg === null) {
+        fail(name, "decoder rejected the frame: " + warnings.join("; "));
+    } else {
+        const batch = /\/backlog$/.test(f.topic);
+        const want = Object.keys(f.json).filter(function (k) { return !(batch && k === "ts"); }).sort();
+        const got = Object.keys(msg.payload).sort();
+        same(name, "keys", got.join(","), want.join(","));
+        want.forEach(function (k) { same(name, k, msg.payload[k], f.json[k]); });
+    }
+    // JSON payloads pass through the decoder unchanged
+    const passthrough = decode({ topic: f.topic, payload: Buffer.from(JSON.stringify(f.json)) }, node);
+    same(name, "json passthrough", JSON.stringify(passthrough.payload), JSON.stringify(f.json));
+    console.log((failures === before ? "PASS " : "FAIL ") + name);
+});
+
+// A corrupt frame is dropped with a warning, not passed on
+if (decode({ topic: "t", payload: Buffer.from([0x02, 0x00, 0x01, 0x00]) }, node) !== null || warnings.length !== 1) {
+    fail("bad version", "expected null and one warning");
+}
+
+if (args.includes("--bench")) {
+    const iterations = args.includes("--quick") ? 200 : 200000;
+    fixtures.forEach(function (f) {
+        const frame = Buffer.from(f.frame, "hex");
+        const text = JSON.stringify(f.json);
+        const jsonBuffer = Buffer.from(text);
+        let sink = 0;
+        let start = process.hrtime.bigint();
+        for (let i = 0; i < iterations; i++) {
+            sink += decode({ topic: f.topic, payload: frame }, node).payload ? 1 : 0;
+        }
+        const binNs = Number(process.hrtime.bigint() - start) / iterations;
+        start = process.hrtime.bigint();
+        for (let i = 0; i < iterations; i++) {
+            sink += decode({ topic: f.topic, payload: jsonBuffer }, node).payload ? 1 : 0;
+        }
+        const jsonNs = Number(process.hrtime.bigint() - start) / iterations;
+        const n = f.json.n || 1;
+        console.log(f.topic.split("/").slice(2).join("/").padEnd(20) + " n=" + String(n).padStart(2) +
+                    "  binary " + String(frame.length).padStart(4) + " B " + binNs.toFixed(0).padStart(6) + " ns" +
+                    "  json " + String(text.length).padStart(4) + " B " + jsonNs.toFixed(0).padStart(6) + " ns");
+        if (sink !== 2 * iterations) {
+            fail("bench", "decoder dropped a payload");
+        }
+    });
+}
+
+if (failures !== 0) {
+    console.log(failures + " check(s) failed");
+    process.exit(1);
+}
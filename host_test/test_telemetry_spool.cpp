@@ -0,0 +1,224 @@
+// Flash spool (storage/telemetry_spool.cpp) on a simulated partition: replay order
+// and timestamps, resets mid-replay, torn writes and ring overrun. Each
+// HostTest::isolated() call is one boot; the partition contents carry over.
+#include <main/storage/telemetry_spool.hpp>
+#include <main/config/config.hpp>
+#include <host_env.hpp>
+#include <test_support.hpp>
+
+namespace {
+    static constexpr const char* LABEL = Config::Tasks::Spool::partition_label;
+    static constexpr std::size_t SEGMENTS = 8;
+    static constexpr uint32_t SLOTS_PER_SEGMENT = (4096 - 32) / 32;
+
+    // Drain the spool the way the cloud task does; returns the records replayed
+    std::size_t drain(TelemetrySpool::Record* out, std::size_t max, std::size_t limit = SIZE_MAX) {
+        TelemetrySpool::Record run[Config::Tasks::Backlog::batch_size];
+        std::size_t total = 0;
+        while (TelemetrySpool::pendingCount() > 0 && total < limit) {
+            std::size_t want = Config::Tasks::Backlog::batch_size;
+            if (limit - total < want) {
+                want = limit - total;
+            }
+            const std::size_t n = TelemetrySpool::peekRun(run, want);
+            for (std::size_t i = 0; i < n && total + i < max; ++i) {
+                out[total + i] = run[i];
+            }
+            TelemetrySpool::consume(n);
+            total += n;
+        }
+        return total;
+    }
+
+    void freshPartition() {
+        HostEnv::createPartition(LABEL, SEGMENTS * 4096);
+        HostEnv::setClockSynced(true);
+    }
+
+    void testReplaysInOrderAcrossReset() {
+        freshPartition();
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            for (uint32_t i = 0; i < 300; ++i) {
+                CHECK(TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 2000 + static_cast<int32_t>(i), i * 5000U));
+            }
+        });
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            CHECK_EQ(TelemetrySpool::pendingCount(), 300U);
+            static TelemetrySpool::Record out[300];
+            CHECK_EQ(drain(out, 300), 300U);
+            for (uint32_t i = 0; i < 300; ++i) {
+                CHECK_EQ(out[i].value_centi, 2000 + static_cast<int32_t>(i));
+                CHECK(out[i].has_epoch);
+                CHECK_EQ(out[i].time_ms, HostEnv::SYNC_EPOCH_MS + i * 5000ULL);
+            }
+            const TelemetrySpool::Stats stats = TelemetrySpool::getStats();
+            CHECK_EQ(stats.replayed, 300U);
+            CHECK_EQ(stats.corrupt, 0U);
+            CHECK_EQ(stats.dropped, 0U);
+        });
+        // Fully replayed: nothing comes back on the next boot
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            CHECK_EQ(TelemetrySpool::pendingCount(), 0U);
+        });
+    }
+
+    void testResetMidReplayResendsAtMostOneSegment() {
+        freshPartition();
+        static constexpr uint32_t TOTAL = 3 * SLOTS_PER_SEGMENT;
+        static constexpr uint32_t REPLAYED = SLOTS_PER_SEGMENT + 40; // reset part-way into segment 2
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            for (uint32_t i = 0; i < TOTAL; ++i) {
+                (void)TelemetrySpool::append(TelemetrySpool::Kind::MOISTURE, static_cast<int32_t>(i), i);
+            }
+            static TelemetrySpool::Record out[TOTAL];
+            CHECK_EQ(drain(out, TOTAL, REPLAYED), REPLAYED);
+        });
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            // Segment 1 was marked drained; segment 2's progress was only in RAM
+            CHECK_EQ(TelemetrySpool::pendingCount(), TOTAL - SLOTS_PER_SEGMENT);
+            static TelemetrySpool::Record out[TOTAL];
+            const std::size_t n = drain(out, TOTAL);
+            CHECK_EQ(n, TOTAL - SLOTS_PER_SEGMENT);
+            CHECK_EQ(out[0].value_centi, static_cast<int32_t>(SLOTS_PER_SEGMENT)); // same record, re-sent
+            CHECK_EQ(out[n - 1].value_centi, static_cast<int32_t>(TOTAL - 1));
+        });
+    }
+
+    void testTornWriteCountedAsCorrupt() {
+        freshPartition();
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            for (uint32_t i = 0; i < 10; ++i) {
+                CHECK(TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, static_cast<int32_t>(i), i));
+            }
+            // Power cut 12 bytes into the next record
+            HostEnv::failWriteAfter(LABEL, 12);
+            CHECK(!TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 99, 99));
+        });
+        HostEnv::clearFaults(LABEL);
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            CHECK_EQ(TelemetrySpool::pendingCount(), 11U); // the torn slot is not erased
+            for (uint32_t i = 10; i < 15; ++i) {
+                CHECK(TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, static_cast<int32_t>(i), i));
+            }
+            TelemetrySpool::Record out[32];
+            const std::size_t n = drain(out, 32);
+            CHECK_EQ(n, 15U);
+            for (std::size_t i = 0; i < n; ++i) {
+                CHECK_EQ(out[i].value_centi, static_cast<int32_t>(i));
+            }
+            const TelemetrySpool::Stats stats = TelemetrySpool::getStats();
+            CHECK_EQ(stats.replayed, 15U);
+            CHECK_EQ(stats.corrupt, 1U);
+        });
+    }
+
+    void testBitFlipSkippedNotReplayed() {
+        freshPartition();
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            for (uint32_t i = 0; i < 20; ++i) {
+                CHECK(TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, static_cast<int32_t>(i), i));
+            }
+        });
+        // Clear one bit in the value of record 5 (segment 0, after the 32-byte header)
+        HostEnv::partitionData(LABEL)[32 + 5 * 32 + 8] &= 0xFE;
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            TelemetrySpool::Record out[32];
+            CHECK_EQ(drain(out, 32), 19U);
+            CHECK_EQ(out[4].value_centi, 4);
+            CHECK_EQ(out[5].value_centi, 6);
+            const TelemetrySpool::Stats stats = TelemetrySpool::getStats();
+            CHECK_EQ(stats.replayed, 19U);
+            CHECK_EQ(stats.corrupt, 1U);
+            CHECK_EQ(TelemetrySpool::pendingCount(), 0U);
+        });
+    }
+
+    void testOverrunDropsOldestSegment() {
+        freshPartition();
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            const uint32_t total = (SEGMENTS + 2) * SLOTS_PER_SEGMENT;
+            for (uint32_t i = 0; i < total; ++i) {
+                (void)TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, static_cast<int32_t>(i), i);
+            }
+            const TelemetrySpool::Stats stats = TelemetrySpool::getStats();
+            CHECK_EQ(stats.dropped + TelemetrySpool::pendingCount(), total);
+            CHECK(TelemetrySpool::pendingCount() <= SEGMENTS * SLOTS_PER_SEGMENT);
+            // Oldest records went first: the survivors are the newest, in order
+            static TelemetrySpool::Record out[SEGMENTS * SLOTS_PER_SEGMENT];
+            const std::size_t n = drain(out, SEGMENTS * SLOTS_PER_SEGMENT);
+            CHECK_EQ(out[0].value_centi, static_cast<int32_t>(stats.dropped));
+            CHECK_EQ(out[n - 1].value_centi, static_cast<int32_t>(total - 1));
+        });
+    }
+
+    void testRunsSplitOnKindAndTimeBase() {
+        freshPartition();
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            HostEnv::setClockSynced(false);
+            (void)TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 1, 10);
+            (void)TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 2, 20);
+            (void)TelemetrySpool::append(TelemetrySpool::Kind::MOISTURE, 3, 30);
+            HostEnv::setClockSynced(true);
+            (void)TelemetrySpool::append(TelemetrySpool::Kind::MOISTURE, 4, 40);
+
+            TelemetrySpool::Record run[8];
+            // Same boot: the unsynced records are mapped once the clock is valid
+            CHECK_EQ(TelemetrySpool::peekRun(run, 8), 2U);
+            CHECK(run[0].has_epoch);
+            CHECK_EQ(run[1].time_ms, HostEnv::SYNC_EPOCH_MS + 20U);
+            TelemetrySpool::consume(2);
+            CHECK_EQ(TelemetrySpool::peekRun(run, 8), 2U);
+            CHECK(run[0].kind == TelemetrySpool::Kind::MOISTURE);
+        });
+        // Next boot: records from the old boot without an epoch can no longer be mapped
+        freshPartition();
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            HostEnv::setClockSynced(false);
+            (void)TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 1, 10);
+            HostEnv::setClockSynced(true);
+            (void)TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 2, 20);
+        });
+        HostTest::isolated([] {
+            CHECK(TelemetrySpool::init());
+            TelemetrySpool::Record run[8];
+            CHECK_EQ(TelemetrySpool::peekRun(run, 8), 1U);
+            CHECK(!run[0].has_epoch);
+            TelemetrySpool::consume(1);
+            CHECK_EQ(TelemetrySpool::peekRun(run, 8), 1U);
+            CHECK(run[0].has_epoch);
+        });
+    }
+
+    void testMissingPartitionDisablesSpool() {
+        HostEnv::removePartition(LABEL);
+        HostTest::isolated([] {
+            CHECK(!TelemetrySpool::init());
+            CHECK(!TelemetrySpool::isReady());
+            CHECK(!TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, 1, 1));
+        });
+    }
+}
+
+int main() {
+    HostEnv::setLogOutput(false);
+    HostTest::run("replays in order across a reset", testReplaysInOrderAcrossReset);
+    HostTest::run("reset mid-replay re-sends at most one segment", testResetMidReplayResendsAtMostOneSegment);
+    HostTest::run("torn write is counted as corrupt, not replayed", testTornWriteCountedAsCorrupt);
+    HostTest::run("bit flip is skipped, not replayed", testBitFlipSkippedNotReplayed);
+    HostTest::run("overrun drops the oldest segment", testOverrunDropsOldestSegment);
+    HostTest::run("runs split on kind and time base", testRunsSplitOnKindAndTimeBase);
+    HostTest::run("missing partition disables the spool", testMissingPartitionDisablesSpool);
+    return HostTest::finish();
+}
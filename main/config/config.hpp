@@ -1,6 +1,7 @@
 #ifndef CONFIG_HPP
 #define CONFIG_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <main/secrets.hpp>
 #include <driver/gpio.h>
@@ -37,6 +38,8 @@ namespace Temperature {
     // Gain (°C per mV) and additional °C offset after scaling.
     // Defaults: 0.1 °C/mV (LM35/TMP36), 0.0 °C offset.
     static constexpr float gain_c_per_mv = 0.1f;
+    // ADC1 full scale at ADC_ATTEN_DB_0 (~1.1 V on ESP32)
+    static constexpr uint32_t adc_full_scale_mv = 1100;
 }
 
 // I2C 16x2 RGB LCD defaults (DFRobot Gravity DFR0464 class)
@@ -52,6 +55,8 @@ namespace Lcd {
     static constexpr uint8_t backlight_r = 128;
     static constexpr uint8_t backlight_g = 128;
     static constexpr uint8_t backlight_b = 128;
+    // Readings line redraw period (taken from the sample bus, newest values only)
+    static constexpr uint32_t refresh_ms = 1000;
 }
 
 namespace Moisture {
@@ -64,6 +69,19 @@ namespace Moisture {
     static constexpr uint16_t raw_dry = 0;
     static constexpr uint16_t raw_wet = 2700;
 }
+
+// ADC1 acquisition (hardware/adc_engine.hpp)
+namespace Adc {
+    // Sample both sensor channels with adc_continuous + DMA instead of oneshot reads.
+    // Not used in low-power/deep-sleep modes (a running DMA keeps the APB clock up).
+    static constexpr bool continuous = true;
+    // Total conversion rate across all channels (ESP32 minimum is 20 kHz)
+    static constexpr uint32_t sample_freq_hz = 20000;
+    // Conversions per DMA frame; each published frame averages these per channel
+    static constexpr uint32_t frame_samples = 1024;
+    // Readers treat older frames as a stalled engine
+    static constexpr uint32_t max_frame_age_ms = 500;
+}
 }
 
 namespace Monitoring {
@@ -94,17 +112,75 @@ namespace Monitoring {
 }
 
 namespace Tasks {
+// Sensor channel timing (hardware/sensor_registry.cpp); phase_ms offsets each
+// channel's deadlines so the scheduler never reads two probes back to back
 namespace Temperature {
     static constexpr uint32_t period_ms = 1000;
+    static constexpr uint32_t phase_ms = 0;
 }
 namespace Moisture {
     static constexpr uint32_t period_ms = 1000;
+    static constexpr uint32_t phase_ms = 500;
+}
+// Sensor-task filter chains (utils/sample_filter.hpp), in centi-units per sample.
+// The median window sets how many consecutive bad samples are masked; the EMA shift
+// adds roughly 2^shift samples of lag; max_step should exceed any real change
+// between two samples at the task period.
+namespace Filter {
+namespace Temperature {
+    static constexpr std::size_t median_window = 5;
+    static constexpr unsigned ema_shift = 2;
+    static constexpr int32_t max_step_centi = 300;   // 3 degC per sample
+    static constexpr uint8_t max_rejects = 3;        // then accept the jump as real
+}
+namespace Moisture {
+    static constexpr std::size_t median_window = 5;
+    static constexpr unsigned ema_shift = 2;
+    static constexpr int32_t max_step_centi = 1500;  // 15 % per sample
+    static constexpr uint8_t max_rejects = 3;
+}
 }
 namespace Cloud {
     static constexpr uint32_t status_period_ms = 5000;
     static constexpr uint32_t reconnect_interval_ms = 30000;
     // Telemetry throttling period (publish latest values at most this often)
     static constexpr uint32_t telemetry_period_ms = 5000;
+    // Window for the loop wakeup / alert latency log line
+    static constexpr uint32_t stats_window_ms = 60000;
+}
+// Per-task CPU share, stack headroom and heap minimums (utils/task_stats.hpp),
+// sampled by the cloud task and published to Topics::METRICS
+namespace Metrics {
+    static constexpr uint32_t period_ms = 60000;
+    // Sample array size; must cover every task in the system (IDF's own included)
+    static constexpr std::size_t max_tasks = 32;
+    // Log a warning for tasks whose stack high-water mark leaves less than this
+    static constexpr uint32_t stack_warn_bytes = 512;
+}
+namespace Backlog {
+    // Offline samples packed per MQTT message when flushing after reconnect
+    static constexpr uint32_t batch_size = 32;
+    // Pace the flush on esp-mqtt outbox depth: hold off while it holds more than this
+    static constexpr int max_outbox_bytes = 2048;
+    // Recheck interval while waiting for the outbox to drain
+    static constexpr uint32_t pacing_poll_ms = 10;
+    // Batches sent per cloud loop pass; the rest resumes on the next pass, so a long
+    // backlog cannot hold off live telemetry, alerts and commands
+    static constexpr uint32_t batches_per_pass = 4;
+}
+// Deferred NVS writer for runtime thresholds (state/runtime_thresholds.cpp).
+// Updates apply at once; flash is written when commits stop arriving for
+// coalesce_ms, and never later than max_defer_ms after the first pending one.
+namespace ThresholdPersist {
+    static constexpr uint32_t coalesce_ms = 2000;
+    static constexpr uint32_t max_defer_ms = 10000;
+}
+namespace Spool {
+    // Data partition holding the flash telemetry spool (see partitions.csv)
+    static constexpr const char* partition_label = "spool";
+    // Spill the RAM backlog rings to flash once this many samples are buffered, so
+    // flash is written in runs; a reset loses at most this many unspilled samples
+    static constexpr uint32_t spill_threshold = 32;
 }
 }
 
@@ -112,10 +188,94 @@ namespace Cloud {
 namespace Features {
     // Toggle tasks/subsystems on or off for focused testing
     static constexpr bool enable_cloud_comm      = true;
-    static constexpr bool enable_temperature_task = true; // disabled for moisture-only testing
+    static constexpr bool enable_temperature_task = true; // registry channel; disabled for moisture-only testing
     static constexpr bool enable_moisture_task    = true;
     static constexpr bool enable_alarm_task       = true;
     static constexpr bool enable_lcd_task         = true; // off by default until wired on hardware
+
+    // Swap ADC/I2C/LEDC/WiFi/MQTT drivers for simulated back ends so the full
+    // task graph runs without sensors or a network (e.g. `idf.py qemu monitor`)
+    static constexpr bool simulate_hardware       = false;
+    // Run the pipeline benchmark driver (sweeps sensor periods, logs latency percentiles)
+    static constexpr bool pipeline_benchmark      = false;
+    // Battery operation: periodic work snaps to Power::wake_period_ms slots, the chip
+    // light-sleeps between them and WiFi stays in modem sleep (see utils/power_manager.hpp)
+    static constexpr bool low_power_mode          = false;
+    // Remote probe: sample from deep sleep into RTC memory, upload every few wakes
+    // (utils/deep_sleep_cycle.hpp). Replaces the task graph entirely when set.
+    static constexpr bool deep_sleep_mode         = false;
+    // Median/EMA/slew filtering in the sensor tasks (Tasks::Filter); off = raw readings
+    static constexpr bool sample_filter           = true;
+    // Hot-path tracepoints from sensor read to MQTT publish (utils/trace.hpp), exported
+    // to Mqtt::Topics::TRACE for tools/trace_report.py
+    static constexpr bool latency_trace           = false;
+}
+
+// Deferred logging (utils/deferred_log.hpp): LOG_WARN/INFO/DEBUG callers enqueue
+// format + raw arguments and a LOW-priority drain task formats and prints them
+namespace Logging {
+    static constexpr bool deferred = true;
+    // Records in the ring (power of two, ~190 bytes each); overflow is dropped and counted
+    static constexpr std::size_t ring_depth = 32;
+    // A record claimed but not committed for this long (its task preempted or
+    // suspended mid-call) is skipped and counted, so it cannot stall the drain
+    static constexpr uint32_t commit_timeout_ms = 200;
+    // Last records kept across panics / watchdog resets (utils/crash_log.hpp; power of
+    // two, 48 bytes each) and uploaded to Topics::CRASH_LOG after the next connect
+    static constexpr std::size_t crash_ring_depth = 32;
+    // Most verbose LogLevel value captured into that ring (0 ERROR, 1 WARN, 2 INFO,
+    // 3 DEBUG). Calls above it skip the capture entirely, timestamp included.
+    static constexpr uint8_t crash_capture_level = 1;
+}
+
+// Latency tracepoints (only used when Features::latency_trace is set)
+namespace Trace {
+    // Records per core (power of two, 12 bytes each); the oldest are overwritten
+    static constexpr std::size_t ring_depth = 256;
+    // Longest gap between SYNC records on a core; keep well below the cycle counter
+    // wrap (2^32 cycles, ~17 s at 240 MHz)
+    static constexpr uint32_t sync_period_ms = 1000;
+    // Cloud task publishes new records this often while connected
+    static constexpr uint32_t export_period_ms = 10000;
+}
+
+// Low-power mode tuning (only used when Features::low_power_mode is set)
+namespace Power {
+    // Common wake grid: sensor sampling, monitor pass and telemetry all land on
+    // multiples of this, so the chip wakes once per slot instead of once per task.
+    // Keep below the 8 s task watchdog timeout.
+    static constexpr uint32_t wake_period_ms = 5000;
+    // DFS range for esp_pm; light sleep is entered whenever all tasks are blocked
+    static constexpr int max_cpu_freq_mhz = 160;
+    static constexpr int min_cpu_freq_mhz = 40;
+    // Beacon intervals between WiFi wakes in modem sleep (WIFI_PS_MAX_MODEM)
+    static constexpr uint16_t wifi_listen_interval = 10;
+    // Awake-time / wakeup-rate report window (run-time counters wrap after ~71 min)
+    static constexpr uint32_t report_period_ms = 600000;
+}
+
+// Deep-sleep duty cycle (only used when Features::deep_sleep_mode is set)
+namespace DeepSleep {
+    // Timer wakeup period between samples
+    static constexpr uint32_t wake_period_s = 300;
+    // Connect and bulk-publish every N wakes (sooner on a threshold crossing)
+    static constexpr uint32_t publish_every_n_wakes = 12;
+    // Samples held in RTC slow memory (16 bytes each); oldest dropped when full
+    static constexpr uint32_t ring_capacity = 96;
+    // Budget for WiFi IP + MQTT connect on an upload wake before giving up
+    static constexpr uint32_t link_timeout_ms = 15000;
+    // Wait for QoS 1 acks (empty outbox) before sleeping
+    static constexpr uint32_t drain_timeout_ms = 5000;
+}
+
+// Pipeline benchmark driver (only used when Features::pipeline_benchmark is set)
+namespace Bench {
+    // Sensor periods swept from slowest to fastest; values below one tick are clamped
+    static constexpr uint32_t sample_periods_ms[] = { 1000, 500, 200, 100, 50, 20, 10 };
+    // Time spent at each step before stats are reported and reset
+    static constexpr uint32_t step_duration_ms = 10000;
+    // Histogram resolution is 1 ms; latencies at or above this land in the overflow bucket
+    static constexpr uint32_t histogram_max_ms = 512;
 }
 
 // Task priority levels (higher number = higher priority, can preempt lower)
@@ -128,6 +288,9 @@ namespace TaskPriorities {
 
     // Non-critical: UI feedback and network I/O can tolerate latency
     static constexpr UBaseType_t NORMAL   = tskIDLE_PRIORITY + 1;
+
+    // Background housekeeping: deferred log output runs only when nothing else wants the CPU
+    static constexpr UBaseType_t LOW      = tskIDLE_PRIORITY;
 }
 
 namespace Mqtt {
@@ -145,14 +308,35 @@ namespace Mqtt {
     static constexpr bool lwt_enable = true;
     static constexpr const char* lwt_prefix = "thermometer";
 
+    // Payload encoding, selectable per topic. BINARY sends TelemetryCodec frames
+    // (utils/telemetry_codec.hpp); decode them with Node_Red_Json/telemetry_decoder.js.
+    enum class PayloadFormat : uint8_t {
+        JSON,
+        BINARY
+    };
+    namespace Encoding {
+        static constexpr PayloadFormat temperature = PayloadFormat::JSON;
+        static constexpr PayloadFormat moisture = PayloadFormat::JSON;
+        static constexpr PayloadFormat backlog = PayloadFormat::JSON; // both backlog topics and spool replay
+    }
+
     // MQTT Topic Templates (use with device ID via snprintf)
     namespace Topics {
         static constexpr const char* TEMPERATURE = "thermometer/%s/temperature";
         static constexpr const char* MOISTURE = "thermometer/%s/moisture";
         static constexpr const char* ALERT = "thermometer/%s/alert";
         static constexpr const char* STATUS = "thermometer/%s/status";
+        // Per-task runtime / stack / heap metrics (TaskStats), not retained
+        static constexpr const char* METRICS = "thermometer/%s/status/metrics";
         static constexpr const char* CMD = "thermometer/%s/cmd";
         static constexpr const char* THRESHOLDS_ACK = "thermometer/%s/thresholds-changed";
+        // Batched offline backlog (JSON arrays, see Config::Tasks::Backlog)
+        static constexpr const char* TEMPERATURE_BACKLOG = "thermometer/%s/temperature/backlog";
+        static constexpr const char* MOISTURE_BACKLOG = "thermometer/%s/moisture/backlog";
+        // Log lines preceding the last watchdog / panic reset (CrashLog)
+        static constexpr const char* CRASH_LOG = "thermometer/%s/crashlog";
+        // Raw latency trace records (Trace, tools/trace_report.py)
+        static constexpr const char* TRACE = "thermometer/%s/trace";
     }
 }
 }
@@ -0,0 +1,73 @@
+#include <main/hardware/adc_calibration.hpp>
+#include <main/utils/logger.hpp>
+#include <main/config/config.hpp>
+#include <esp_adc/adc_cali.h>
+#include <esp_adc/adc_cali_scheme.h>
+#include <sdkconfig.h>
+
+static const char* TAG = "ADC_CALI";
+
+AdcMillivoltTable::AdcMillivoltTable() : table{}, valid(false) {}
+
+bool AdcMillivoltTable::init(adc_unit_t unit, adc_channel_t channel, adc_atten_t atten) {
+    valid = false;
+    if (Config::Features::simulate_hardware) {
+        return false;
+    }
+
+    adc_cali_handle_t handle = nullptr;
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+    const char* scheme = "none";
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t curve_cfg = {};
+    curve_cfg.unit_id = unit;
+    curve_cfg.chan = channel;
+    curve_cfg.atten = atten;
+    curve_cfg.bitwidth = ADC_BITWIDTH_12;
+    err = adc_cali_create_scheme_curve_fitting(&curve_cfg, &handle);
+    scheme = "curve";
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t line_cfg = {};
+    line_cfg.unit_id = unit;
+    line_cfg.atten = atten;
+    line_cfg.bitwidth = ADC_BITWIDTH_12;
+#if CONFIG_IDF_TARGET_ESP32
+    line_cfg.default_vref = 1100; // used when neither eFuse Vref nor Two Point is burnt
+#endif
+    err = adc_cali_create_scheme_line_fitting(&line_cfg, &handle);
+    scheme = "line";
+#else
+    (void)unit;
+    (void)channel;
+    (void)atten;
+#endif
+    if (err != ESP_OK || handle == nullptr) {
+        LOG_WARN(TAG, "No ADC calibration scheme (%d); using nominal full scale", static_cast<int>(err));
+        return false;
+    }
+
+    bool ok = true;
+    for (uint32_t i = 0; i < ENTRIES && ok; ++i) {
+        uint32_t raw = i << STEP_SHIFT;
+        if (raw > RAW_MAX) {
+            raw = RAW_MAX;
+        }
+        int mv = 0;
+        ok = adc_cali_raw_to_voltage(handle, static_cast<int>(raw), &mv) == ESP_OK && mv >= 0;
+        table[i] = static_cast<uint16_t>(mv);
+    }
+    // The table is all that is kept; the scheme handle is not needed per sample
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    (void)adc_cali_delete_scheme_curve_fitting(handle);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    (void)adc_cali_delete_scheme_line_fitting(handle);
+#endif
+    if (!ok) {
+        LOG_WARN(TAG, "%s", "ADC calibration table build failed; using nominal full scale");
+        return false;
+    }
+    valid = true;
+    LOG_INFO(TAG, "ADC%d_CH%d %s-fitting table: 0..%u mV", static_cast<int>(unit) + 1, static_cast<int>(channel),
+             scheme, static_cast<unsigned>(table[ENTRIES - 1U]));
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef ADC_CALIBRATION_HPP
+#define ADC_CALIBRATION_HPP
+
+#include <cstdint>
+#include <hal/adc_types.h>
+
+// Raw -> mV for one ADC channel/attenuation using the chip's adc_cali scheme
+// (curve fitting where supported, otherwise line fitting from eFuse Vref/Two Point).
+// The scheme is evaluated once at init into a 257-entry table (every 16 raw counts);
+// a lookup is one table read and a linear interpolation, so O(1) with no driver
+// call per sample. ready() is false when no scheme is available (e.g. simulation);
+// callers then fall back to the nominal full-scale conversion.
+class AdcMillivoltTable {
+public:
+    static constexpr uint32_t RAW_MAX = 4095;
+    static constexpr uint32_t STEP_SHIFT = 4;
+    static constexpr uint32_t ENTRIES = ((RAW_MAX + 1U) >> STEP_SHIFT) + 1U;
+
+    AdcMillivoltTable();
+
+    bool init(adc_unit_t unit, adc_channel_t channel, adc_atten_t atten);
+
+    bool ready() const { return valid; }
+
+    uint32_t toMillivolts(uint32_t raw) const {
+        if (raw > RAW_MAX) {
+            raw = RAW_MAX;
+        }
+        const uint32_t idx = raw >> STEP_SHIFT;
+        const uint32_t frac = raw & ((1U << STEP_SHIFT) - 1U);
+        const int32_t lo = table[idx];
+        const int32_t hi = table[idx + 1U];
+        return static_cast<uint32_t>(lo + (((hi - lo) * static_cast<int32_t>(frac) + (1 << (STEP_SHIFT - 1))) >> STEP_SHIFT));
+    }
+
+private:
+    uint16_t table[ENTRIES];
+    bool valid;
+};
+
+#endif // ADC_CALIBRATION_HPP
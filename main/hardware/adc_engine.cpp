@@ -0,0 +1,287 @@
+#include <main/hardware/adc_engine.hpp>
+#include <main/utils/logger.hpp>
+#include <main/sim/sim_backends.hpp>
+#include <esp_adc/adc_continuous.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <cstring>
+
+namespace {
+    static const char* TAG = "ADC_ENGINE";
+
+    // ESP32 / ESP32-S2 DMA results are TYPE1 (12-bit data, 4-bit channel)
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+    static constexpr adc_digi_output_format_t OUTPUT_FORMAT = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    static inline uint32_t resultChannel(const adc_digi_output_data_t* p) { return p->type1.channel; }
+    static inline uint32_t resultData(const adc_digi_output_data_t* p) { return p->type1.data; }
+#else
+    static constexpr adc_digi_output_format_t OUTPUT_FORMAT = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    static inline uint32_t resultChannel(const adc_digi_output_data_t* p) { return p->type2.channel; }
+    static inline uint32_t resultData(const adc_digi_output_data_t* p) { return p->type2.data; }
+#endif
+
+    static constexpr uint32_t FRAME_BYTES = Config::Hardware::Adc::frame_samples * SOC_ADC_DIGI_RESULT_BYTES;
+
+    static StaticTask_t s_task_tcb;
+    static StackType_t s_task_stack[3072 / sizeof(StackType_t)];
+    static TaskHandle_t s_task_handle = nullptr;
+
+    // Setup state: only touched by attach() under s_setup_mutex. The engine task
+    // also holds it around adc_continuous_read() so a rebuild never frees the handle
+    // under a read.
+    static StaticSemaphore_t s_setup_mutex_buffer;
+    static SemaphoreHandle_t s_setup_mutex = nullptr;
+    static portMUX_TYPE s_setup_mux = portMUX_INITIALIZER_UNLOCKED;
+    static adc_continuous_handle_t s_handle = nullptr;
+    static adc_digi_pattern_config_t s_pattern[AdcEngine::MAX_CHANNELS] = {};
+    static int s_channel_count = 0;
+    // channel -> slot lookup for the parser (-1 = not attached)
+    static std::atomic<int8_t> s_slot_of_channel[16];
+
+    // Engine task private DMA copy buffer
+    static uint8_t s_raw[FRAME_BYTES];
+
+    // Double buffer: the writer fills the slot not currently published, bumping its
+    // sequence to odd while writing and back to even when done
+    static AdcEngine::Frame s_frames[2];
+    static std::atomic<uint32_t> s_frame_seq[2];
+    static std::atomic<uint32_t> s_published{0};
+    static std::atomic<uint32_t> s_frame_count{0};
+    static std::atomic<uint32_t> s_overflows{0};
+
+    static bool IRAM_ATTR onConvDone(adc_continuous_handle_t, const adc_continuous_evt_data_t*, void*) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(s_task_handle, &woken);
+        return woken == pdTRUE;
+    }
+
+    static bool IRAM_ATTR onPoolOverflow(adc_continuous_handle_t, const adc_continuous_evt_data_t*, void*) {
+        s_overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Fake driver for simulate_hardware: one frame of TYPE1/TYPE2 results cycling
+    // through the attached channels, paced at the configured conversion rate
+    static uint32_t fakeRead(uint8_t* out, uint32_t size) {
+        const int channels = s_channel_count;
+        const uint32_t frame_ms = (Config::Hardware::Adc::frame_samples * 1000U) / Config::Hardware::Adc::sample_freq_hz;
+        vTaskDelay(pdMS_TO_TICKS(frame_ms > 0 ? frame_ms : 1));
+        if (channels == 0) {
+            return 0;
+        }
+        uint32_t n = size / SOC_ADC_DIGI_RESULT_BYTES;
+        for (uint32_t i = 0; i < n; ++i) {
+            adc_channel_t ch = static_cast<adc_channel_t>(s_pattern[i % channels].channel);
+            adc_digi_output_data_t r{};
+            if (OUTPUT_FORMAT == ADC_DIGI_OUTPUT_FORMAT_TYPE1) {
+                r.type1.channel = ch;
+                r.type1.data = static_cast<uint16_t>(SimBackends::adcRead(ch));
+            } else {
+                r.type2.channel = ch;
+                r.type2.data = static_cast<uint32_t>(SimBackends::adcRead(ch));
+            }
+            std::memcpy(out + i * SOC_ADC_DIGI_RESULT_BYTES, &r, SOC_ADC_DIGI_RESULT_BYTES);
+        }
+        return n * SOC_ADC_DIGI_RESULT_BYTES;
+    }
+
+    // Reduce one DMA frame to per-slot means and publish it
+    static void publishFrame(const uint8_t* raw, uint32_t len) {
+        uint32_t sum[AdcEngine::MAX_CHANNELS] = {};
+        uint16_t count[AdcEngine::MAX_CHANNELS] = {};
+        for (uint32_t off = 0; off + SOC_ADC_DIGI_RESULT_BYTES <= len; off += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t r{};
+            std::memcpy(&r, raw + off, SOC_ADC_DIGI_RESULT_BYTES);
+            uint32_t ch = resultChannel(&r);
+            int slot = (ch < 16U) ? s_slot_of_channel[ch].load(std::memory_order_relaxed) : -1;
+            if (slot < 0) {
+                continue;
+            }
+            sum[slot] += resultData(&r);
+            count[slot]++;
+        }
+
+        const uint32_t target = s_published.load(std::memory_order_relaxed) ^ 1U;
+        const uint32_t seq = s_frame_seq[target].load(std::memory_order_relaxed);
+        s_frame_seq[target].store(seq + 1U, std::memory_order_relaxed); // odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        AdcEngine::Frame& f = s_frames[target];
+        f.seq = s_frame_count.load(std::memory_order_relaxed) + 1U;
+        f.ts_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+        for (int i = 0; i < AdcEngine::MAX_CHANNELS; ++i) {
+            f.samples[i] = count[i];
+            f.mean_raw[i] = (count[i] > 0) ? static_cast<uint16_t>(sum[i] / count[i]) : 0;
+        }
+        s_frame_seq[target].store(seq + 2U, std::memory_order_release); // even: stable
+        s_published.store(target, std::memory_order_release);
+        s_frame_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void taskFunction(void* arg) {
+        (void)arg;
+        LOG_INFO(TAG, "%s", "ADC engine task started");
+        for (;;) {
+            uint32_t got = 0;
+            if (Config::Features::simulate_hardware) {
+                got = fakeRead(s_raw, sizeof(s_raw));
+            } else {
+                // One take clears every pending conv-done notification, so drain all
+                // completed frames and keep the newest; otherwise each wake would read
+                // an older frame and the engine would run behind the DMA
+                (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                xSemaphoreTake(s_setup_mutex, portMAX_DELAY);
+                if (s_handle != nullptr) {
+                    uint32_t len = 0;
+                    while (adc_continuous_read(s_handle, s_raw, sizeof(s_raw), &len, 0) == ESP_OK) {
+                        got = len;
+                    }
+                }
+                xSemaphoreGive(s_setup_mutex);
+            }
+            if (got > 0) {
+                publishFrame(s_raw, got);
+            }
+        }
+    }
+
+    // Build the driver for the current scan pattern. A running handle is never
+    // reconfigured: attaching a channel later tears it down and creates a fresh one
+    // with the full pattern, so adc_continuous_config() only ever sees a new handle.
+    static bool rebuildDriver() {
+        if (Config::Features::simulate_hardware) {
+            return true;
+        }
+        if (s_handle != nullptr) {
+            (void)adc_continuous_stop(s_handle);
+            (void)adc_continuous_deinit(s_handle);
+            s_handle = nullptr;
+        }
+        adc_continuous_handle_t handle = nullptr;
+        adc_continuous_handle_cfg_t handle_cfg = {};
+        handle_cfg.max_store_buf_size = FRAME_BYTES * 4U;
+        handle_cfg.conv_frame_size = FRAME_BYTES;
+        if (adc_continuous_new_handle(&handle_cfg, &handle) != ESP_OK) {
+            return false;
+        }
+        adc_continuous_evt_cbs_t cbs = {};
+        cbs.on_conv_done = onConvDone;
+        cbs.on_pool_ovf = onPoolOverflow;
+        adc_continuous_config_t dig_cfg = {};
+        dig_cfg.pattern_num = static_cast<uint32_t>(s_channel_count);
+        dig_cfg.adc_pattern = s_pattern;
+        dig_cfg.sample_freq_hz = Config::Hardware::Adc::sample_freq_hz;
+        dig_cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+        dig_cfg.format = OUTPUT_FORMAT;
+        if (adc_continuous_register_event_callbacks(handle, &cbs, nullptr) != ESP_OK ||
+            adc_continuous_config(handle, &dig_cfg) != ESP_OK ||
+            adc_continuous_start(handle) != ESP_OK) {
+            (void)adc_continuous_deinit(handle);
+            return false;
+        }
+        s_handle = handle;
+        return true;
+    }
+}
+
+namespace AdcEngine {
+    int attach(adc_channel_t channel, adc_atten_t atten) {
+        // First caller creates the setup mutex (sensor tasks may init concurrently)
+        taskENTER_CRITICAL(&s_setup_mux);
+        if (s_setup_mutex == nullptr) {
+            s_setup_mutex = xSemaphoreCreateMutexStatic(&s_setup_mutex_buffer);
+            for (auto& slot : s_slot_of_channel) {
+                slot.store(-1, std::memory_order_relaxed);
+            }
+        }
+        taskEXIT_CRITICAL(&s_setup_mux);
+
+        if (static_cast<uint32_t>(channel) >= 16U) {
+            return -1;
+        }
+        xSemaphoreTake(s_setup_mutex, portMAX_DELAY);
+        // The task must exist before the first adc_continuous_start(): the first
+        // conv-done interrupt may fire before rebuildDriver() returns and notifies
+        // s_task_handle. Until then the task just waits on that notification.
+        if (s_task_handle == nullptr) {
+            s_task_handle = xTaskCreateStatic(taskFunction, "adc_engine",
+                                              sizeof(s_task_stack) / sizeof(StackType_t), nullptr,
+                                              Config::TaskPriorities::HIGH, s_task_stack, &s_task_tcb);
+        }
+        int slot = s_slot_of_channel[channel].load(std::memory_order_relaxed);
+        if (slot < 0) {
+            if (s_channel_count == MAX_CHANNELS) {
+                xSemaphoreGive(s_setup_mutex);
+                LOG_ERROR(TAG, "No free slot for ADC1_CH%d", static_cast<int>(channel));
+                return -1;
+            }
+            slot = s_channel_count;
+            adc_digi_pattern_config_t& p = s_pattern[slot];
+            p.atten = static_cast<uint8_t>(atten);
+            p.channel = static_cast<uint8_t>(channel);
+            p.unit = static_cast<uint8_t>(ADC_UNIT_1);
+            p.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+            s_channel_count++;
+            s_slot_of_channel[channel].store(static_cast<int8_t>(slot), std::memory_order_relaxed);
+            if (!rebuildDriver()) {
+                LOG_ERROR(TAG, "adc_continuous setup failed for ADC1_CH%d", static_cast<int>(channel));
+                s_channel_count--;
+                s_slot_of_channel[channel].store(-1, std::memory_order_relaxed);
+                // Bring the channels attached so far back up
+                if (s_channel_count > 0 && !rebuildDriver()) {
+                    LOG_ERROR(TAG, "%s", "adc_continuous restart failed; engine stopped");
+                }
+                xSemaphoreGive(s_setup_mutex);
+                return -1;
+            }
+            LOG_INFO(TAG, "ADC1_CH%d on slot %d (%d channel(s), %u Hz)", static_cast<int>(channel), slot,
+                     s_channel_count, static_cast<unsigned>(Config::Hardware::Adc::sample_freq_hz));
+        }
+        xSemaphoreGive(s_setup_mutex);
+        return slot;
+    }
+
+    bool latest(Frame& out) {
+        for (;;) {
+            const uint32_t idx = s_published.load(std::memory_order_acquire);
+            const uint32_t before = s_frame_seq[idx].load(std::memory_order_acquire);
+            if (before == 0U) {
+                return false; // nothing published yet
+            }
+            if ((before & 1U) != 0U) {
+                continue; // writer lapped us and is refilling this slot
+            }
+            out = s_frames[idx];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s_frame_seq[idx].load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+    }
+
+    bool readMean(int slot, uint16_t& out_raw) {
+        if (slot < 0 || slot >= MAX_CHANNELS) {
+            return false;
+        }
+        Frame f{};
+        if (!latest(f) || f.samples[slot] == 0) {
+            return false;
+        }
+        uint32_t now_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+        if ((now_ms - f.ts_ms) > Config::Hardware::Adc::max_frame_age_ms) {
+            return false;
+        }
+        out_raw = f.mean_raw[slot];
+        return true;
+    }
+
+    Stats getStats() {
+        Stats stats{};
+        stats.frames = s_frame_count.load(std::memory_order_relaxed);
+        stats.overflows = s_overflows.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
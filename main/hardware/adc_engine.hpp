@@ -0,0 +1,50 @@
+// Continuous-mode ADC1 acquisition shared by the LM35 and soil moisture sensors.
+// adc_continuous samples every attached channel by DMA at Config::Hardware::Adc::
+// sample_freq_hz; an engine task reduces each completed DMA frame to a per-channel
+// mean and publishes it into a double buffer. Readers copy the latest frame with a
+// per-slot sequence check (seqlock), so neither side takes a mutex or blocks.
+// In simulate_hardware mode a fake driver fills frames from SimBackends::adcRead()
+// in the same DMA result format, so the parse/publish path runs without hardware.
+#ifndef ADC_ENGINE_HPP
+#define ADC_ENGINE_HPP
+
+#include <cstdint>
+#include <hal/adc_types.h>
+#include <main/config/config.hpp>
+
+namespace AdcEngine {
+    static constexpr int MAX_CHANNELS = 4;
+
+    struct Frame {
+        uint32_t seq;                     // frames published since start
+        uint32_t ts_ms;                   // esp_timer ms when the frame completed
+        uint16_t mean_raw[MAX_CHANNELS];  // per attached slot, 12-bit
+        uint16_t samples[MAX_CHANNELS];   // conversions averaged into mean_raw (0 = none)
+    };
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t overflows;               // DMA pool overruns (engine task too slow)
+    };
+
+    constexpr bool enabled() {
+        return Config::Hardware::Adc::continuous && !Config::Features::low_power_mode &&
+               !Config::Features::deep_sleep_mode;
+    }
+
+    // Add an ADC1 channel to the scan pattern and (re)start the engine; a new
+    // channel replaces the running driver handle with one for the full pattern.
+    // Returns the slot index used in Frame, or -1 on failure. Attaching the same
+    // channel again returns its existing slot. Init-time only (serialized internally).
+    int attach(adc_channel_t channel, adc_atten_t atten);
+
+    // Copy the most recent complete frame; false if none has been published yet
+    bool latest(Frame& out);
+
+    // Mean raw value for a slot from a frame no older than max_frame_age_ms
+    bool readMean(int slot, uint16_t& out_raw);
+
+    Stats getStats();
+}
+
+#endif // ADC_ENGINE_HPP
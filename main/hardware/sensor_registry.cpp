@@ -0,0 +1,142 @@
+#include <main/hardware/sensor_registry.hpp>
+#include <main/hardware/temperature_sensor.hpp>
+#include <main/hardware/soil_moisture_sensor.hpp>
+#include <main/models/moisture_data.hpp>
+#include <main/config/config.hpp>
+#include <main/state/runtime_thresholds.hpp>
+#include <main/state/calibration.hpp>
+#include <main/utils/sample_filter.hpp>
+#include <main/utils/fixed_point.hpp>
+
+namespace {
+    // Channel 0: LM35 temperature
+    static TemperatureSensor s_temperature; // default GPIO per header
+    static SampleFilter::Chain<Config::Tasks::Filter::Temperature::median_window,
+                               Config::Tasks::Filter::Temperature::ema_shift>
+        s_temperature_filter{Config::Tasks::Filter::Temperature::max_step_centi,
+                             Config::Tasks::Filter::Temperature::max_rejects};
+
+    static bool temperatureInit() {
+        return s_temperature.init();
+    }
+
+    static bool temperatureRead(SensorRegistry::Reading& out) {
+        int16_t temp_centi_c = 0;
+        if (!s_temperature.readTemperature(temp_centi_c)) {
+            return false;
+        }
+        out.value_centi = temp_centi_c;
+        out.raw = 0;
+        return true;
+    }
+
+    static SensorRegistry::FilterResult temperatureFilter(int32_t value, int32_t& out) {
+        return s_temperature_filter.push(value, out) ? SensorRegistry::FilterResult::PUBLISH
+                                                     : SensorRegistry::FilterResult::DROPPED;
+    }
+
+    static void temperatureReset() {
+        s_temperature_filter.reset();
+    }
+
+    static SensorRegistry::Thresholds temperatureThresholds(const RuntimeThresholds::Values& v) {
+        return SensorRegistry::Thresholds{
+            FixedPoint::toCenti(v.temp_low_crit_c),
+            FixedPoint::toCenti(v.temp_low_warn_c),
+            FixedPoint::toCenti(v.temp_high_warn_c),
+            FixedPoint::toCenti(v.temp_high_crit_c),
+        };
+    }
+
+    // Channel 1: capacitive soil moisture probe
+    static SoilMoistureSensor s_moisture{ SoilMoistureSensor::Config{
+        Config::Hardware::Moisture::unit,
+        Config::Hardware::Moisture::channel,
+        Config::Hardware::Moisture::attenuation,
+        Config::Hardware::Moisture::sample_count,
+        Config::Hardware::Moisture::raw_dry,
+        Config::Hardware::Moisture::raw_wet
+    }};
+    static SampleFilter::Chain<Config::Tasks::Filter::Moisture::median_window,
+                               Config::Tasks::Filter::Moisture::ema_shift>
+        s_moisture_filter{Config::Tasks::Filter::Moisture::max_step_centi,
+                          Config::Tasks::Filter::Moisture::max_rejects};
+    static uint32_t s_moisture_calibration_gen = 0;
+
+    static bool moistureInit() {
+        return s_moisture.init();
+    }
+
+    static bool moistureRead(SensorRegistry::Reading& out) {
+        // Pick up endpoints changed by the MQTT "calibrate" command
+        const uint32_t gen = Calibration::generation();
+        if (gen != s_moisture_calibration_gen) {
+            s_moisture_calibration_gen = gen;
+            const Calibration::Moisture cal = Calibration::getMoisture();
+            s_moisture.setCalibration(cal.raw_dry, cal.raw_wet);
+            s_moisture_filter.reset();
+        }
+        MoistureData sample{};
+        if (!s_moisture.read(sample)) {
+            return false;
+        }
+        // Unfiltered, so a "calibrate" capture sees the probe's actual reading
+        Calibration::noteMoistureRaw(sample.moisture_raw);
+        out.value_centi = sample.moisture_centi_pct;
+        out.raw = sample.moisture_raw;
+        return true;
+    }
+
+    static SensorRegistry::FilterResult moistureFilter(int32_t value, int32_t& out) {
+        return s_moisture_filter.push(value, out) ? SensorRegistry::FilterResult::PUBLISH
+                                                  : SensorRegistry::FilterResult::DROPPED;
+    }
+
+    static void moistureReset() {
+        s_moisture_filter.reset();
+    }
+
+    static SensorRegistry::Thresholds moistureThresholds(const RuntimeThresholds::Values& v) {
+        return SensorRegistry::Thresholds{
+            FixedPoint::toCenti(v.moisture_low_crit_pct),
+            FixedPoint::toCenti(v.moisture_low_warn_pct),
+            FixedPoint::toCenti(v.moisture_high_warn_pct),
+            FixedPoint::toCenti(v.moisture_high_crit_pct),
+        };
+    }
+
+    static constexpr SensorRegistry::Descriptor CHANNELS[] = {
+        {
+            "temperature", "C", SensorKind::TEMPERATURE,
+            Config::Features::enable_temperature_task,
+            Config::Tasks::Temperature::period_ms, Config::Tasks::Temperature::phase_ms,
+            AlertReason::TEMP_LOW, AlertReason::TEMP_HIGH,
+            temperatureInit, temperatureRead, temperatureFilter, temperatureReset, temperatureThresholds,
+        },
+        {
+            "moisture", "%", SensorKind::MOISTURE,
+            Config::Features::enable_moisture_task,
+            Config::Tasks::Moisture::period_ms, Config::Tasks::Moisture::phase_ms,
+            AlertReason::MOISTURE_LOW, AlertReason::MOISTURE_HIGH,
+            moistureInit, moistureRead, moistureFilter, moistureReset, moistureThresholds,
+        },
+    };
+    static_assert(sizeof(CHANNELS) / sizeof(CHANNELS[0]) == SensorRegistry::CHANNEL_COUNT,
+                  "CHANNEL_COUNT must match the descriptor table");
+    static_assert(SensorRegistry::CHANNEL_COUNT <= UINT8_MAX, "channel index must fit SensorSample::channel");
+}
+
+namespace SensorRegistry {
+    const Descriptor& get(std::size_t channel) {
+        return CHANNELS[channel < CHANNEL_COUNT ? channel : 0];
+    }
+
+    int primary(SensorKind kind) {
+        for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+            if (CHANNELS[i].enabled && CHANNELS[i].kind == kind) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+}
@@ -0,0 +1,57 @@
+// Compile-time table of sensor channels sampled by SensorSchedulerTask.
+// Each descriptor binds a probe's driver (init/read), its sample filter, timing and
+// alarm thresholds, so the scheduler and monitor handle any number of probes with
+// one task and one sample stream. Adding a probe means adding a driver instance and
+// a descriptor in sensor_registry.cpp and bumping CHANNEL_COUNT.
+#ifndef SENSOR_REGISTRY_HPP
+#define SENSOR_REGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <main/models/sensor_sample.hpp>
+#include <main/models/alert_request.hpp>
+#include <main/state/runtime_thresholds.hpp>
+
+namespace SensorRegistry {
+    static constexpr std::size_t CHANNEL_COUNT = 2;
+
+    // Alarm thresholds in the channel's centi-units
+    struct Thresholds {
+        int32_t low_crit;
+        int32_t low_warn;
+        int32_t high_warn;
+        int32_t high_crit;
+    };
+
+    struct Reading {
+        int32_t  value_centi;
+        uint16_t raw;
+    };
+
+    // Outcome of running a reading through the channel's filter chain
+    enum class FilterResult : uint8_t { PUBLISH, DROPPED };
+
+    struct Descriptor {
+        const char* name;           // log / topic label, e.g. "temperature"
+        const char* unit;           // display unit, e.g. "C"
+        SensorKind  kind;
+        bool        enabled;        // build-time toggle (Config::Features)
+        uint32_t    period_ms;      // sampling period
+        uint32_t    phase_ms;       // offset of the first sample, staggers channels
+        AlertReason reason_low;     // raised on a low threshold crossing
+        AlertReason reason_high;    // raised on a high threshold crossing
+
+        bool (*init)();                                       // may be retried
+        bool (*read)(Reading& out);                           // unfiltered reading
+        FilterResult (*filter)(int32_t value, int32_t& out);  // per-channel filter state
+        void (*reset)();                                      // restart the filter
+        Thresholds (*thresholds)(const RuntimeThresholds::Values& v); // this channel's share of a snapshot
+    };
+
+    const Descriptor& get(std::size_t channel);
+
+    // First enabled channel of a kind (LCD / cloud summary value), -1 when none
+    int primary(SensorKind kind);
+}
+
+#endif // SENSOR_REGISTRY_HPP
@@ -1,11 +1,30 @@
 #include <main/hardware/soil_moisture_sensor.hpp>
 #include <main/hardware/adc_shared.hpp>
-#include <algorithm>
+#include <main/hardware/adc_engine.hpp>
+#include <main/sim/sim_backends.hpp>
+#include <main/config/config.hpp>
 
 SoilMoistureSensor::SoilMoistureSensor(const Config& cfg_in)
-    : cfg(cfg_in), adc_handle(nullptr) {}
+    : cfg(cfg_in), scale(cfg_in.raw_dry, cfg_in.raw_wet), adc_handle(nullptr), engine_slot(-1), simulated(false) {}
+
+// The default endpoints get the same Q16 kernel; pin it to the float formula it replaced
+static_assert(FixedPoint::maxErrorCenti<FixedPoint::MoistureKernel<::Config::Hardware::Moisture::raw_dry,
+                                                                   ::Config::Hardware::Moisture::raw_wet>>(4095) <= 1,
+              "moisture kernel drifts from the float conversion by more than 0.01 %");
 
 bool SoilMoistureSensor::init() {
+    if (cfg.sample_count == 0) {
+        cfg.sample_count = 1;
+    }
+    if (AdcEngine::enabled() && cfg.unit == ADC_UNIT_1) {
+        engine_slot = AdcEngine::attach(cfg.channel, cfg.attenuation);
+        return engine_slot >= 0;
+    }
+    // Global ::Config (not the nested sensor Config struct)
+    if (::Config::Features::simulate_hardware) {
+        simulated = true;
+        return true;
+    }
     // Use shared ADC1 handle if using ADC_UNIT_1, otherwise create new handle
     if (cfg.unit == ADC_UNIT_1) {
         adc_handle = AdcShared::getAdc1Handle();
@@ -27,26 +46,37 @@ bool SoilMoistureSensor::init() {
     if (adc_oneshot_config_channel(adc_handle, cfg.channel, &chan_cfg) != ESP_OK) {
         return false;
     }
-    if (cfg.sample_count == 0) {
-        cfg.sample_count = 1;
-    }
     return true;
 }
 
 void SoilMoistureSensor::setCalibration(uint16_t raw_dry, uint16_t raw_wet) {
     cfg.raw_dry = raw_dry;
     cfg.raw_wet = raw_wet;
+    scale = FixedPoint::MoistureScale(raw_dry, raw_wet);
 }
 
 bool SoilMoistureSensor::read(MoistureData& out_data) {
-    if (!adc_handle) {
+    if (engine_slot >= 0) {
+        // Latest DMA frame mean (already averaged over the whole frame)
+        uint16_t raw = 0;
+        if (!AdcEngine::readMean(engine_slot, raw)) {
+            return false;
+        }
+        out_data.moisture_raw = raw;
+        out_data.moisture_centi_pct = static_cast<uint16_t>(scale.toCenti(raw));
+        out_data.ts_ms = 0;
+        return true;
+    }
+    if (!adc_handle && !simulated) {
         return false;
     }
     uint32_t sum = 0;
     AdcShared::lock();
     for (uint8_t i = 0; i < cfg.sample_count; ++i) {
         int raw = 0;
-        if (adc_oneshot_read(adc_handle, cfg.channel, &raw) != ESP_OK) {
+        if (simulated) {
+            raw = SimBackends::adcRead(cfg.channel);
+        } else if (adc_oneshot_read(adc_handle, cfg.channel, &raw) != ESP_OK) {
             AdcShared::unlock();
             return false;
         }
@@ -55,31 +85,8 @@ bool SoilMoistureSensor::read(MoistureData& out_data) {
     AdcShared::unlock();
     uint16_t avg = static_cast<uint16_t>(sum / cfg.sample_count);
     out_data.moisture_raw = avg;
-    out_data.moisture_percent = convertToPercent(avg);
+    out_data.moisture_centi_pct = static_cast<uint16_t>(scale.toCenti(avg));
     // Timestamp should be supplied by caller; set 0 here
     out_data.ts_ms = 0;
     return true;
 }
-
-float SoilMoistureSensor::convertToPercent(int raw) const {
-    // Map raw to 0..100 using calibration endpoints.
-    // Many capacitive sensors report LOWER raw when wet. We handle both orders.
-    const int dry = static_cast<int>(cfg.raw_dry);
-    const int wet = static_cast<int>(cfg.raw_wet);
-    if (dry == wet) {
-        return 0.0f;
-    }
-    float percent = 0.0f;
-    if (dry > wet) {
-        // lower raw = wetter
-        percent = 100.0f * (static_cast<float>(dry - raw) / static_cast<float>(dry - wet));
-    } else {
-        // higher raw = wetter
-        percent = 100.0f * (static_cast<float>(raw - dry) / static_cast<float>(wet - dry));
-    }
-    if (percent < 0.0f) percent = 0.0f;
-    if (percent > 100.0f) percent = 100.0f;
-    return percent;
-}
-
-
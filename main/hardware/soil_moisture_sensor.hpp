@@ -5,10 +5,12 @@
 #include <hal/adc_types.h>
 #include <esp_adc/adc_oneshot.h>
 #include <main/models/moisture_data.hpp>
+#include <main/utils/fixed_point.hpp>
 
-// DFRobot soil moisture (analog) sensor reader using ADC one-shot mode.
+// DFRobot soil moisture (analog) sensor reader. ADC1 channels are read from the
+// continuous AdcEngine when it is enabled, otherwise in one-shot mode.
 // Reads multiple samples, averages to get 'moisture_raw', and converts to
-// percentage using user-provided calibration endpoints (dry/wet).
+// centi-percent using user-provided calibration endpoints (dry/wet) in integer math.
 class SoilMoistureSensor {
 public:
     struct Config {
@@ -33,10 +35,11 @@ public:
     bool read(MoistureData& out_data);
 
 private:
-    float convertToPercent(int raw) const;
-
     Config cfg;
+    FixedPoint::MoistureScale scale; // Q16 factor, recomputed only on calibration change
     adc_oneshot_unit_handle_t adc_handle;
+    int engine_slot; // AdcEngine slot, -1 when using oneshot reads
+    bool simulated; // SimBackends ADC in place of adc_oneshot
 };
 
 #endif // SOIL_MOISTURE_SENSOR_HPP
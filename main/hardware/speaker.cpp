@@ -1,11 +1,16 @@
 #include <main/hardware/speaker.hpp>
 #include <driver/ledc.h>
 #include <freertos/task.h>
+#include <main/config/config.hpp>
+#include <main/sim/sim_backends.hpp>
 
 Speaker::Speaker(gpio_num_t pin, bool active_high, uint32_t freq_hz, uint8_t duty_percent)
     : pin_(pin), active_high_(active_high), freq_hz_(freq_hz), duty_percent_(duty_percent) {}
 
 bool Speaker::init() {
+    if (Config::Features::simulate_hardware) {
+        return true;
+    }
     // Configure LEDC timer
     ledc_timer_config_t timer_conf = {};
     timer_conf.speed_mode = LEDC_LOW_SPEED_MODE;
@@ -40,11 +45,19 @@ void Speaker::toneOn() {
     if (!active_high_) {
         duty = max_duty - duty;
     }
+    if (Config::Features::simulate_hardware) {
+        SimBackends::ledcSetDuty(duty);
+        return;
+    }
     ledc_set_duty(LEDC_LOW_SPEED_MODE, channel_, duty);
     ledc_update_duty(LEDC_LOW_SPEED_MODE, channel_);
 }
 
 void Speaker::toneOff() {
+    if (Config::Features::simulate_hardware) {
+        SimBackends::ledcSetDuty(0);
+        return;
+    }
     ledc_set_duty(LEDC_LOW_SPEED_MODE, channel_, 0);
     ledc_update_duty(LEDC_LOW_SPEED_MODE, channel_);
 }
@@ -68,6 +81,9 @@ void Speaker::pulse(uint32_t on_ms, uint32_t off_ms, uint32_t repeat) {
 
 bool Speaker::setFrequency(uint32_t freq_hz) {
     freq_hz_ = freq_hz;
+    if (Config::Features::simulate_hardware) {
+        return true;
+    }
     uint32_t set = ledc_set_freq(LEDC_LOW_SPEED_MODE, timer_, freq_hz_);
     return (set == freq_hz_);
 }
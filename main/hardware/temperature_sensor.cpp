@@ -1,22 +1,32 @@
 #include <main/hardware/temperature_sensor.hpp>
 #include <main/utils/logger.hpp>
 #include <main/hardware/adc_shared.hpp>
+#include <main/hardware/adc_engine.hpp>
+#include <main/sim/sim_backends.hpp>
+#include <main/utils/fixed_point.hpp>
 #include <esp_adc/adc_oneshot.h>
 
 static const char* TAG_SENSOR = "TempSensor";
 
-// ESP32 ADC reference voltage (typically 3.3V)
-// For ADC_ATTEN_DB_0 on ESP32, effective full-scale is ~1.1V
-static constexpr float ADC_REF_VOLTAGE = 1.1f;
 // ADC resolution (12-bit = 4095)
 static constexpr int ADC_MAX_VALUE = 4095;
 // Number of samples for averaging (reduces noise)
 static constexpr int ADC_SAMPLES = 16;
 
+// raw -> 0.01 degC, folded from the calibration constants at compile time
+using TempKernel = FixedPoint::LinearKernel<Config::Hardware::Temperature::adc_full_scale_mv, ADC_MAX_VALUE,
+                                            Config::Hardware::Temperature::gain_c_per_mv>;
+static_assert(FixedPoint::maxErrorCenti<TempKernel>(ADC_MAX_VALUE) <= 1,
+              "LM35 kernel drifts from the float conversion by more than 0.01 degC");
+// calibrated mV -> 0.01 degC
+using TempMvKernel = FixedPoint::MillivoltKernel<Config::Hardware::Temperature::gain_c_per_mv>;
+
 TemperatureSensor::TemperatureSensor(gpio_num_t sensor_pin)
     : pin(sensor_pin),
       adc_channel(ADC_CHANNEL_0),
       adc_handle(nullptr),
+      engine_slot(-1),
+      mv_table(),
       initialized(false) {
     // Map GPIO to ADC channel for ADC1
     // GPIO 32-39 are ADC1 channels on ESP32
@@ -36,6 +46,25 @@ TemperatureSensor::TemperatureSensor(gpio_num_t sensor_pin)
 }
 
 bool TemperatureSensor::init() {
+    if (AdcEngine::enabled()) {
+        // 0 dB attenuation, as in the oneshot path below
+        engine_slot = AdcEngine::attach(adc_channel, ADC_ATTEN_DB_0);
+        if (engine_slot < 0) {
+            LOG_ERROR(TAG_SENSOR, "Failed to attach ADC1_CH%d to ADC engine", adc_channel);
+            return false;
+        }
+        (void)mv_table.init(ADC_UNIT_1, adc_channel, ADC_ATTEN_DB_0);
+        initialized = true;
+        LOG_INFO(TAG_SENSOR, "LM35 on ADC engine slot %d (ADC1_CH%d)", engine_slot, adc_channel);
+        return true;
+    }
+
+    if (Config::Features::simulate_hardware) {
+        initialized = true;
+        LOG_INFO(TAG_SENSOR, "LM35 simulated on ADC1_CH%d", adc_channel);
+        return true;
+    }
+
     // Get shared ADC1 handle
     adc_handle = AdcShared::getAdc1Handle();
     if (adc_handle == nullptr) {
@@ -55,49 +84,63 @@ bool TemperatureSensor::init() {
         return false;
     }
 
+    (void)mv_table.init(ADC_UNIT_1, adc_channel, ADC_ATTEN_DB_0);
     initialized = true;
     LOG_INFO(TAG_SENSOR, "LM35 initialized on GPIO %d (ADC1_CH%d)", pin, adc_channel);
     return true;
 }
 
-bool TemperatureSensor::readTemperature(float& out_celsius) {
-    if (!initialized || adc_handle == nullptr) {
+bool TemperatureSensor::readTemperature(int16_t& out_centi_c) {
+    if (!initialized) {
         return false;
     }
 
-    // Read multiple samples and average for noise reduction
-    int32_t adc_sum = 0;
-    int valid_samples = 0;
-    
-    AdcShared::lock();
-    for (int i = 0; i < ADC_SAMPLES; ++i) {
-        int adc_raw = 0;
-        esp_err_t ret = adc_oneshot_read(adc_handle, adc_channel, &adc_raw);
-        if (ret == ESP_OK && adc_raw >= 0) {
-            adc_sum += adc_raw;
-            valid_samples++;
+    uint32_t adc_mean = 0;
+    if (engine_slot >= 0) {
+        // Latest DMA frame mean; no ADC access or lock on this path
+        uint16_t raw = 0;
+        if (!AdcEngine::readMean(engine_slot, raw)) {
+            LOG_ERROR(TAG_SENSOR, "No fresh ADC engine frame");
+            return false;
         }
-    }
-    AdcShared::unlock();
-
-    if (valid_samples == 0) {
-        LOG_ERROR(TAG_SENSOR, "Failed to read ADC");
+        adc_mean = raw;
+    } else if (adc_handle == nullptr && !Config::Features::simulate_hardware) {
         return false;
+    } else {
+        // Read multiple samples and average for noise reduction
+        uint32_t adc_sum = 0;
+        uint32_t valid_samples = 0;
+
+        AdcShared::lock();
+        for (int i = 0; i < ADC_SAMPLES; ++i) {
+            int adc_raw = 0;
+            esp_err_t ret = ESP_OK;
+            if (Config::Features::simulate_hardware) {
+                adc_raw = SimBackends::adcRead(adc_channel);
+            } else {
+                ret = adc_oneshot_read(adc_handle, adc_channel, &adc_raw);
+            }
+            if (ret == ESP_OK && adc_raw >= 0) {
+                adc_sum += static_cast<uint32_t>(adc_raw);
+                valid_samples++;
+            }
+        }
+        AdcShared::unlock();
+
+        if (valid_samples == 0) {
+            LOG_ERROR(TAG_SENSOR, "Failed to read ADC");
+            return false;
+        }
+
+        // Rounded average ADC value
+        adc_mean = (adc_sum + valid_samples / 2U) / valid_samples;
     }
 
-    // Calculate average ADC value
-    float adc_avg = static_cast<float>(adc_sum) / static_cast<float>(valid_samples);
-    
-    // Suppress per-read debug logging to reduce noise
-    
-    // Convert ADC reading to voltage (millivolts)
-    // Voltage = (ADC_value / ADC_max) * Reference_voltage
-    float voltage_mv = (adc_avg / static_cast<float>(ADC_MAX_VALUE)) * ADC_REF_VOLTAGE * 1000.0f;
-    
-    // Convert voltage to temperature using configurable gain/offset (no mV offset)
-    out_celsius = (Config::Hardware::Temperature::gain_c_per_mv * voltage_mv);
-    
     // Suppress per-read debug logging to reduce noise
-    
+
+    // raw -> mV -> degC (configurable gain, no mV offset): table lookup plus one Q16
+    // multiply when calibrated, otherwise the nominal full-scale kernel
+    out_centi_c = static_cast<int16_t>(mv_table.ready() ? TempMvKernel::toCenti(mv_table.toMillivolts(adc_mean))
+                                                        : TempKernel::toCenti(adc_mean));
     return true;
 }
@@ -1,9 +1,11 @@
 #ifndef TEMPERATURE_SENSOR_HPP
 #define TEMPERATURE_SENSOR_HPP
 
+#include <cstdint>
 #include <driver/gpio.h>
 #include <esp_adc/adc_oneshot.h>
 #include <main/config/config.hpp>
+#include <main/hardware/adc_calibration.hpp>
 
 class TemperatureSensor {
 public:
@@ -13,14 +15,16 @@ public:
     // Initialize ADC for LM35 analog temperature sensor
     bool init();
 
-    // Read temperature in Celsius from LM35 (10mV per degree C)
+    // Read temperature in 0.01 degC from LM35 (10mV per degree C), integer math only
     // Returns false on ADC read failure
-    bool readTemperature(float& out_celsius);
+    bool readTemperature(int16_t& out_centi_c);
 
 private:
     gpio_num_t pin;
     adc_channel_t adc_channel;
     adc_oneshot_unit_handle_t adc_handle;
+    int engine_slot; // AdcEngine slot, -1 when using oneshot reads
+    AdcMillivoltTable mv_table; // eFuse-calibrated raw -> mV; nominal 1.1 V scale if not ready
     bool initialized;
 };
 
@@ -1,10 +1,11 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <main/utils/logger.hpp>
+#include <main/utils/deferred_log.hpp>
+#include <main/utils/crash_log.hpp>
 #include <main/config/config.hpp>
 #include <main/tasks/cloud_communication_task.hpp>
-#include <main/tasks/temperature_sensor_task.hpp>
-#include <main/tasks/soil_moisture_task.hpp>
+#include <main/tasks/sensor_scheduler_task.hpp>
 #include <main/tasks/alarm_control_task.hpp>
 #include <main/tasks/plant_monitoring_task.hpp>
 #include <main/tasks/lcd_display_task.hpp>
@@ -12,16 +13,23 @@
 #include <main/models/temperature_data.hpp>
 #include <main/models/alarm_event.hpp>
 #include <main/models/command.hpp>
+#include <main/models/alert_request.hpp>
 #include <main/models/moisture_data.hpp>
 #include <main/models/cloud_publish_request.hpp>
 #include <main/state/runtime_thresholds.hpp>
+#include <main/state/calibration.hpp>
 #include <main/utils/watchdog.hpp>
+#include <main/utils/power_manager.hpp>
+#include <main/utils/deep_sleep_cycle.hpp>
+#include <main/sim/pipeline_bench.hpp>
 #include <nvs_flash.h>
 #include <freertos/queue.h>
 #include <cstring>
 
 extern "C" void app_main(void)
 {
+    // Before the first log line: keeps the previous boot's records for upload
+    CrashLog::init();
     Logger::setLevel(LogLevel::INFO);
     LOG_INFO("MAIN", "%s", "---Digital thermometer started---");
 
@@ -37,16 +45,29 @@ extern "C" void app_main(void)
 
     // Initialize runtime thresholds (load from NVS or use defaults)
     RuntimeThresholds::init();
+    // Moisture probe endpoints set over MQTT (NVS "calib")
+    Calibration::init();
+
+    // Remote probe mode: sample, maybe upload, deep sleep; the task graph never starts
+    if (Config::Features::deep_sleep_mode) {
+        DeepSleepCycle::run();
+    }
+
+    // From here on WARN/INFO/DEBUG are formatted by the log drain task, not the caller
+    if (Config::Logging::deferred) {
+        DeferredLog::start();
+    }
 
     // Initialize Task Watchdog Timer for safety-critical tasks
     Watchdog::init();
 
-    // Create static queues
-    static uint8_t temperature_data_queue_storage[32 * sizeof(TemperatureData)];
-    static StaticQueue_t temperature_data_queue_tcb;
-    QueueHandle_t temperature_data_queue = xQueueCreateStatic(
-        32, sizeof(TemperatureData), temperature_data_queue_storage, &temperature_data_queue_tcb);
+    // Light sleep + DFS when Config::Features::low_power_mode is set (no-op otherwise)
+    PowerManager::init();
+
+    // Sensor scheduler -> monitor/cloud sample bus (one writer, per-subscriber cursors)
+    static SensorSampleBus sensor_sample_bus;
 
+    // Create static queues
     static uint8_t alarm_queue_storage[16 * sizeof(AlarmEvent)];
     static StaticQueue_t alarm_queue_tcb;
     QueueHandle_t alarm_queue = xQueueCreateStatic(
@@ -57,26 +78,17 @@ extern "C" void app_main(void)
     QueueHandle_t command_queue = xQueueCreateStatic(
         16, sizeof(Command), command_queue_storage, &command_queue_tcb);
 
-    static uint8_t moisture_data_queue_storage[16 * sizeof(MoistureData)];
-    static StaticQueue_t moisture_data_queue_tcb;
-    QueueHandle_t moisture_data_queue = xQueueCreateStatic(
-        16, sizeof(MoistureData), moisture_data_queue_storage, &moisture_data_queue_tcb);
-        
+    // Monitor -> cloud alert requests (kept apart from MQTT commands)
+    static uint8_t alert_queue_storage[8 * sizeof(AlertRequest)];
+    static StaticQueue_t alert_queue_tcb;
+    QueueHandle_t alert_queue = xQueueCreateStatic(
+        8, sizeof(AlertRequest), alert_queue_storage, &alert_queue_tcb);
+
     static uint8_t lcd_queue_storage[8 * sizeof(LcdUpdate)];
     static StaticQueue_t lcd_queue_tcb;
     QueueHandle_t lcd_queue = xQueueCreateStatic(
         8, sizeof(LcdUpdate), lcd_queue_storage, &lcd_queue_tcb);
 
-    static uint8_t temperature_mqtt_queue_storage[1 * sizeof(TemperatureData)];
-    static StaticQueue_t temperature_mqtt_queue_tcb;
-    QueueHandle_t temperature_mqtt_queue = xQueueCreateStatic(
-        1, sizeof(TemperatureData), temperature_mqtt_queue_storage, &temperature_mqtt_queue_tcb);
-
-    static uint8_t moisture_mqtt_queue_storage[1 * sizeof(MoistureData)];
-    static StaticQueue_t moisture_mqtt_queue_tcb;
-    QueueHandle_t moisture_mqtt_queue = xQueueCreateStatic(
-        1, sizeof(MoistureData), moisture_mqtt_queue_storage, &moisture_mqtt_queue_tcb);
-
     // Thresholds-changed queue for consolidated ACKs
     static uint8_t thresholds_changed_queue_storage[4 * sizeof(CloudPublishRequest)];
     static StaticQueue_t thresholds_changed_queue_tcb;
@@ -85,27 +97,24 @@ extern "C" void app_main(void)
 
     // Start tasks (honor feature toggles)
     if (Config::Features::enable_cloud_comm) {
-        CloudCommunicationTask::create(temperature_mqtt_queue, alarm_queue, command_queue, moisture_mqtt_queue, thresholds_changed_queue);
+        CloudCommunicationTask::create(&sensor_sample_bus, command_queue, alert_queue, thresholds_changed_queue);
     }
     // Create command task to handle incoming MQTT commands
     CommandTask::create(command_queue, thresholds_changed_queue);
     
-    if (Config::Features::enable_temperature_task) {
-        TemperatureSensorTask::create(temperature_data_queue);
-    }
-    if (Config::Features::enable_moisture_task) {
-        SoilMoistureTask::create(moisture_data_queue);
-    }
+    // One task samples every SensorRegistry channel (per-channel toggles live in the registry)
+    SensorSchedulerTask::create(&sensor_sample_bus);
     if (Config::Features::enable_alarm_task) {
         AlarmControlTask::create(alarm_queue, Config::Hardware::Pins::vibration_module_gpio, true);
     }
     // Start monitoring task after producers/consumers are running
-    PlantMonitoringTask::create(temperature_data_queue, moisture_data_queue, alarm_queue, lcd_queue, command_queue,
-                                temperature_mqtt_queue, moisture_mqtt_queue);
+    PlantMonitoringTask::create(&sensor_sample_bus, alarm_queue, lcd_queue, alert_queue);
     if (Config::Features::enable_lcd_task) {
-        LcdDisplayTask::create(lcd_queue);
+        LcdDisplayTask::create(&sensor_sample_bus, lcd_queue);
        
     }
+    // Benchmark driver sweeps sensor periods once the task graph is up (no-op unless enabled)
+    PipelineBench::start(&sensor_sample_bus);
 
     // Main task has nothing to do after initialization - block forever
     // This yields CPU to all other tasks and keeps the task alive
@@ -0,0 +1,28 @@
+// Alert publish request sent from the plant monitoring task to the
+// cloud communication task (its only consumer) on every state/reason change.
+#ifndef ALERT_REQUEST_HPP
+#define ALERT_REQUEST_HPP
+
+#include <cstdint>
+
+enum class AlertState : uint8_t {
+    OK = 0,
+    WARNING = 1,
+    CRITICAL = 2
+};
+
+enum class AlertReason : uint8_t {
+    CLEAR = 0,
+    TEMP_HIGH = 1,
+    TEMP_LOW = 2,
+    MOISTURE_LOW = 3,
+    MOISTURE_HIGH = 4
+};
+
+struct AlertRequest {
+    uint32_t    timestamp_ms; // tick time the monitor raised it (alert latency)
+    AlertState  state;
+    AlertReason reason;
+};
+
+#endif // ALERT_REQUEST_HPP
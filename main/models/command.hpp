@@ -10,15 +10,9 @@ struct Command {
     float    value;        // optional numeric value
 };
 
-// Command type encoding for inter-task and MQTT commands
-// Negative values: external MQTT commands (threshold updates)
-// Non-negative values: internal commands (alert publishing)
+// Command type encoding for MQTT commands (cloud task -> command task).
+// Values stay negative for compatibility; alerts travel on their own queue (AlertRequest).
 enum class CommandType : int32_t {
-    // Internal commands (handled by cloud task for alert publishing)
-    ALERT_OK = 0,
-    ALERT_WARNING = 1,
-    ALERT_CRITICAL = 2,
-    
     // External MQTT commands (handled by command task)
     UPDATE_TEMP_LOW_WARN = -1,
     UPDATE_TEMP_LOW_CRIT = -2,
@@ -28,6 +22,10 @@ enum class CommandType : int32_t {
     UPDATE_MOISTURE_LOW_CRIT = -6,
     UPDATE_MOISTURE_HIGH_WARN = -7,
     UPDATE_MOISTURE_HIGH_CRIT = -8,
+    // Moisture probe endpoints (value = raw ADC counts 0..4095, or
+    // Calibration::CAPTURE_CURRENT to capture the current reading)
+    CALIBRATE_MOISTURE_DRY = -9,
+    CALIBRATE_MOISTURE_WET = -10,
 };
 
 #endif // COMMAND_HPP
@@ -6,7 +6,7 @@
 // Fixed-size soil moisture sample
 struct MoistureData {
     uint16_t  moisture_raw;     // raw ADC reading
-    float     moisture_percent; // 0.0..100.0 computed percentage
+    uint16_t  moisture_centi_pct; // 0..10000, 0.01 % units
     uint32_t  ts_ms;            // sample timestamp in milliseconds
 };
 
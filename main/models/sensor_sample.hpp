@@ -0,0 +1,21 @@
+#ifndef SENSOR_SAMPLE_HPP
+#define SENSOR_SAMPLE_HPP
+
+#include <cstdint>
+
+// Physical quantity of a registry channel (hardware/sensor_registry.hpp)
+enum class SensorKind : uint8_t {
+    TEMPERATURE = 0, // value in 0.01 degC
+    MOISTURE = 1     // value in 0.01 %
+};
+
+// One filtered reading from any registry channel (scheduler -> monitor)
+struct SensorSample {
+    int32_t    value_centi; // centi-units of the channel's kind (see utils/fixed_point.hpp)
+    uint32_t   ts_ms;       // sample timestamp in milliseconds
+    uint16_t   raw;         // averaged raw ADC counts
+    uint8_t    channel;     // index into SensorRegistry
+    SensorKind kind;
+};
+
+#endif // SENSOR_SAMPLE_HPP
@@ -5,7 +5,7 @@
 
 // Fixed-size sample for temperature data
 struct TemperatureData {
-    float     temp_c; // temperature in Celsius
+    int16_t   temp_centi_c; // temperature in 0.01 degC (see utils/fixed_point.hpp)
     uint32_t  ts_ms;  // sample timestamp in milliseconds
 };
 
@@ -1,6 +1,7 @@
 #include <main/network/mqtt_client.hpp>
 #include <main/utils/logger.hpp>
 #include <main/config/config.hpp>
+#include <main/sim/sim_backends.hpp>
 #include <cstring>
 #include <cstdio>
 
@@ -12,7 +13,8 @@ MqttClient::MqttClient()
       port(Config::Mqtt::port),
       client_id(Config::Device::id),
       connected(false),
-      on_message(nullptr) {}
+      on_message(nullptr),
+      on_connection(nullptr) {}
 
 bool MqttClient::init() {
     // Nothing heavy to do here; actual client is created on connect()
@@ -23,6 +25,17 @@ bool MqttClient::connect() {
     if (client != nullptr) {
         return true;
     }
+    if (Config::Features::simulate_hardware) {
+        // Simulated broker: connected as soon as asked, publishes are counted and dropped
+        if (!connected) {
+            connected = true;
+            LOG_INFO(TAG_MQTT, "%s", "MQTT connected (simulated)");
+            if (on_connection) {
+                on_connection(true);
+            }
+        }
+        return true;
+    }
 
     esp_mqtt_client_config_t cfg = {};
     // esp-mqtt expects a URI with scheme, e.g. "mqtt://host:1883"
@@ -60,6 +73,10 @@ bool MqttClient::connect() {
 }
 
 void MqttClient::disconnect() {
+    if (Config::Features::simulate_hardware) {
+        connected = false;
+        return;
+    }
     if (client) {
         (void)esp_mqtt_client_stop(client);
         (void)esp_mqtt_client_destroy(client);
@@ -73,12 +90,20 @@ bool MqttClient::isConnected() const {
 }
 
 int MqttClient::publish(const char* topic, const char* payload, int qos, bool retain) {
+    return publish(topic, reinterpret_cast<const uint8_t*>(payload), static_cast<int>(std::strlen(payload)), qos, retain);
+}
+
+int MqttClient::publish(const char* topic, const uint8_t* data, int length, int qos, bool retain) {
+    if (Config::Features::simulate_hardware && connected) {
+        (void)qos;
+        (void)retain;
+        return SimBackends::mqttPublish(topic, length);
+    }
     if (!client || !connected) {
         LOG_WARN(TAG_MQTT, "Skip publish (not connected) topic=%s", topic);
         return -1;
     }
-    int length = static_cast<int>(std::strlen(payload));
-    int mid = esp_mqtt_client_publish(client, topic, payload, length, qos, retain ? 1 : 0);
+    int mid = esp_mqtt_client_publish(client, topic, reinterpret_cast<const char*>(data), length, qos, retain ? 1 : 0);
     if (mid >= 0) {
         LOG_INFO(TAG_MQTT, "Publish topic=%s len=%d qos=%d retain=%d mid=%d", topic, length, qos, retain ? 1 : 0, mid);
     } else {
@@ -88,6 +113,9 @@ int MqttClient::publish(const char* topic, const char* payload, int qos, bool re
 }
 
 int MqttClient::subscribe(const char* topic, int qos) {
+    if (Config::Features::simulate_hardware && connected) {
+        return 0;
+    }
     if (!client || !connected) {
         LOG_WARN(TAG_MQTT, "Skip subscribe (not connected) topic=%s", topic);
         return -1;
@@ -115,10 +143,21 @@ int MqttClient::unsubscribe(const char* topic) {
     return mid;
 }
 
+int MqttClient::outboxBytes() const {
+    if (!client) {
+        return 0;
+    }
+    return esp_mqtt_client_get_outbox_size(client);
+}
+
 void MqttClient::setMessageHandler(MessageHandler handler) {
     on_message = handler;
 }
 
+void MqttClient::setConnectionHandler(ConnectionHandler handler) {
+    on_connection = handler;
+}
+
 void MqttClient::mqttEventHandler(void* handler_args, esp_event_base_t, int32_t event_id, void* event_data) {
     auto* self = static_cast<MqttClient*>(handler_args);
     esp_mqtt_event_handle_t event = static_cast<esp_mqtt_event_handle_t>(event_data);
@@ -136,11 +175,17 @@ void MqttClient::handleEvent(esp_mqtt_event_handle_t event) {
                 (void)publish(topic, "online", Config::Mqtt::default_qos, true);
             }
             LOG_INFO(TAG_MQTT, "%s", "MQTT connected");
+            if (on_connection) {
+                on_connection(true);
+            }
             break;
         }
         case MQTT_EVENT_DISCONNECTED:
             connected = false;
             LOG_WARN(TAG_MQTT, "%s", "MQTT disconnected");
+            if (on_connection) {
+                on_connection(false);
+            }
             break;
         case MQTT_EVENT_DATA:
             if (on_message) {
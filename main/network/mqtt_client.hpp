@@ -7,6 +7,8 @@
 class MqttClient {
 public:
     using MessageHandler = void (*)(const char* topic, const uint8_t* payload, int length);
+    // Called from the MQTT event task on connect (true) / disconnect (false)
+    using ConnectionHandler = void (*)(bool connected);
 
     // Construct using values from Config::Mqtt and Config::Device
     MqttClient();
@@ -19,10 +21,16 @@ public:
     bool isConnected() const;
 
     int publish(const char* topic, const char* payload, int qos = 1, bool retain = false);
+    // Binary-safe variant (payload may contain NUL bytes)
+    int publish(const char* topic, const uint8_t* data, int length, int qos = 1, bool retain = false);
     int subscribe(const char* topic, int qos = 1);
     int unsubscribe(const char* topic);
 
+    // Bytes queued in the esp-mqtt outbox (unsent or awaiting ACK); 0 when not connected
+    int outboxBytes() const;
+
     void setMessageHandler(MessageHandler handler);
+    void setConnectionHandler(ConnectionHandler handler);
 
 private:
     static void mqttEventHandler(void* handler_args, esp_event_base_t base, int32_t event_id, void* event_data);
@@ -34,6 +42,7 @@ private:
     const char* client_id;
     bool connected;
     MessageHandler on_message;
+    ConnectionHandler on_connection;
 };
 
 #endif // MQTT_CLIENT_HPP
@@ -14,6 +14,7 @@ WiFiManager::WiFiManager()
       connected(false),
       got_ip(false),
       retry_count(0),
+      on_link(nullptr),
       wifi_any_id_instance(nullptr),
       ip_got_ip_instance(nullptr) {}
 
@@ -22,6 +23,15 @@ bool WiFiManager::init() {
         return true;
     }
 
+    if (Config::Features::simulate_hardware) {
+        // Simulated link: report an address immediately, no radio or netif
+        initialized = true;
+        connected = true;
+        got_ip = true;
+        LOG_INFO(TAG, "%s", "WiFi simulated (link up)");
+        return true;
+    }
+
     // NVS init (required by WiFi)
     esp_err_t err = nvs_flash_init();
     if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
@@ -76,9 +86,20 @@ bool WiFiManager::init() {
     wifi_config.sta.sae_pwe_h2e = WPA3_SAE_PWE_BOTH;
     wifi_config.sta.pmf_cfg.capable = true;
     wifi_config.sta.pmf_cfg.required = false;
+    if (Config::Features::low_power_mode) {
+        // Wake for every Nth beacon only; MQTT traffic is batched into the wake slots
+        wifi_config.sta.listen_interval = Config::Power::wifi_listen_interval;
+    }
 
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+    if (Config::Features::low_power_mode) {
+        // Modem sleep between DTIM beacons (required for light sleep with WiFi up)
+        esp_err_t ps_err = esp_wifi_set_ps(WIFI_PS_MAX_MODEM);
+        if (ps_err != ESP_OK) {
+            LOG_WARN(TAG, "esp_wifi_set_ps failed: %d", static_cast<int>(ps_err));
+        }
+    }
 
     initialized = true;
 
@@ -95,6 +116,11 @@ bool WiFiManager::connect() {
         }
     }
     retry_count = 0;
+    if (Config::Features::simulate_hardware) {
+        connected = true;
+        got_ip = true;
+        return true;
+    }
     got_ip = false;
     esp_err_t err = esp_wifi_connect();
     if (err != ESP_OK) {
@@ -106,7 +132,9 @@ bool WiFiManager::connect() {
 }
 
 void WiFiManager::disconnect() {
-    (void)esp_wifi_disconnect();
+    if (!Config::Features::simulate_hardware) {
+        (void)esp_wifi_disconnect();
+    }
     connected = false;
     got_ip = false;
 }
@@ -133,6 +161,9 @@ void WiFiManager::wifiEventHandler(void* arg, esp_event_base_t event_base, int32
             LOG_WARN(TAG, "WIFI_EVENT_STA_DISCONNECTED");
             self->connected = false;
             self->got_ip = false;
+            if (self->on_link) {
+                self->on_link(false);
+            }
             if (self->retry_count < Config::Wifi::max_retry_count) {
                 self->retry_count++;
                 LOG_INFO(TAG, "Retrying WiFi (%d/%d)", self->retry_count, Config::Wifi::max_retry_count);
@@ -145,6 +176,9 @@ void WiFiManager::wifiEventHandler(void* arg, esp_event_base_t event_base, int32
             LOG_INFO(TAG, "WIFI_EVENT_STA_STOP");
             self->connected = false;
             self->got_ip = false;
+            if (self->on_link) {
+                self->on_link(false);
+            }
             break;
         default:
             break;
@@ -158,6 +192,9 @@ void WiFiManager::ipEventHandler(void* arg, esp_event_base_t event_base, int32_t
         self->connected = true;
         LOG_INFO(TAG, "Got IP address");
         self->retry_count = 0;
+        if (self->on_link) {
+            self->on_link(true);
+        }
     }
 }
 
@@ -8,6 +8,9 @@
 
 class WiFiManager {
 public:
+    // Called from the event loop task when the IP link comes up (true) or drops (false)
+    using LinkHandler = void (*)(bool has_ip);
+
     WiFiManager();
 
     bool init();
@@ -18,6 +21,8 @@ public:
     bool isConnected() const { return connected; }
     bool hasIp() const { return got_ip; }
 
+    void setLinkHandler(LinkHandler handler) { on_link = handler; }
+
 private:
     static void wifiEventHandler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
     static void ipEventHandler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
@@ -26,6 +31,7 @@ private:
     bool connected;
     bool got_ip;
     int retry_count;
+    LinkHandler on_link;
 
     esp_event_handler_instance_t wifi_any_id_instance;
     esp_event_handler_instance_t ip_got_ip_instance;
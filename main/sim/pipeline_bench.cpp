@@ -0,0 +1,197 @@
+#include <main/sim/pipeline_bench.hpp>
+#include <main/sim/sim_backends.hpp>
+#include <main/config/config.hpp>
+#include <main/utils/logger.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/portmacro.h>
+#include <esp_timer.h>
+#include <inttypes.h>
+#include <cstring>
+
+namespace {
+    static const char* TAG = "PIPE_BENCH";
+
+    static StaticTask_t s_task_tcb;
+    static StackType_t s_task_stack[3072 / sizeof(StackType_t)];
+
+    static constexpr uint32_t BUCKETS = Config::Bench::histogram_max_ms + 1; // last bucket = overflow
+
+    // Fixed-bucket latency histogram (1 ms resolution)
+    struct Histogram {
+        uint32_t counts[BUCKETS];
+        uint32_t total;
+        uint32_t max_ms;
+    };
+
+    struct StepStats {
+        uint32_t produced;
+        Histogram monitor;
+        Histogram publish;
+    };
+
+    static StepStats s_stats;
+    static volatile uint32_t s_period_ms = 0; // 0 = benchmark not running
+    static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+    static const SensorSampleBus* s_bus = nullptr;
+
+    static uint32_t nowMs() {
+        return static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+    }
+
+    static void record(Histogram& h, uint32_t latency_ms) {
+        uint32_t bucket = (latency_ms < BUCKETS - 1U) ? latency_ms : (BUCKETS - 1U);
+        h.counts[bucket]++;
+        h.total++;
+        if (latency_ms > h.max_ms) {
+            h.max_ms = latency_ms;
+        }
+    }
+
+    // Smallest bucket whose cumulative count reaches pct percent of the total
+    static uint32_t percentile(const Histogram& h, uint32_t pct) {
+        if (h.total == 0) {
+            return 0;
+        }
+        uint64_t target = (static_cast<uint64_t>(h.total) * pct + 99U) / 100U;
+        uint64_t cumulative = 0;
+        for (uint32_t i = 0; i < BUCKETS; ++i) {
+            cumulative += h.counts[i];
+            if (cumulative >= target) {
+                return i;
+            }
+        }
+        return BUCKETS - 1U;
+    }
+
+    // Samples lost to the producer lapping a subscriber, summed over subscribers.
+    // A subscriber counts its overruns at its next poll; lag beyond the ring is
+    // already lost, so it is added too and the total only grows.
+    static uint32_t busLost() {
+        uint32_t lost = 0;
+        for (size_t i = 0; i < s_bus->getSubscriberCount(); ++i) {
+            const SensorSampleBus::SubscriberStats st = s_bus->getStats(i);
+            lost += st.overruns;
+            if (st.lag > s_bus->getCapacity()) {
+                lost += st.lag - static_cast<uint32_t>(s_bus->getCapacity());
+            }
+        }
+        return lost;
+    }
+
+    static void logHistogram(const char* stage, const Histogram& h) {
+        LOG_INFO(TAG, "  %-16s n=%" PRIu32 " p50=%" PRIu32 "ms p90=%" PRIu32 "ms p99=%" PRIu32 "ms max=%" PRIu32 "ms",
+                 stage, h.total, percentile(h, 50), percentile(h, 90), percentile(h, 99), h.max_ms);
+    }
+
+    static void taskFunction(void* arg) {
+        (void)arg;
+        static StepStats snapshot;
+        const size_t step_count = sizeof(Config::Bench::sample_periods_ms) / sizeof(Config::Bench::sample_periods_ms[0]);
+        const uint32_t tick_ms = portTICK_PERIOD_MS;
+        uint32_t best_period_ms = 0;
+
+        LOG_INFO(TAG, "Pipeline benchmark: %u steps x %" PRIu32 " ms (tick=%" PRIu32 " ms, simulated=%d)",
+                 static_cast<unsigned>(step_count), Config::Bench::step_duration_ms, tick_ms,
+                 Config::Features::simulate_hardware ? 1 : 0);
+
+        for (size_t step = 0; step < step_count; ++step) {
+            uint32_t period_ms = Config::Bench::sample_periods_ms[step];
+            if (period_ms < tick_ms) {
+                period_ms = tick_ms; // vTaskDelayUntil cannot go below one tick
+            }
+
+            taskENTER_CRITICAL(&s_mux);
+            std::memset(&s_stats, 0, sizeof(s_stats));
+            s_period_ms = period_ms;
+            taskEXIT_CRITICAL(&s_mux);
+
+            uint32_t lost_start = busLost();
+            uint32_t pub_count_start = SimBackends::mqttPublishes();
+            uint32_t pub_bytes_start = SimBackends::mqttBytes();
+            uint32_t start_ms = nowMs();
+            vTaskDelay(pdMS_TO_TICKS(Config::Bench::step_duration_ms));
+            uint32_t elapsed_ms = nowMs() - start_ms;
+
+            taskENTER_CRITICAL(&s_mux);
+            std::memcpy(&snapshot, &s_stats, sizeof(snapshot));
+            taskEXIT_CRITICAL(&s_mux);
+            // Summed over subscribers: a step counts as dropping once either the
+            // monitor or the cloud task falls a full ring behind
+            uint32_t dropped = busLost() - lost_start;
+            uint32_t rate_milli = (elapsed_ms > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(snapshot.produced) * 1000000ULL) / elapsed_ms) : 0;
+            LOG_INFO(TAG, "Step %u: period=%" PRIu32 "ms produced=%" PRIu32 " dropped=%" PRIu32 " rate=%" PRIu32 ".%03" PRIu32 " samples/s",
+                     static_cast<unsigned>(step), period_ms, snapshot.produced, dropped,
+                     rate_milli / 1000U, rate_milli % 1000U);
+            logHistogram("sensor->monitor", snapshot.monitor);
+            logHistogram("sensor->publish", snapshot.publish);
+            if (Config::Features::simulate_hardware) {
+                LOG_INFO(TAG, "  mqtt publishes=%" PRIu32 " bytes=%" PRIu32,
+                         SimBackends::mqttPublishes() - pub_count_start,
+                         SimBackends::mqttBytes() - pub_bytes_start);
+            }
+
+            if (snapshot.produced > 0 && dropped == 0) {
+                best_period_ms = period_ms;
+            }
+        }
+
+        s_period_ms = 0;
+        if (best_period_ms > 0) {
+            LOG_INFO(TAG, "Max sustainable rate: %" PRIu32 " samples/s per sensor (period %" PRIu32 " ms)",
+                     1000U / best_period_ms, best_period_ms);
+        } else {
+            LOG_WARN(TAG, "%s", "No step completed without drops");
+        }
+        vTaskDelete(nullptr);
+    }
+}
+
+namespace PipelineBench {
+    void start(const SensorSampleBus* bus) {
+        if (!Config::Features::pipeline_benchmark || bus == nullptr) {
+            return;
+        }
+        s_bus = bus;
+        xTaskCreateStatic(taskFunction, "pipeline_bench",
+                          sizeof(s_task_stack) / sizeof(StackType_t), nullptr,
+                          Config::TaskPriorities::NORMAL, s_task_stack, &s_task_tcb);
+    }
+
+    uint32_t samplePeriodMs(uint32_t default_ms) {
+        if (!Config::Features::pipeline_benchmark) {
+            return default_ms;
+        }
+        uint32_t p = s_period_ms;
+        return (p != 0) ? p : default_ms;
+    }
+
+    void onProduced() {
+        if (!Config::Features::pipeline_benchmark || s_period_ms == 0) {
+            return;
+        }
+        taskENTER_CRITICAL(&s_mux);
+        s_stats.produced++;
+        taskEXIT_CRITICAL(&s_mux);
+    }
+
+    void onMonitorReceive(uint32_t sample_ts_ms) {
+        if (!Config::Features::pipeline_benchmark || s_period_ms == 0) {
+            return;
+        }
+        uint32_t latency = nowMs() - sample_ts_ms;
+        taskENTER_CRITICAL(&s_mux);
+        record(s_stats.monitor, latency);
+        taskEXIT_CRITICAL(&s_mux);
+    }
+
+    void onPublish(uint32_t sample_ts_ms) {
+        if (!Config::Features::pipeline_benchmark || s_period_ms == 0) {
+            return;
+        }
+        uint32_t latency = nowMs() - sample_ts_ms;
+        taskENTER_CRITICAL(&s_mux);
+        record(s_stats.publish, latency);
+        taskEXIT_CRITICAL(&s_mux);
+    }
+}
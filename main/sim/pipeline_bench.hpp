@@ -0,0 +1,29 @@
+// End-to-end pipeline benchmark driver (sensor task -> PlantMonitoringTask -> cloud).
+// Sweeps the sensor sampling period through Config::Bench::sample_periods_ms and
+// logs latency percentiles per step plus the fastest period sustained without drops.
+// All hooks are no-ops unless Config::Features::pipeline_benchmark is set.
+#ifndef PIPELINE_BENCH_HPP
+#define PIPELINE_BENCH_HPP
+
+#include <cstdint>
+#include <main/tasks/sensor_scheduler_task.hpp>
+
+namespace PipelineBench {
+    // Create the static benchmark driver task (call from app_main after the task graph).
+    // A step's drops are the samples bus subscribers lost to the producer lapping them.
+    void start(const SensorSampleBus* bus);
+
+    // Sampling period producers should use right now; returns default_ms when idle
+    uint32_t samplePeriodMs(uint32_t default_ms);
+
+    // Producer hook: one sample published on the bus
+    void onProduced();
+
+    // Monitoring hook: sample captured at sample_ts_ms (esp_timer ms) was dequeued
+    void onMonitorReceive(uint32_t sample_ts_ms);
+
+    // Cloud hook: a value captured at sample_ts_ms was handed to the MQTT client
+    void onPublish(uint32_t sample_ts_ms);
+}
+
+#endif // PIPELINE_BENCH_HPP
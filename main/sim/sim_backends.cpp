@@ -0,0 +1,75 @@
+#include <main/sim/sim_backends.hpp>
+#include <main/config/config.hpp>
+#include <esp_timer.h>
+#include <atomic>
+
+namespace {
+    static std::atomic<uint32_t> s_i2c_writes{0};
+    static std::atomic<uint32_t> s_mqtt_publishes{0};
+    static std::atomic<uint32_t> s_mqtt_bytes{0};
+    static std::atomic<uint32_t> s_ledc_duty{0};
+    static std::atomic<uint32_t> s_noise_state{0x12345678u};
+
+    // Cheap LCG noise in [-amplitude, +amplitude]
+    static int noise(int amplitude) {
+        uint32_t x = s_noise_state.load(std::memory_order_relaxed) * 1664525u + 1013904223u;
+        s_noise_state.store(x, std::memory_order_relaxed);
+        return static_cast<int>((x >> 16) % static_cast<uint32_t>(2 * amplitude + 1)) - amplitude;
+    }
+
+    // Triangle wave in [0, span] with the given period
+    static int triangle(uint32_t t_ms, uint32_t period_ms, int span) {
+        uint32_t phase = t_ms % period_ms;
+        uint32_t half = period_ms / 2U;
+        uint32_t ramp = (phase < half) ? phase : (period_ms - phase);
+        return static_cast<int>((static_cast<uint64_t>(ramp) * static_cast<uint64_t>(span)) / half);
+    }
+}
+
+namespace SimBackends {
+    int adcRead(adc_channel_t channel) {
+        uint32_t t_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+        int raw = 0;
+        if (channel == Config::Hardware::Moisture::channel) {
+            // Slow sweep across the calibrated range so alert states get exercised
+            raw = Config::Hardware::Moisture::raw_dry +
+                  triangle(t_ms, 600000U, Config::Hardware::Moisture::raw_wet - Config::Hardware::Moisture::raw_dry) +
+                  noise(12);
+        } else {
+            // ~18..26 C at 0.1 C/mV over a 1.1 V / 4095 scale (~0.27 mV per LSB)
+            raw = 670 + triangle(t_ms, 300000U, 300) + noise(4);
+        }
+        if (raw < 0) raw = 0;
+        if (raw > 4095) raw = 4095;
+        return raw;
+    }
+
+    bool i2cWrite(uint8_t addr7, std::size_t len) {
+        (void)addr7;
+        (void)len;
+        s_i2c_writes.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void ledcSetDuty(uint32_t duty) {
+        s_ledc_duty.store(duty, std::memory_order_relaxed);
+    }
+
+    int mqttPublish(const char* topic, int length) {
+        (void)topic;
+        s_mqtt_bytes.fetch_add(static_cast<uint32_t>(length), std::memory_order_relaxed);
+        return static_cast<int>(s_mqtt_publishes.fetch_add(1, std::memory_order_relaxed) & 0x7FFFu);
+    }
+
+    uint32_t i2cWrites() {
+        return s_i2c_writes.load(std::memory_order_relaxed);
+    }
+
+    uint32_t mqttPublishes() {
+        return s_mqtt_publishes.load(std::memory_order_relaxed);
+    }
+
+    uint32_t mqttBytes() {
+        return s_mqtt_bytes.load(std::memory_order_relaxed);
+    }
+}
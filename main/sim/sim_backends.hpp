@@ -0,0 +1,30 @@
+// Simulated hardware/network back ends used when Config::Features::simulate_hardware
+// is set. Lets the full task graph run without sensors, LCD, buzzer or WiFi.
+#ifndef SIM_BACKENDS_HPP
+#define SIM_BACKENDS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <hal/adc_types.h>
+
+namespace SimBackends {
+    // ADC: synthetic 12-bit raw reading for an ADC1 channel.
+    // Temperature channel drifts around ~22 C, moisture channel sweeps dry<->wet.
+    int adcRead(adc_channel_t channel);
+
+    // I2C: accept a write to a 7-bit address (always succeeds)
+    bool i2cWrite(uint8_t addr7, std::size_t len);
+
+    // LEDC: record the last duty written to the speaker channel
+    void ledcSetDuty(uint32_t duty);
+
+    // MQTT: accept a publish and return a message id (always >= 0)
+    int mqttPublish(const char* topic, int length);
+
+    // Counters (monotonic since boot)
+    uint32_t i2cWrites();
+    uint32_t mqttPublishes();
+    uint32_t mqttBytes();
+}
+
+#endif // SIM_BACKENDS_HPP
@@ -0,0 +1,268 @@
+#include <main/state/calibration.hpp>
+#include <main/config/config.hpp>
+#include <main/utils/logger.hpp>
+#include <main/storage/config_blob.hpp>
+#include <nvs_flash.h>
+#include <nvs.h>
+#include <freertos/FreeRTOS.h>
+#include <atomic>
+#include <cstddef>
+#include <cmath>
+
+static const char* TAG = "CALIBRATION";
+static const char* NVS_NAMESPACE = "calib";
+
+namespace {
+    struct CalibrationData {
+        uint16_t moisture_raw_dry;
+        uint16_t moisture_raw_wet;
+    };
+
+    static CalibrationData s_data{Config::Hardware::Moisture::raw_dry, Config::Hardware::Moisture::raw_wet};
+    static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+    static std::atomic<uint32_t> s_generation{0};
+    // Bit 16 set once a reading has been noted; low 16 bits hold the raw value
+    static std::atomic<uint32_t> s_last_raw{0};
+
+    // Stored as a ConfigBlob under BLOB_KEY, one entry per endpoint, like the
+    // thresholds. Tags are permanent: add new fields with new tags and bump SCHEMA_VERSION.
+    static const char* BLOB_KEY = "cfg";
+    static const char* LEGACY_KEY = "data"; // v1: raw CalibrationData struct
+    static constexpr uint16_t SCHEMA_VERSION = 2;
+    static constexpr uint8_t TAG_MOISTURE_RAW_DRY = 1;
+    static constexpr uint8_t TAG_MOISTURE_RAW_WET = 2;
+    static constexpr std::size_t FIELD_COUNT = 2;
+    // Largest stored blob handled; ours is 20 bytes, the rest is room for fields
+    // added by newer builds. A bigger one is left alone, like an unparseable one.
+    static constexpr std::size_t BLOB_MAX = 256;
+
+    // Scratch for the stored blob and its replacement. Users are serialized: init()
+    // runs before the command task, the only caller of the setters.
+    static uint8_t s_stored_blob[BLOB_MAX];
+    static uint8_t s_encode_blob[BLOB_MAX];
+
+    // Set when the stored blob could not be parsed: it is never overwritten, and
+    // changes stay in RAM until the namespace is erased
+    static bool s_store_locked = false;
+
+    enum class Stored : uint8_t { NONE, OK, UNPARSEABLE };
+
+    static std::size_t describe(CalibrationData& d, ConfigBlob::Field (&fields)[FIELD_COUNT]) {
+        fields[0] = ConfigBlob::Field{TAG_MOISTURE_RAW_DRY, sizeof(uint16_t), &d.moisture_raw_dry};
+        fields[1] = ConfigBlob::Field{TAG_MOISTURE_RAW_WET, sizeof(uint16_t), &d.moisture_raw_wet};
+        return FIELD_COUNT;
+    }
+
+    // Read BLOB_KEY into s_stored_blob at the size NVS reports, and check its framing
+    static Stored readStored(nvs_handle_t handle, std::size_t& out_size) {
+        size_t size = 0;
+        esp_err_t err = nvs_get_blob(handle, BLOB_KEY, nullptr, &size);
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            return Stored::NONE;
+        }
+        if (err == ESP_OK && size > BLOB_MAX) {
+            LOG_ERROR(TAG, "Calibration blob is %u bytes (max %u)", static_cast<unsigned>(size),
+                      static_cast<unsigned>(BLOB_MAX));
+            return Stored::UNPARSEABLE;
+        }
+        if (err == ESP_OK) {
+            err = nvs_get_blob(handle, BLOB_KEY, s_stored_blob, &size);
+        }
+        if (err != ESP_OK) {
+            LOG_ERROR(TAG, "Calibration blob unreadable: %d", static_cast<int>(err));
+            return Stored::UNPARSEABLE;
+        }
+        uint16_t version = 0;
+        const ConfigBlob::Status status = ConfigBlob::decode(s_stored_blob, size, nullptr, 0, version);
+        if (status != ConfigBlob::Status::OK) {
+            LOG_ERROR(TAG, "Calibration blob rejected (status %u)", static_cast<unsigned>(status));
+            return Stored::UNPARSEABLE;
+        }
+        out_size = size;
+        return Stored::OK;
+    }
+
+    // Rewrite the blob with data, keeping entries this build does not know. Refuses
+    // to replace a blob it cannot parse.
+    static bool saveToNvs(const CalibrationData& data) {
+        if (s_store_locked) {
+            LOG_ERROR(TAG, "%s", "Stored calibration is unparseable; not overwriting it");
+            return false;
+        }
+        nvs_handle_t handle;
+        esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+        if (err != ESP_OK) {
+            LOG_ERROR(TAG, "NVS open failed: %d", static_cast<int>(err));
+            return false;
+        }
+
+        std::size_t stored_size = 0;
+        const Stored stored = readStored(handle, stored_size);
+        if (stored == Stored::UNPARSEABLE) {
+            nvs_close(handle);
+            s_store_locked = true;
+            LOG_ERROR(TAG, "%s", "Not overwriting the stored calibration");
+            return false;
+        }
+
+        CalibrationData copy = data;
+        ConfigBlob::Field fields[FIELD_COUNT];
+        const std::size_t count = describe(copy, fields);
+        const std::size_t size =
+            ConfigBlob::encode(SCHEMA_VERSION, fields, count, s_encode_blob, sizeof(s_encode_blob),
+                               (stored == Stored::OK) ? s_stored_blob : nullptr, stored_size);
+        if (size == 0) {
+            nvs_close(handle);
+            LOG_ERROR(TAG, "Calibration blob exceeds %u bytes", static_cast<unsigned>(BLOB_MAX));
+            return false;
+        }
+
+        err = nvs_set_blob(handle, BLOB_KEY, s_encode_blob, size);
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+        if (err != ESP_OK) {
+            LOG_ERROR(TAG, "NVS write failed: %d", static_cast<int>(err));
+            return false;
+        }
+        return true;
+    }
+
+    // Layout before the versioned blob; accepted only at its exact size
+    static bool migrateLegacy(nvs_handle_t handle, CalibrationData& out) {
+        CalibrationData legacy{};
+        size_t size = sizeof(legacy);
+        if (nvs_get_blob(handle, LEGACY_KEY, &legacy, &size) != ESP_OK || size != sizeof(legacy)) {
+            return false;
+        }
+        out = legacy;
+        LOG_INFO(TAG, "Migrating v1 calibration blob to schema v%u", static_cast<unsigned>(SCHEMA_VERSION));
+        return true;
+    }
+
+    // Apply the stored values to out; endpoints absent from the blob keep the
+    // defaults already in out. False when nothing usable is stored.
+    static bool loadFromNvs(CalibrationData& out) {
+        nvs_handle_t handle;
+        if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+            return false;
+        }
+
+        std::size_t size = 0;
+        const Stored stored = readStored(handle, size);
+        if (stored == Stored::NONE) {
+            const bool migrated = migrateLegacy(handle, out);
+            nvs_close(handle);
+            if (migrated && saveToNvs(out)) {
+                nvs_handle_t rw;
+                if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &rw) == ESP_OK) {
+                    (void)nvs_erase_key(rw, LEGACY_KEY);
+                    (void)nvs_commit(rw);
+                    nvs_close(rw);
+                }
+            }
+            return migrated;
+        }
+        nvs_close(handle);
+        if (stored == Stored::UNPARSEABLE) {
+            s_store_locked = true;
+            return false;
+        }
+
+        CalibrationData values = out;
+        ConfigBlob::Field fields[FIELD_COUNT];
+        const std::size_t count = describe(values, fields);
+        uint16_t version = 0;
+        std::size_t applied = 0;
+        (void)ConfigBlob::decode(s_stored_blob, size, fields, count, version, &applied);
+        if (version != SCHEMA_VERSION || applied != count) {
+            LOG_INFO(TAG, "Calibration blob schema v%u: %u of %u fields stored",
+                     static_cast<unsigned>(version), static_cast<unsigned>(applied), static_cast<unsigned>(count));
+        }
+        out = values;
+        return true;
+    }
+
+    static bool update(bool dry, uint16_t raw) {
+        if (raw > 4095U) {
+            return false;
+        }
+        taskENTER_CRITICAL(&s_mux);
+        CalibrationData next = s_data;
+        taskEXIT_CRITICAL(&s_mux);
+        (dry ? next.moisture_raw_dry : next.moisture_raw_wet) = raw;
+        // Persist before publishing so a reset never reverts an acknowledged change
+        if (!saveToNvs(next)) {
+            return false;
+        }
+        taskENTER_CRITICAL(&s_mux);
+        s_data = next;
+        taskEXIT_CRITICAL(&s_mux);
+        s_generation.fetch_add(1, std::memory_order_release);
+        LOG_INFO(TAG, "Moisture calibration: dry=%u wet=%u", static_cast<unsigned>(next.moisture_raw_dry),
+                 static_cast<unsigned>(next.moisture_raw_wet));
+        return true;
+    }
+}
+
+namespace Calibration {
+    void init() {
+        CalibrationData loaded = s_data;
+        if (loadFromNvs(loaded)) {
+            taskENTER_CRITICAL(&s_mux);
+            s_data = loaded;
+            taskEXIT_CRITICAL(&s_mux);
+            LOG_INFO(TAG, "Loaded moisture calibration: dry=%u wet=%u", static_cast<unsigned>(loaded.moisture_raw_dry),
+                     static_cast<unsigned>(loaded.moisture_raw_wet));
+        } else {
+            LOG_INFO(TAG, "%s", "Using default moisture calibration");
+        }
+        s_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    Moisture getMoisture() {
+        taskENTER_CRITICAL(&s_mux);
+        Moisture m{s_data.moisture_raw_dry, s_data.moisture_raw_wet};
+        taskEXIT_CRITICAL(&s_mux);
+        return m;
+    }
+
+    bool setMoistureDry(uint16_t raw) {
+        return update(true, raw);
+    }
+
+    bool setMoistureWet(uint16_t raw) {
+        return update(false, raw);
+    }
+
+    uint32_t generation() {
+        return s_generation.load(std::memory_order_acquire);
+    }
+
+    void noteMoistureRaw(uint16_t raw) {
+        s_last_raw.store(0x10000U | raw, std::memory_order_relaxed);
+    }
+
+    bool lastMoistureRaw(uint16_t& out_raw) {
+        uint32_t v = s_last_raw.load(std::memory_order_relaxed);
+        out_raw = static_cast<uint16_t>(v & 0xFFFFU);
+        return (v & 0x10000U) != 0;
+    }
+
+    bool resolveMoistureRaw(float value, uint16_t& out_raw) {
+        if (std::isnan(value)) {
+            if (!lastMoistureRaw(out_raw)) {
+                LOG_ERROR(TAG, "%s", "No moisture reading to capture yet");
+                return false;
+            }
+            return true;
+        }
+        if (!(value >= 0.0f && value <= 4095.0f)) {
+            LOG_ERROR(TAG, "Invalid calibration raw value: %.0f", static_cast<double>(value));
+            return false;
+        }
+        out_raw = static_cast<uint16_t>(value + 0.5f);
+        return true;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef CALIBRATION_HPP
+#define CALIBRATION_HPP
+
+#include <cstdint>
+#include <limits>
+
+// Runtime sensor calibration, persisted in NVS as a versioned ConfigBlob
+// (calib/cfg, storage/config_blob.hpp, next to the "thresholds" namespace).
+// Currently the soil moisture two-point endpoints:
+// raw ADC counts in air (dry) and in water (wet), set over MQTT with the
+// "calibrate" command. Defaults come from Config::Hardware::Moisture.
+namespace Calibration {
+    // Load from NVS or fall back to defaults
+    void init();
+
+    struct Moisture {
+        uint16_t raw_dry;
+        uint16_t raw_wet;
+    };
+
+    Moisture getMoisture();
+
+    // Persist one endpoint; bumps generation() so the moisture task reloads
+    bool setMoistureDry(uint16_t raw);
+    bool setMoistureWet(uint16_t raw);
+
+    // Changes on every successful update (sensor tasks compare against a cached copy)
+    uint32_t generation();
+
+    // Latest unfiltered moisture reading, for capturing an endpoint in place
+    void noteMoistureRaw(uint16_t raw);
+    bool lastMoistureRaw(uint16_t& out_raw);
+
+    // "calibrate" command value when the message had no "raw" field: capture the
+    // latest reading instead. NaN, so no number from the wire can mean it.
+    static constexpr float CAPTURE_CURRENT = std::numeric_limits<float>::quiet_NaN();
+
+    // Command value -> endpoint counts: 0..4095 (rounded), or the latest reading for
+    // CAPTURE_CURRENT. Anything else, negative counts included, is rejected.
+    bool resolveMoistureRaw(float value, uint16_t& out_raw);
+}
+
+#endif // CALIBRATION_HPP
@@ -1,65 +1,123 @@
 #include <main/state/runtime_thresholds.hpp>
 #include <main/config/config.hpp>
 #include <main/utils/logger.hpp>
+#include <main/storage/config_blob.hpp>
+#include <main/state/threshold_table.hpp>
 #include <nvs_flash.h>
 #include <nvs.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/portmacro.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <inttypes.h>
 #include <cstring>
 
 static const char* TAG = "RUNTIME_THRESH";
 static const char* NVS_NAMESPACE = "thresholds";
 
 namespace {
-    struct ThresholdData {
-        float temp_low_warn_c;
-        float temp_low_crit_c;
-        float temp_high_warn_c;
-        float temp_high_crit_c;
-        float moisture_low_warn_pct;
-        float moisture_low_crit_pct;
-        float moisture_high_warn_pct;
-        float moisture_high_crit_pct;
-    };
+    using ThresholdData = RuntimeThresholds::Values;
 
+    // Seqlock: s_seq is odd while a writer is copying into s_data. Readers retry
+    // instead of locking; writers are serialized by s_mux (command task only in practice).
     static ThresholdData s_data;
+    static std::atomic<uint32_t> s_seq{0};
     static bool s_initialized = false;
+
+    // Deferred NVS writer: commits notify it, it waits for the burst to settle and
+    // writes the latest snapshot once
+    static StaticTask_t s_writer_tcb;
+    static StackType_t s_writer_stack[3072 / sizeof(StackType_t)];
+    static TaskHandle_t s_writer_handle = nullptr;
+    static std::atomic<uint32_t> s_saved_gen{0}; // generation last written to NVS
+    // Serializes persistLatest(): the writer task and flush() callers both write, and
+    // s_saved_gen must only move with the flash contents. Created by init(); earlier
+    // callers run at boot before any other task exists and go without it.
+    static StaticSemaphore_t s_persist_mutex_buffer;
+    static SemaphoreHandle_t s_persist_mutex = nullptr;
+    static std::atomic<uint32_t> s_flash_commits{0};
 #if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
     static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
 #else
     // For dual-core, use regular critical sections
 #endif
 
-    static void loadDefaults() {
+    static void loadDefaults(ThresholdData& d) {
         using namespace Config::Monitoring;
-        s_data.temp_low_warn_c = temp_low_warn_c;
-        s_data.temp_low_crit_c = temp_low_crit_c;
-        s_data.temp_high_warn_c = temp_high_warn_c;
-        s_data.temp_high_crit_c = temp_high_crit_c;
-        s_data.moisture_low_warn_pct = moisture_low_warn_pct;
-        s_data.moisture_low_crit_pct = moisture_low_crit_pct;
-        s_data.moisture_high_warn_pct = moisture_high_warn_pct;
-        s_data.moisture_high_crit_pct = moisture_high_crit_pct;
+        d.temp_low_warn_c = temp_low_warn_c;
+        d.temp_low_crit_c = temp_low_crit_c;
+        d.temp_high_warn_c = temp_high_warn_c;
+        d.temp_high_crit_c = temp_high_crit_c;
+        d.moisture_low_warn_pct = moisture_low_warn_pct;
+        d.moisture_low_crit_pct = moisture_low_crit_pct;
+        d.moisture_high_warn_pct = moisture_high_warn_pct;
+        d.moisture_high_crit_pct = moisture_high_crit_pct;
     }
 
-    static bool loadFromNvs() {
-        nvs_handle_t handle;
-        esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
-        if (err != ESP_OK) {
-            return false;
-        }
+    // Stored as a ConfigBlob under BLOB_KEY, one entry per ThresholdTable row (blob_tag).
+    // Tags are permanent: add new fields with new tags and bump SCHEMA_VERSION.
+    static const char* BLOB_KEY = "cfg";
+    static const char* LEGACY_KEY = "data"; // v1: raw ThresholdData struct
+    static constexpr uint16_t SCHEMA_VERSION = 2;
+    // Largest stored blob handled; ours is ~60 bytes, the rest is room for fields
+    // added by newer builds. A bigger one is left alone, like an unparseable one.
+    static constexpr std::size_t BLOB_MAX = 512;
 
-        size_t required_size = sizeof(ThresholdData);
-        err = nvs_get_blob(handle, "data", &s_data, &required_size);
-        nvs_close(handle);
+    // Scratch for the stored blob and its replacement. Users are serialized: init()
+    // runs before the writer task exists, later saves hold s_persist_mutex.
+    static uint8_t s_stored_blob[BLOB_MAX];
+    static uint8_t s_encode_blob[BLOB_MAX];
+
+    // Set when the stored blob could not be parsed (foreign or corrupt format, or over
+    // BLOB_MAX): it is never overwritten, and changes stay in RAM until it is erased
+    static std::atomic<bool> s_store_locked{false};
+
+    enum class Stored : uint8_t { NONE, OK, UNPARSEABLE };
 
-        if (err == ESP_OK && required_size == sizeof(ThresholdData)) {
-            return true;
+    static std::size_t describe(ThresholdData& d, ConfigBlob::Field (&fields)[ThresholdTable::COUNT]) {
+        for (std::size_t i = 0; i < ThresholdTable::COUNT; ++i) {
+            const ThresholdTable::Entry& e = ThresholdTable::ENTRIES[i];
+            fields[i] = ConfigBlob::Field{e.blob_tag, sizeof(float), &(d.*e.field)};
+        }
+        return ThresholdTable::COUNT;
+    }
+
+    // Read BLOB_KEY into s_stored_blob at the size NVS reports, and check its framing
+    static Stored readStored(nvs_handle_t handle, std::size_t& out_size) {
+        size_t size = 0;
+        esp_err_t err = nvs_get_blob(handle, BLOB_KEY, nullptr, &size);
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            return Stored::NONE;
+        }
+        if (err == ESP_OK && size > BLOB_MAX) {
+            LOG_ERROR(TAG, "Threshold blob is %u bytes (max %u)", static_cast<unsigned>(size),
+                      static_cast<unsigned>(BLOB_MAX));
+            return Stored::UNPARSEABLE;
+        }
+        if (err == ESP_OK) {
+            err = nvs_get_blob(handle, BLOB_KEY, s_stored_blob, &size);
+        }
+        if (err != ESP_OK) {
+            LOG_ERROR(TAG, "Threshold blob unreadable: %d", static_cast<int>(err));
+            return Stored::UNPARSEABLE;
         }
-        return false;
+        uint16_t version = 0;
+        const ConfigBlob::Status status = ConfigBlob::decode(s_stored_blob, size, nullptr, 0, version);
+        if (status != ConfigBlob::Status::OK) {
+            LOG_ERROR(TAG, "Threshold blob rejected (status %u)", static_cast<unsigned>(status));
+            return Stored::UNPARSEABLE;
+        }
+        out_size = size;
+        return Stored::OK;
     }
 
-    static bool saveToNvs() {
+    // Rewrite the blob with d, keeping entries this build does not know. Refuses to
+    // replace a blob it cannot parse.
+    static bool saveToNvs(const ThresholdData& d) {
+        if (s_store_locked.load(std::memory_order_relaxed)) {
+            return false;
+        }
         nvs_handle_t handle;
         esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
         if (err != ESP_OK) {
@@ -67,7 +125,28 @@ namespace {
             return false;
         }
 
-        err = nvs_set_blob(handle, "data", &s_data, sizeof(ThresholdData));
+        std::size_t stored_size = 0;
+        const Stored stored = readStored(handle, stored_size);
+        if (stored == Stored::UNPARSEABLE) {
+            nvs_close(handle);
+            s_store_locked.store(true, std::memory_order_relaxed);
+            LOG_ERROR(TAG, "%s", "Not overwriting the stored thresholds; changes stay in RAM");
+            return false;
+        }
+
+        ThresholdData copy = d;
+        ConfigBlob::Field fields[ThresholdTable::COUNT];
+        const std::size_t count = describe(copy, fields);
+        const std::size_t size =
+            ConfigBlob::encode(SCHEMA_VERSION, fields, count, s_encode_blob, sizeof(s_encode_blob),
+                               (stored == Stored::OK) ? s_stored_blob : nullptr, stored_size);
+        if (size == 0) {
+            nvs_close(handle);
+            LOG_ERROR(TAG, "Threshold blob exceeds %u bytes", static_cast<unsigned>(BLOB_MAX));
+            return false;
+        }
+
+        err = nvs_set_blob(handle, BLOB_KEY, s_encode_blob, size);
         if (err != ESP_OK) {
             LOG_ERROR(TAG, "NVS set_blob failed: %d", static_cast<int>(err));
             nvs_close(handle);
@@ -83,296 +162,264 @@ namespace {
 
         return true;
     }
-}
 
-namespace RuntimeThresholds {
-    void init() {
-        if (s_initialized) {
-            return;
+    // Layout before the versioned blob; accepted only at its exact size
+    static bool migrateLegacy(nvs_handle_t handle, ThresholdData& d) {
+        ThresholdData legacy{};
+        size_t size = sizeof(legacy);
+        if (nvs_get_blob(handle, LEGACY_KEY, &legacy, &size) != ESP_OK || size != sizeof(legacy)) {
+            return false;
         }
+        d = legacy;
+        LOG_INFO(TAG, "Migrating v1 threshold blob to schema v%u", static_cast<unsigned>(SCHEMA_VERSION));
+        return true;
+    }
 
-        loadDefaults();
-
-        if (loadFromNvs()) {
-            LOG_INFO(TAG, "Loaded thresholds from NVS");
-        } else {
-            LOG_INFO(TAG, "Using default thresholds (NVS not found or empty)");
-            // Save defaults to NVS for next time
-            (void)saveToNvs();
+    // Apply the stored values to d (OK); fields absent from the blob keep the defaults
+    // already in d. NONE when nothing is stored, UNPARSEABLE leaves d untouched.
+    static Stored loadFromNvs(ThresholdData& d) {
+        nvs_handle_t handle;
+        if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+            return Stored::NONE;
         }
 
-        s_initialized = true;
-    }
+        std::size_t size = 0;
+        const Stored stored = readStored(handle, size);
+        if (stored == Stored::NONE) {
+            const bool migrated = migrateLegacy(handle, d);
+            nvs_close(handle);
+            if (migrated && saveToNvs(d)) {
+                nvs_handle_t rw;
+                if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &rw) == ESP_OK) {
+                    (void)nvs_erase_key(rw, LEGACY_KEY);
+                    (void)nvs_commit(rw);
+                    nvs_close(rw);
+                }
+            }
+            return migrated ? Stored::OK : Stored::NONE;
+        }
+        nvs_close(handle);
+        if (stored == Stored::UNPARSEABLE) {
+            return stored;
+        }
 
-    float getTempLowWarn() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.temp_low_warn_c;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+        ThresholdData values = d;
+        ConfigBlob::Field fields[ThresholdTable::COUNT];
+        const std::size_t count = describe(values, fields);
+        uint16_t version = 0;
+        std::size_t applied = 0;
+        (void)ConfigBlob::decode(s_stored_blob, size, fields, count, version, &applied);
+        if (version != SCHEMA_VERSION || applied != count) {
+            LOG_INFO(TAG, "Threshold blob schema v%u: %u of %u fields stored",
+                     static_cast<unsigned>(version), static_cast<unsigned>(applied), static_cast<unsigned>(count));
+        }
+        d = values;
+        return Stored::OK;
     }
 
-    float getTempLowCrit() {
+    // Publish a new value set, either a whole one (d) or the current one with a
+    // batch applied, in one writer section; readers see the old or the new set
+    static void publish(const ThresholdData* d, const RuntimeThresholds::Batch* batch) {
 #if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
         taskENTER_CRITICAL(&s_mux);
 #else
         taskENTER_CRITICAL();
 #endif
-        float val = s_data.temp_low_crit_c;
+        const uint32_t seq = s_seq.load(std::memory_order_relaxed);
+        s_seq.store(seq + 1U, std::memory_order_relaxed); // odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        if (d != nullptr) {
+            s_data = *d;
+        }
+        if (batch != nullptr) {
+            batch->applyTo(s_data);
+        }
+        s_seq.store(seq + 2U, std::memory_order_release); // even: stable
 #if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
         taskEXIT_CRITICAL(&s_mux);
 #else
         taskEXIT_CRITICAL();
 #endif
-        return val;
     }
 
-    float getTempHighWarn() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.temp_high_warn_c;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+    // Write the current snapshot unless that generation is already in flash
+    static bool persistLatest() {
+        if (s_persist_mutex != nullptr) {
+            xSemaphoreTake(s_persist_mutex, portMAX_DELAY);
+        }
+        uint32_t gen = 0;
+        const ThresholdData d = RuntimeThresholds::snapshot(&gen);
+        bool ok = true;
+        if (gen != s_saved_gen.load(std::memory_order_relaxed)) {
+            ok = saveToNvs(d);
+            if (ok) {
+                s_saved_gen.store(gen, std::memory_order_release);
+                const uint32_t commits = s_flash_commits.fetch_add(1, std::memory_order_relaxed) + 1U;
+                LOG_INFO(TAG, "Thresholds persisted (gen %" PRIu32 ", %" PRIu32 " commits since boot)", gen, commits);
+            }
+        }
+        if (s_persist_mutex != nullptr) {
+            xSemaphoreGive(s_persist_mutex);
+        }
+        return ok;
     }
 
-    float getTempHighCrit() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.temp_high_crit_c;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+    static void writerTask(void* arg) {
+        (void)arg;
+        using namespace Config::Tasks::ThresholdPersist;
+        for (;;) {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            // Debounce: every further commit restarts the quiet window, bounded by max_defer_ms
+            const TickType_t first = xTaskGetTickCount();
+            for (;;) {
+                const TickType_t elapsed = xTaskGetTickCount() - first;
+                if (elapsed >= pdMS_TO_TICKS(max_defer_ms)) {
+                    break;
+                }
+                const TickType_t remaining = pdMS_TO_TICKS(max_defer_ms) - elapsed;
+                const TickType_t quiet = pdMS_TO_TICKS(coalesce_ms);
+                if (ulTaskNotifyTake(pdTRUE, (quiet < remaining) ? quiet : remaining) == 0) {
+                    break;
+                }
+            }
+            if (!persistLatest() && !s_store_locked.load(std::memory_order_relaxed)) {
+                // Keep the change pending and try again after another window
+                LOG_WARN(TAG, "%s", "Deferred threshold write failed; will retry");
+                (void)xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+            }
+        }
     }
 
-    float getMoistureLowWarn() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.moisture_low_warn_pct;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+    static void logEntry(float ThresholdData::* field, float value) {
+        const ThresholdTable::Entry* e = ThresholdTable::byField(field);
+        if (e != nullptr) {
+            LOG_INFO(TAG, "Updated %s to %.*f", e->name, e->decimals, value);
+        }
     }
 
-    float getMoistureLowCrit() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.moisture_low_crit_pct;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+    static bool setField(float ThresholdData::* field, float value) {
+        RuntimeThresholds::Batch batch;
+        (void)batch.set(field, value);
+        return RuntimeThresholds::commit(batch);
     }
+}
 
-    bool setTempLowWarn(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.temp_low_warn_c = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated temp_low_warn to %.2f", value);
+namespace RuntimeThresholds {
+    void init() {
+        if (s_initialized) {
+            return;
         }
-        return ok;
-    }
 
-    bool setTempLowCrit(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.temp_low_crit_c = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated temp_low_crit to %.2f", value);
+        ThresholdData d{};
+        loadDefaults(d);
+
+        const Stored stored = loadFromNvs(d);
+        if (stored == Stored::OK) {
+            LOG_INFO(TAG, "Loaded thresholds from NVS");
+        } else if (stored == Stored::UNPARSEABLE) {
+            loadDefaults(d);
+            s_store_locked.store(true, std::memory_order_relaxed);
+            LOG_ERROR(TAG, "%s", "Using default thresholds; the stored blob is kept and changes stay in RAM");
+        } else {
+            loadDefaults(d); // a failed read may leave the blob half-copied
+            LOG_INFO(TAG, "Using default thresholds (NVS not found or empty)");
+            // Save defaults to NVS for next time
+            (void)saveToNvs(d);
         }
-        return ok;
+        publish(&d, nullptr);
+        s_saved_gen.store(generation(), std::memory_order_release);
+
+        s_persist_mutex = xSemaphoreCreateMutexStatic(&s_persist_mutex_buffer);
+
+        s_writer_handle = xTaskCreateStatic(writerTask, "thresh_nvs",
+                                            sizeof(s_writer_stack) / sizeof(StackType_t), nullptr,
+                                            Config::TaskPriorities::NORMAL, s_writer_stack, &s_writer_tcb);
+        s_initialized = true;
     }
 
-    bool setTempHighWarn(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.temp_high_warn_c = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated temp_high_warn to %.2f", value);
+    bool Batch::set(float Values::* field, float value) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (entries[i].field == field) {
+                entries[i].value = value;
+                return true;
+            }
         }
-        return ok;
+        if (count == MAX_ENTRIES) {
+            return false;
+        }
+        entries[count++] = Entry{field, value};
+        return true;
     }
 
-    bool setTempHighCrit(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.temp_high_crit_c = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated temp_high_crit to %.2f", value);
+    void Batch::applyTo(Values& v) const {
+        for (std::size_t i = 0; i < count; ++i) {
+            v.*(entries[i].field) = entries[i].value;
         }
-        return ok;
     }
 
-    bool setMoistureLowWarn(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.moisture_low_warn_pct = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated moisture_low_warn to %.1f", value);
+    bool commit(const Batch& batch) {
+        if (batch.size() == 0) {
+            return false;
         }
-        return ok;
+        publish(nullptr, &batch);
+        batch.forEach(logEntry);
+        if (s_writer_handle == nullptr) {
+            return persistLatest();
+        }
+        (void)xTaskNotifyGive(s_writer_handle);
+        return true;
     }
 
-    bool setMoistureLowCrit(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.moisture_low_crit_pct = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated moisture_low_crit to %.1f", value);
-        }
-        return ok;
+    bool flush() {
+        return persistLatest();
     }
 
-    float getMoistureHighWarn() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.moisture_high_warn_pct;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+    bool writePending() {
+        return s_saved_gen.load(std::memory_order_acquire) != generation();
     }
 
-    float getMoistureHighCrit() {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        float val = s_data.moisture_high_crit_pct;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        return val;
+    uint32_t flashCommits() {
+        return s_flash_commits.load(std::memory_order_relaxed);
     }
 
-    bool setMoistureHighWarn(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.moisture_high_warn_pct = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated moisture_high_warn to %.1f", value);
+    Values snapshot(uint32_t* out_generation) {
+        for (;;) {
+            const uint32_t before = s_seq.load(std::memory_order_acquire);
+            if ((before & 1U) != 0U) {
+                continue; // writer mid-copy (runs in a short critical section)
+            }
+            ThresholdData copy = s_data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s_seq.load(std::memory_order_relaxed) == before) {
+                if (out_generation != nullptr) {
+                    *out_generation = before >> 1;
+                }
+                return copy;
+            }
         }
-        return ok;
     }
 
-    bool setMoistureHighCrit(float value) {
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskENTER_CRITICAL(&s_mux);
-#else
-        taskENTER_CRITICAL();
-#endif
-        s_data.moisture_high_crit_pct = value;
-#if defined(CONFIG_FREERTOS_UNICORE) || defined(portMUX_INITIALIZER_UNLOCKED)
-        taskEXIT_CRITICAL(&s_mux);
-#else
-        taskEXIT_CRITICAL();
-#endif
-        bool ok = saveToNvs();
-        if (ok) {
-            LOG_INFO(TAG, "Updated moisture_high_crit to %.1f", value);
-        }
-        return ok;
+    uint32_t generation() {
+        return s_seq.load(std::memory_order_acquire) >> 1;
     }
+
+    float getTempLowWarn()  { return snapshot().temp_low_warn_c; }
+    float getTempLowCrit()  { return snapshot().temp_low_crit_c; }
+    float getTempHighWarn() { return snapshot().temp_high_warn_c; }
+    float getTempHighCrit() { return snapshot().temp_high_crit_c; }
+
+    bool setTempLowWarn(float value)  { return setField(&ThresholdData::temp_low_warn_c, value); }
+    bool setTempLowCrit(float value)  { return setField(&ThresholdData::temp_low_crit_c, value); }
+    bool setTempHighWarn(float value) { return setField(&ThresholdData::temp_high_warn_c, value); }
+    bool setTempHighCrit(float value) { return setField(&ThresholdData::temp_high_crit_c, value); }
+
+    float getMoistureLowWarn()  { return snapshot().moisture_low_warn_pct; }
+    float getMoistureLowCrit()  { return snapshot().moisture_low_crit_pct; }
+    float getMoistureHighWarn() { return snapshot().moisture_high_warn_pct; }
+    float getMoistureHighCrit() { return snapshot().moisture_high_crit_pct; }
+
+    bool setMoistureLowWarn(float value)  { return setField(&ThresholdData::moisture_low_warn_pct, value); }
+    bool setMoistureLowCrit(float value)  { return setField(&ThresholdData::moisture_low_crit_pct, value); }
+    bool setMoistureHighWarn(float value) { return setField(&ThresholdData::moisture_high_warn_pct, value); }
+    bool setMoistureHighCrit(float value) { return setField(&ThresholdData::moisture_high_crit_pct, value); }
 }
@@ -1,19 +1,93 @@
 #ifndef RUNTIME_THRESHOLDS_HPP
 #define RUNTIME_THRESHOLDS_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 namespace RuntimeThresholds {
+    // All eight thresholds. NVS holds them as ConfigBlob TLV entries
+    // (storage/config_blob.hpp), not as this struct's bytes.
+    struct Values {
+        float temp_low_warn_c;
+        float temp_low_crit_c;
+        float temp_high_warn_c;
+        float temp_high_crit_c;
+        float moisture_low_warn_pct;
+        float moisture_low_crit_pct;
+        float moisture_high_warn_pct;
+        float moisture_high_crit_pct;
+    };
+
     // Initialize runtime thresholds from NVS or use defaults from Config::Monitoring
     void init();
 
+    // Consistent copy of all thresholds, lock-free (seqlock; retries while a
+    // setter is mid-update, never disables interrupts). out_generation, when
+    // given, receives the generation this copy belongs to.
+    Values snapshot(uint32_t* out_generation = nullptr);
+
+    // Bumped by every setter; compare against a cached value to detect changes
+    uint32_t generation();
+
+    // Several threshold writes applied together: commit() publishes them in one
+    // seqlock update (readers never see half a batch) and persists once.
+    class Batch {
+    public:
+        static constexpr std::size_t MAX_ENTRIES = 8;
+
+        // Stage a write; a later write to the same field replaces the earlier one.
+        // Returns false when the batch is full.
+        bool set(float Values::* field, float value);
+
+        std::size_t size() const { return count; }
+
+        // Apply the staged writes to v
+        void applyTo(Values& v) const;
+
+        // Visit each staged write as fn(field, value)
+        template <typename Fn>
+        void forEach(Fn fn) const {
+            for (std::size_t i = 0; i < count; ++i) {
+                fn(entries[i].field, entries[i].value);
+            }
+        }
+
+    private:
+        struct Entry {
+            float Values::* field;
+            float value;
+        };
+        Entry entries[MAX_ENTRIES] = {};
+        std::size_t count = 0;
+    };
+
+    // Publish a batch and schedule its NVS write. The write is deferred and
+    // coalesced: it runs once no commit has arrived for
+    // Config::Tasks::ThresholdPersist::coalesce_ms (at most max_defer_ms after the
+    // first). Before init() the batch is written synchronously. Returns false
+    // only for an empty batch or a failed synchronous write.
+    bool commit(const Batch& batch);
+
+    // Write any pending change to NVS now (e.g. before a reset or deep sleep).
+    // Safe from any task; serialized with the deferred writer.
+    bool flush();
+
+    // True while the latest committed values are not in NVS yet (write deferred or
+    // failed): they are applied, but a reset now would bring back the stored ones
+    bool writePending();
+
+    // NVS commits performed since boot (status topic)
+    uint32_t flashCommits();
+
+    // Single-field getters (each takes its own snapshot; prefer snapshot() for several)
+
     // Temperature threshold getters
     float getTempLowWarn();
     float getTempLowCrit();
     float getTempHighWarn();
     float getTempHighCrit();
 
-    // Temperature threshold setters (persist to NVS)
+    // Temperature threshold setters (one-field batches; persisted by the deferred writer)
     bool setTempLowWarn(float value);
     bool setTempLowCrit(float value);
     bool setTempHighWarn(float value);
@@ -25,7 +99,7 @@ namespace RuntimeThresholds {
     float getMoistureHighWarn();
     float getMoistureHighCrit();
 
-    // Moisture threshold setters (persist to NVS)
+    // Moisture threshold setters (one-field batches; persisted by the deferred writer)
     bool setMoistureLowWarn(float value);
     bool setMoistureLowCrit(float value);
     bool setMoistureHighWarn(float value);
@@ -0,0 +1,114 @@
+// One constexpr descriptor per runtime threshold. MQTT parsing (name -> entry),
+// the command task (command -> entry), NVS encoding and logging all walk this
+// table instead of repeating their own eight-way chains. Entries are sorted by
+// name for binary search; adding a threshold means adding a Values field, a
+// CommandType and one row here.
+#ifndef THRESHOLD_TABLE_HPP
+#define THRESHOLD_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <main/models/command.hpp>
+#include <main/state/runtime_thresholds.hpp>
+
+namespace ThresholdTable {
+    struct Entry {
+        const char* name;                          // MQTT key and ACK field
+        CommandType command;
+        float RuntimeThresholds::Values::* field;
+        float       min;                           // accepted range, inclusive
+        float       max;
+        uint8_t     decimals;                      // log / ACK precision
+        uint8_t     blob_tag;                      // ConfigBlob tag; permanent, never reused
+
+        constexpr bool valid(float value) const { return value >= min && value <= max; }
+    };
+
+    using V = RuntimeThresholds::Values;
+
+    static constexpr Entry ENTRIES[] = {
+        {"moisture_high_crit", CommandType::UPDATE_MOISTURE_HIGH_CRIT, &V::moisture_high_crit_pct,   0.0f, 100.0f, 1, 8},
+        {"moisture_high_warn", CommandType::UPDATE_MOISTURE_HIGH_WARN, &V::moisture_high_warn_pct,   0.0f, 100.0f, 1, 7},
+        {"moisture_low_crit",  CommandType::UPDATE_MOISTURE_LOW_CRIT,  &V::moisture_low_crit_pct,    0.0f, 100.0f, 1, 6},
+        {"moisture_low_warn",  CommandType::UPDATE_MOISTURE_LOW_WARN,  &V::moisture_low_warn_pct,    0.0f, 100.0f, 1, 5},
+        {"temp_high_crit",     CommandType::UPDATE_TEMP_HIGH_CRIT,     &V::temp_high_crit_c,       -50.0f, 100.0f, 2, 4},
+        {"temp_high_warn",     CommandType::UPDATE_TEMP_HIGH_WARN,     &V::temp_high_warn_c,       -50.0f, 100.0f, 2, 3},
+        {"temp_low_crit",      CommandType::UPDATE_TEMP_LOW_CRIT,      &V::temp_low_crit_c,        -50.0f, 100.0f, 2, 2},
+        {"temp_low_warn",      CommandType::UPDATE_TEMP_LOW_WARN,      &V::temp_low_warn_c,        -50.0f, 100.0f, 2, 1},
+    };
+    static constexpr std::size_t COUNT = sizeof(ENTRIES) / sizeof(ENTRIES[0]);
+    static_assert(COUNT == sizeof(V) / sizeof(float), "one entry per threshold");
+
+    // Compare NUL-terminated a against the first len bytes of b (b need not be terminated)
+    constexpr int compare(const char* a, const char* b, std::size_t len) {
+        for (std::size_t i = 0; i < len; ++i) {
+            if (a[i] == '\0' || a[i] != b[i]) {
+                return (a[i] == '\0') ? -1 : (static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1);
+            }
+        }
+        return (a[len] == '\0') ? 0 : 1;
+    }
+
+    constexpr std::size_t length(const char* s) {
+        std::size_t n = 0;
+        while (s[n] != '\0') {
+            n++;
+        }
+        return n;
+    }
+
+    constexpr bool sortedByName() {
+        for (std::size_t i = 1; i < COUNT; ++i) {
+            if (compare(ENTRIES[i - 1].name, ENTRIES[i].name, length(ENTRIES[i].name)) >= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(sortedByName(), "ENTRIES must stay sorted by name for find()");
+
+    // Entry for a key (len bytes at name, e.g. straight out of the JSON buffer), or nullptr
+    constexpr const Entry* find(const char* name, std::size_t len) {
+        std::size_t lo = 0;
+        std::size_t hi = COUNT;
+        while (lo < hi) {
+            const std::size_t mid = (lo + hi) / 2;
+            const int c = compare(ENTRIES[mid].name, name, len);
+            if (c == 0) {
+                return &ENTRIES[mid];
+            }
+            if (c < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return nullptr;
+    }
+    static_assert(find("temp_low_warn", 13) == &ENTRIES[7] && find("temp_low", 8) == nullptr,
+                  "name lookup");
+
+    constexpr const Entry* byCommand(CommandType command) {
+        for (const Entry& e : ENTRIES) {
+            if (e.command == command) {
+                return &e;
+            }
+        }
+        return nullptr;
+    }
+
+    constexpr const Entry* byField(float RuntimeThresholds::Values::* field) {
+        for (const Entry& e : ENTRIES) {
+            if (e.field == field) {
+                return &e;
+            }
+        }
+        return nullptr;
+    }
+
+    constexpr std::size_t indexOf(const Entry& e) {
+        return static_cast<std::size_t>(&e - ENTRIES);
+    }
+}
+
+#endif // THRESHOLD_TABLE_HPP
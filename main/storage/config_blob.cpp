@@ -0,0 +1,109 @@
+#include <main/storage/config_blob.hpp>
+#include <esp_rom_crc.h>
+#include <cstring>
+
+namespace ConfigBlob {
+    std::size_t encodedSize(const Field* fields, std::size_t count) {
+        std::size_t size = sizeof(Header);
+        for (std::size_t i = 0; i < count; ++i) {
+            size += 2U + fields[i].len;
+        }
+        return size;
+    }
+
+    std::size_t encode(uint16_t version, const Field* fields, std::size_t count, uint8_t* out, std::size_t cap,
+                       const uint8_t* previous, std::size_t previous_len) {
+        std::size_t size = encodedSize(fields, count);
+        if (size > cap) {
+            return 0;
+        }
+        uint8_t* p = out + sizeof(Header);
+        for (std::size_t i = 0; i < count; ++i) {
+            *p++ = fields[i].tag;
+            *p++ = fields[i].len;
+            std::memcpy(p, fields[i].value, fields[i].len);
+            p += fields[i].len;
+        }
+        if (previous != nullptr) {
+            uint16_t previous_version = 0;
+            if (decode(previous, previous_len, nullptr, 0, previous_version) != Status::OK) {
+                return 0;
+            }
+            Header h{};
+            std::memcpy(&h, previous, sizeof(h));
+            const uint8_t* const end = previous + sizeof(Header) + h.payload_len;
+            for (const uint8_t* q = previous + sizeof(Header); q < end; q += 2U + q[1]) {
+                bool known = false;
+                for (std::size_t i = 0; i < count && !known; ++i) {
+                    known = (fields[i].tag == q[0]);
+                }
+                if (known) {
+                    continue;
+                }
+                const std::size_t entry = 2U + q[1];
+                if (size + entry > cap) {
+                    return 0;
+                }
+                std::memcpy(p, q, entry);
+                p += entry;
+                size += entry;
+            }
+        }
+        if (size - sizeof(Header) > UINT16_MAX) {
+            return 0;
+        }
+        Header h{};
+        h.magic = MAGIC;
+        h.version = version;
+        h.payload_len = static_cast<uint16_t>(size - sizeof(Header));
+        h.crc = esp_rom_crc32_le(0, out + sizeof(Header), h.payload_len);
+        std::memcpy(out, &h, sizeof(h));
+        return size;
+    }
+
+    Status decode(const uint8_t* blob, std::size_t len, Field* fields, std::size_t count,
+                  uint16_t& out_version, std::size_t* out_applied) {
+        if (out_applied != nullptr) {
+            *out_applied = 0;
+        }
+        if (len < sizeof(Header)) {
+            return Status::BAD_LENGTH;
+        }
+        Header h{};
+        std::memcpy(&h, blob, sizeof(h));
+        if (h.magic != MAGIC) {
+            return Status::BAD_MAGIC;
+        }
+        if (sizeof(Header) + h.payload_len > len) {
+            return Status::BAD_LENGTH;
+        }
+        const uint8_t* p = blob + sizeof(Header);
+        if (esp_rom_crc32_le(0, p, h.payload_len) != h.crc) {
+            return Status::BAD_CRC;
+        }
+        out_version = h.version;
+
+        // Walk once to check framing, then apply, so a malformed blob changes nothing
+        const uint8_t* const end = p + h.payload_len;
+        for (const uint8_t* q = p; q < end; q += 2U + q[1]) {
+            if (end - q < 2 || end - q - 2 < q[1]) {
+                return Status::BAD_LENGTH;
+            }
+        }
+        std::size_t applied = 0;
+        for (const uint8_t* q = p; q < end; q += 2U + q[1]) {
+            for (std::size_t i = 0; i < count; ++i) {
+                // A known tag with an unexpected size is skipped like an unknown one
+                if (fields[i].tag == q[0] && fields[i].len == q[1]) {
+                    std::memcpy(fields[i].value, q + 2, q[1]);
+                    applied++;
+                    break;
+                }
+            }
+        }
+        if (out_applied != nullptr) {
+            *out_applied = applied;
+        }
+        return Status::OK;
+    }
+}
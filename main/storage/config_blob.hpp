@@ -0,0 +1,60 @@
+// Versioned, self-describing blob for small settings records kept in NVS.
+// Layout: Header (magic, schema version, payload length, CRC32 of the payload)
+// followed by TLV entries { uint8 tag, uint8 len, value[len] }.
+// - Readers apply the tags they know and skip the rest, so a newer firmware can add
+//   fields without older (or newer) builds rejecting the blob.
+// - A field missing from the blob keeps the caller's default (partial read).
+// - Rewriting a record carries the unknown entries of the old blob over (encode()).
+// - Entries are little-endian copies of the value; the CRC catches torn writes.
+// Pure encode/decode on caller buffers; no NVS or allocation here.
+#ifndef CONFIG_BLOB_HPP
+#define CONFIG_BLOB_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ConfigBlob {
+    static constexpr uint32_t MAGIC = 0x31474643; // "CFG1"
+    static constexpr std::size_t MAX_VALUE_BYTES = 255;
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;     // schema version of the writer
+        uint16_t payload_len; // TLV bytes after the header
+        uint32_t crc;         // crc32 over the TLV bytes
+    };
+    static_assert(sizeof(Header) == 12, "Header layout is stored in flash");
+
+    // One field of a record: the caller's storage for the value
+    struct Field {
+        uint8_t tag;   // stable id, never reused for a different meaning
+        uint8_t len;   // value size in bytes
+        void*   value;
+    };
+
+    enum class Status : uint8_t {
+        OK,          // every entry well-formed (unknown tags skipped)
+        BAD_MAGIC,   // not a ConfigBlob (e.g. a legacy raw struct)
+        BAD_LENGTH,  // truncated header, payload or TLV entry
+        BAD_CRC      // payload corrupted
+    };
+
+    // Bytes needed to encode these fields
+    std::size_t encodedSize(const Field* fields, std::size_t count);
+
+    // Encode fields into out; returns the blob size, or 0 if out is too small.
+    // previous (optional) is the stored blob being replaced: its entries whose tags
+    // are not among fields are copied through unchanged, so a save from an older
+    // build keeps the fields a newer one added. Returns 0 if previous does not decode.
+    std::size_t encode(uint16_t version, const Field* fields, std::size_t count, uint8_t* out, std::size_t cap,
+                       const uint8_t* previous = nullptr, std::size_t previous_len = 0);
+
+    // Validate blob and copy every entry whose tag and length match a field into
+    // that field's storage. Fields without an entry are left untouched.
+    // out_version receives the writer's schema version; out_applied (optional) the
+    // number of fields filled.
+    Status decode(const uint8_t* blob, std::size_t len, Field* fields, std::size_t count,
+                  uint16_t& out_version, std::size_t* out_applied = nullptr);
+}
+
+#endif // CONFIG_BLOB_HPP
@@ -0,0 +1,345 @@
+#include <main/storage/telemetry_spool.hpp>
+#include <main/config/config.hpp>
+#include <main/utils/logger.hpp>
+#include <main/utils/time_sync.hpp>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include <esp_random.h>
+#include <inttypes.h>
+#include <cstddef>
+#include <cstring>
+
+static const char* TAG = "SPOOL";
+
+namespace {
+    static constexpr uint32_t SEGMENT_BYTES = 4096; // flash erase sector
+    static constexpr uint32_t SEGMENT_MAGIC = 0x324C4F50; // "POL2": centi-unit integer values
+    static constexpr uint32_t WORD_ERASED = 0xFFFFFFFFu;
+    static constexpr uint8_t FLAG_EPOCH = 0x01;
+
+    // On-flash layouts. Sizes are multiples of 4 so every write stays word aligned.
+    struct SegmentHeader {
+        uint32_t magic;
+        uint32_t seq;         // increments each time a segment is (re)opened
+        uint32_t crc;         // crc32 over magic and seq
+        uint32_t drained;     // WORD_ERASED while pending; cleared to 0 once fully replayed
+        uint32_t reserved[4];
+    };
+
+    struct FlashRecord {
+        uint32_t seq;         // global record sequence (diagnostics)
+        uint8_t  kind;
+        uint8_t  flags;       // FLAG_EPOCH: time_ms is Unix epoch ms, else esp_timer ms of boot_id
+        uint16_t boot_id;
+        int32_t  value_centi;
+        uint64_t time_ms;
+        uint32_t reserved;
+        uint32_t crc;         // crc32 over all preceding fields
+    };
+
+    static_assert(sizeof(SegmentHeader) == 32, "SegmentHeader layout");
+    static_assert(sizeof(FlashRecord) == 32, "FlashRecord layout");
+    static_assert(offsetof(SegmentHeader, drained) % 4 == 0, "drained must be word aligned");
+
+    static constexpr uint32_t SLOTS_PER_SEGMENT = (SEGMENT_BYTES - sizeof(SegmentHeader)) / sizeof(FlashRecord);
+
+    struct Position {
+        uint32_t segment;
+        uint32_t slot;
+    };
+
+    static const esp_partition_t* s_partition = nullptr;
+    static uint32_t s_segment_count = 0;
+    static Position s_head{0, 0};     // next slot to write
+    static uint32_t s_head_seq = 0;
+    static bool s_head_drained = false;  // head segment marked drained; next append opens a new one
+    static Position s_tail{0, 0};     // oldest pending record (valid when s_pending > 0)
+    static uint32_t s_pending = 0;
+    static uint32_t s_record_seq = 0;
+    static uint16_t s_boot_id = 0;
+    static TelemetrySpool::Stats s_stats{};
+
+    static uint32_t headerCrc(const SegmentHeader& h) {
+        return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&h), offsetof(SegmentHeader, crc));
+    }
+
+    static uint32_t recordCrc(const FlashRecord& r) {
+        return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&r), offsetof(FlashRecord, crc));
+    }
+
+    static size_t segmentOffset(uint32_t segment) {
+        return static_cast<size_t>(segment) * SEGMENT_BYTES;
+    }
+
+    static size_t slotOffset(const Position& p) {
+        return segmentOffset(p.segment) + sizeof(SegmentHeader) + static_cast<size_t>(p.slot) * sizeof(FlashRecord);
+    }
+
+    static uint32_t nextSegment(uint32_t segment) {
+        return (segment + 1U) % s_segment_count;
+    }
+
+    static void advance(Position& p) {
+        if (++p.slot == SLOTS_PER_SEGMENT) {
+            p.slot = 0;
+            p.segment = nextSegment(p.segment);
+        }
+    }
+
+    static bool readHeader(uint32_t segment, SegmentHeader& out) {
+        if (esp_partition_read(s_partition, segmentOffset(segment), &out, sizeof(out)) != ESP_OK) {
+            return false;
+        }
+        return out.magic == SEGMENT_MAGIC && out.crc == headerCrc(out);
+    }
+
+    static bool slotIsErased(const Position& p) {
+        uint32_t words[sizeof(FlashRecord) / 4];
+        if (esp_partition_read(s_partition, slotOffset(p), words, sizeof(words)) != ESP_OK) {
+            return false;
+        }
+        for (uint32_t w : words) {
+            if (w != WORD_ERASED) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Segments fill front to back, so the first erased slot can be bisected
+    static uint32_t findWriteSlot(uint32_t segment) {
+        uint32_t lo = 0;
+        uint32_t hi = SLOTS_PER_SEGMENT;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2U;
+            if (slotIsErased(Position{segment, mid})) {
+                hi = mid;
+            } else {
+                lo = mid + 1U;
+            }
+        }
+        return lo;
+    }
+
+    static void markDrained(uint32_t segment) {
+        const uint32_t zero = 0;
+        // Clears bits only, so no erase is needed
+        if (esp_partition_write(s_partition, segmentOffset(segment) + offsetof(SegmentHeader, drained),
+                                &zero, sizeof(zero)) != ESP_OK) {
+            LOG_WARN(TAG, "Failed to mark segment %" PRIu32 " drained", segment);
+        }
+    }
+
+    static bool openSegment(uint32_t segment) {
+        if (esp_partition_erase_range(s_partition, segmentOffset(segment), SEGMENT_BYTES) != ESP_OK) {
+            LOG_ERROR(TAG, "Erase of segment %" PRIu32 " failed", segment);
+            return false;
+        }
+        s_stats.erases++;
+        SegmentHeader h;
+        std::memset(&h, 0xFF, sizeof(h));
+        h.magic = SEGMENT_MAGIC;
+        h.seq = ++s_head_seq;
+        h.crc = headerCrc(h);
+        if (esp_partition_write(s_partition, segmentOffset(segment), &h, sizeof(h)) != ESP_OK) {
+            LOG_ERROR(TAG, "Header write of segment %" PRIu32 " failed", segment);
+            return false;
+        }
+        s_head = Position{segment, 0};
+        s_head_drained = false;
+        return true;
+    }
+
+    // Move to a fresh segment, dropping the oldest one if the ring is full
+    static bool rollHead() {
+        uint32_t next = nextSegment(s_head.segment);
+        if (s_pending > 0 && s_tail.segment == next) {
+            uint32_t lost = SLOTS_PER_SEGMENT - s_tail.slot;
+            s_pending -= lost;
+            s_stats.dropped += lost;
+            s_tail = Position{nextSegment(next), 0};
+            LOG_WARN(TAG, "Spool full, dropped %" PRIu32 " oldest records", lost);
+        }
+        return openSegment(next);
+    }
+
+    static void recover() {
+        bool found = false;
+        uint32_t head_segment = 0;
+        uint32_t head_seq = 0;
+        SegmentHeader h;
+        for (uint32_t seg = 0; seg < s_segment_count; ++seg) {
+            if (readHeader(seg, h) && (!found || h.seq > head_seq)) {
+                found = true;
+                head_segment = seg;
+                head_seq = h.seq;
+            }
+        }
+        if (!found) {
+            s_head_seq = 0;
+            (void)openSegment(0);
+            LOG_INFO(TAG, "Formatted %" PRIu32 " segments", s_segment_count);
+            return;
+        }
+        s_head_seq = head_seq;
+        s_head = Position{head_segment, findWriteSlot(head_segment)};
+
+        // Pending data is the contiguous run of undrained segments ending at the head
+        uint32_t seg = head_segment;
+        uint32_t pending = s_head.slot;
+        for (uint32_t i = 1; i < s_segment_count; ++i) {
+            uint32_t prev = (seg + s_segment_count - 1U) % s_segment_count;
+            if (!readHeader(prev, h) || h.drained != WORD_ERASED || h.seq != head_seq - i) {
+                break;
+            }
+            seg = prev;
+            pending += SLOTS_PER_SEGMENT;
+        }
+        if (readHeader(head_segment, h) && h.drained != WORD_ERASED) {
+            pending = 0; // everything up to the head was replayed
+            s_head_drained = true;
+        }
+        s_tail = Position{seg, 0};
+        s_pending = pending;
+    }
+
+    // Release the n oldest pending records, adding them to counter (replayed or corrupt)
+    static void releaseTail(std::size_t n, uint32_t& counter) {
+        while (n > 0 && s_pending > 0) {
+            Position before = s_tail;
+            advance(s_tail);
+            s_pending--;
+            counter++;
+            n--;
+            if (s_tail.segment != before.segment) {
+                markDrained(before.segment);
+                s_head_drained = s_head_drained || before.segment == s_head.segment;
+            }
+        }
+        // Fully replayed: close the head too so a reset does not re-send it. The rest
+        // of that segment is skipped, costing at most one erase per outage.
+        if (s_pending == 0 && !s_head_drained) {
+            markDrained(s_head.segment);
+            s_head_drained = true;
+        }
+    }
+}
+
+namespace TelemetrySpool {
+    bool init() {
+        if (s_partition != nullptr) {
+            return true;
+        }
+        const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                               Config::Tasks::Spool::partition_label);
+        if (part == nullptr || part->size / SEGMENT_BYTES < 2U) {
+            LOG_WARN(TAG, "No usable '%s' partition; offline samples stay in RAM only",
+                     Config::Tasks::Spool::partition_label);
+            return false;
+        }
+        s_partition = part;
+        s_segment_count = part->size / SEGMENT_BYTES;
+        s_boot_id = static_cast<uint16_t>(esp_random());
+        recover();
+        LOG_INFO(TAG, "Mounted: segments=%" PRIu32 " capacity=%" PRIu32 " pending=%" PRIu32 " head=%" PRIu32 "/%" PRIu32,
+                 s_segment_count, s_segment_count * SLOTS_PER_SEGMENT, s_pending, s_head.segment, s_head.slot);
+        return true;
+    }
+
+    bool isReady() {
+        return s_partition != nullptr;
+    }
+
+    bool append(Kind kind, int32_t value_centi, uint32_t capture_ms) {
+        if (s_partition == nullptr) {
+            return false;
+        }
+        if ((s_head.slot == SLOTS_PER_SEGMENT || s_head_drained) && !rollHead()) {
+            return false;
+        }
+        FlashRecord r;
+        r.seq = s_record_seq++;
+        r.kind = static_cast<uint8_t>(kind);
+        r.flags = 0;
+        r.boot_id = s_boot_id;
+        r.value_centi = value_centi;
+        r.time_ms = capture_ms;
+        r.reserved = WORD_ERASED;
+        uint64_t epoch_ms = 0;
+        if (TimeSync::monotonicToEpochMs(capture_ms, epoch_ms)) {
+            r.flags |= FLAG_EPOCH;
+            r.time_ms = epoch_ms;
+        }
+        r.crc = recordCrc(r);
+        if (esp_partition_write(s_partition, slotOffset(s_head), &r, sizeof(r)) != ESP_OK) {
+            LOG_ERROR(TAG, "Record write failed at %" PRIu32 "/%" PRIu32, s_head.segment, s_head.slot);
+            // Never rewrite a possibly half-written slot: keep it in the pending range
+            // so replay stays in step, and let its CRC mismatch skip it there.
+            if (s_pending == 0) {
+                s_tail = s_head;
+            }
+            s_head.slot++;
+            s_pending++;
+            return false;
+        }
+        if (s_pending == 0) {
+            s_tail = s_head;
+        }
+        s_head.slot++;
+        s_pending++;
+        s_stats.appended++;
+        return true;
+    }
+
+    std::size_t peekRun(Record* out, std::size_t max) {
+        std::size_t n = 0;
+        Position p = s_tail;
+        uint32_t remaining = s_pending;
+        while (n < max && remaining > 0) {
+            FlashRecord r;
+            bool ok = esp_partition_read(s_partition, slotOffset(p), &r, sizeof(r)) == ESP_OK && r.crc == recordCrc(r);
+            if (!ok) {
+                if (n > 0) {
+                    break; // end the run here; the bad slot is skipped on the next call
+                }
+                // Torn or unreadable record at the tail: skip it, it was never replayed
+                LOG_WARN(TAG, "Skipping corrupt record at %" PRIu32 "/%" PRIu32, s_tail.segment, s_tail.slot);
+                releaseTail(1, s_stats.corrupt);
+                p = s_tail;
+                remaining = s_pending;
+                continue;
+            }
+            Record rec;
+            rec.kind = static_cast<Kind>(r.kind);
+            rec.value_centi = r.value_centi;
+            rec.has_epoch = (r.flags & FLAG_EPOCH) != 0;
+            rec.time_ms = r.time_ms;
+            if (!rec.has_epoch && r.boot_id == s_boot_id) {
+                uint64_t epoch_ms = 0;
+                if (TimeSync::monotonicToEpochMs(static_cast<uint32_t>(r.time_ms), epoch_ms)) {
+                    rec.has_epoch = true;
+                    rec.time_ms = epoch_ms;
+                }
+            }
+            if (n > 0 && (rec.kind != out[0].kind || rec.has_epoch != out[0].has_epoch)) {
+                break;
+            }
+            out[n++] = rec;
+            advance(p);
+            remaining--;
+        }
+        return n;
+    }
+
+    void consume(std::size_t n) {
+        releaseTail(n, s_stats.replayed);
+    }
+
+    uint32_t pendingCount() {
+        return s_pending;
+    }
+
+    Stats getStats() {
+        return s_stats;
+    }
+}
@@ -0,0 +1,62 @@
+// Flash-backed telemetry spool on a dedicated data partition (see partitions.csv).
+// Holds offline samples across resets and long outages; replayed oldest-first.
+// - Log-structured ring of erase sectors ("segments"), each with a sequence-numbered
+//   header. Segments fill front to back and are erased only when the ring wraps,
+//   so erase cycles spread evenly over the partition.
+// - Each record is written exactly once. Replay progress is kept in RAM and
+//   persisted only when a whole segment has been replayed or the spool empties
+//   (one header word cleared in place), so a reset mid-replay re-sends at most one
+//   segment; ingest dedupes those on timestamp.
+// - When the ring is full the oldest segment is dropped.
+// - Single-task use only (cloud task); no internal locking.
+#ifndef TELEMETRY_SPOOL_HPP
+#define TELEMETRY_SPOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TelemetrySpool {
+    enum class Kind : uint8_t {
+        TEMPERATURE = 0,
+        MOISTURE = 1
+    };
+
+    struct Record {
+        Kind     kind;
+        bool     has_epoch; // true: time_ms is Unix epoch ms; false: capture time is unknown (earlier boot, never synced)
+        int32_t  value_centi; // 0.01 degC or 0.01 %
+        uint64_t time_ms;
+    };
+
+    struct Stats {
+        uint32_t appended;
+        uint32_t replayed;  // records handed out by peekRun() and consumed
+        uint32_t dropped;   // records lost to ring overrun
+        uint32_t corrupt;   // records skipped on a read error or CRC mismatch (torn writes)
+        uint32_t erases;
+    };
+
+    // Mount the spool partition and recover head/tail. Returns false if the partition
+    // is missing or too small; the spool then stays disabled and callers keep RAM-only buffering.
+    bool init();
+
+    bool isReady();
+
+    // Append one sample captured at capture_ms (esp_timer ms, as in the sample models)
+    bool append(Kind kind, int32_t value_centi, uint32_t capture_ms);
+
+    // Copy up to max oldest pending records into out without consuming them. The run
+    // stops at a change of kind or time base so it maps onto one backlog message.
+    // Unreadable records at the tail are skipped and counted in Stats::corrupt, so 0
+    // can be returned while records are still pending.
+    std::size_t peekRun(Record* out, std::size_t max);
+
+    // Mark the n oldest pending records as replayed
+    void consume(std::size_t n);
+
+    uint32_t pendingCount();
+
+    Stats getStats();
+}
+
+#endif // TELEMETRY_SPOOL_HPP
@@ -7,6 +7,7 @@
 #include <main/config/config.hpp>
 #include <main/state/device_state.hpp>
 #include <main/utils/watchdog.hpp>
+#include <main/utils/power_manager.hpp>
 
 namespace {
     static const char* TAG = "ALARM_TASK";
@@ -50,7 +51,9 @@ namespace {
         LOG_INFO(TAG, "%s", "Alarm Control Task started");
 
         // Boot up chime: low to high "doo-do"
+        // LEDC stops in light sleep, so hold the chip awake while the speaker sounds
         if (s_speaker) {
+            PowerManager::holdAwake();
             LOG_INFO(TAG, "%s", "Boot chime...");
             // Low tone
             (void)s_speaker->setFrequency(600);
@@ -63,6 +66,7 @@ namespace {
             s_speaker->toneOn();
             vTaskDelay(pdMS_TO_TICKS(220));
             s_speaker->toneOff();
+            PowerManager::releaseAwake();
         } else {
             LOG_WARN(TAG, "%s", "Speaker not available for testing");
         }
@@ -70,11 +74,17 @@ namespace {
         Watchdog::subscribe();
 
         // Wait for alarms and act; repeat pattern in CRITICAL mode
+        bool holding_awake = false;
         for (;;) {
             Watchdog::feed();
             AlarmEvent evt{};
-            // Use a short timeout so we can schedule repeated critical beeps
-            if (xQueueReceive(s_alarm_queue, &evt, pdMS_TO_TICKS(100)) == pdTRUE) {
+            // Use a short timeout so we can schedule repeated critical beeps; in low-power
+            // mode only while CRITICAL, otherwise the state poll rides the shared wake slot
+            TickType_t wait = pdMS_TO_TICKS(100);
+            if (PowerManager::enabled() && s_mode != Mode::CRITICAL) {
+                wait = PowerManager::alignWait(xTaskGetTickCount(), 1);
+            }
+            if (xQueueReceive(s_alarm_queue, &evt, wait) == pdTRUE) {
                 // Map incoming event types to mode
                 if (evt.type == AlarmType::CRITICAL) {
                     s_mode = Mode::CRITICAL;
@@ -82,7 +92,9 @@ namespace {
                 } else if (evt.type == AlarmType::WARNING) {
                     s_mode = Mode::WARNING;
                     // Single short beep on warning event
+                    PowerManager::holdAwake();
                     playPattern(0);
+                    PowerManager::releaseAwake();
                 } else {
                     // Clear/unknown alarm
                     s_mode = Mode::NONE;
@@ -97,6 +109,15 @@ namespace {
             } else {
                 s_mode = Mode::CRITICAL;
             }
+            // Keep the buzzer PWM running through the CRITICAL pattern gaps
+            if ((s_mode == Mode::CRITICAL) != holding_awake) {
+                holding_awake = !holding_awake;
+                if (holding_awake) {
+                    PowerManager::holdAwake();
+                } else {
+                    PowerManager::releaseAwake();
+                }
+            }
 
             // Handle continuous beeping in CRITICAL mode
             if (s_mode == Mode::CRITICAL && s_speaker) {
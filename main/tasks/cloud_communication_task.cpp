@@ -4,19 +4,35 @@
 #include <main/utils/logger.hpp>
 #include <main/network/wifi_manager.hpp>
 #include <main/network/mqtt_client.hpp>
+#include <main/utils/power_manager.hpp>
+#include <main/tasks/cloud_communication_task.hpp>
 #include <main/utils/circular_buffer.hpp>
 #include <main/config/config.hpp>
 #include <main/models/temperature_data.hpp>
-#include <main/models/alarm_event.hpp>
 #include <main/models/command.hpp>
+#include <main/state/threshold_table.hpp>
+#include <main/models/alert_request.hpp>
 #include <main/models/moisture_data.hpp>
 #include <main/models/cloud_publish_request.hpp>
+#include <main/hardware/sensor_registry.hpp>
 #include <inttypes.h>
+#include <esp_timer.h>
 #include <cstdio>
 #include <cstring>
 #include <main/utils/time_sync.hpp>
 #include <main/state/device_state.hpp>
+#include <main/state/runtime_thresholds.hpp>
+#include <main/state/calibration.hpp>
 #include <main/utils/third-party/mjson.h>
+#include <main/sim/pipeline_bench.hpp>
+#include <main/storage/telemetry_spool.hpp>
+#include <main/utils/telemetry_codec.hpp>
+#include <main/utils/backlog_format.hpp>
+#include <main/utils/fixed_point.hpp>
+#include <main/utils/crash_log.hpp>
+#include <main/utils/task_stats.hpp>
+#include <main/utils/trace.hpp>
+#include <main/tasks/task_channels.hpp>
 
 static const char* TAG = "CLOUD_TASK";
 
@@ -30,36 +46,361 @@ namespace {
     static CircularBuffer<MoistureData, 512> s_moisture_buffer;
     static bool s_post_connect_pending = false;
     // Cache latest values for alerts
-    static float s_last_temp_c = 0.0f;
-    static float s_last_moisture_pct = 0.0f;
+    static int32_t s_last_temp_centi = 0;
+    static int32_t s_last_moisture_centi = 0;
+    static uint32_t s_last_temp_ts = 0;
+    static uint32_t s_last_moist_ts = 0;
     static bool  s_have_temp = false;
     static bool  s_have_moist = false;
+    // Set when a new sample arrives, cleared once it is published or buffered, so an
+    // offline period buffers each capture once rather than once per telemetry period
+    static bool  s_temp_unsent = false;
+    static bool  s_moist_unsent = false;
 
     // Task static stack and TCB
     static StaticTask_t s_task_tcb;
     static StackType_t s_task_stack[4096 / sizeof(StackType_t)];
-    // Telemetry rate-limit
-    static TickType_t s_last_temp_emit = 0;
-    static TickType_t s_last_moist_emit = 0;
-
-    // Queues provided by main (cloud-forwarded, latest-only)
-    static QueueHandle_t s_temperature_mqtt_queue = nullptr;
-    static QueueHandle_t s_alarm_queue = nullptr;
+    static TaskHandle_t s_task_handle = nullptr;
+
+    // Loop instrumentation, logged once per stats_window_ms
+    struct LoopStats {
+        TickType_t window_start;
+        uint32_t wakeups;
+        uint32_t idle_wakeups;     // woke and found nothing due
+        uint32_t notified;         // woken by notify() rather than a deadline
+        uint32_t alerts;
+        uint32_t alert_latency_sum_ms;
+        uint32_t alert_latency_max_ms;
+    };
+    static LoopStats s_loop_stats{};
+
+    // Sensor sample bus and this task's cursor on it
+    static SensorSampleBus* s_sample_bus = nullptr;
+    static SensorSampleBus::Subscriber* s_bus_sub = nullptr;
+    // MQTT commands out to the command task; alert requests in from the monitor
     static QueueHandle_t s_command_queue = nullptr;
-    static QueueHandle_t s_moisture_mqtt_queue = nullptr;
+    static QueueHandle_t s_alert_queue = nullptr;
     static QueueHandle_t s_thresholds_changed_queue = nullptr;
 
-    // Map threshold name string to command type
-    static CommandType parseThresholdName(const char* name) {
-        if (std::strcmp(name, "temp_low_warn") == 0) return CommandType::UPDATE_TEMP_LOW_WARN;
-        if (std::strcmp(name, "temp_low_crit") == 0) return CommandType::UPDATE_TEMP_LOW_CRIT;
-        if (std::strcmp(name, "temp_high_warn") == 0) return CommandType::UPDATE_TEMP_HIGH_WARN;
-        if (std::strcmp(name, "temp_high_crit") == 0) return CommandType::UPDATE_TEMP_HIGH_CRIT;
-        if (std::strcmp(name, "moisture_low_warn") == 0) return CommandType::UPDATE_MOISTURE_LOW_WARN;
-        if (std::strcmp(name, "moisture_low_crit") == 0) return CommandType::UPDATE_MOISTURE_LOW_CRIT;
-        if (std::strcmp(name, "moisture_high_warn") == 0) return CommandType::UPDATE_MOISTURE_HIGH_WARN;
-        if (std::strcmp(name, "moisture_high_crit") == 0) return CommandType::UPDATE_MOISTURE_HIGH_CRIT;
-        return static_cast<CommandType>(0); // Invalid
+    struct BacklogFlushStats {
+        uint32_t samples;
+        uint32_t messages;
+        uint32_t bytes;
+    };
+
+    // Outcome of one bounded backlog step
+    enum class FlushResult {
+        DONE,   // nothing left to send
+        MORE,   // batch budget used up; resume on the next loop pass
+        PAUSED  // link dropped or a batch failed; resume on the next reconnect
+    };
+
+    // Backlog left over from the last reconnect, sent batches_per_pass at a time
+    static bool s_backlog_pending = false;
+    static BacklogFlushStats s_flush_stats{};
+    static int64_t s_flush_start_us = 0;
+
+    // Wait until the esp-mqtt outbox drops under the pacing limit; false if the link drops
+    static bool waitForOutboxRoom() {
+        while (s_mqtt_client.outboxBytes() > Config::Tasks::Backlog::max_outbox_bytes) {
+            if (!s_mqtt_client.isConnected()) {
+                return false;
+            }
+            vTaskDelay(pdMS_TO_TICKS(Config::Tasks::Backlog::pacing_poll_ms));
+        }
+        return s_mqtt_client.isConnected();
+    }
+
+    // ~12 chars per value ("-1234.56,") and ~11 per offset ("123456789,") plus a fixed envelope
+    static char s_backlog_payload[160 + Config::Tasks::Backlog::batch_size * 24];
+    static_assert(sizeof(s_backlog_payload) >= TelemetryCodec::maxFrameBytes(Config::Tasks::Backlog::batch_size),
+                  "backlog payload buffer too small for a binary batch");
+    static constexpr bool BACKLOG_BINARY = Config::Mqtt::Encoding::backlog == Config::Mqtt::PayloadFormat::BINARY;
+
+    // Serialize one backlog batch into s_backlog_payload in the configured encoding
+    template<typename ValueAt, typename EpochAt>
+    static int buildBacklogBatch(TelemetryCodec::Kind kind, const char* key, unsigned decimals,
+                                 std::size_t n, ValueAt value_at, bool have_epoch, EpochAt epoch_at) {
+        if (BACKLOG_BINARY) {
+            return BacklogFormat::encodeBinary(reinterpret_cast<uint8_t*>(s_backlog_payload), sizeof(s_backlog_payload),
+                                               kind, n, value_at, have_epoch, epoch_at);
+        }
+        return BacklogFormat::formatJson(s_backlog_payload, sizeof(s_backlog_payload), key, decimals,
+                                         n, value_at, have_epoch, epoch_at);
+    }
+
+    // Publish one formatted batch; false stops the flush (samples stay buffered)
+    template<typename Format>
+    static bool publishBacklogBatch(const char* topic, std::size_t& n, Format format, BacklogFlushStats& stats) {
+        if (!waitForOutboxRoom()) {
+            return false;
+        }
+        int len = format(n);
+        // Out-of-range values can outgrow the estimate; shrink the batch rather than truncate
+        while (len < 0 && n > 1) {
+            n /= 2U;
+            len = format(n);
+        }
+        if (len < 0) {
+            LOG_ERROR(TAG, "%s", "Backlog batch does not fit; check batch_size");
+            return false;
+        }
+        if (s_mqtt_client.publish(topic, reinterpret_cast<const uint8_t*>(s_backlog_payload), len,
+                                  Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain) < 0) {
+            return false;
+        }
+        if (BACKLOG_BINARY) {
+            LOG_DEBUG(TAG, "MQTT TX topic=%s binary samples=%u len=%d", topic, static_cast<unsigned>(n), len);
+        } else {
+            LOG_DEBUG(TAG, "MQTT TX topic=%s payload=%s", topic, s_backlog_payload);
+        }
+        stats.samples += static_cast<uint32_t>(n);
+        stats.messages++;
+        stats.bytes += static_cast<uint32_t>(len);
+        return true;
+    }
+
+    // Drain a RAM backlog ring in batches, at most `budget` of them. Samples are serialized
+    // in place and only discarded once the publish is accepted, so a dropped link leaves
+    // them buffered.
+    template<typename T, std::size_t Capacity, typename ValueFn>
+    static FlushResult flushBacklog(CircularBuffer<T, Capacity>& buffer, TelemetryCodec::Kind kind, const char* topic_fmt,
+                                    const char* key, ValueFn value_of, unsigned decimals, BacklogFlushStats& stats,
+                                    uint32_t& budget) {
+        char topic[96];
+        std::snprintf(topic, sizeof(topic), topic_fmt, Config::Device::id);
+
+        while (!buffer.isEmpty()) {
+            if (budget == 0) {
+                return FlushResult::MORE;
+            }
+            const uint32_t t0_mono_ms = buffer.peekAt(0)->ts_ms;
+            uint64_t t0_epoch_ms = 0;
+            const bool have_epoch = TimeSync::monotonicToEpochMs(t0_mono_ms, t0_epoch_ms);
+            std::size_t n = buffer.getCount();
+            if (n > Config::Tasks::Backlog::batch_size) {
+                n = Config::Tasks::Backlog::batch_size;
+            }
+            auto format = [&](std::size_t count) {
+                return buildBacklogBatch(kind, key, decimals, count,
+                                         [&](std::size_t i) { return value_of(*buffer.peekAt(i)); }, have_epoch,
+                                         // Unsigned difference: correct across the 32-bit ts_ms wrap
+                                         [&](std::size_t i) { return t0_epoch_ms + (buffer.peekAt(i)->ts_ms - t0_mono_ms); });
+            };
+            if (!publishBacklogBatch(topic, n, format, stats)) {
+                LOG_WARN(TAG, "Backlog flush paused, %u left", static_cast<unsigned>(buffer.getCount()));
+                return FlushResult::PAUSED;
+            }
+            (void)buffer.discard(n);
+            budget--;
+        }
+        return FlushResult::DONE;
+    }
+
+    // Publish one live sample as a single-sample TelemetryCodec frame
+    static int publishBinarySample(const char* topic, TelemetryCodec::Kind kind, int32_t value_centi, uint32_t capture_ms) {
+        uint8_t frame[TelemetryCodec::maxFrameBytes(1)];
+        uint64_t epoch_ms = 0;
+        const bool has_time = TimeSync::monotonicToEpochMs(capture_ms, epoch_ms);
+        TelemetryCodec::FrameEncoder encoder(frame, sizeof(frame), kind, has_time);
+        (void)encoder.add(value_centi, epoch_ms);
+        int len = static_cast<int>(encoder.finish());
+        int mid = s_mqtt_client.publish(topic, frame, len, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
+        LOG_INFO(TAG, "MQTT TX topic=%s binary len=%d", topic, len);
+        return mid;
+    }
+
+    // Move the RAM backlog rings to the flash spool once they pass the spill threshold
+    // (or unconditionally with force). Spooled samples are older than anything left in
+    // RAM, so replaySpool() runs before flushBacklog() on reconnect.
+    static void spillToSpool(bool force) {
+        if (!TelemetrySpool::isReady()) {
+            return;
+        }
+        std::size_t buffered = s_telemetry_buffer.getCount() + s_moisture_buffer.getCount();
+        if (buffered == 0 || (!force && buffered < Config::Tasks::Spool::spill_threshold)) {
+            return;
+        }
+        // Each ring goes out as one run so replay can batch by kind
+        const TemperatureData* t = nullptr;
+        while ((t = s_telemetry_buffer.peekAt(0)) != nullptr &&
+               TelemetrySpool::append(TelemetrySpool::Kind::TEMPERATURE, t->temp_centi_c, t->ts_ms)) {
+            (void)s_telemetry_buffer.discard(1);
+        }
+        const MoistureData* m = nullptr;
+        while ((m = s_moisture_buffer.peekAt(0)) != nullptr &&
+               TelemetrySpool::append(TelemetrySpool::Kind::MOISTURE, m->moisture_centi_pct, m->ts_ms)) {
+            (void)s_moisture_buffer.discard(1);
+        }
+        LOG_DEBUG(TAG, "Spilled %u samples to flash (pending=%" PRIu32 ")",
+                  static_cast<unsigned>(buffered), TelemetrySpool::pendingCount());
+    }
+
+    // Replay the flash spool oldest-first on the same backlog topics, at most `budget` batches
+    static FlushResult replaySpool(BacklogFlushStats& stats, uint32_t& budget) {
+        static TelemetrySpool::Record run[Config::Tasks::Backlog::batch_size];
+        char temp_topic[96];
+        char moist_topic[96];
+        std::snprintf(temp_topic, sizeof(temp_topic), Config::Mqtt::Topics::TEMPERATURE_BACKLOG, Config::Device::id);
+        std::snprintf(moist_topic, sizeof(moist_topic), Config::Mqtt::Topics::MOISTURE_BACKLOG, Config::Device::id);
+
+        while (TelemetrySpool::pendingCount() > 0) {
+            if (budget == 0) {
+                return FlushResult::MORE;
+            }
+            std::size_t n = TelemetrySpool::peekRun(run, Config::Tasks::Backlog::batch_size);
+            if (n == 0) {
+                continue; // unreadable records were skipped (counted as corrupt)
+            }
+            const bool is_temp = run[0].kind == TelemetrySpool::Kind::TEMPERATURE;
+            auto format = [&](std::size_t count) {
+                return buildBacklogBatch(is_temp ? TelemetryCodec::Kind::TEMPERATURE : TelemetryCodec::Kind::MOISTURE,
+                                         is_temp ? "values" : "percent", is_temp ? 2U : 1U, count,
+                                         [&](std::size_t i) { return run[i].value_centi; },
+                                         run[0].has_epoch, [&](std::size_t i) { return run[i].time_ms; });
+            };
+            if (!publishBacklogBatch(is_temp ? temp_topic : moist_topic, n, format, stats)) {
+                LOG_WARN(TAG, "Spool replay paused, %" PRIu32 " left", TelemetrySpool::pendingCount());
+                return FlushResult::PAUSED;
+            }
+            TelemetrySpool::consume(n);
+            budget--;
+        }
+        return FlushResult::DONE;
+    }
+
+    // One bounded pass over the backlog: flash spool first (oldest), then the RAM rings,
+    // which hold newer samples and so wait until the spool is drained
+    static FlushResult flushBacklogStep() {
+        uint32_t budget = Config::Tasks::Backlog::batches_per_pass;
+        FlushResult result = replaySpool(s_flush_stats, budget);
+        if (result == FlushResult::DONE) {
+            result = flushBacklog(s_telemetry_buffer, TelemetryCodec::Kind::TEMPERATURE, Config::Mqtt::Topics::TEMPERATURE_BACKLOG, "values",
+                                  [](const TemperatureData& d) { return static_cast<int32_t>(d.temp_centi_c); }, 2U, s_flush_stats, budget);
+        }
+        if (result == FlushResult::DONE) {
+            result = flushBacklog(s_moisture_buffer, TelemetryCodec::Kind::MOISTURE, Config::Mqtt::Topics::MOISTURE_BACKLOG, "percent",
+                                  [](const MoistureData& d) { return static_cast<int32_t>(d.moisture_centi_pct); }, 1U, s_flush_stats, budget);
+        }
+        return result;
+    }
+
+    static char s_crash_payload[1024];
+    static std::size_t s_crash_uploaded = 0; // pending records already published
+
+    // Publish the log lines that preceded the last watchdog / panic reset, packed into
+    // as few messages as fit the buffer. Resumes after a dropped link; cleared once sent.
+    static void uploadCrashLog() {
+        const std::size_t total = CrashLog::pendingCount();
+        if (s_crash_uploaded >= total) {
+            return;
+        }
+        char topic[96];
+        std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::CRASH_LOG, Config::Device::id);
+        static constexpr char LEVELS[] = {'E', 'W', 'I', 'D'};
+
+        while (s_crash_uploaded < total) {
+            if (!waitForOutboxRoom()) {
+                return;
+            }
+            int off = mjson_snprintf(s_crash_payload, sizeof(s_crash_payload),
+                                     "{\"reset\":%Q,\"first\":%u,\"total\":%u,\"records\":[",
+                                     CrashLog::resetReason(), static_cast<unsigned>(s_crash_uploaded),
+                                     static_cast<unsigned>(total));
+            std::size_t n = 0;
+            while (s_crash_uploaded + n < total) {
+                const CrashLog::Record& r = CrashLog::pending(s_crash_uploaded + n);
+                char text[128];
+                char entry[320];
+                CrashLog::format(r, text, sizeof(text));
+                const int len = mjson_snprintf(entry, sizeof(entry), "%s{\"t\":%lu,\"l\":\"%c\",\"tag\":%Q,\"msg\":%Q}",
+                                               (n > 0) ? "," : "", static_cast<unsigned long>(r.ts_ms),
+                                               LEVELS[r.level & 3U], r.tag, text);
+                // Leave room for the closing "]}"
+                if (len <= 0 || off + len + 3 > static_cast<int>(sizeof(s_crash_payload))) {
+                    break;
+                }
+                std::memcpy(s_crash_payload + off, entry, static_cast<std::size_t>(len) + 1U);
+                off += len;
+                n++;
+            }
+            if (n == 0) {
+                s_crash_uploaded++; // a record that fails to encode is skipped, not retried forever
+                continue;
+            }
+            off += std::snprintf(s_crash_payload + off, sizeof(s_crash_payload) - off, "]}");
+            if (s_mqtt_client.publish(topic, s_crash_payload, Config::Mqtt::default_qos) < 0) {
+                return;
+            }
+            s_crash_uploaded += n;
+        }
+        LOG_INFO(TAG, "Crash log uploaded: %u records (reset: %s)", static_cast<unsigned>(total), CrashLog::resetReason());
+        CrashLog::clearPending();
+        s_crash_uploaded = 0;
+    }
+
+    static TaskStats::Snapshot s_metrics;
+    static char s_metrics_payload[1024];
+
+    // Sample per-task stats every metrics period; the sample runs offline too so
+    // low-stack warnings still reach the log, the publish only when connected
+    static void publishMetrics() {
+        TaskStats::sample(s_metrics);
+        if (!s_mqtt_client.isConnected()) {
+            return;
+        }
+        const int len = TaskStats::formatJson(s_metrics, s_metrics_payload, sizeof(s_metrics_payload));
+        if (len <= 0) {
+            return;
+        }
+        char topic[96];
+        std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::METRICS, Config::Device::id);
+        (void)s_mqtt_client.publish(topic, s_metrics_payload, Config::Mqtt::default_qos, false);
+        LOG_DEBUG(TAG, "MQTT TX topic=%s payload=%s", topic, s_metrics_payload);
+    }
+
+    // Trace export buffers (one record is at most 30 chars: "[7,255,4294967295,4294967295],")
+    static constexpr std::size_t TRACE_CHUNK = Trace::enabled() ? 32 : 1;
+    static Trace::Record s_trace_chunk[TRACE_CHUNK];
+    static char s_trace_payload[Trace::enabled() ? 64 + TRACE_CHUNK * 30 : 1];
+    static uint32_t s_trace_cursor[portNUM_PROCESSORS] = {};
+    static uint32_t s_trace_lost[portNUM_PROCESSORS] = {}; // not yet reported
+
+    // Publish every trace record written since the last export, per core, in chunks:
+    // {"core":0,"lost":0,"r":[[point,channel,id,cycles],...]}
+    static void uploadTrace() {
+        char topic[96];
+        std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::TRACE, Config::Device::id);
+        for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+            for (;;) {
+                if (!waitForOutboxRoom()) {
+                    return;
+                }
+                uint32_t lost = 0;
+                const std::size_t n = Trace::read(core, s_trace_cursor[core], s_trace_chunk, TRACE_CHUNK, lost);
+                s_trace_lost[core] += lost;
+                if (n == 0) {
+                    break;
+                }
+                int off = std::snprintf(s_trace_payload, sizeof(s_trace_payload), "{\"core\":%d,\"lost\":%" PRIu32 ",\"r\":[",
+                                        core, s_trace_lost[core]);
+                for (std::size_t i = 0; i < n; ++i) {
+                    const Trace::Record& r = s_trace_chunk[i];
+                    off += std::snprintf(s_trace_payload + off, sizeof(s_trace_payload) - off, "%s[%u,%u,%" PRIu32 ",%" PRIu32 "]",
+                                         (i > 0) ? "," : "", static_cast<unsigned>(r.point), static_cast<unsigned>(r.channel),
+                                         r.id, r.cycles);
+                }
+                off += std::snprintf(s_trace_payload + off, sizeof(s_trace_payload) - off, "]}");
+                if (s_mqtt_client.publish(topic, s_trace_payload, Config::Mqtt::default_qos) < 0) {
+                    s_trace_lost[core] += static_cast<uint32_t>(n);
+                    return;
+                }
+                s_trace_lost[core] = 0;
+                if (n < TRACE_CHUNK) {
+                    break;
+                }
+            }
+        }
     }
 
     // MQTT message callback - uses mjson for zero-allocation parsing
@@ -97,20 +438,14 @@ namespace {
                 return;
             }
 
-            CommandType cmd_type = parseThresholdName(threshold_name);
-            if (cmd_type == static_cast<CommandType>(0)) {
+            const ThresholdTable::Entry* entry = ThresholdTable::find(threshold_name, static_cast<std::size_t>(name_len));
+            if (entry == nullptr) {
                 LOG_WARN(TAG, "MQTT RX unknown threshold: %s", threshold_name);
                 return;
             }
 
-            // Enqueue command for command task
-            Command cmd{};
-            cmd.timestamp_ms = static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
-            cmd.type = static_cast<int32_t>(cmd_type);
-            cmd.value = static_cast<float>(threshold_value);
-
-            if (xQueueSend(s_command_queue, &cmd, 0) == pdTRUE) {
-                LOG_INFO(TAG, "MQTT RX parsed: threshold=%s value=%.2f", threshold_name, cmd.value);
+            if (TaskChannels::sendCommand(s_command_queue, entry->command, threshold_value)) {
+                LOG_INFO(TAG, "MQTT RX parsed: threshold=%s value=%.2f", entry->name, threshold_value);
             } else {
                 LOG_WARN(TAG, "MQTT RX queue full, dropped command");
             }
@@ -119,46 +454,95 @@ namespace {
         else if (std::strcmp(cmd_str, "update_thresholds") == 0) {
             int updated_count = 0;
             int failed_count = 0;
-            
-            // Check all known threshold names directly (mjson doesn't support iteration like cJSON)
-            const char* threshold_names[] = {
-                "temp_low_warn", "temp_low_crit", "temp_high_warn", "temp_high_crit",
-                "moisture_low_warn", "moisture_low_crit", "moisture_high_warn", "moisture_high_crit"
-            };
-            
-            for (size_t i = 0; i < sizeof(threshold_names) / sizeof(threshold_names[0]); i++) {
-                const char* threshold_name = threshold_names[i];
-                double threshold_value;
-                
-                // Build JSONPath: $.threshold_name
-                char path[80];
-                std::snprintf(path, sizeof(path), "$.%s", threshold_name);
-                
-                if (mjson_get_number(json_buf, copy_len, path, &threshold_value) == 1) {
-                    CommandType cmd_type = parseThresholdName(threshold_name);
-                    if (cmd_type != static_cast<CommandType>(0)) {
-                        Command cmd{};
-                        cmd.timestamp_ms = static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
-                        cmd.type = static_cast<int32_t>(cmd_type);
-                        cmd.value = static_cast<float>(threshold_value);
-                        
-                        if (xQueueSend(s_command_queue, &cmd, 0) == pdTRUE) {
-                            updated_count++;
-                            LOG_INFO(TAG, "MQTT RX parsed: threshold=%s value=%.2f", threshold_name, cmd.value);
-                        } else {
-                            failed_count++;
-                            LOG_WARN(TAG, "MQTT RX queue full, dropped command: %s", threshold_name);
-                        }
-                    }
+
+            // One pass over the top-level members; each key is looked up in the table
+            int key_off = 0, key_len = 0, val_off = 0, val_len = 0, val_type = 0;
+            int off = 0;
+            while ((off = mjson_next(json_buf, copy_len, off, &key_off, &key_len, &val_off, &val_len, &val_type)) > 0) {
+                // Keys come back quoted
+                if (val_type != MJSON_TOK_NUMBER || key_len < 2) {
+                    continue;
+                }
+                const ThresholdTable::Entry* entry =
+                    ThresholdTable::find(json_buf + key_off + 1, static_cast<std::size_t>(key_len - 2));
+                double threshold_value = 0.0;
+                if (entry == nullptr || mjson_get_number(json_buf + val_off, val_len, "$", &threshold_value) != 1) {
+                    continue;
+                }
+                if (TaskChannels::sendCommand(s_command_queue, entry->command, threshold_value)) {
+                    updated_count++;
+                    LOG_INFO(TAG, "MQTT RX parsed: threshold=%s value=%.2f", entry->name, threshold_value);
+                } else {
+                    failed_count++;
+                    LOG_WARN(TAG, "MQTT RX queue full, dropped command: %s", entry->name);
                 }
             }
-            
+
             if (updated_count > 0) {
                 LOG_INFO(TAG, "MQTT RX batch update: %d succeeded, %d failed", updated_count, failed_count);
             } else if (failed_count == 0) {
                 LOG_WARN(TAG, "MQTT RX batch update: no valid thresholds found");
             }
         }
+        // Field debugging: {"command": "set_log_level", "tag": "CLOUD_TASK", "level": "debug"}
+        // "level": "default" drops the override; without "tag" the global level changes.
+        // Applied here directly: no NVS, reverts on reboot.
+        else if (std::strcmp(cmd_str, "set_log_level") == 0) {
+            char tag[Logger::MAX_TAG_LEN + 1];
+            char level_name[16];
+            if (mjson_get_string(json_buf, copy_len, "$.level", level_name, sizeof(level_name)) <= 0) {
+                LOG_WARN(TAG, "MQTT RX set_log_level missing 'level' field");
+                return;
+            }
+            const bool has_tag = mjson_get_string(json_buf, copy_len, "$.tag", tag, sizeof(tag)) > 0;
+            LogLevel level = LogLevel::INFO;
+            bool ok = false;
+            if (has_tag && std::strcmp(level_name, "default") == 0) {
+                ok = Logger::clearTagLevel(tag);
+            } else if (Logger::parseLevel(level_name, level)) {
+                if (has_tag) {
+                    ok = Logger::setTagLevel(tag, level);
+                } else {
+                    Logger::setLevel(level);
+                    ok = true;
+                }
+            }
+            if (ok) {
+                LOG_INFO(TAG, "Log level %s -> %s", has_tag ? tag : "*", level_name);
+            } else {
+                LOG_WARN(TAG, "MQTT RX set_log_level rejected: tag=%s level=%s", has_tag ? tag : "*", level_name);
+            }
+        }
+        // Moisture probe calibration: {"command": "calibrate", "point": "moisture_dry"|"moisture_wet", "raw": 2710}
+        // Without "raw" the probe's current reading is captured (hold it in air / water first)
+        else if (std::strcmp(cmd_str, "calibrate") == 0) {
+            char point[32];
+            double raw = Calibration::CAPTURE_CURRENT;
+            if (mjson_get_string(json_buf, copy_len, "$.point", point, sizeof(point)) <= 0) {
+                LOG_WARN(TAG, "MQTT RX calibrate missing 'point' field");
+                return;
+            }
+            // A present "raw" must be a number; its range is checked by the command task
+            if (mjson_find(json_buf, copy_len, "$.raw", nullptr, nullptr) != MJSON_TOK_INVALID &&
+                mjson_get_number(json_buf, copy_len, "$.raw", &raw) == 0) {
+                LOG_WARN(TAG, "MQTT RX calibrate 'raw' is not a number");
+                return;
+            }
+            CommandType type;
+            if (std::strcmp(point, "moisture_dry") == 0) {
+                type = CommandType::CALIBRATE_MOISTURE_DRY;
+            } else if (std::strcmp(point, "moisture_wet") == 0) {
+                type = CommandType::CALIBRATE_MOISTURE_WET;
+            } else {
+                LOG_WARN(TAG, "MQTT RX unknown calibration point: %s", point);
+                return;
+            }
+            if (TaskChannels::sendCommand(s_command_queue, type, raw)) {
+                LOG_INFO(TAG, "MQTT RX parsed: calibrate %s raw=%.0f", point, raw);
+            } else {
+                LOG_WARN(TAG, "MQTT RX queue full, dropped command");
+            }
+        }
         else {
             LOG_WARN(TAG, "MQTT RX unknown command: %s", cmd_str);
             return;
@@ -167,6 +551,102 @@ namespace {
         // No cleanup needed - mjson uses zero allocation!
     }
 
+    static TickType_t clampElapsed(TickType_t elapsed, TickType_t limit) {
+        return (elapsed < limit) ? elapsed : limit;
+    }
+
+    static TickType_t minTicks(TickType_t a, TickType_t b) {
+        return (a < b) ? a : b;
+    }
+
+    // Alert latency: monitor enqueue (Command.timestamp_ms, tick clock) to MQTT publish
+    static void recordAlertLatency(uint32_t enqueued_ms) {
+        uint32_t latency_ms = static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS) - enqueued_ms;
+        s_loop_stats.alerts++;
+        s_loop_stats.alert_latency_sum_ms += latency_ms;
+        if (latency_ms > s_loop_stats.alert_latency_max_ms) {
+            s_loop_stats.alert_latency_max_ms = latency_ms;
+        }
+    }
+
+    // Publish one alert request from the monitor (TaskChannels::AlertHandler)
+    static void publishAlert(const AlertRequest& alert) {
+        const char* s_str = (alert.state == AlertState::CRITICAL) ? "CRITICAL"
+                           : (alert.state == AlertState::WARNING)  ? "WARNING"
+                                                                   : "OK";
+        const char* r_str = (alert.reason == AlertReason::TEMP_HIGH)       ? "temp_high"
+                           : (alert.reason == AlertReason::TEMP_LOW)       ? "temp_low"
+                           : (alert.reason == AlertReason::MOISTURE_LOW)   ? "moisture_low"
+                           : (alert.reason == AlertReason::MOISTURE_HIGH)  ? "moisture_high"
+                                                                           : "clear";
+        char topic[96];
+        char payload[192];
+        char ts[16];
+        TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+        std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::ALERT, Config::Device::id);
+        char t_str[16];
+        char m_str[16];
+        (void)FixedPoint::formatCenti(t_str, sizeof(t_str), s_last_temp_centi, 2);
+        (void)FixedPoint::formatCenti(m_str, sizeof(m_str), s_last_moisture_centi, 1);
+        std::snprintf(payload, sizeof(payload),
+                      "{\"state\":\"%s\",\"reason\":\"%s\",\"temp\":%s,\"moisture\":%s,\"ts\":\"%s\"}",
+                      s_str, r_str, t_str, m_str, ts);
+        (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, false);
+        LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
+        recordAlertLatency(alert.timestamp_ms);
+    }
+
+    static void recordWakeup(bool did_work, TickType_t now) {
+        s_loop_stats.wakeups++;
+        s_loop_stats.idle_wakeups += did_work ? 0U : 1U;
+        const TickType_t window = pdMS_TO_TICKS(Config::Tasks::Cloud::stats_window_ms);
+        if ((now - s_loop_stats.window_start) < window) {
+            return;
+        }
+        uint32_t window_ms = static_cast<uint32_t>((now - s_loop_stats.window_start) * portTICK_PERIOD_MS);
+        uint32_t per_min = static_cast<uint32_t>((static_cast<uint64_t>(s_loop_stats.wakeups) * 60000ULL) / window_ms);
+        uint32_t avg_ms = (s_loop_stats.alerts > 0) ? s_loop_stats.alert_latency_sum_ms / s_loop_stats.alerts : 0;
+        LOG_INFO(TAG, "Loop: wakeups/min=%" PRIu32 " idle=%" PRIu32 " notified=%" PRIu32 " alerts=%" PRIu32
+                      " alert_latency_avg=%" PRIu32 "ms max=%" PRIu32 "ms",
+                 per_min, s_loop_stats.idle_wakeups, s_loop_stats.notified, s_loop_stats.alerts,
+                 avg_ms, s_loop_stats.alert_latency_max_ms);
+        // Sample bus cursor lag per subscriber (max_lag near capacity means overruns are close)
+        for (size_t i = 0; s_sample_bus != nullptr && i < s_sample_bus->getSubscriberCount(); ++i) {
+            const SensorSampleBus::SubscriberStats bs = s_sample_bus->getStats(i);
+            LOG_INFO(TAG, "Bus: %s lag=%" PRIu32 " max_lag=%" PRIu32 "/%u overruns=%" PRIu32,
+                     bs.name, bs.lag, bs.max_lag, static_cast<unsigned>(s_sample_bus->getCapacity()), bs.overruns);
+        }
+        s_loop_stats = LoopStats{};
+        s_loop_stats.window_start = now;
+    }
+
+    // Take every unread sample off the bus, keeping the latest of each primary channel
+    static void drainSamples() {
+        if (s_bus_sub == nullptr) {
+            return;
+        }
+        const int t_ch = SensorRegistry::primary(SensorKind::TEMPERATURE);
+        const int m_ch = SensorRegistry::primary(SensorKind::MOISTURE);
+        SensorSample batch[8];
+        size_t n = 0;
+        while ((n = s_sample_bus->poll(*s_bus_sub, batch)) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                Trace::point(Trace::Point::CLOUD_RX, batch[i].channel, batch[i].ts_ms);
+                if (batch[i].channel == t_ch) {
+                    s_last_temp_centi = batch[i].value_centi;
+                    s_last_temp_ts = batch[i].ts_ms;
+                    s_have_temp = true;
+                    s_temp_unsent = true;
+                } else if (batch[i].channel == m_ch) {
+                    s_last_moisture_centi = batch[i].value_centi;
+                    s_last_moist_ts = batch[i].ts_ms;
+                    s_have_moist = true;
+                    s_moist_unsent = true;
+                }
+            }
+        }
+    }
+
     static void taskFunction(void* parameters) {
         (void)parameters;
         LOG_INFO(TAG, "%s", "Cloud Communication Task started");
@@ -182,26 +662,39 @@ namespace {
         (void)s_mqtt_client.init();
         s_mqtt_client.setMessageHandler(&onMqttMessage);
 
+        // Mount the flash spool; samples left from before a reset replay on first connect
+        (void)TelemetrySpool::init();
+
         // Time sync flags
         bool time_inited = false;
         bool time_synced_once = false;
 
+        // Link changes wake the loop instead of being polled
+        s_wifi_manager.setLinkHandler([](bool) { CloudCommunicationTask::notify(); });
+        s_mqtt_client.setConnectionHandler([](bool) { CloudCommunicationTask::notify(); });
+
         TickType_t last_status_time = xTaskGetTickCount();
         const TickType_t status_period = pdMS_TO_TICKS(Config::Tasks::Cloud::status_period_ms);
+        TickType_t last_metrics_time = xTaskGetTickCount();
+        const TickType_t metrics_period = pdMS_TO_TICKS(Config::Tasks::Metrics::period_ms);
+        TickType_t last_trace_export = xTaskGetTickCount();
+        const TickType_t trace_export_period = pdMS_TO_TICKS(Config::Trace::export_period_ms);
         TickType_t last_reconnect_attempt = 0;
         const TickType_t reconnect_interval = pdMS_TO_TICKS(Config::Tasks::Cloud::reconnect_interval_ms);
-
-        TemperatureData datum;
-        AlarmEvent alarm_event;
-        MoistureData moisture;
+        TickType_t last_telemetry_time = 0;
+        const TickType_t telemetry_period = pdMS_TO_TICKS(Config::Tasks::Cloud::telemetry_period_ms);
+        s_loop_stats.window_start = xTaskGetTickCount();
 
         for (;;) {
             TickType_t now = xTaskGetTickCount();
+            bool did_work = false;
+            // Keep the cursor close to the head so alerts and snapshots carry fresh values
+            drainSamples();
             bool has_ip = s_wifi_manager.hasIp();
             bool mqtt_ok = s_mqtt_client.isConnected();
 
-            // Initialize SNTP when we have IP
-            if (has_ip && !time_inited) {
+            // Initialize SNTP when we have IP (no real network behind simulated back ends)
+            if (has_ip && !time_inited && !Config::Features::simulate_hardware) {
                 TimeSync::init();
                 time_inited = true;
             }
@@ -216,6 +709,7 @@ namespace {
                 if ((now - last_reconnect_attempt) > reconnect_interval) {
                     (void)s_wifi_manager.reconnect();
                     last_reconnect_attempt = now;
+                    did_work = true;
                 }
             }
 
@@ -232,36 +726,13 @@ namespace {
                 std::snprintf(cmd_topic, sizeof(cmd_topic), Config::Mqtt::Topics::CMD, Config::Device::id);
                 (void)s_mqtt_client.subscribe(cmd_topic, Config::Mqtt::default_qos);
 
-                // Flush buffered data
-                TemperatureData buffered;
-                while (s_telemetry_buffer.pop(buffered)) {
-                    char topic[96];
-                    char payload[160];
-                    char ts[16];
-                    TimeSync::formatFixedTimestamp(ts, sizeof(ts));
-                    std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::TEMPERATURE, Config::Device::id);
-                    std::snprintf(payload, sizeof(payload),
-                                  "{\"value\":%.2f,\"ts\":\"%s\",\"buffered\":1}",
-                                  buffered.temp_c, ts);
-                    (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
-                    LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
-                    vTaskDelay(pdMS_TO_TICKS(50));
-                }
-                // Flush buffered moisture data
-                MoistureData mbuf;
-                while (s_moisture_buffer.pop(mbuf)) {
-                    char topic[96];
-                    char payload[192];
-                    char ts[16];
-                    TimeSync::formatFixedTimestamp(ts, sizeof(ts));
-                    std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::MOISTURE, Config::Device::id);
-                    std::snprintf(payload, sizeof(payload),
-                                  "{\"percent\":%.1f,\"ts\":\"%s\",\"buffered\":1}",
-                                  static_cast<double>(mbuf.moisture_percent), ts);
-                    (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
-                    LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
-                    vTaskDelay(pdMS_TO_TICKS(50));
-                }
+                // Context of the last crash first, before the backlog competes for the outbox
+                uploadCrashLog();
+
+                // Buffered data goes out in bounded steps from the loop below
+                s_backlog_pending = true;
+                s_flush_stats = BacklogFlushStats{};
+                s_flush_start_us = esp_timer_get_time();
                 // Emit current alert snapshot once per reconnect
                 {
                     auto st = DeviceStateMachine::get();
@@ -290,142 +761,137 @@ namespace {
                     if (rf & DeviceStateMachine::REASON_TEMP_LOW)   append_reason("temp_low");
                     if (rf & DeviceStateMachine::REASON_MOIST_LOW)  append_reason("moisture_low");
                     if (rf & DeviceStateMachine::REASON_MOIST_HIGH) append_reason("moisture_high");
+                    char t_str[16];
+                    char m_str[16];
+                    (void)FixedPoint::formatCenti(t_str, sizeof(t_str), s_last_temp_centi, 2);
+                    (void)FixedPoint::formatCenti(m_str, sizeof(m_str), s_last_moisture_centi, 1);
                     if (first_reason) {
                         std::snprintf(payload, sizeof(payload),
-                                      "{\"state\":\"%s\",\"temp\":%.2f,\"moisture\":%.1f,\"ts\":\"%s\",\"snapshot\":1}",
-                                      s_str, s_last_temp_c, s_last_moisture_pct, ts);
+                                      "{\"state\":\"%s\",\"temp\":%s,\"moisture\":%s,\"ts\":\"%s\",\"snapshot\":1}",
+                                      s_str, t_str, m_str, ts);
                     } else {
                         std::snprintf(payload, sizeof(payload),
-                                      "{\"state\":\"%s\",\"reasons\":[%s],\"temp\":%.2f,\"moisture\":%.1f,\"ts\":\"%s\",\"snapshot\":1}",
-                                      s_str, reasons_str, s_last_temp_c, s_last_moisture_pct, ts);
+                                      "{\"state\":\"%s\",\"reasons\":[%s],\"temp\":%s,\"moisture\":%s,\"ts\":\"%s\",\"snapshot\":1}",
+                                      s_str, reasons_str, t_str, m_str, ts);
                     }
                     (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, false);
                     LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
                 }
                 s_post_connect_pending = false;
+                did_work = true;
             }
 
-            // Read latest temperature from forward queue (non-blocking)
-            if (s_temperature_mqtt_queue != nullptr) {
-                if (xQueueReceive(s_temperature_mqtt_queue, &datum, 0) == pdTRUE) {
-                    s_last_temp_c = datum.temp_c;
-                    s_have_temp = true;
+            // Backlog: a few batches per pass, paced by outbox depth, between live work
+            if (s_backlog_pending && s_mqtt_client.isConnected()) {
+                if (flushBacklogStep() != FlushResult::MORE) {
+                    s_backlog_pending = false;
+                    if (s_flush_stats.samples > 0) {
+                        LOG_INFO(TAG, "Backlog flushed: samples=%" PRIu32 " messages=%" PRIu32 " bytes=%" PRIu32
+                                 " spool_corrupt=%" PRIu32 " elapsed_ms=%" PRIu32,
+                                 s_flush_stats.samples, s_flush_stats.messages, s_flush_stats.bytes,
+                                 TelemetrySpool::getStats().corrupt,
+                                 static_cast<uint32_t>((esp_timer_get_time() - s_flush_start_us) / 1000));
+                    }
                 }
+                did_work = true;
             }
-            // Emit temperature at most every telemetry_period_ms
-            if (s_have_temp) {
-                const TickType_t telemetry_period = pdMS_TO_TICKS(Config::Tasks::Cloud::telemetry_period_ms);
-                if ((now - s_last_temp_emit) >= telemetry_period) {
+
+            // Telemetry deadline: publish the latest primary-channel values taken off the bus
+            if ((now - last_telemetry_time) >= telemetry_period) {
+                if (s_have_temp) {
                     if (s_mqtt_client.isConnected()) {
+                        const uint8_t trace_channel = static_cast<uint8_t>(SensorRegistry::primary(SensorKind::TEMPERATURE));
+                        Trace::point(Trace::Point::PUBLISH_BEGIN, trace_channel, s_last_temp_ts);
                         char topic[96];
-                        char payload[160];
-                        char ts[16];
-                        TimeSync::formatFixedTimestamp(ts, sizeof(ts));
                         std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::TEMPERATURE, Config::Device::id);
-                        std::snprintf(payload, sizeof(payload),
-                                      "{\"value\":%.2f,\"ts\":\"%s\"}",
-                                      s_last_temp_c, ts);
-                        (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
-                        LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
-                    } else {
-                        // Buffer latest temperature for post-connect flush
+                        if (Config::Mqtt::Encoding::temperature == Config::Mqtt::PayloadFormat::BINARY) {
+                            (void)publishBinarySample(topic, TelemetryCodec::Kind::TEMPERATURE, s_last_temp_centi, s_last_temp_ts);
+                        } else {
+                            char payload[160];
+                            char ts[16];
+                            char value[16];
+                            TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+                            (void)FixedPoint::formatCenti(value, sizeof(value), s_last_temp_centi, 2);
+                            std::snprintf(payload, sizeof(payload),
+                                          "{\"value\":%s,\"ts\":\"%s\"}",
+                                          value, ts);
+                            (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
+                            LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
+                        }
+                        Trace::point(Trace::Point::PUBLISH_END, trace_channel, s_last_temp_ts);
+                        PipelineBench::onPublish(s_last_temp_ts);
+                        s_temp_unsent = false;
+                    } else if (s_temp_unsent) {
+                        // Buffer the new temperature sample for post-connect flush
                         TemperatureData buffered{};
-                        buffered.temp_c = s_last_temp_c;
-                        buffered.ts_ms = static_cast<uint32_t>(now * portTICK_PERIOD_MS);
+                        buffered.temp_centi_c = static_cast<int16_t>(s_last_temp_centi);
+                        buffered.ts_ms = s_last_temp_ts; // capture time, mapped to epoch at flush
+                        if (s_telemetry_buffer.isFull()) {
+                            spillToSpool(true);
+                        }
                         (void)s_telemetry_buffer.push(buffered);
+                        spillToSpool(false);
+                        s_temp_unsent = false;
                     }
-                    s_last_temp_emit = now;
                 }
-            }
-
-            // Drain alarm queue (no longer publish legacy alarm topic)
-            if (s_alarm_queue != nullptr) {
-                while (xQueueReceive(s_alarm_queue, &alarm_event, 0) == pdTRUE) {
-                    // intentionally ignored for MQTT
-                    (void)alarm_event;
-                }
-            }
-
-            // Read latest moisture from forward queue (non-blocking)
-            if (s_moisture_mqtt_queue != nullptr) {
-                if (xQueueReceive(s_moisture_mqtt_queue, &moisture, 0) == pdTRUE) {
-                    s_last_moisture_pct = moisture.moisture_percent;
-                    s_have_moist = true;
-                }
-            }
-            // Emit moisture at most every telemetry_period_ms
-            if (s_have_moist) {
-                const TickType_t telemetry_period = pdMS_TO_TICKS(Config::Tasks::Cloud::telemetry_period_ms);
-                if ((now - s_last_moist_emit) >= telemetry_period) {
+                if (s_have_moist) {
                     if (s_mqtt_client.isConnected()) {
+                        const uint8_t trace_channel = static_cast<uint8_t>(SensorRegistry::primary(SensorKind::MOISTURE));
+                        Trace::point(Trace::Point::PUBLISH_BEGIN, trace_channel, s_last_moist_ts);
                         char topic[96];
-                        char payload[160];
-                        char ts[16];
-                        TimeSync::formatFixedTimestamp(ts, sizeof(ts));
                         std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::MOISTURE, Config::Device::id);
-                        std::snprintf(payload, sizeof(payload),
-                                      "{\"percent\":%.1f,\"ts\":\"%s\"}",
-                                      static_cast<double>(s_last_moisture_pct),
-                                      ts);
-                        (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
-                        LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
-                    } else {
-                        // Buffer latest moisture for post-connect flush
+                        if (Config::Mqtt::Encoding::moisture == Config::Mqtt::PayloadFormat::BINARY) {
+                            (void)publishBinarySample(topic, TelemetryCodec::Kind::MOISTURE, s_last_moisture_centi, s_last_moist_ts);
+                        } else {
+                            char payload[160];
+                            char ts[16];
+                            char percent[16];
+                            TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+                            (void)FixedPoint::formatCenti(percent, sizeof(percent), s_last_moisture_centi, 1);
+                            std::snprintf(payload, sizeof(payload),
+                                          "{\"percent\":%s,\"ts\":\"%s\"}",
+                                          percent, ts);
+                            (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain);
+                            LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
+                        }
+                        Trace::point(Trace::Point::PUBLISH_END, trace_channel, s_last_moist_ts);
+                        PipelineBench::onPublish(s_last_moist_ts);
+                        s_moist_unsent = false;
+                    } else if (s_moist_unsent) {
+                        // Buffer the new moisture sample for post-connect flush
                         MoistureData buffered{};
-                        buffered.moisture_percent = s_last_moisture_pct;
+                        buffered.moisture_centi_pct = static_cast<uint16_t>(s_last_moisture_centi);
                         buffered.moisture_raw = 0;
-                        buffered.ts_ms = static_cast<uint32_t>(now * portTICK_PERIOD_MS);
+                        buffered.ts_ms = s_last_moist_ts; // capture time, mapped to epoch at flush
+                        if (s_moisture_buffer.isFull()) {
+                            spillToSpool(true);
+                        }
                         (void)s_moisture_buffer.push(buffered);
+                        spillToSpool(false);
+                        s_moist_unsent = false;
                     }
-                    s_last_moist_emit = now;
                 }
+                last_telemetry_time = PowerManager::slotStart(now);
+                did_work = true;
             }
 
-            // Handle internal alert publish requests via command queue:
-            // Command.type = state (0 OK, 1 WARNING, 2 CRITICAL), Command.value = reason (0 CLEAR,1 TEMP_HIGH,2 TEMP_LOW,3 MOISTURE_LOW,4 MOISTURE_HIGH)
-            // Only process internal commands (type >= 0); external commands (type < 0) are handled by command task
-            if (s_command_queue != nullptr && s_mqtt_client.isConnected()) {
-                Command cmd{};
-                // Peek at queue without removing items, process only internal commands
-                // Note: FreeRTOS doesn't have peek, so we receive and put back external commands
-                int processed = 0;
-                const int max_iterations = 16; // Limit iterations to avoid infinite loop
-                while (processed < max_iterations && xQueueReceive(s_command_queue, &cmd, 0) == pdTRUE) {
-                    // Skip external commands (negative type values) - put back for command task
-                    if (cmd.type < 0) {
-                        // Put it back at front so command task (blocking) will get it
-                        (void)xQueueSendToFront(s_command_queue, &cmd, 0);
-                        break; // Exit to avoid consuming all external commands
-                    }
-                    // Process internal command
-                    int state = cmd.type;
-                    int reason = static_cast<int>(cmd.value);
-                    const char* s_str = (state == 2) ? "CRITICAL" : (state == 1) ? "WARNING" : "OK";
-                    const char* r_str = (reason == 1) ? "temp_high" : (reason == 2) ? "temp_low"
-                                         : (reason == 3) ? "moisture_low" : (reason == 4) ? "moisture_high" : "clear";
-                    char topic[96];
-                    char payload[192];
-                    char ts[16];
-                    TimeSync::formatFixedTimestamp(ts, sizeof(ts));
-                    std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::ALERT, Config::Device::id);
-                    std::snprintf(payload, sizeof(payload),
-                                  "{\"state\":\"%s\",\"reason\":\"%s\",\"temp\":%.2f,\"moisture\":%.1f,\"ts\":\"%s\"}",
-                                  s_str, r_str, s_last_temp_c, s_last_moisture_pct, ts);
-                    (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, false);
-                    LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
-                    processed++;
-                }
+            // Alert publish requests from the monitor (this task is the only consumer)
+            if (s_mqtt_client.isConnected() && TaskChannels::drainAlerts(s_alert_queue, publishAlert) > 0) {
+                did_work = true;
             }
 
             // Periodic status
-            if ((now - last_status_time) > status_period && s_mqtt_client.isConnected()) {
+            if ((now - last_status_time) >= status_period && s_mqtt_client.isConnected()) {
                 char topic[96];
-                char payload[256];
+                char payload[320];
                 std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::STATUS, Config::Device::id);
                 uint32_t uptime_ms = static_cast<uint32_t>(now * portTICK_PERIOD_MS);
                 uint32_t buffered_temp = static_cast<uint32_t>(s_telemetry_buffer.getCount());
                 uint32_t buffered_moist = static_cast<uint32_t>(s_moisture_buffer.getCount());
                 uint32_t buffered_total = buffered_temp + buffered_moist;
+                uint32_t spooled = TelemetrySpool::pendingCount();
+                uint32_t spool_corrupt = TelemetrySpool::getStats().corrupt;
+                uint32_t nvs_commits = RuntimeThresholds::flashCommits();
                 // Read device state
                 auto st = DeviceStateMachine::get();
                 const char* st_str = (st == DeviceStateMachine::DeviceState::CRITICAL) ? "CRITICAL"
@@ -455,55 +921,91 @@ namespace {
                 }
                 if (first) {
                     std::snprintf(payload, sizeof(payload),
-                                  "{\"status\":\"online\",\"uptime_ms\":%" PRIu32 ",\"buffered\":%" PRIu32 ",\"buffered_temp\":%" PRIu32 ",\"buffered_moist\":%" PRIu32 ",\"state\":\"%s\"}",
-                                  uptime_ms, buffered_total, buffered_temp, buffered_moist, st_str);
+                                  "{\"status\":\"online\",\"uptime_ms\":%" PRIu32 ",\"buffered\":%" PRIu32 ",\"buffered_temp\":%" PRIu32 ",\"buffered_moist\":%" PRIu32 ",\"spooled\":%" PRIu32 ",\"spool_corrupt\":%" PRIu32 ",\"nvs_commits\":%" PRIu32 ",\"state\":\"%s\"}",
+                                  uptime_ms, buffered_total, buffered_temp, buffered_moist, spooled, spool_corrupt, nvs_commits, st_str);
                 } else {
                     std::snprintf(payload, sizeof(payload),
-                                  "{\"status\":\"online\",\"uptime_ms\":%" PRIu32 ",\"buffered\":%" PRIu32 ",\"buffered_temp\":%" PRIu32 ",\"buffered_moist\":%" PRIu32 ",\"state\":\"%s\",\"reasons\":[%s]}",
-                                  uptime_ms, buffered_total, buffered_temp, buffered_moist, st_str, reasons_str);
+                                  "{\"status\":\"online\",\"uptime_ms\":%" PRIu32 ",\"buffered\":%" PRIu32 ",\"buffered_temp\":%" PRIu32 ",\"buffered_moist\":%" PRIu32 ",\"spooled\":%" PRIu32 ",\"spool_corrupt\":%" PRIu32 ",\"nvs_commits\":%" PRIu32 ",\"state\":\"%s\",\"reasons\":[%s]}",
+                                  uptime_ms, buffered_total, buffered_temp, buffered_moist, spooled, spool_corrupt, nvs_commits, st_str, reasons_str);
                 }
                 (void)s_mqtt_client.publish(topic, payload, Config::Mqtt::default_qos, true);
                 LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
-                last_status_time = now;
+                last_status_time = PowerManager::slotStart(now);
+                did_work = true;
+            }
+
+            // Latency trace export
+            if (Trace::enabled() && (now - last_trace_export) >= trace_export_period && s_mqtt_client.isConnected()) {
+                uploadTrace();
+                last_trace_export = PowerManager::slotStart(now);
+                did_work = true;
             }
 
-            // Drain thresholds-changed publish requests from command task
+            // Periodic task / stack / heap metrics
+            if ((now - last_metrics_time) >= metrics_period) {
+                publishMetrics();
+                last_metrics_time = PowerManager::slotStart(now);
+                did_work = true;
+            }
+
+            // Thresholds-changed publish requests from command task
             if (s_thresholds_changed_queue != nullptr && s_mqtt_client.isConnected()) {
                 CloudPublishRequest req;
-                int drained = 0;
-                const int max_drain = 8;
-                while (drained < max_drain && xQueueReceive(s_thresholds_changed_queue, &req, 0) == pdTRUE) {
+                while (xQueueReceive(s_thresholds_changed_queue, &req, 0) == pdTRUE) {
                     (void)s_mqtt_client.publish(req.topic, req.payload, Config::Mqtt::default_qos, false);
                     LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", req.topic, req.payload);
-                    drained++;
-                    vTaskDelay(pdMS_TO_TICKS(10));
+                    did_work = true;
                 }
             }
 
-            vTaskDelay(pdMS_TO_TICKS(100));
+            // Block until the nearest deadline or until notify() signals new work
+            now = xTaskGetTickCount();
+            TickType_t wait = telemetry_period - clampElapsed(now - last_telemetry_time, telemetry_period);
+            wait = minTicks(wait, metrics_period - clampElapsed(now - last_metrics_time, metrics_period));
+            if (s_mqtt_client.isConnected()) {
+                wait = minTicks(wait, status_period - clampElapsed(now - last_status_time, status_period));
+                if (Trace::enabled()) {
+                    wait = minTicks(wait, trace_export_period - clampElapsed(now - last_trace_export, trace_export_period));
+                }
+            }
+            if (s_backlog_pending && s_mqtt_client.isConnected()) {
+                wait = minTicks(wait, pdMS_TO_TICKS(Config::Tasks::Backlog::pacing_poll_ms));
+            }
+            if (!s_wifi_manager.hasIp()) {
+                wait = minTicks(wait, reconnect_interval + 1U - clampElapsed(now - last_reconnect_attempt, reconnect_interval + 1U));
+            }
+            // Low-power mode: deadlines snap to the shared wake slots
+            wait = PowerManager::alignWait(now, wait);
+            recordWakeup(did_work, now);
+            const bool notified = ulTaskNotifyTake(pdTRUE, wait) > 0;
+            s_loop_stats.notified += notified ? 1U : 0U;
+            PowerManager::noteWake(xTaskGetTickCount());
         }
     }
 } // namespace
 
 namespace CloudCommunicationTask {
-    void create(QueueHandle_t temperature_mqtt_queue,
-                QueueHandle_t alarm_queue,
+    void create(SensorSampleBus* sample_bus,
                 QueueHandle_t command_queue,
-                QueueHandle_t moisture_mqtt_queue,
+                QueueHandle_t alert_queue,
                 QueueHandle_t thresholds_changed_queue) {
-        s_temperature_mqtt_queue = temperature_mqtt_queue;
-        s_alarm_queue = alarm_queue;
+        s_sample_bus = sample_bus;
+        s_bus_sub = sample_bus->subscribe("cloud");
         s_command_queue = command_queue;
-        s_moisture_mqtt_queue = moisture_mqtt_queue;
+        s_alert_queue = alert_queue;
         s_thresholds_changed_queue = thresholds_changed_queue;
-        xTaskCreateStatic(taskFunction,
-                          "cloud_comm",
-                          sizeof(s_task_stack) / sizeof(StackType_t),
-                          nullptr,
-                          Config::TaskPriorities::NORMAL,
-                          s_task_stack,
-                          &s_task_tcb);
+        s_task_handle = xTaskCreateStatic(taskFunction,
+                                          "cloud_comm",
+                                          sizeof(s_task_stack) / sizeof(StackType_t),
+                                          nullptr,
+                                          Config::TaskPriorities::NORMAL,
+                                          s_task_stack,
+                                          &s_task_tcb);
     }
-}
-
 
+    void notify() {
+        if (s_task_handle != nullptr) {
+            (void)xTaskNotifyGive(s_task_handle);
+        }
+    }
+}
@@ -3,15 +3,19 @@
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <main/tasks/sensor_scheduler_task.hpp>
 
 namespace CloudCommunicationTask {
-    void create(QueueHandle_t temperature_mqtt_queue,
-                QueueHandle_t alarm_queue,
+    // Subscribes to sample_bus for telemetry (latest value of each primary channel)
+    void create(SensorSampleBus* sample_bus,
                 QueueHandle_t command_queue,
-                QueueHandle_t moisture_mqtt_queue,
+                QueueHandle_t alert_queue,
                 QueueHandle_t thresholds_changed_queue);
+
+    // Wake the cloud task after queueing work for it (alert_queue, threshold ACKs).
+    // The task otherwise sleeps until its next status/telemetry/reconnect deadline.
+    // Task context only; no-op before create().
+    void notify();
 }
 
 #endif // CLOUD_COMMUNICATION_TASK_HPP
-
-
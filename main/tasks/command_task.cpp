@@ -6,9 +6,13 @@
 #include <main/models/command.hpp>
 #include <main/config/config.hpp>
 #include <main/state/runtime_thresholds.hpp>
+#include <main/state/threshold_table.hpp>
+#include <main/state/calibration.hpp>
 #include <main/models/cloud_publish_request.hpp>
 #include <main/utils/time_sync.hpp>
 #include <main/utils/third-party/mjson.h>
+#include <main/tasks/cloud_communication_task.hpp>
+#include <main/tasks/task_channels.hpp>
 #include <inttypes.h>
 #include <cstring>
 #include <cstdio>
@@ -22,202 +26,47 @@ namespace {
     static QueueHandle_t s_command_queue = nullptr;
     static QueueHandle_t s_thresholds_changed_queue = nullptr;
 
-    // Validate threshold value ranges
-    static bool validateTempThreshold(float value) {
-        // Reasonable range: -50 to 100 degrees Celsius
-        return (value >= -50.0f && value <= 100.0f);
-    }
-
-    static bool validateMoistureThreshold(float value) {
-        // Reasonable range: 0 to 100 percent
-        return (value >= 0.0f && value <= 100.0f);
-    }
-
-    static void handleCommand(const Command& cmd) {
-        CommandType cmd_type = static_cast<CommandType>(cmd.type);
-
-        // Only process external commands (negative type values)
-        // Internal commands (non-negative) are handled by cloud task
-        if (cmd.type >= 0) {
-            return; // Not our command, ignore
-        }
-
-        bool success = false;
-        const char* threshold_name = nullptr;
-
-        switch (cmd_type) {
-            case CommandType::UPDATE_TEMP_LOW_WARN:
-                if (validateTempThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setTempLowWarn(cmd.value);
-                    threshold_name = "temp_low_warn";
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_low_warn value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_TEMP_LOW_CRIT:
-                if (validateTempThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setTempLowCrit(cmd.value);
-                    threshold_name = "temp_low_crit";
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_low_crit value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_TEMP_HIGH_WARN:
-                if (validateTempThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setTempHighWarn(cmd.value);
-                    threshold_name = "temp_high_warn";
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_high_warn value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_TEMP_HIGH_CRIT:
-                if (validateTempThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setTempHighCrit(cmd.value);
-                    threshold_name = "temp_high_crit";
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_high_crit value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_MOISTURE_LOW_WARN:
-                if (validateMoistureThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setMoistureLowWarn(cmd.value);
-                    threshold_name = "moisture_low_warn";
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_low_warn value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_MOISTURE_LOW_CRIT:
-                if (validateMoistureThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setMoistureLowCrit(cmd.value);
-                    threshold_name = "moisture_low_crit";
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_low_crit value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_MOISTURE_HIGH_WARN:
-                if (validateMoistureThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setMoistureHighWarn(cmd.value);
-                    threshold_name = "moisture_high_warn";
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_high_warn value: %.2f", cmd.value);
-                }
-                break;
-
-            case CommandType::UPDATE_MOISTURE_HIGH_CRIT:
-                if (validateMoistureThreshold(cmd.value)) {
-                    success = RuntimeThresholds::setMoistureHighCrit(cmd.value);
-                    threshold_name = "moisture_high_crit";
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_high_crit value: %.2f", cmd.value);
-                }
-                break;
-
-            default:
-                LOG_WARN(TAG, "Unknown command type: %" PRId32, cmd.type);
-                return;
-        }
-
-        if (success && threshold_name != nullptr) {
-            LOG_INFO(TAG, "Command executed: %s = %.2f", threshold_name, cmd.value);
-        } else if (threshold_name != nullptr) {
-            LOG_ERROR(TAG, "Command failed: %s = %.2f", threshold_name, cmd.value);
-        }
-    }
-
+    // Accepted this window, indexed like ThresholdTable::ENTRIES
     struct ThresholdChanges {
-        bool temp_low_warn = false;
-        bool temp_low_crit = false;
-        bool temp_high_warn = false;
-        bool temp_high_crit = false;
-        bool moisture_low_warn = false;
-        bool moisture_low_crit = false;
-        bool moisture_high_warn = false;
-        bool moisture_high_crit = false;
-
-        float v_temp_low_warn = 0.0f;
-        float v_temp_low_crit = 0.0f;
-        float v_temp_high_warn = 0.0f;
-        float v_temp_high_crit = 0.0f;
-        float v_moisture_low_warn = 0.0f;
-        float v_moisture_low_crit = 0.0f;
-        float v_moisture_high_warn = 0.0f;
-        float v_moisture_high_crit = 0.0f;
+        bool  threshold[ThresholdTable::COUNT] = {};
+        float v_threshold[ThresholdTable::COUNT] = {};
+        bool moisture_raw_dry = false;
+        bool moisture_raw_wet = false;
+        float v_moisture_raw_dry = 0.0f;
+        float v_moisture_raw_wet = 0.0f;
     };
 
-    static bool applyAndRecordChange(const Command& cmd, ThresholdChanges& changes) {
+    // Threshold commands are staged in batch (committed once per window);
+    // calibration commands apply immediately
+    static bool applyAndRecordChange(const Command& cmd, ThresholdChanges& changes, RuntimeThresholds::Batch& batch) {
         CommandType t = static_cast<CommandType>(cmd.type);
+        if (const ThresholdTable::Entry* e = ThresholdTable::byCommand(t)) {
+            if (!e->valid(cmd.value)) {
+                LOG_ERROR(TAG, "Invalid %s value: %.2f", e->name, cmd.value);
+                return false;
+            }
+            if (!batch.set(e->field, cmd.value)) {
+                return false;
+            }
+            const std::size_t i = ThresholdTable::indexOf(*e);
+            changes.threshold[i] = true;
+            changes.v_threshold[i] = cmd.value;
+            return true;
+        }
+
         bool ok = false;
         switch (t) {
-            case CommandType::UPDATE_TEMP_LOW_WARN:
-                if (validateTempThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setTempLowWarn(cmd.value);
-                    if (ok) { changes.temp_low_warn = true; changes.v_temp_low_warn = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_low_warn value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_TEMP_LOW_CRIT:
-                if (validateTempThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setTempLowCrit(cmd.value);
-                    if (ok) { changes.temp_low_crit = true; changes.v_temp_low_crit = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_low_crit value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_TEMP_HIGH_WARN:
-                if (validateTempThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setTempHighWarn(cmd.value);
-                    if (ok) { changes.temp_high_warn = true; changes.v_temp_high_warn = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_high_warn value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_TEMP_HIGH_CRIT:
-                if (validateTempThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setTempHighCrit(cmd.value);
-                    if (ok) { changes.temp_high_crit = true; changes.v_temp_high_crit = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid temp_high_crit value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_MOISTURE_LOW_WARN:
-                if (validateMoistureThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setMoistureLowWarn(cmd.value);
-                    if (ok) { changes.moisture_low_warn = true; changes.v_moisture_low_warn = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_low_warn value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_MOISTURE_LOW_CRIT:
-                if (validateMoistureThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setMoistureLowCrit(cmd.value);
-                    if (ok) { changes.moisture_low_crit = true; changes.v_moisture_low_crit = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_low_crit value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_MOISTURE_HIGH_WARN:
-                if (validateMoistureThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setMoistureHighWarn(cmd.value);
-                    if (ok) { changes.moisture_high_warn = true; changes.v_moisture_high_warn = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_high_warn value: %.2f", cmd.value);
-                }
-                break;
-            case CommandType::UPDATE_MOISTURE_HIGH_CRIT:
-                if (validateMoistureThreshold(cmd.value)) {
-                    ok = RuntimeThresholds::setMoistureHighCrit(cmd.value);
-                    if (ok) { changes.moisture_high_crit = true; changes.v_moisture_high_crit = cmd.value; }
-                } else {
-                    LOG_ERROR(TAG, "Invalid moisture_high_crit value: %.2f", cmd.value);
+            case CommandType::CALIBRATE_MOISTURE_DRY:
+            case CommandType::CALIBRATE_MOISTURE_WET: {
+                const bool dry = (t == CommandType::CALIBRATE_MOISTURE_DRY);
+                uint16_t raw = 0;
+                if (Calibration::resolveMoistureRaw(cmd.value, raw)) {
+                    ok = dry ? Calibration::setMoistureDry(raw) : Calibration::setMoistureWet(raw);
+                    if (ok && dry) { changes.moisture_raw_dry = true; changes.v_moisture_raw_dry = raw; }
+                    if (ok && !dry) { changes.moisture_raw_wet = true; changes.v_moisture_raw_wet = raw; }
                 }
                 break;
+            }
             default:
                 // Ignore non-threshold or internal commands
                 break;
@@ -225,19 +74,28 @@ namespace {
         return ok;
     }
 
-    static void publishAckIfAny(const ThresholdChanges& changes) {
+    struct BatchContext {
+        ThresholdChanges& changes;
+        RuntimeThresholds::Batch& batch;
+    };
+
+    // TaskChannels::CommandHandler for one batch window
+    static void stageCommand(const Command& cmd, void* ctx) {
+        BatchContext& c = *static_cast<BatchContext*>(ctx);
+        (void)applyAndRecordChange(cmd, c.changes, c.batch);
+    }
+
+    // persisted: every change in the ACK is already in NVS. Threshold writes are
+    // deferred (RuntimeThresholds::commit), so an ACK right after a commit usually
+    // reports them applied but not yet persisted.
+    static void publishAckIfAny(const ThresholdChanges& changes, bool persisted) {
         if (s_thresholds_changed_queue == nullptr) {
             return;
         }
-        // Count changes
-        int count = (changes.temp_low_warn ? 1 : 0) +
-                    (changes.temp_low_crit ? 1 : 0) +
-                    (changes.temp_high_warn ? 1 : 0) +
-                    (changes.temp_high_crit ? 1 : 0) +
-                    (changes.moisture_low_warn ? 1 : 0) +
-                    (changes.moisture_low_crit ? 1 : 0) +
-                    (changes.moisture_high_warn ? 1 : 0) +
-                    (changes.moisture_high_crit ? 1 : 0);
+        int count = (changes.moisture_raw_dry ? 1 : 0) + (changes.moisture_raw_wet ? 1 : 0);
+        for (bool changed : changes.threshold) {
+            count += changed ? 1 : 0;
+        }
         if (count == 0) {
             return;
         }
@@ -254,34 +112,33 @@ namespace {
         int off = 0;
         bool first = true;
         
-        auto append_field = [&](const char* name, float value, const char* fmt) {
+        auto append_field = [&](const char* name, float value, int decimals) {
             if (off < static_cast<int>(sizeof(changes_json))) {
                 off += std::snprintf(changes_json + off, sizeof(changes_json) - off,
-                                    "%s\"%s\":", first ? "" : ",", name);
-                off += std::snprintf(changes_json + off, sizeof(changes_json) - off,
-                                    fmt, static_cast<double>(value));
+                                    "%s\"%s\":%.*f", first ? "" : ",", name,
+                                    decimals, static_cast<double>(value));
                 first = false;
             }
         };
-        
-        if (changes.temp_low_warn)  append_field("temp_low_warn",  changes.v_temp_low_warn,  "%.2f");
-        if (changes.temp_low_crit)  append_field("temp_low_crit",  changes.v_temp_low_crit,  "%.2f");
-        if (changes.temp_high_warn) append_field("temp_high_warn", changes.v_temp_high_warn, "%.2f");
-        if (changes.temp_high_crit) append_field("temp_high_crit", changes.v_temp_high_crit, "%.2f");
-        if (changes.moisture_low_warn)  append_field("moisture_low_warn",  changes.v_moisture_low_warn,  "%.1f");
-        if (changes.moisture_low_crit)  append_field("moisture_low_crit",  changes.v_moisture_low_crit,  "%.1f");
-        if (changes.moisture_high_warn) append_field("moisture_high_warn", changes.v_moisture_high_warn, "%.1f");
-        if (changes.moisture_high_crit) append_field("moisture_high_crit", changes.v_moisture_high_crit, "%.1f");
+
+        for (std::size_t i = 0; i < ThresholdTable::COUNT; ++i) {
+            if (changes.threshold[i]) {
+                append_field(ThresholdTable::ENTRIES[i].name, changes.v_threshold[i], ThresholdTable::ENTRIES[i].decimals);
+            }
+        }
+        if (changes.moisture_raw_dry) append_field("moisture_raw_dry", changes.v_moisture_raw_dry, 0);
+        if (changes.moisture_raw_wet) append_field("moisture_raw_wet", changes.v_moisture_raw_wet, 0);
 
         // Assemble final JSON using mjson_snprintf (zero allocation)
         mjson_snprintf(req.payload, sizeof(req.payload),
-                       "{\"changes\":{%s},\"ts\":\"%s\",\"status\":\"ok\"}",
-                       changes_json, ts);
+                       "{\"changes\":{%s},\"ts\":\"%s\",\"status\":\"ok\",\"persisted\":%s}",
+                       changes_json, ts, persisted ? "true" : "false");
 
         if (xQueueSend(s_thresholds_changed_queue, &req, 0) != pdTRUE) {
             LOG_WARN(TAG, "%s", "thresholds_changed_queue full, dropped thresholds-changed ACK");
         } else {
             LOG_INFO(TAG, "Enqueued thresholds-changed ACK: %s", req.payload);
+            CloudCommunicationTask::notify();
         }
     }
 
@@ -289,44 +146,33 @@ namespace {
         (void)arg;
         LOG_INFO(TAG, "%s", "Command Task started");
 
-        Command cmd;
         for (;;) {
-            // Block waiting for commands
-            if (xQueueReceive(s_command_queue, &cmd, portMAX_DELAY) != pdTRUE) {
-                continue;
-            }
-            // Only handle external threshold updates here
-            if (cmd.type >= 0) {
+            // This task is the only consumer of command_queue (MQTT threshold updates).
+            // Block for the first command, then stage whatever else arrives within the
+            // batch window; commit and acknowledge the whole window once.
+            ThresholdChanges changes{};
+            RuntimeThresholds::Batch batch;
+            BatchContext ctx{changes, batch};
+            if (TaskChannels::receiveCommandBatch(s_command_queue, portMAX_DELAY, pdMS_TO_TICKS(50), pdMS_TO_TICKS(5),
+                                                  stageCommand, &ctx) == 0) {
                 continue;
             }
 
-            // Start batch: apply first command and then accumulate changes for a brief window
-            ThresholdChanges changes{};
-            (void)applyAndRecordChange(cmd, changes);
-
-            TickType_t start = xTaskGetTickCount();
-            const TickType_t window = pdMS_TO_TICKS(50);
-            for (;;) {
-                // If window elapsed, stop accumulating
-                if ((xTaskGetTickCount() - start) > window) {
-                    break;
-                }
-                Command next{};
-                if (xQueueReceive(s_command_queue, &next, 0) == pdTRUE) {
-                    if (next.type < 0) {
-                        (void)applyAndRecordChange(next, changes);
-                    } else {
-                        // Not ours; push back to front for the other consumer
-                        (void)xQueueSendToFront(s_command_queue, &next, 0);
-                        break;
-                    }
-                } else {
-                    // brief sleep within window to allow queue to fill
-                    vTaskDelay(pdMS_TO_TICKS(5));
+            // One publish and one (deferred) NVS write for the whole window
+            if (batch.size() > 0 && !RuntimeThresholds::commit(batch)) {
+                LOG_ERROR(TAG, "Threshold batch of %u failed to persist", static_cast<unsigned>(batch.size()));
+                // Calibration points were saved on their own; only they are acknowledged
+                for (bool& changed : changes.threshold) {
+                    changed = false;
                 }
             }
 
-            publishAckIfAny(changes);
+            // Calibration points were written synchronously; thresholds may still be queued
+            bool thresholds_changed = false;
+            for (bool changed : changes.threshold) {
+                thresholds_changed = thresholds_changed || changed;
+            }
+            publishAckIfAny(changes, !(thresholds_changed && RuntimeThresholds::writePending()));
         }
     }
 }
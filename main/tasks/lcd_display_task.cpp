@@ -1,8 +1,11 @@
 #include <main/tasks/lcd_display_task.hpp>
 #include <main/hardware/i2c_rgb_lcd.hpp>
+#include <main/hardware/sensor_registry.hpp>
 #include <main/config/config.hpp>
+#include <main/utils/fixed_point.hpp>
 #include <main/utils/logger.hpp>
 #include <freertos/task.h>
+#include <cstdio>
 #include <cstring>
 #include <driver/i2c.h>
 
@@ -13,6 +16,8 @@ namespace {
 	static StaticTask_t s_task_tcb;
 	static StackType_t s_task_stack[3072 / sizeof(StackType_t)];
 	static QueueHandle_t s_lcd_queue = nullptr;
+	static SensorSampleBus* s_bus = nullptr;
+	static SensorSampleBus::Subscriber* s_bus_sub = nullptr;
 	static bool s_task_created = false;
 
 	static bool installI2cIfNeeded() {
@@ -40,6 +45,7 @@ namespace {
 	}
 
 	static void scanI2cBus() {
+		if (Config::Features::simulate_hardware) return;
 		if (!installI2cIfNeeded()) return;
 		static uint8_t link_buffer[128];
 		const i2c_port_t port = static_cast<i2c_port_t>(Config::Hardware::Lcd::i2c_port);
@@ -120,6 +126,37 @@ namespace {
 		}
 	}
 
+	// Line 1 from the newest samples of the primary channel of each kind. Returns
+	// false when no new sample arrived since the last call.
+	static bool readingsLine(char (&line)[17]) {
+		static int32_t s_temp_centi = 0;
+		static int32_t s_moist_centi = 0;
+		if (s_bus_sub == nullptr) {
+			return false;
+		}
+		const int t_ch = SensorRegistry::primary(SensorKind::TEMPERATURE);
+		const int m_ch = SensorRegistry::primary(SensorKind::MOISTURE);
+		// Newest few only: enough to hold the latest of every channel
+		SensorSample batch[2 * SensorRegistry::CHANNEL_COUNT];
+		const size_t n = s_bus->pollLatest(*s_bus_sub, batch);
+		for (size_t i = 0; i < n; ++i) {
+			if (batch[i].channel == t_ch) {
+				s_temp_centi = batch[i].value_centi;
+			} else if (batch[i].channel == m_ch) {
+				s_moist_centi = batch[i].value_centi;
+			}
+		}
+		if (n == 0) {
+			return false;
+		}
+		char t_str[8];
+		char m_str[8];
+		(void)FixedPoint::formatCenti(t_str, sizeof(t_str), s_temp_centi, 1);
+		(void)FixedPoint::formatCenti(m_str, sizeof(m_str), s_moist_centi, 1);
+		snprintf(line, sizeof(line), "T:%sC M:%s%%", t_str, m_str);
+		return true;
+	}
+
 	static void taskFunction(void* arg) {
 		(void)arg;
 		LOG_INFO(TAG, "%s", "LCD Display Task started");
@@ -146,9 +183,15 @@ namespace {
 		safeWriteLine(0, 1, Config::Device::id);
 
 		LcdUpdate update{};
+		char shown[17] = "";
+		TickType_t last_refresh = xTaskGetTickCount();
+		const TickType_t refresh = pdMS_TO_TICKS(Config::Hardware::Lcd::refresh_ms);
 		for (;;) {
-			// Wait indefinitely for updates
-			if (xQueueReceive(s_lcd_queue, &update, portMAX_DELAY) == pdTRUE) {
+			// Status changes from the monitor, or the next readings refresh
+			const TickType_t elapsed = xTaskGetTickCount() - last_refresh;
+			const TickType_t wait = (elapsed < refresh) ? refresh - elapsed : 0;
+			bool cleared = false;
+			if (xQueueReceive(s_lcd_queue, &update, wait) == pdTRUE) {
 				if (update.set_backlight) {
 					(void)s_lcd.setBacklight(update.r, update.g, update.b);
 				}
@@ -156,21 +199,34 @@ namespace {
 					(void)s_lcd.clear();
 					// HD44780 requires ~1.5ms after clear/home
 					vTaskDelay(pdMS_TO_TICKS(2));
+					cleared = true;
 				}
-				safeWriteLine(0, 0, update.line1);
 				safeWriteLine(0, 1, update.line2);
 			}
+			if (cleared && shown[0] != '\0') {
+				safeWriteLine(0, 0, shown);
+			}
+			if ((xTaskGetTickCount() - last_refresh) >= refresh) {
+				last_refresh = xTaskGetTickCount();
+				char line[17];
+				if (readingsLine(line) && std::strcmp(line, shown) != 0) {
+					std::memcpy(shown, line, sizeof(shown));
+					safeWriteLine(0, 0, shown);
+				}
+			}
 		}
 	}
 }
 
 namespace LcdDisplayTask {
-	void create(QueueHandle_t lcd_queue) {
+	void create(SensorSampleBus* sample_bus, QueueHandle_t lcd_queue) {
 		if (s_task_created) {
 			LOG_WARN(TAG, "%s", "LCD task already created; ignoring duplicate create()");
 			return;
 		}
 		s_lcd_queue = lcd_queue;
+		s_bus = sample_bus;
+		s_bus_sub = (sample_bus != nullptr) ? sample_bus->subscribeLatest("lcd") : nullptr;
 		xTaskCreateStatic(taskFunction,
 		                  "lcd_display",
 		                  sizeof(s_task_stack) / sizeof(StackType_t),
@@ -4,11 +4,12 @@
 #include <cstdint>
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <main/tasks/sensor_scheduler_task.hpp>
 
-// Queue item for updating the LCD.
+// Queue item for updating the LCD status (monitor -> LCD task): line 2 and the
+// backlight. Line 1 shows the readings, which the LCD task takes off the sample bus.
 // All fields are fixed-size to avoid dynamic allocation.
 struct LcdUpdate {
-	char     line1[17];         // null-terminated if shorter; will be truncated to 16
 	char     line2[17];         // null-terminated if shorter; will be truncated to 16
 	uint8_t  r;                 // backlight red   (0..255)
 	uint8_t  g;                 // backlight green (0..255)
@@ -18,10 +19,12 @@ struct LcdUpdate {
 };
 
 namespace LcdDisplayTask {
-	// Create a static FreeRTOS task that initializes the I2C RGB LCD and
-	// processes LcdUpdate messages from the provided queue.
+	// Create a static FreeRTOS task that initializes the I2C RGB LCD, processes
+	// LcdUpdate messages from the provided queue and, every
+	// Config::Hardware::Lcd::refresh_ms, redraws line 1 from the newest samples on
+	// sample_bus (subscribed with subscribeLatest(), so it never lags the ring).
 	// The task uses I2C pins/addresses from Config::Hardware::Lcd.
-	void create(QueueHandle_t lcd_queue);
+	void create(SensorSampleBus* sample_bus, QueueHandle_t lcd_queue);
 }
 
 #endif // LCD_DISPLAY_TASK_HPP
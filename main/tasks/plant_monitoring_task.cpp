@@ -1,8 +1,7 @@
 #include <main/tasks/plant_monitoring_task.hpp>
 #include <freertos/task.h>
 #include <freertos/queue.h>
-#include <main/models/temperature_data.hpp>
-#include <main/models/moisture_data.hpp>
+#include <main/hardware/sensor_registry.hpp>
 #include <main/models/alarm_event.hpp>
 #include <main/tasks/lcd_display_task.hpp>
 #include <main/utils/logger.hpp>
@@ -10,10 +9,15 @@
 #include <main/utils/time_sync.hpp>
 #include <cstring>
 #include <cstdio>
-#include <main/models/command.hpp>
+#include <main/models/alert_request.hpp>
 #include <main/state/device_state.hpp>
 #include <main/state/runtime_thresholds.hpp>
 #include <main/utils/watchdog.hpp>
+#include <main/sim/pipeline_bench.hpp>
+#include <main/tasks/cloud_communication_task.hpp>
+#include <main/tasks/task_channels.hpp>
+#include <main/utils/power_manager.hpp>
+#include <main/utils/trace.hpp>
 
 namespace {
     static const char* TAG = "PLANT_MON";
@@ -21,39 +25,78 @@ namespace {
     static StaticTask_t s_task_tcb;
     static StackType_t s_task_stack[4096 / sizeof(StackType_t)];
 
-    static QueueHandle_t q_temperature_data = nullptr;
-    static QueueHandle_t q_moisture_data  = nullptr;
+    using SensorRegistry::CHANNEL_COUNT;
+
+    // Sensor sample bus and this task's cursor on it
+    static SensorSampleBus* s_bus = nullptr;
+    static SensorSampleBus::Subscriber* s_bus_sub = nullptr;
     static QueueHandle_t q_alarm  = nullptr;
     static QueueHandle_t q_lcd    = nullptr;
-    static QueueHandle_t q_cmd    = nullptr;
-    // Cloud-forward queues (length 1, latest-only)
-    static QueueHandle_t q_temperature_mqtt = nullptr;
-    static QueueHandle_t q_moisture_mqtt  = nullptr;
+    static QueueHandle_t q_alert  = nullptr;
+
+    // Monitor state is published as-is in alert requests
+    using State = AlertState;
+    using Reason = AlertReason;
 
-    enum class State : uint8_t { OK = 0, WARNING = 1, CRITICAL = 2 };
-    enum class Reason : uint8_t { CLEAR = 0, TEMP_HIGH = 1, TEMP_LOW = 2, MOISTURE_LOW = 3, MOISTURE_HIGH = 4 };
+    // Latest filtered value per registry channel
+    struct LastSample {
+        bool     valid = false;
+        int32_t  value_centi = 0;
+        uint32_t ts_ms = 0;
+    };
+    using LastSamples = LastSample[CHANNEL_COUNT];
 
-    struct LastSamples {
-        bool     has_temp = false;
-        bool     has_moist = false;
-        float    temp_c = 0.0f;
-        float    moisture_pct = 0.0f;
-        uint32_t temp_ts = 0;
-        uint32_t moist_ts = 0;
+    // Per-channel verdict for one monitor pass
+    struct Verdict {
+        State  state = State::OK;
+        Reason reason = Reason::CLEAR;
     };
+    using Verdicts = Verdict[CHANNEL_COUNT];
+
+    static State classify(std::size_t channel, int32_t value_centi, Reason& r) {
+        // Thresholds in channel centi-units, reconverted only when a setter bumps the
+        // generation, so an MQTT update applies on the next pass
+        static SensorRegistry::Thresholds cached[CHANNEL_COUNT] = {};
+        static uint32_t cached_gen = UINT32_MAX;
+
+        if (RuntimeThresholds::generation() != cached_gen) {
+            const RuntimeThresholds::Values v = RuntimeThresholds::snapshot(&cached_gen);
+            for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+                cached[i] = SensorRegistry::get(i).thresholds(v);
+            }
+        }
 
-    // Forward declarations for classifiers used in setLcd
-    static State classifyTemp(float t, Reason& r);
-    static State classifyMoist(float m, Reason& r);
+        const SensorRegistry::Descriptor& d = SensorRegistry::get(channel);
+        const SensorRegistry::Thresholds& t = cached[channel];
+        if (value_centi <= t.low_crit)  { r = d.reason_low;  return State::CRITICAL; }
+        if (value_centi >= t.high_crit) { r = d.reason_high; return State::CRITICAL; }
+        if (value_centi <= t.low_warn)  { r = d.reason_low;  return State::WARNING; }
+        if (value_centi >= t.high_warn) { r = d.reason_high; return State::WARNING; }
+        r = Reason::CLEAR; return State::OK;
+    }
 
-    static void setLcd(State s, const LastSamples& last, bool flash_phase) {
+    // Worst state among channels of one kind
+    static State worstOfKind(const Verdicts& v, SensorKind kind) {
+        State worst = State::OK;
+        for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+            if (SensorRegistry::get(i).kind == kind && static_cast<uint8_t>(v[i].state) > static_cast<uint8_t>(worst)) {
+                worst = v[i].state;
+            }
+        }
+        return worst;
+    }
+
+    // Status line and backlight; the LCD task reads the readings line off the sample
+    // bus itself. Sent only when it differs from the last one queued.
+    static void setLcd(State s, const Verdicts& v, bool flash_phase) {
         if (!q_lcd) return;
+        static LcdUpdate s_sent{};
+        static bool s_have_sent = false;
         LcdUpdate u{};
-        snprintf(u.line1, sizeof(u.line1), "T:%3.1fC M:%2.1f%%", last.temp_c, last.moisture_pct);
+        // Line 2 flags the kinds at the current severity, over every channel
+        const State ts = worstOfKind(v, SensorKind::TEMPERATURE);
+        const State ms = worstOfKind(v, SensorKind::MOISTURE);
         if (s == State::CRITICAL) {
-            Reason tr, mr;
-            State ts = classifyTemp(last.temp_c, tr);
-            State ms = classifyMoist(last.moisture_pct, mr);
             if (ts == State::CRITICAL && ms == State::CRITICAL) {
                 snprintf(u.line2, sizeof(u.line2), "Crit: T+M");
             } else if (ts == State::CRITICAL) {
@@ -65,9 +108,6 @@ namespace {
             }
         } else {
             if (s == State::WARNING) {
-                Reason tr, mr;
-                State ts = classifyTemp(last.temp_c, tr);
-                State ms = classifyMoist(last.moisture_pct, mr);
                 bool t_warn = (ts == State::WARNING);
                 bool m_warn = (ms == State::WARNING);
                 if (t_warn && m_warn) {
@@ -90,56 +130,23 @@ namespace {
             case State::CRITICAL: u.r = flash_phase ? 255 : 20; u.g = 0; u.b = 0; break;
         }
         u.clear_first = 0;
-        (void)xQueueSend(q_lcd, &u, 0);
-    }
-
-    static State classifyTemp(float t, Reason& r) {
-        // Cache thresholds to avoid repeated function calls
-        static float cached_temp_low_crit = 0.0f;
-        static float cached_temp_high_crit = 0.0f;
-        static float cached_temp_low_warn = 0.0f;
-        static float cached_temp_high_warn = 0.0f;
-        static TickType_t last_cache_update = 0;
-        
-        TickType_t now = xTaskGetTickCount();
-        // Refresh cache every 5 seconds to pick up threshold changes
-        if ((now - last_cache_update) > pdMS_TO_TICKS(5000) || last_cache_update == 0) {
-            cached_temp_low_crit = RuntimeThresholds::getTempLowCrit();
-            cached_temp_high_crit = RuntimeThresholds::getTempHighCrit();
-            cached_temp_low_warn = RuntimeThresholds::getTempLowWarn();
-            cached_temp_high_warn = RuntimeThresholds::getTempHighWarn();
-            last_cache_update = now;
+        if (s_have_sent && std::memcmp(&u, &s_sent, sizeof(u)) == 0) {
+            return;
         }
-
-        if (t <= cached_temp_low_crit)  { r = Reason::TEMP_LOW;  return State::CRITICAL; }
-        if (t >= cached_temp_high_crit) { r = Reason::TEMP_HIGH; return State::CRITICAL; }
-        if (t <= cached_temp_low_warn)  { r = Reason::TEMP_LOW;  return State::WARNING; }
-        if (t >= cached_temp_high_warn) { r = Reason::TEMP_HIGH; return State::WARNING; }
-        r = Reason::CLEAR; return State::OK;
-    }
-    static State classifyMoist(float m, Reason& r) {
-        // Cache thresholds to avoid repeated function calls
-        static float cached_moisture_low_crit = 0.0f;
-        static float cached_moisture_low_warn = 0.0f;
-        static float cached_moisture_high_crit = 0.0f;
-        static float cached_moisture_high_warn = 0.0f;
-        static TickType_t last_cache_update = 0;
-        
-        TickType_t now = xTaskGetTickCount();
-        // Refresh cache every 5 seconds to pick up threshold changes
-        if ((now - last_cache_update) > pdMS_TO_TICKS(5000) || last_cache_update == 0) {
-            cached_moisture_low_crit = RuntimeThresholds::getMoistureLowCrit();
-            cached_moisture_low_warn = RuntimeThresholds::getMoistureLowWarn();
-            cached_moisture_high_crit = RuntimeThresholds::getMoistureHighCrit();
-            cached_moisture_high_warn = RuntimeThresholds::getMoistureHighWarn();
-            last_cache_update = now;
+        if (xQueueSend(q_lcd, &u, 0) == pdTRUE) {
+            s_sent = u;
+            s_have_sent = true;
         }
+    }
 
-        if (m <= cached_moisture_low_crit)  { r = Reason::MOISTURE_LOW;  return State::CRITICAL; }
-        if (m >= cached_moisture_high_crit) { r = Reason::MOISTURE_HIGH; return State::CRITICAL; }
-        if (m <= cached_moisture_low_warn)  { r = Reason::MOISTURE_LOW;  return State::WARNING; }
-        if (m >= cached_moisture_high_warn) { r = Reason::MOISTURE_HIGH; return State::WARNING; }
-        r = Reason::CLEAR; return State::OK;
+    static uint8_t reasonFlag(Reason r) {
+        switch (r) {
+            case Reason::TEMP_HIGH:     return DeviceStateMachine::REASON_TEMP_HIGH;
+            case Reason::TEMP_LOW:      return DeviceStateMachine::REASON_TEMP_LOW;
+            case Reason::MOISTURE_LOW:  return DeviceStateMachine::REASON_MOIST_LOW;
+            case Reason::MOISTURE_HIGH: return DeviceStateMachine::REASON_MOIST_HIGH;
+            default:                    return DeviceStateMachine::REASON_NONE;
+        }
     }
 
     static void sendBuzzer(State s, Reason r) {
@@ -164,15 +171,16 @@ namespace {
         (void)xQueueSend(q_alarm, &evt, 0);
     }
 
-    // Publish alert via Cloud task by sending a Command with state and reason encoded
+    // Publish alert via the cloud task (dedicated alert queue, never shared with MQTT commands)
     static void requestAlert(State s, Reason r) {
-        if (!q_cmd) return;
-        Command c{};
-        c.timestamp_ms = static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
-        // Encode: type = state (0,1,2), value = reason code (0..4)
-        c.type  = static_cast<int32_t>(s);
-        c.value = static_cast<float>(static_cast<uint32_t>(r));
-        (void)xQueueSend(q_cmd, &c, 0);
+        if (!q_alert) return;
+        AlertRequest req{};
+        req.timestamp_ms = static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
+        req.state = s;
+        req.reason = r;
+        if (!TaskChannels::sendAlert(q_alert, req, CloudCommunicationTask::notify)) {
+            LOG_WARN(TAG, "%s", "alert_queue full, dropped alert request");
+        }
     }
 
     static void taskFn(void* arg) {
@@ -180,35 +188,44 @@ namespace {
         LOG_INFO(TAG, "%s", "Plant Monitoring Task started");
         Watchdog::subscribe();
         LastSamples last{};
+        Verdicts verdicts{};
         State current = State::OK;
         Reason cur_reason = Reason::CLEAR;
         TickType_t warn_start = 0, crit_start = 0;
         TickType_t last_lcd_blink = 0;
+        TickType_t last_wake = xTaskGetTickCount();
         bool flash_phase = false;
 
         for (;;) {
             Watchdog::feed();
-            // Drain queues (non-blocking)
-            TemperatureData sd{};
-            while (q_temperature_data && xQueueReceive(q_temperature_data, &sd, 0) == pdTRUE) {
-                last.has_temp = true; last.temp_c = sd.temp_c; last.temp_ts = sd.ts_ms;
-            }
-            MoistureData md{};
-            while (q_moisture_data && xQueueReceive(q_moisture_data, &md, 0) == pdTRUE) {
-                last.has_moist = true; last.moisture_pct = md.moisture_percent; last.moist_ts = md.ts_ms;
+            // Drain the sample bus in bulk (non-blocking, lock-free); keep the latest per channel
+            SensorSample batch[8];
+            size_t n = 0;
+            while (s_bus_sub && (n = s_bus->poll(*s_bus_sub, batch)) > 0) {
+                for (size_t i = 0; i < n; ++i) {
+                    PipelineBench::onMonitorReceive(batch[i].ts_ms);
+                    Trace::point(Trace::Point::MONITOR_RX, batch[i].channel, batch[i].ts_ms);
+                    if (batch[i].channel < CHANNEL_COUNT) {
+                        LastSample& l = last[batch[i].channel];
+                        l.valid = true; l.value_centi = batch[i].value_centi; l.ts_ms = batch[i].ts_ms;
+                    }
+                }
             }
 
-            // Classify each metric
-            Reason tr, mr;
-            State ts = last.has_temp ? classifyTemp(last.temp_c, tr) : State::OK;
-            State ms = last.has_moist ? classifyMoist(last.moisture_pct, mr) : State::OK;
-            // Pick overall = max severity (CRITICAL > WARNING > OK)
-            State next = (ts == State::CRITICAL || ms == State::CRITICAL) ? State::CRITICAL
-                         : (ts == State::WARNING || ms == State::WARNING) ? State::WARNING
-                         : State::OK;
-            Reason next_reason = (next == State::CRITICAL) ? (ts == State::CRITICAL ? tr : mr)
-                                  : (next == State::WARNING) ? (ts == State::WARNING ? tr : mr)
-                                  : Reason::CLEAR;
+            // Classify each channel; overall = max severity (CRITICAL > WARNING > OK),
+            // reason from the first channel at that severity (registry order)
+            State next = State::OK;
+            Reason next_reason = Reason::CLEAR;
+            for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+                verdicts[i] = Verdict{};
+                if (last[i].valid) {
+                    verdicts[i].state = classify(i, last[i].value_centi, verdicts[i].reason);
+                }
+                if (static_cast<uint8_t>(verdicts[i].state) > static_cast<uint8_t>(next)) {
+                    next = verdicts[i].state;
+                    next_reason = verdicts[i].reason;
+                }
+            }
 
             TickType_t now = xTaskGetTickCount();
             using namespace Config::Monitoring;
@@ -262,25 +279,11 @@ namespace {
                 // Update shared device state machine with reason flags
                 // Only flag reasons matching the current state severity
                 uint8_t flags = DeviceStateMachine::REASON_NONE;
-                if (current == State::CRITICAL) {
-                    // Only flag CRITICAL conditions
-                    if (ts == State::CRITICAL) {
-                        if (tr == Reason::TEMP_HIGH) flags |= DeviceStateMachine::REASON_TEMP_HIGH;
-                        if (tr == Reason::TEMP_LOW)  flags |= DeviceStateMachine::REASON_TEMP_LOW;
-                    }
-                    if (ms == State::CRITICAL) {
-                        if (mr == Reason::MOISTURE_LOW)  flags |= DeviceStateMachine::REASON_MOIST_LOW;
-                        if (mr == Reason::MOISTURE_HIGH) flags |= DeviceStateMachine::REASON_MOIST_HIGH;
-                    }
-                } else if (current == State::WARNING) {
-                    // Only flag WARNING conditions
-                    if (ts == State::WARNING) {
-                        if (tr == Reason::TEMP_HIGH) flags |= DeviceStateMachine::REASON_TEMP_HIGH;
-                        if (tr == Reason::TEMP_LOW)  flags |= DeviceStateMachine::REASON_TEMP_LOW;
-                    }
-                    if (ms == State::WARNING) {
-                        if (mr == Reason::MOISTURE_LOW)  flags |= DeviceStateMachine::REASON_MOIST_LOW;
-                        if (mr == Reason::MOISTURE_HIGH) flags |= DeviceStateMachine::REASON_MOIST_HIGH;
+                if (current != State::OK) {
+                    for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+                        if (verdicts[i].state == current) {
+                            flags |= reasonFlag(verdicts[i].reason);
+                        }
                     }
                 }
                 // If current == State::OK, flags remain REASON_NONE
@@ -294,56 +297,41 @@ namespace {
                 requestAlert(current, cur_reason);
             }
 
-            // Forward latest samples to Cloud (latest-only overwrite)
-            if (q_temperature_mqtt && last.has_temp) {
-                TemperatureData out{};
-                out.temp_c = last.temp_c;
-                out.ts_ms = last.temp_ts;
-                (void)xQueueOverwrite(q_temperature_mqtt, &out);
-            }
-            if (q_moisture_mqtt && last.has_moist) {
-                MoistureData out{};
-                out.moisture_raw = 0;
-                out.moisture_percent = last.moisture_pct;
-                out.ts_ms = last.moist_ts;
-                (void)xQueueOverwrite(q_moisture_mqtt, &out);
-            }
-
-            // LCD update (periodic; flash critical ~1Hz)
+            // LCD status line (re-checked periodically; flash critical ~1Hz)
             if (current == State::CRITICAL) {
                 if ((now - last_lcd_blink) >= pdMS_TO_TICKS(500)) {
                     flash_phase = !flash_phase;
-                    setLcd(current, last, flash_phase);
+                    setLcd(current, verdicts, flash_phase);
                     last_lcd_blink = now;
                 }
             } else {
                 if ((now - last_lcd_blink) >= pdMS_TO_TICKS(1000)) {
                     flash_phase = false;
-                    setLcd(current, last, flash_phase);
+                    setLcd(current, verdicts, flash_phase);
                     last_lcd_blink = now;
                 }
             }
 
-            vTaskDelay(pdMS_TO_TICKS(100));
+            // Low-power mode: one pass per wake slot, except while CRITICAL so the LCD keeps flashing
+            if (PowerManager::enabled() && current != State::CRITICAL) {
+                PowerManager::delayUntilSlot(last_wake, pdMS_TO_TICKS(100));
+            } else {
+                vTaskDelay(pdMS_TO_TICKS(100));
+            }
         }
     }
 }
 
 namespace PlantMonitoringTask {
-    void create(QueueHandle_t temperature_data_queue,
-                QueueHandle_t moisture_data_queue,
+    void create(SensorSampleBus* sample_bus,
                 QueueHandle_t alarm_queue,
                 QueueHandle_t lcd_queue,
-                QueueHandle_t command_queue,
-                QueueHandle_t temperature_mqtt_queue,
-                QueueHandle_t moisture_mqtt_queue) {
-        q_temperature_data = temperature_data_queue;
-        q_moisture_data  = moisture_data_queue;
+                QueueHandle_t alert_queue) {
+        s_bus = sample_bus;
+        s_bus_sub = sample_bus->subscribe("monitor");
         q_alarm  = alarm_queue;
         q_lcd    = lcd_queue;
-        q_cmd    = command_queue;
-        q_temperature_mqtt = temperature_mqtt_queue;
-        q_moisture_mqtt  = moisture_mqtt_queue;
+        q_alert  = alert_queue;
         xTaskCreateStatic(taskFn, "plant_monitor",
                           sizeof(s_task_stack) / sizeof(StackType_t), nullptr,
                           Config::TaskPriorities::HIGH, s_task_stack, &s_task_tcb);
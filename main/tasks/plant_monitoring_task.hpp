@@ -3,15 +3,13 @@
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <main/tasks/sensor_scheduler_task.hpp>
 
 namespace PlantMonitoringTask {
-    void create(QueueHandle_t temperature_data_queue,
-                QueueHandle_t moisture_data_queue,
+    void create(SensorSampleBus* sample_bus,
                 QueueHandle_t alarm_queue,
                 QueueHandle_t lcd_queue,
-                QueueHandle_t command_queue,
-                QueueHandle_t temperature_mqtt_queue,
-                QueueHandle_t moisture_mqtt_queue);
+                QueueHandle_t alert_queue);
 }
 
 #endif // PLANT_MONITORING_TASK_HPP
@@ -0,0 +1,150 @@
+#include <main/tasks/sensor_scheduler_task.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <main/utils/logger.hpp>
+#include <main/hardware/sensor_registry.hpp>
+#include <main/config/config.hpp>
+#include <main/utils/watchdog.hpp>
+#include <main/sim/pipeline_bench.hpp>
+#include <main/utils/power_manager.hpp>
+#include <main/utils/trace.hpp>
+
+namespace {
+    static const char* TAG = "SENSOR_SCHED";
+
+    using SensorRegistry::CHANNEL_COUNT;
+
+    // Static task resources
+    static StaticTask_t s_task_tcb;
+    static StackType_t s_task_stack[3072 / sizeof(StackType_t)];
+
+    // Runtime state
+    static SensorSampleBus* s_sample_bus = nullptr;
+
+    struct ChannelState {
+        TickType_t next_due; // absolute tick of the next sample (or init retry)
+        bool       inited;
+    };
+    static ChannelState s_channels[CHANNEL_COUNT];
+
+    // Longest block so the watchdog is fed well inside its 8 s timeout
+    static constexpr uint32_t MAX_WAIT_MS = 1000;
+    static constexpr uint32_t INIT_RETRY_MS = 2000;
+
+    static bool isDue(TickType_t now, TickType_t deadline) {
+        return static_cast<int32_t>(now - deadline) >= 0;
+    }
+
+    static void sampleChannel(std::size_t i, const SensorRegistry::Descriptor& d) {
+        SensorRegistry::Reading reading{};
+        int32_t filtered = 0;
+        const uint8_t channel = static_cast<uint8_t>(i);
+        Trace::point(Trace::Point::READ_BEGIN, channel, 0);
+        if (!d.read(reading)) {
+            LOG_WARN(TAG, "%s read failed", d.name);
+            return;
+        }
+        Trace::point(Trace::Point::READ_END, channel, 0);
+        if (Config::Features::sample_filter && d.filter(reading.value_centi, filtered) == SensorRegistry::FilterResult::DROPPED) {
+            LOG_DEBUG(TAG, "%s outlier dropped: %ld centi-%s", d.name, static_cast<long>(reading.value_centi), d.unit);
+            return;
+        }
+        SensorSample sample{};
+        sample.value_centi = Config::Features::sample_filter ? filtered : reading.value_centi;
+        sample.ts_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+        sample.raw = reading.raw;
+        sample.channel = channel;
+        sample.kind = d.kind;
+        // The bus never blocks the producer; slow subscribers lose their oldest samples
+        s_sample_bus->publish(sample);
+        Trace::point(Trace::Point::BUS_PUBLISH, channel, sample.ts_ms);
+        PipelineBench::onProduced();
+    }
+
+    // Run one channel whose deadline has passed and schedule its next deadline
+    static void serviceChannel(std::size_t i, TickType_t now) {
+        const SensorRegistry::Descriptor& d = SensorRegistry::get(i);
+        ChannelState& ch = s_channels[i];
+        if (!ch.inited) {
+            ch.inited = d.init();
+            if (!ch.inited) {
+                LOG_WARN(TAG, "%s init retry failed", d.name);
+                ch.next_due = now + pdMS_TO_TICKS(INIT_RETRY_MS);
+                return;
+            }
+            LOG_INFO(TAG, "%s init successful", d.name);
+            // Restart periodicity from recovery, as the per-sensor tasks used to
+            ch.next_due = now;
+            d.reset();
+        }
+
+        sampleChannel(i, d);
+
+        // Period may be swept by the pipeline benchmark
+        TickType_t period = pdMS_TO_TICKS(PipelineBench::samplePeriodMs(d.period_ms));
+        period = (period > 0) ? period : 1;
+        ch.next_due += period;
+        if (isDue(now, ch.next_due)) {
+            // Overran a whole period (slow read or long block): skip ahead, no burst
+            ch.next_due = now + period;
+        }
+    }
+
+    static void taskFunction(void* arg) {
+        (void)arg;
+        LOG_INFO(TAG, "Sensor Scheduler Task started (%u channels)", static_cast<unsigned>(CHANNEL_COUNT));
+        Watchdog::subscribe();
+
+        const TickType_t start = xTaskGetTickCount();
+        for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+            const SensorRegistry::Descriptor& d = SensorRegistry::get(i);
+            s_channels[i].inited = d.enabled && d.init();
+            if (d.enabled && !s_channels[i].inited) {
+                LOG_WARN(TAG, "%s init failed; will retry periodically", d.name);
+            }
+            // Staggered first deadlines spread ADC work across the period
+            s_channels[i].next_due = start + pdMS_TO_TICKS(d.phase_ms);
+        }
+
+        for (;;) {
+            Watchdog::feed();
+            TickType_t now = xTaskGetTickCount();
+            for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+                if (SensorRegistry::get(i).enabled && isDue(now, s_channels[i].next_due)) {
+                    serviceChannel(i, now);
+                }
+            }
+
+            // Block until the earliest deadline
+            now = xTaskGetTickCount();
+            TickType_t wait = pdMS_TO_TICKS(MAX_WAIT_MS);
+            for (std::size_t i = 0; i < CHANNEL_COUNT; ++i) {
+                if (!SensorRegistry::get(i).enabled) {
+                    continue;
+                }
+                if (isDue(now, s_channels[i].next_due)) {
+                    wait = 0;
+                    break;
+                }
+                const TickType_t until = s_channels[i].next_due - now;
+                wait = (until < wait) ? until : wait;
+            }
+            // Low-power mode: deadlines snap to the shared wake slots
+            wait = PowerManager::alignWait(now, wait);
+            if (wait > 0) {
+                vTaskDelay(wait);
+                PowerManager::noteWake(xTaskGetTickCount());
+            }
+        }
+    }
+}
+
+namespace SensorSchedulerTask {
+    void create(SensorSampleBus* sample_bus) {
+        s_sample_bus = sample_bus;
+        xTaskCreateStatic(taskFunction, "sensor_sched",
+                          sizeof(s_task_stack) / sizeof(StackType_t), nullptr,
+                          Config::TaskPriorities::HIGH, s_task_stack, &s_task_tcb);
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef SENSOR_SCHEDULER_TASK_HPP
+#define SENSOR_SCHEDULER_TASK_HPP
+
+#include <main/models/sensor_sample.hpp>
+#include <main/utils/sample_bus.hpp>
+
+// Every registry channel's samples, written once by this task and copied straight out
+// of the shared ring by each subscriber (PlantMonitoringTask, CloudCommunicationTask)
+// through its own cursor
+using SensorSampleBus = SampleBus<SensorSample, 64>;
+
+namespace SensorSchedulerTask {
+    // Creates a static FreeRTOS task that samples every enabled SensorRegistry
+    // channel on its own staggered deadline and publishes filtered samples on the bus.
+    void create(SensorSampleBus* sample_bus);
+}
+
+#endif // SENSOR_SCHEDULER_TASK_HPP
@@ -0,0 +1,60 @@
+#include <main/tasks/task_channels.hpp>
+#include <freertos/task.h>
+
+namespace TaskChannels {
+    bool sendAlert(QueueHandle_t alert_queue, const AlertRequest& req, WakeFn wake) {
+        if (alert_queue == nullptr || xQueueSend(alert_queue, &req, 0) != pdTRUE) {
+            return false;
+        }
+        if (wake != nullptr) {
+            wake();
+        }
+        return true;
+    }
+
+    std::size_t drainAlerts(QueueHandle_t alert_queue, AlertHandler handle) {
+        if (alert_queue == nullptr) {
+            return 0;
+        }
+        std::size_t n = 0;
+        AlertRequest alert{};
+        while (xQueueReceive(alert_queue, &alert, 0) == pdTRUE) {
+            handle(alert);
+            n++;
+        }
+        return n;
+    }
+
+    bool sendCommand(QueueHandle_t command_queue, CommandType type, double value) {
+        if (command_queue == nullptr) {
+            return false;
+        }
+        Command cmd{};
+        cmd.timestamp_ms = static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
+        cmd.type = static_cast<int32_t>(type);
+        cmd.value = static_cast<float>(value);
+        return xQueueSend(command_queue, &cmd, 0) == pdTRUE;
+    }
+
+    std::size_t receiveCommandBatch(QueueHandle_t command_queue, TickType_t wait, TickType_t window, TickType_t poll,
+                                    CommandHandler handle, void* ctx) {
+        Command cmd{};
+        if (command_queue == nullptr || xQueueReceive(command_queue, &cmd, wait) != pdTRUE) {
+            return 0;
+        }
+        handle(cmd, ctx);
+        std::size_t n = 1;
+
+        const TickType_t start = xTaskGetTickCount();
+        while ((xTaskGetTickCount() - start) <= window) {
+            if (xQueueReceive(command_queue, &cmd, 0) == pdTRUE) {
+                handle(cmd, ctx);
+                n++;
+            } else {
+                // Let the rest of a burst arrive
+                vTaskDelay(poll);
+            }
+        }
+        return n;
+    }
+}
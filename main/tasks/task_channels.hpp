@@ -0,0 +1,39 @@
+// Typed hand-off between tasks: one queue per message kind, each with a single
+// consumer, so no task ever receives (and puts back) an item meant for another.
+// - alert_queue:   plant monitor -> cloud task (AlertRequest)
+// - command_queue: cloud task's MQTT handler -> command task (Command)
+// Senders never block; a full queue drops the new item and the sender is told.
+#ifndef TASK_CHANNELS_HPP
+#define TASK_CHANNELS_HPP
+
+#include <cstddef>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <main/models/alert_request.hpp>
+#include <main/models/command.hpp>
+
+namespace TaskChannels {
+    using WakeFn = void (*)();
+    using AlertHandler = void (*)(const AlertRequest& alert);
+    using CommandHandler = void (*)(const Command& cmd, void* ctx);
+
+    // Monitor side: queue req and, if it was accepted, call wake (the consumer's
+    // notify, CloudCommunicationTask::notify). False when alert_queue is full.
+    bool sendAlert(QueueHandle_t alert_queue, const AlertRequest& req, WakeFn wake);
+
+    // Cloud task side: pass every queued alert to handle, oldest first, without
+    // blocking. Returns the number handled.
+    std::size_t drainAlerts(QueueHandle_t alert_queue, AlertHandler handle);
+
+    // MQTT handler side: queue a parsed command stamped with the tick time.
+    // False when command_queue is full.
+    bool sendCommand(QueueHandle_t command_queue, CommandType type, double value);
+
+    // Command task side: wait up to wait ticks for a command, then keep taking the
+    // ones that arrive within window ticks of it (polling every poll ticks), passing
+    // each to handle(cmd, ctx) in order. Returns the batch size (0 on timeout).
+    std::size_t receiveCommandBatch(QueueHandle_t command_queue, TickType_t wait, TickType_t window, TickType_t poll,
+                                    CommandHandler handle, void* ctx);
+}
+
+#endif // TASK_CHANNELS_HPP
@@ -0,0 +1,62 @@
+// Batched telemetry payloads shared by the cloud task's backlog flush and the
+// deep-sleep upload path. Both fill a caller-provided buffer in place.
+#ifndef BACKLOG_FORMAT_HPP
+#define BACKLOG_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <inttypes.h>
+#include <main/utils/fixed_point.hpp>
+#include <main/utils/telemetry_codec.hpp>
+#include <main/utils/time_sync.hpp>
+
+namespace BacklogFormat {
+    // One backlog batch as JSON:
+    //   {"<key>":[v0,v1,...],"t0_ms":E,"dt_ms":[0,d1,...],"n":N,"ts":"...","buffered":1}
+    // t0_ms is the first sample's capture time in Unix epoch ms and dt_ms the offset of
+    // each sample from it, so ingest sees the real capture times in order. Both are
+    // omitted when the capture times are unknown (ts, the flush time, is then the only
+    // time reference). value_at(i) returns the i-th sample in centi-units and
+    // epoch_at(i) its time, both read in place; values print with `decimals` (1 or 2).
+    // Returns the payload length, or -1 if it did not fit.
+    template<typename ValueAt, typename EpochAt>
+    int formatJson(char* payload, std::size_t size, const char* key, unsigned decimals,
+                   std::size_t n, ValueAt value_at, bool have_epoch, EpochAt epoch_at) {
+        char ts[16];
+        TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+        int off = std::snprintf(payload, size, "{\"%s\":[", key);
+        for (std::size_t i = 0; i < n && off < static_cast<int>(size); ++i) {
+            off += std::snprintf(payload + off, size - off, i == 0 ? "" : ",");
+            off += FixedPoint::formatCenti(payload + off, size - off, value_at(i), decimals);
+        }
+        if (have_epoch && off < static_cast<int>(size)) {
+            const uint64_t t0 = epoch_at(0);
+            off += std::snprintf(payload + off, size - off, "],\"t0_ms\":%" PRIu64 ",\"dt_ms\":[", t0);
+            for (std::size_t i = 0; i < n && off < static_cast<int>(size); ++i) {
+                off += std::snprintf(payload + off, size - off, i == 0 ? "%" PRIu64 : ",%" PRIu64, epoch_at(i) - t0);
+            }
+        }
+        if (off < static_cast<int>(size)) {
+            off += std::snprintf(payload + off, size - off,
+                                 "],\"n\":%u,\"ts\":\"%s\",\"buffered\":1}", static_cast<unsigned>(n), ts);
+        }
+        return (off < static_cast<int>(size)) ? off : -1;
+    }
+
+    // Binary counterpart of formatJson (TelemetryCodec frame); -1 if it did not fit
+    template<typename ValueAt, typename EpochAt>
+    int encodeBinary(uint8_t* out, std::size_t size, TelemetryCodec::Kind kind,
+                     std::size_t n, ValueAt value_at, bool have_epoch, EpochAt epoch_at) {
+        TelemetryCodec::FrameEncoder encoder(out, size, kind, have_epoch);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!encoder.add(value_at(i), have_epoch ? epoch_at(i) : 0U)) {
+                return -1;
+            }
+        }
+        std::size_t len = encoder.finish();
+        return (len > 0) ? static_cast<int>(len) : -1;
+    }
+}
+
+#endif // BACKLOG_FORMAT_HPP
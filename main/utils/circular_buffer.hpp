@@ -6,7 +6,8 @@
 
 // Fixed-capacity, header-only circular buffer.
 // - No dynamic allocation (storage is embedded).
-// - Single-producer / single-consumer friendly (no internal locking).
+// - No internal locking or atomics: use from a single task only.
+//   For cross-task/cross-core hand-off of samples use SampleBus (utils/sample_bus.hpp).
 // - T should be copyable.
 // - Methods are non-blocking; push/pop return false on full/empty.
 template<typename T, std::size_t Capacity>
@@ -44,6 +45,25 @@ public:
         return true;
     }
 
+    // Pointer to the element 'offset' positions after the oldest one, or nullptr.
+    // Lets callers serialize in place before committing with discard().
+    const T* peekAt(std::size_t offset) const {
+        if (offset >= count) {
+            return nullptr;
+        }
+        return &storage[(tail_index + offset) % Capacity];
+    }
+
+    // Drop up to n oldest elements; returns the number dropped.
+    std::size_t discard(std::size_t n) {
+        if (n > count) {
+            n = count;
+        }
+        tail_index = (tail_index + n) % Capacity;
+        count -= n;
+        return n;
+    }
+
     bool isFull() const {
         return count == Capacity;
     }
@@ -0,0 +1,156 @@
+#include <main/utils/crash_log.hpp>
+#include <main/utils/deferred_log.hpp>
+#include <main/config/config.hpp>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_app_desc.h>
+#include <cstring>
+
+namespace {
+    static constexpr uint32_t MAGIC = 0x474F4C43; // "CLOG"
+    static constexpr std::size_t DEPTH = Config::Logging::crash_ring_depth;
+    static_assert(DEPTH >= 2 && (DEPTH & (DEPTH - 1)) == 0, "crash_ring_depth must be a power of two");
+    static constexpr uint32_t MASK = DEPTH - 1;
+
+    // Plain data only: a constructor would wipe it at boot. head is advanced with
+    // atomic builtins so any task can log.
+    struct Ring {
+        uint32_t magic;
+        uint32_t image;   // first word of the app ELF SHA-256 that wrote the ring
+        uint32_t head;    // next ring position
+        CrashLog::Record records[DEPTH];
+    };
+    static __NOINIT_ATTR Ring s_ring;
+
+    static bool s_ready = false;
+
+    // Previous boot's records, copied out at init() so the live ring can restart
+    static CrashLog::Record s_pending[DEPTH];
+    static std::size_t s_pending_count = 0;
+    static esp_reset_reason_t s_reason = ESP_RST_UNKNOWN;
+
+    static uint32_t imageId() {
+        const uint8_t* sha = esp_app_get_description()->app_elf_sha256;
+        uint32_t id = 0;
+        std::memcpy(&id, sha, sizeof(id));
+        return id;
+    }
+
+    // Memory is only kept across resets that do not power the chip (or DRAM) down
+    static bool keepsRam(esp_reset_reason_t reason) {
+        switch (reason) {
+            case ESP_RST_SW:
+            case ESP_RST_PANIC:
+            case ESP_RST_INT_WDT:
+            case ESP_RST_TASK_WDT:
+            case ESP_RST_WDT:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+namespace CrashLog {
+    void init() {
+        s_reason = esp_reset_reason();
+        const uint32_t image = imageId();
+        s_pending_count = 0;
+        if (keepsRam(s_reason) && s_ring.magic == MAGIC && s_ring.image == image) {
+            // Oldest first: walk one lap ending at head, keep slots whose stamp matches
+            const uint32_t head = s_ring.head;
+            for (uint32_t n = 0; n < DEPTH; ++n) {
+                const uint32_t pos = head - DEPTH + n;
+                const Record& r = s_ring.records[pos & MASK];
+                if (r.stamp == pos + 1U && pos < head) {
+                    s_pending[s_pending_count++] = r;
+                }
+            }
+        }
+        std::memset(&s_ring, 0, sizeof(s_ring));
+        s_ring.magic = MAGIC;
+        s_ring.image = image;
+        s_ready = true;
+    }
+
+    Record* claim(uint32_t& pos) {
+        if (!s_ready) {
+            return nullptr;
+        }
+        pos = __atomic_fetch_add(&s_ring.head, 1U, __ATOMIC_RELAXED);
+        Record* r = &s_ring.records[pos & MASK];
+        // Invalidate first so a reset mid-write leaves no half record behind
+        __atomic_store_n(&r->stamp, 0U, __ATOMIC_RELAXED);
+        r->ts_ms = static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+        return r;
+    }
+
+    void commit(Record* record, uint32_t pos) {
+        __atomic_store_n(&record->stamp, pos + 1U, __ATOMIC_RELEASE);
+    }
+
+    std::size_t pendingCount() {
+        return s_pending_count;
+    }
+
+    const Record& pending(std::size_t i) {
+        return s_pending[(i < s_pending_count) ? i : 0];
+    }
+
+    void clearPending() {
+        s_pending_count = 0;
+    }
+
+    const char* resetReason() {
+        switch (s_reason) {
+            case ESP_RST_SW:       return "software";
+            case ESP_RST_PANIC:    return "panic";
+            case ESP_RST_INT_WDT:  return "int_wdt";
+            case ESP_RST_TASK_WDT: return "task_wdt";
+            case ESP_RST_WDT:      return "wdt";
+            default:               return "other";
+        }
+    }
+
+    void format(const Record& r, char* out, std::size_t cap) {
+        // Widen into a DeferredLog record and reuse its printf replay
+        DeferredLog::Record d{};
+        d.tag = r.tag;
+        d.fmt = r.fmt;
+        d.level = r.level;
+        d.arg_count = static_cast<uint8_t>((r.arg_count < MAX_ARGS) ? r.arg_count : MAX_ARGS);
+        for (std::size_t i = 0; i < d.arg_count; ++i) {
+            switch ((r.kinds >> (2 * i)) & 3U) {
+                case INT:
+                    d.kinds[i] = DeferredLog::ArgKind::INT;
+                    d.args[i].i = static_cast<int32_t>(r.args[i]);
+                    break;
+                case FLOAT: {
+                    float f = 0.0f;
+                    std::memcpy(&f, &r.args[i], sizeof(f));
+                    d.kinds[i] = DeferredLog::ArgKind::DOUBLE;
+                    d.args[i].d = f;
+                    break;
+                }
+                case STRING: {
+                    static_assert(MAX_ARGS * STRING_BYTES <= DeferredLog::STRING_BYTES, "text must fit");
+                    const bool kept = (r.text_arg == i + 1);
+                    const char* src = kept ? r.text : "<?>";
+                    d.kinds[i] = DeferredLog::ArgKind::STRING;
+                    d.args[i].p = reinterpret_cast<const void*>(static_cast<uintptr_t>(r.args[i]));
+                    d.str_offsets[i] = d.string_used;
+                    const std::size_t n = std::strlen(src) + 1U;
+                    std::memcpy(&d.strings[d.string_used], src, n);
+                    d.string_used = static_cast<uint8_t>(d.string_used + n);
+                    break;
+                }
+                default:
+                    d.kinds[i] = DeferredLog::ArgKind::UINT;
+                    d.args[i].u = r.args[i];
+                    break;
+            }
+        }
+        DeferredLog::format(d, out, cap);
+    }
+}
@@ -0,0 +1,127 @@
+// Last log records kept in no-init RAM, which survives panics, watchdog and
+// software resets (not power loss or deep sleep), so the lines leading up to a
+// watchdog panic can be uploaded after the reboot.
+// Only calls at Config::Logging::crash_capture_level or more severe are kept.
+// Records are compact and binary: pointers to the tag and format literals (still
+// valid after resetting into the same image, checked against the app ELF SHA-256)
+// plus up to four raw 32-bit arguments and the start of the first %s argument.
+// Text is only produced at upload time, with DeferredLog::format(), and reads as
+// printf would have printed the call except that:
+// - arguments past MAX_ARGS are not kept and print as "<?>";
+// - integers keep their low 32 bits (a 64-bit %lld/%llu value prints truncated),
+//   and floating-point arguments are stored as float;
+// - %p prints the pointer as passed (a string argument's address, too), cut to its
+//   low 32 bits where pointers are wider (host builds);
+// - only the first string argument keeps text (STRING_BYTES - 1 characters);
+//   later %s arguments print as "<?>".
+#ifndef CRASH_LOG_HPP
+#define CRASH_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <main/config/config.hpp>
+
+namespace CrashLog {
+    static constexpr std::size_t MAX_ARGS = 4;
+    static constexpr std::size_t STRING_BYTES = 12;
+    static constexpr uint8_t CAPTURE_LEVEL = Config::Logging::crash_capture_level;
+
+    // 2 bits per argument in Record::kinds
+    enum ArgKind : uint8_t { INT = 0, UINT = 1, FLOAT = 2, STRING = 3 };
+
+    struct Record {
+        uint32_t    stamp;       // ring position + 1, written last; 0 = empty or torn
+        uint32_t    ts_ms;       // uptime of the boot that wrote it
+        const char* tag;
+        const char* fmt;
+        uint8_t     level;       // LogLevel value
+        uint8_t     arg_count;   // as called; arguments past MAX_ARGS are not kept
+        uint8_t     kinds;
+        uint8_t     text_arg;    // 1-based index of the argument held in text, 0 = none
+        uint32_t    args[MAX_ARGS];
+        char        text[STRING_BYTES]; // first %s argument, truncated
+    };
+
+    // Adopt the previous boot's records (if the reset kept them) and start a fresh
+    // ring. Call first thing in app_main; capture() is a no-op until then.
+    void init();
+
+    // Hot path behind Logger::log(): claim a slot, fill it, commit()
+    Record* claim(uint32_t& pos);
+    void commit(Record* record, uint32_t pos);
+
+    // Previous boot's records, oldest first
+    std::size_t pendingCount();
+    const Record& pending(std::size_t i);
+    void clearPending();
+    // Why the previous boot ended, e.g. "task_wdt" or "panic"
+    const char* resetReason();
+
+    // Text of a record (as printf would have produced, within the kept arguments)
+    void format(const Record& r, char* out, std::size_t cap);
+
+    namespace detail {
+        template <typename T>
+        inline void put(Record& r, std::size_t i, T value) {
+            if (i >= MAX_ARGS) {
+                return;
+            }
+            using D = std::decay_t<T>;
+            uint8_t kind = UINT;
+            if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+                kind = STRING;
+                r.args[i] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)); // for %p
+                // Only the first string argument is kept; later ones render as "<?>"
+                if (r.text_arg == 0 && value != nullptr) {
+                    std::size_t n = 0;
+                    while (n < STRING_BYTES - 1 && value[n] != '\0') {
+                        r.text[n] = value[n];
+                        n++;
+                    }
+                    r.text[n] = '\0';
+                    r.text_arg = static_cast<uint8_t>(i + 1);
+                }
+            } else if constexpr (std::is_null_pointer_v<D>) {
+                r.args[i] = 0;
+            } else if constexpr (std::is_pointer_v<D>) {
+                r.args[i] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+            } else if constexpr (std::is_floating_point_v<D>) {
+                kind = FLOAT;
+                const float f = static_cast<float>(value);
+                static_assert(sizeof(f) == sizeof(uint32_t), "float must be 32-bit");
+                __builtin_memcpy(&r.args[i], &f, sizeof(f));
+            } else if constexpr (std::is_enum_v<D> || std::is_signed_v<D>) {
+                kind = INT;
+                r.args[i] = static_cast<uint32_t>(static_cast<int32_t>(value));
+            } else {
+                r.args[i] = static_cast<uint32_t>(value);
+            }
+            r.kinds = static_cast<uint8_t>(r.kinds | (kind << (2 * i)));
+        }
+    }
+
+    // No-op above CAPTURE_LEVEL (folded away at LOG_* call sites, whose level is constant)
+    template <typename... Args>
+    inline void capture(uint8_t level, const char* tag, const char* fmt, Args... args) {
+        if (level > CAPTURE_LEVEL) {
+            return;
+        }
+        uint32_t pos = 0;
+        Record* r = claim(pos);
+        if (r == nullptr) {
+            return;
+        }
+        r->tag = tag;
+        r->fmt = fmt;
+        r->level = level;
+        r->arg_count = static_cast<uint8_t>(sizeof...(Args));
+        r->kinds = 0;
+        r->text_arg = 0;
+        std::size_t i = 0;
+        (detail::put(*r, i++, args), ...);
+        commit(r, pos);
+    }
+}
+
+#endif // CRASH_LOG_HPP
@@ -0,0 +1,343 @@
+#include <main/utils/deep_sleep_cycle.hpp>
+#include <main/utils/logger.hpp>
+#include <main/utils/time_sync.hpp>
+#include <main/utils/backlog_format.hpp>
+#include <main/utils/fixed_point.hpp>
+#include <main/utils/telemetry_codec.hpp>
+#include <main/config/config.hpp>
+#include <main/hardware/temperature_sensor.hpp>
+#include <main/hardware/soil_moisture_sensor.hpp>
+#include <main/models/moisture_data.hpp>
+#include <main/models/alert_request.hpp>
+#include <main/network/wifi_manager.hpp>
+#include <main/network/mqtt_client.hpp>
+#include <main/state/runtime_thresholds.hpp>
+#include <main/state/calibration.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <esp_wifi.h>
+#include <sys/time.h>
+#include <inttypes.h>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    static const char* TAG = "DEEP_SLEEP";
+
+    static constexpr uint32_t RTC_MAGIC = 0x44534C31; // "DSL1"
+
+    static constexpr uint8_t HAS_TEMP  = 0x01;
+    static constexpr uint8_t HAS_MOIST = 0x02;
+    static constexpr uint8_t HAS_EPOCH = 0x04; // time_ms is Unix epoch, else ms since power-on
+
+    struct Reading {
+        int64_t  time_ms;        // gettimeofday() at capture
+        int16_t  temp_centi;     // 0.01 degC
+        uint16_t moisture_centi; // 0.01 %
+        uint8_t  flags;
+        uint8_t  reserved[3];
+    };
+    static_assert(sizeof(Reading) == 16, "Reading layout is sized for RTC slow memory");
+
+    // Survives deep sleep; zeroed on power-on (RTC_DATA_ATTR), validated by magic
+    struct RtcState {
+        uint32_t magic;
+        uint32_t wakes_since_upload;
+        uint32_t head;            // oldest reading
+        uint32_t count;
+        uint32_t dropped;         // overwritten before they could be uploaded
+        AlertState last_state;    // threshold state at the previous wake
+        uint32_t awake_ms_sum;    // wake-to-sleep time since the last upload
+        uint32_t awake_ms_max;
+        uint32_t awake_cycles;
+        Reading ring[Config::DeepSleep::ring_capacity];
+    };
+    RTC_DATA_ATTR static RtcState s_rtc;
+
+    static WiFiManager s_wifi;
+    static MqttClient s_mqtt;
+
+    // Same sizing as the cloud task's backlog buffer
+    static char s_payload[160 + Config::Tasks::Backlog::batch_size * 24];
+    static_assert(sizeof(s_payload) >= TelemetryCodec::maxFrameBytes(Config::Tasks::Backlog::batch_size),
+                  "payload buffer too small for a binary batch");
+
+    static int64_t wallClockMs() {
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        return static_cast<int64_t>(tv.tv_sec) * 1000LL + tv.tv_usec / 1000;
+    }
+
+    static uint32_t uptimeMs() {
+        return static_cast<uint32_t>(esp_timer_get_time() / 1000LL);
+    }
+
+    static Reading& readingAt(uint32_t i) {
+        return s_rtc.ring[(s_rtc.head + i) % Config::DeepSleep::ring_capacity];
+    }
+
+    static void append(const Reading& r) {
+        if (s_rtc.count == Config::DeepSleep::ring_capacity) {
+            s_rtc.head = (s_rtc.head + 1) % Config::DeepSleep::ring_capacity;
+            s_rtc.count--;
+            s_rtc.dropped++;
+        }
+        readingAt(s_rtc.count) = r;
+        s_rtc.count++;
+    }
+
+    static Reading sample() {
+        Reading r{};
+        static TemperatureSensor temp_sensor;
+        int16_t temp_centi_c = 0;
+        if (temp_sensor.init() && temp_sensor.readTemperature(temp_centi_c)) {
+            r.temp_centi = temp_centi_c;
+            r.flags |= HAS_TEMP;
+        }
+        static SoilMoistureSensor moisture_sensor{ SoilMoistureSensor::Config{
+            Config::Hardware::Moisture::unit,
+            Config::Hardware::Moisture::channel,
+            Config::Hardware::Moisture::attenuation,
+            Config::Hardware::Moisture::sample_count,
+            Config::Hardware::Moisture::raw_dry,
+            Config::Hardware::Moisture::raw_wet
+        }};
+        const Calibration::Moisture cal = Calibration::getMoisture();
+        moisture_sensor.setCalibration(cal.raw_dry, cal.raw_wet);
+        MoistureData moisture{};
+        if (moisture_sensor.init() && moisture_sensor.read(moisture)) {
+            r.moisture_centi = moisture.moisture_centi_pct;
+            r.flags |= HAS_MOIST;
+        }
+        r.time_ms = wallClockMs();
+        if (TimeSync::clockIsValid()) {
+            r.flags |= HAS_EPOCH;
+        }
+        return r;
+    }
+
+    // Severity against the live thresholds, same ordering as the plant monitor
+    // (no debounce: one sample per wake)
+    static AlertState classify(const Reading& r, AlertReason& reason) {
+        AlertState state = AlertState::OK;
+        reason = AlertReason::CLEAR;
+        auto raise = [&](AlertState s, AlertReason why) {
+            if (static_cast<uint8_t>(s) > static_cast<uint8_t>(state)) {
+                state = s;
+                reason = why;
+            }
+        };
+        const RuntimeThresholds::Values th = RuntimeThresholds::snapshot();
+        if (r.flags & HAS_TEMP) {
+            const int32_t t = r.temp_centi;
+            if (t <= FixedPoint::toCenti(th.temp_low_crit_c))       raise(AlertState::CRITICAL, AlertReason::TEMP_LOW);
+            else if (t >= FixedPoint::toCenti(th.temp_high_crit_c)) raise(AlertState::CRITICAL, AlertReason::TEMP_HIGH);
+            else if (t <= FixedPoint::toCenti(th.temp_low_warn_c))  raise(AlertState::WARNING, AlertReason::TEMP_LOW);
+            else if (t >= FixedPoint::toCenti(th.temp_high_warn_c)) raise(AlertState::WARNING, AlertReason::TEMP_HIGH);
+        }
+        if (r.flags & HAS_MOIST) {
+            const int32_t m = r.moisture_centi;
+            if (m <= FixedPoint::toCenti(th.moisture_low_crit_pct))       raise(AlertState::CRITICAL, AlertReason::MOISTURE_LOW);
+            else if (m >= FixedPoint::toCenti(th.moisture_high_crit_pct)) raise(AlertState::CRITICAL, AlertReason::MOISTURE_HIGH);
+            else if (m <= FixedPoint::toCenti(th.moisture_low_warn_pct))  raise(AlertState::WARNING, AlertReason::MOISTURE_LOW);
+            else if (m >= FixedPoint::toCenti(th.moisture_high_warn_pct)) raise(AlertState::WARNING, AlertReason::MOISTURE_HIGH);
+        }
+        return state;
+    }
+
+    static bool waitFor(bool (*ready)(), uint32_t deadline_ms) {
+        while (!ready()) {
+            if (uptimeMs() >= deadline_ms) {
+                return false;
+            }
+            vTaskDelay(pdMS_TO_TICKS(50));
+        }
+        return true;
+    }
+
+    // Readings taken before the clock was ever set carry ms since power-on; once SNTP
+    // has stepped the clock, shift them by the step so they land on the epoch too
+    static void syncClock(uint32_t deadline_ms) {
+        const int64_t wall_before = wallClockMs();
+        const int64_t mono_before = esp_timer_get_time() / 1000LL;
+        TimeSync::init();
+        uint32_t now = uptimeMs();
+        if (!TimeSync::waitForSync((deadline_ms > now) ? (deadline_ms - now) : 0) || !TimeSync::clockIsValid()) {
+            return;
+        }
+        const int64_t step = (wallClockMs() - wall_before) - (esp_timer_get_time() / 1000LL - mono_before);
+        for (uint32_t i = 0; i < s_rtc.count; ++i) {
+            Reading& r = readingAt(i);
+            if ((r.flags & HAS_EPOCH) == 0) {
+                r.time_ms += step;
+                r.flags |= HAS_EPOCH;
+            }
+        }
+    }
+
+    // Publish every reading carrying `flag` in backlog batches; false on any failure
+    static bool publishKind(uint8_t flag, TelemetryCodec::Kind kind, const char* topic_fmt,
+                            const char* key, unsigned decimals) {
+        char topic[96];
+        std::snprintf(topic, sizeof(topic), topic_fmt, Config::Device::id);
+        const Reading* batch[Config::Tasks::Backlog::batch_size];
+        std::size_t n = 0;
+        for (uint32_t i = 0; i <= s_rtc.count; ++i) {
+            if (i < s_rtc.count && (readingAt(i).flags & flag)) {
+                batch[n++] = &readingAt(i);
+            }
+            if (n == 0 || (n < Config::Tasks::Backlog::batch_size && i < s_rtc.count)) {
+                continue;
+            }
+            bool have_epoch = true;
+            for (std::size_t j = 0; j < n; ++j) {
+                have_epoch = have_epoch && (batch[j]->flags & HAS_EPOCH);
+            }
+            auto value_at = [&](std::size_t j) {
+                return (flag == HAS_TEMP) ? static_cast<int32_t>(batch[j]->temp_centi)
+                                          : static_cast<int32_t>(batch[j]->moisture_centi);
+            };
+            auto epoch_at = [&](std::size_t j) { return static_cast<uint64_t>(batch[j]->time_ms); };
+            int len = (Config::Mqtt::Encoding::backlog == Config::Mqtt::PayloadFormat::BINARY)
+                ? BacklogFormat::encodeBinary(reinterpret_cast<uint8_t*>(s_payload), sizeof(s_payload),
+                                              kind, n, value_at, have_epoch, epoch_at)
+                : BacklogFormat::formatJson(s_payload, sizeof(s_payload), key, decimals,
+                                            n, value_at, have_epoch, epoch_at);
+            if (len < 0 || s_mqtt.publish(topic, reinterpret_cast<const uint8_t*>(s_payload), len,
+                                          Config::Mqtt::default_qos, Config::Mqtt::telemetry_retain) < 0) {
+                return false;
+            }
+            n = 0;
+        }
+        return true;
+    }
+
+    // False if the client refused the message (not connected, outbox full)
+    static bool publishAlert(AlertState state, AlertReason reason, const Reading& r) {
+        const char* s_str = (state == AlertState::CRITICAL) ? "CRITICAL"
+                           : (state == AlertState::WARNING)  ? "WARNING"
+                                                             : "OK";
+        const char* r_str = (reason == AlertReason::TEMP_HIGH)      ? "temp_high"
+                           : (reason == AlertReason::TEMP_LOW)      ? "temp_low"
+                           : (reason == AlertReason::MOISTURE_LOW)  ? "moisture_low"
+                           : (reason == AlertReason::MOISTURE_HIGH) ? "moisture_high"
+                                                                    : "clear";
+        char topic[96];
+        char payload[192];
+        char ts[16];
+        TimeSync::formatFixedTimestamp(ts, sizeof(ts));
+        std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::ALERT, Config::Device::id);
+        char t_str[16];
+        char m_str[16];
+        (void)FixedPoint::formatCenti(t_str, sizeof(t_str), r.temp_centi, 2);
+        (void)FixedPoint::formatCenti(m_str, sizeof(m_str), r.moisture_centi, 1);
+        std::snprintf(payload, sizeof(payload),
+                      "{\"state\":\"%s\",\"reason\":\"%s\",\"temp\":%s,\"moisture\":%s,\"ts\":\"%s\"}",
+                      s_str, r_str, t_str, m_str, ts);
+        if (s_mqtt.publish(topic, payload, Config::Mqtt::default_qos, false) < 0) {
+            LOG_WARN(TAG, "%s", "Alert publish refused");
+            return false;
+        }
+        LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
+        return true;
+    }
+
+    static void publishStatus() {
+        char topic[96];
+        char payload[224];
+        std::snprintf(topic, sizeof(topic), Config::Mqtt::Topics::STATUS, Config::Device::id);
+        uint32_t avg = (s_rtc.awake_cycles > 0) ? s_rtc.awake_ms_sum / s_rtc.awake_cycles : 0;
+        std::snprintf(payload, sizeof(payload),
+                      "{\"status\":\"sleeping\",\"wakes\":%" PRIu32 ",\"samples\":%" PRIu32 ",\"dropped\":%" PRIu32
+                      ",\"awake_ms_avg\":%" PRIu32 ",\"awake_ms_max\":%" PRIu32 ",\"wake_period_s\":%" PRIu32 "}",
+                      s_rtc.wakes_since_upload, s_rtc.count, s_rtc.dropped, avg, s_rtc.awake_ms_max,
+                      Config::DeepSleep::wake_period_s);
+        (void)s_mqtt.publish(topic, payload, Config::Mqtt::default_qos, true);
+        LOG_INFO(TAG, "MQTT TX topic=%s payload=%s", topic, payload);
+    }
+
+    static bool upload(bool crossed, AlertState state, AlertReason reason, const Reading& latest) {
+        const uint32_t deadline_ms = uptimeMs() + Config::DeepSleep::link_timeout_ms;
+        if (!s_wifi.init() || (!Config::Wifi::auto_connect_on_start && !s_wifi.connect())) {
+            return false;
+        }
+        bool ok = waitFor([] { return s_wifi.hasIp(); }, deadline_ms);
+        if (ok && !Config::Features::simulate_hardware) {
+            syncClock(deadline_ms);
+        }
+        ok = ok && s_mqtt.init() && s_mqtt.connect() && waitFor([] { return s_mqtt.isConnected(); }, deadline_ms);
+        if (ok) {
+            ok = publishKind(HAS_TEMP, TelemetryCodec::Kind::TEMPERATURE, Config::Mqtt::Topics::TEMPERATURE_BACKLOG, "values", 2U)
+                && publishKind(HAS_MOIST, TelemetryCodec::Kind::MOISTURE, Config::Mqtt::Topics::MOISTURE_BACKLOG, "percent", 1U);
+            if (crossed) {
+                ok = publishAlert(state, reason, latest) && ok;
+            }
+            publishStatus();
+            // QoS 1: only forget the readings (and settle the crossing) once the broker has acked them
+            ok = ok && waitFor([] { return s_mqtt.outboxBytes() == 0; }, uptimeMs() + Config::DeepSleep::drain_timeout_ms);
+        }
+        s_mqtt.disconnect();
+        s_wifi.disconnect();
+        if (!Config::Features::simulate_hardware) {
+            (void)esp_wifi_stop();
+        }
+        return ok;
+    }
+
+    [[noreturn]] static void sleepNow() {
+        // Wake-to-sleep time: esp_timer starts at app start (excludes ROM/bootloader)
+        uint32_t awake_ms = uptimeMs();
+        s_rtc.awake_ms_sum += awake_ms;
+        s_rtc.awake_cycles++;
+        if (awake_ms > s_rtc.awake_ms_max) {
+            s_rtc.awake_ms_max = awake_ms;
+        }
+        LOG_INFO(TAG, "Awake %" PRIu32 " ms, %" PRIu32 " readings held, sleeping %" PRIu32 " s",
+                 awake_ms, s_rtc.count, Config::DeepSleep::wake_period_s);
+        (void)esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(Config::DeepSleep::wake_period_s) * 1000000ULL);
+        esp_deep_sleep_start();
+        for (;;) {
+        }
+    }
+}
+
+namespace DeepSleepCycle {
+    void run() {
+        if (s_rtc.magic != RTC_MAGIC) {
+            std::memset(&s_rtc, 0, sizeof(s_rtc));
+            s_rtc.magic = RTC_MAGIC;
+            LOG_INFO(TAG, "%s", "RTC ring initialized (power-on)");
+        }
+
+        Reading latest = sample();
+        append(latest);
+        s_rtc.wakes_since_upload++;
+
+        AlertReason reason = AlertReason::CLEAR;
+        AlertState state = classify(latest, reason);
+        const bool crossed = (state != s_rtc.last_state);
+
+        if (crossed || s_rtc.wakes_since_upload >= Config::DeepSleep::publish_every_n_wakes) {
+            LOG_INFO(TAG, "Upload: %" PRIu32 " readings (%s)", s_rtc.count, crossed ? "threshold crossed" : "scheduled");
+            if (upload(crossed, state, reason, latest)) {
+                // upload() is true only once the alert was accepted and the outbox drained;
+                // otherwise the crossing stays open and the alert is retried next wake
+                s_rtc.last_state = state;
+                s_rtc.head = 0;
+                s_rtc.count = 0;
+                s_rtc.dropped = 0;
+                s_rtc.awake_ms_sum = 0;
+                s_rtc.awake_ms_max = 0;
+                s_rtc.awake_cycles = 0;
+            } else {
+                LOG_WARN(TAG, "%s", "Upload failed; keeping readings for the next upload window");
+            }
+            // A failed scheduled upload waits a full window rather than burning the battery every wake
+            s_rtc.wakes_since_upload = 0;
+        }
+        sleepNow();
+    }
+}
@@ -0,0 +1,16 @@
+// Deep-sleep duty cycle for battery probes (Config::Features::deep_sleep_mode).
+// Each timer wake samples both sensors straight from app_main, appends the reading
+// to a ring in RTC slow memory and goes back to deep sleep without starting WiFi or
+// the task graph. Every Config::DeepSleep::publish_every_n_wakes wakes, or when a
+// reading crosses a RuntimeThresholds boundary, the wake also connects and publishes
+// the ring in batches on the backlog topics (plus an alert on a crossing).
+#ifndef DEEP_SLEEP_CYCLE_HPP
+#define DEEP_SLEEP_CYCLE_HPP
+
+namespace DeepSleepCycle {
+    // Sample, maybe upload, then enter deep sleep. Never returns.
+    // Requires NVS and RuntimeThresholds::init().
+    [[noreturn]] void run();
+}
+
+#endif // DEEP_SLEEP_CYCLE_HPP
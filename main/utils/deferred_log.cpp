@@ -0,0 +1,322 @@
+#include <main/utils/deferred_log.hpp>
+#include <main/utils/logger.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <main/config/config.hpp>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    static const char* TAG = "DLOG";
+
+    static constexpr std::size_t DEPTH = Config::Logging::ring_depth;
+    static_assert(DEPTH >= 4 && (DEPTH & (DEPTH - 1)) == 0, "ring_depth must be a power of two, at least 4");
+    static constexpr uint32_t MASK = DEPTH - 1;
+
+    // Bounded MPSC ring (Vyukov): slot i is free for position p when s_seq[i] == p and
+    // holds a committed record for the drain when s_seq[i] == p + 1. Producers claim
+    // positions with a CAS on s_tail, so any task can log without a lock.
+    // A slot the drain gave up on (claimed at p, never committed) is marked p + DEPTH - 1:
+    // neither free nor committed for any position, so the next lap's producer sees a
+    // full ring until the late commit() frees it.
+    static std::atomic<uint32_t> s_seq[DEPTH];
+    static DeferredLog::Record s_records[DEPTH];
+    static uint32_t s_claimed[DEPTH]; // position a producer holds the slot for
+    static std::atomic<uint32_t> s_tail{0};
+    static uint32_t s_head = 0; // drain task only
+    static std::atomic<uint32_t> s_dropped{0};
+    static std::atomic<uint32_t> s_abandoned{0};
+    static std::atomic<bool> s_running{false};
+    static TaskHandle_t s_task_handle = nullptr;
+    // Set by the drain before it blocks; the first producer to see it set notifies,
+    // so a busy drain costs producers no kernel call
+    static std::atomic<bool> s_drain_waiting{false};
+
+    static StaticTask_t s_task_tcb;
+    static StackType_t s_task_stack[3072 / sizeof(StackType_t)];
+
+    static char s_line[LOGGER_MAX_MESSAGE_LEN];
+
+    static void write(uint8_t level, const char* tag, const char* text) {
+        switch (level) {
+            case 0:  ESP_LOGE(tag, "%s", text); break;
+            case 1:  ESP_LOGW(tag, "%s", text); break;
+            case 3:  ESP_LOGD(tag, "%s", text); break;
+            default: ESP_LOGI(tag, "%s", text); break;
+        }
+    }
+
+    // Report losses since the last report (drain task only)
+    static void reportLosses(uint32_t& reported_dropped, uint32_t& reported_abandoned) {
+        const uint32_t dropped = s_dropped.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped) {
+            std::snprintf(s_line, sizeof(s_line), "%lu log records dropped (ring full)",
+                          static_cast<unsigned long>(dropped - reported_dropped));
+            write(1, TAG, s_line);
+            reported_dropped = dropped;
+        }
+        const uint32_t abandoned = s_abandoned.load(std::memory_order_relaxed);
+        if (abandoned != reported_abandoned) {
+            std::snprintf(s_line, sizeof(s_line), "%lu log records skipped (not committed within %lu ms)",
+                          static_cast<unsigned long>(abandoned - reported_abandoned),
+                          static_cast<unsigned long>(Config::Logging::commit_timeout_ms));
+            write(1, TAG, s_line);
+            reported_abandoned = abandoned;
+        }
+    }
+
+    // Give the drain's notification if it is (about to be) blocked
+    static void wakeDrain() {
+        // Order the caller's slot update before the flag load (pairs with waitForWork())
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (s_drain_waiting.load(std::memory_order_relaxed) &&
+            s_drain_waiting.exchange(false, std::memory_order_relaxed)) {
+            (void)xTaskNotifyGive(s_task_handle);
+        }
+    }
+
+    // Block for up to ticks unless slot i moved on from seq, or a record was dropped
+    // since the last report, meanwhile. A producer that changes either after this
+    // re-check sees s_drain_waiting and notifies.
+    static void waitForWork(uint32_t i, uint32_t seq, uint32_t reported_dropped, TickType_t ticks) {
+        s_drain_waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (s_seq[i].load(std::memory_order_relaxed) == seq &&
+            s_dropped.load(std::memory_order_relaxed) == reported_dropped) {
+            (void)ulTaskNotifyTake(pdTRUE, ticks);
+        }
+        s_drain_waiting.store(false, std::memory_order_relaxed);
+    }
+
+    // Sleeps on its task notification, given by commit() and a dropped claim() while
+    // it waits. The only timed wait is for a head slot claimed but not yet committed,
+    // so an idle drain never wakes and does not hold off light sleep.
+    static void drainTask(void* arg) {
+        (void)arg;
+        const TickType_t commit_timeout = pdMS_TO_TICKS(Config::Logging::commit_timeout_ms);
+        uint32_t reported_dropped = 0;
+        uint32_t reported_abandoned = 0;
+        bool stalled = false;          // head slot claimed but not committed...
+        TickType_t stalled_since = 0;  // ...since this tick
+        for (;;) {
+            const uint32_t i = s_head & MASK;
+            uint32_t seq = s_seq[i].load(std::memory_order_acquire);
+            if (seq != s_head + 1U) {
+                reportLosses(reported_dropped, reported_abandoned);
+                const bool claimed = (seq == s_head) &&
+                                     static_cast<int32_t>(s_tail.load(std::memory_order_relaxed) - s_head) > 0;
+                if (!claimed) {
+                    stalled = false;
+                    waitForWork(i, seq, reported_dropped, portMAX_DELAY);
+                    continue;
+                }
+                const TickType_t now = xTaskGetTickCount();
+                if (!stalled) {
+                    stalled = true;
+                    stalled_since = now;
+                }
+                const TickType_t waited = now - stalled_since;
+                if (waited >= commit_timeout) {
+                    // Give up on it unless the producer commits first; commit() frees it later
+                    if (s_seq[i].compare_exchange_strong(seq, s_head + DEPTH - 1U, std::memory_order_relaxed)) {
+                        s_abandoned.fetch_add(1, std::memory_order_relaxed);
+                        s_head++;
+                        stalled = false;
+                        reportLosses(reported_dropped, reported_abandoned); // at the gap
+                    }
+                    continue;
+                }
+                // Woken early by its commit, or by records committed behind it
+                waitForWork(i, seq, reported_dropped, commit_timeout - waited);
+                continue;
+            }
+            stalled = false;
+            DeferredLog::format(s_records[i], s_line, sizeof(s_line));
+            write(s_records[i].level, s_records[i].tag, s_line);
+            // Free the slot for the producer one lap ahead
+            s_seq[i].store(s_head + DEPTH, std::memory_order_release);
+            s_head++;
+        }
+    }
+}
+
+namespace DeferredLog {
+    void start() {
+        if (s_running.load(std::memory_order_relaxed)) {
+            return;
+        }
+        for (uint32_t i = 0; i < DEPTH; ++i) {
+            s_seq[i].store(i, std::memory_order_relaxed);
+        }
+        s_task_handle = xTaskCreateStatic(drainTask, "log_drain",
+                                          sizeof(s_task_stack) / sizeof(StackType_t), nullptr,
+                                          Config::TaskPriorities::LOW, s_task_stack, &s_task_tcb);
+        s_running.store(true, std::memory_order_release);
+    }
+
+    bool running() {
+        return s_running.load(std::memory_order_acquire);
+    }
+
+    Record* claim() {
+        uint32_t pos = s_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint32_t i = pos & MASK;
+            const int32_t diff = static_cast<int32_t>(s_seq[i].load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (s_tail.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) {
+                    s_claimed[i] = pos;
+                    return &s_records[i];
+                }
+            } else if (diff < 0) {
+                // Drain is a full lap behind; wake it to report the loss
+                s_dropped.fetch_add(1, std::memory_order_relaxed);
+                wakeDrain();
+                return nullptr;
+            } else {
+                pos = s_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void commit(Record* record) {
+        const std::size_t i = static_cast<std::size_t>(record - s_records);
+        const uint32_t pos = s_claimed[i];
+        uint32_t expected = pos;
+        if (!s_seq[i].compare_exchange_strong(expected, pos + 1U, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+            // The drain skipped this record while it was being filled; the slot is
+            // ours until now, so hand it to the producer one lap ahead
+            s_seq[i].store(pos + DEPTH, std::memory_order_release);
+        }
+        wakeDrain();
+    }
+
+    // Re-run printf one conversion at a time, passing each stored argument with the
+    // type its length modifier asks for
+    void format(const Record& r, char* out, std::size_t cap) {
+        std::size_t off = 0;
+        std::size_t next_arg = 0;
+        const char* f = r.fmt;
+        auto room = [&]() { return (off < cap) ? cap - off : 0; };
+        // snprintf reports the untruncated length; stop at the end of out
+        auto advance = [&](int n) {
+            if (n > 0) {
+                off = (off + static_cast<std::size_t>(n) < cap) ? off + static_cast<std::size_t>(n) : cap - 1;
+            }
+        };
+
+        while (*f != '\0' && off + 1 < cap) {
+            if (*f != '%') {
+                out[off++] = *f++;
+                continue;
+            }
+            if (f[1] == '%') {
+                out[off++] = '%';
+                f += 2;
+                continue;
+            }
+
+            // Copy "%[flags][width][.precision][length]conv", resolving '*' from the args
+            char spec[48];
+            std::size_t s = 0;
+            spec[s++] = *f++;
+            bool ok = true;
+            while (*f != '\0' && std::strchr("-+ #0", *f) != nullptr && s < 8) {
+                spec[s++] = *f++;
+            }
+            for (int part = 0; part < 2 && ok; ++part) {
+                if (part == 1) {
+                    if (*f != '.') {
+                        break;
+                    }
+                    spec[s++] = *f++;
+                }
+                if (*f == '*') {
+                    f++;
+                    if (next_arg >= r.arg_count) {
+                        ok = false;
+                        break;
+                    }
+                    s += static_cast<std::size_t>(std::snprintf(spec + s, sizeof(spec) - s, "%d", static_cast<int>(r.args[next_arg++].i)));
+                } else {
+                    while (*f >= '0' && *f <= '9' && s < 32) {
+                        spec[s++] = *f++;
+                    }
+                }
+            }
+            char length[3] = {};
+            std::size_t l = 0;
+            while (*f != '\0' && std::strchr("hljztL", *f) != nullptr && l < 2) {
+                length[l++] = *f;
+                spec[s++] = *f++;
+            }
+            const char conv = *f;
+            if (conv == '\0' || !ok || next_arg >= r.arg_count) {
+                advance(std::snprintf(out + off, room(), "%s", "<?>"));
+                break;
+            }
+            spec[s++] = *f++;
+            spec[s] = '\0';
+
+            const std::size_t a = next_arg++;
+            const bool is_long = (l == 1 && length[0] == 'l');
+            const bool is_long_long = (l == 2 && length[0] == 'l') || length[0] == 'j';
+            const bool is_size = length[0] == 'z' || length[0] == 't';
+            switch (conv) {
+                case 'd':
+                case 'i':
+                    if (is_long_long)  advance(std::snprintf(out + off, room(), spec, static_cast<long long>(r.args[a].i)));
+                    else if (is_long)  advance(std::snprintf(out + off, room(), spec, static_cast<long>(r.args[a].i)));
+                    else if (is_size)  advance(std::snprintf(out + off, room(), spec, static_cast<ptrdiff_t>(r.args[a].i)));
+                    else               advance(std::snprintf(out + off, room(), spec, static_cast<int>(r.args[a].i)));
+                    break;
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o':
+                    if (is_long_long)  advance(std::snprintf(out + off, room(), spec, static_cast<unsigned long long>(r.args[a].u)));
+                    else if (is_long)  advance(std::snprintf(out + off, room(), spec, static_cast<unsigned long>(r.args[a].u)));
+                    else if (is_size)  advance(std::snprintf(out + off, room(), spec, static_cast<std::size_t>(r.args[a].u)));
+                    else               advance(std::snprintf(out + off, room(), spec, static_cast<unsigned>(r.args[a].u)));
+                    break;
+                case 'c':
+                    advance(std::snprintf(out + off, room(), spec, static_cast<int>(r.args[a].i)));
+                    break;
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                    if (length[0] == 'L') advance(std::snprintf(out + off, room(), spec, static_cast<long double>(r.args[a].d)));
+                    else                  advance(std::snprintf(out + off, room(), spec, r.args[a].d));
+                    break;
+                case 's':
+                    advance(std::snprintf(out + off, room(), spec,
+                                          r.kinds[a] == ArgKind::STRING ? &r.strings[r.str_offsets[a]] : "<?>"));
+                    break;
+                case 'p':
+                    // STRING args keep the caller's pointer alongside the copy
+                    advance(std::snprintf(out + off, room(), spec, r.args[a].p));
+                    break;
+                default:
+                    // %n and unknown conversions are not replayed
+                    break;
+            }
+        }
+        out[off] = '\0';
+    }
+
+    uint32_t dropped() {
+        return s_dropped.load(std::memory_order_relaxed);
+    }
+
+    uint32_t abandoned() {
+        return s_abandoned.load(std::memory_order_relaxed);
+    }
+}
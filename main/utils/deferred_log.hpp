@@ -0,0 +1,127 @@
+// Deferred log records: the caller stores the tag and format pointers plus its raw
+// arguments in a lock-free ring and returns; a low-priority drain task does the
+// formatting and the UART write later. Tags and formats must be string literals
+// (or otherwise outlive the record, as every TAG in this tree does); %s arguments
+// are copied into the record, truncated to STRING_BYTES (%p on a string argument
+// still prints the caller's pointer).
+// Output order is preserved; the ESP-IDF timestamp on each line is drain time. A
+// record left claimed but uncommitted for Config::Logging::commit_timeout_ms (its
+// task preempted or suspended mid-fill) is skipped so it cannot hold up the rest.
+#ifndef DEFERRED_LOG_HPP
+#define DEFERRED_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace DeferredLog {
+    static constexpr std::size_t MAX_ARGS = 8;
+    static constexpr std::size_t STRING_BYTES = 96;
+
+    enum class ArgKind : uint8_t { INT, UINT, DOUBLE, POINTER, STRING };
+
+    struct Record {
+        const char* tag;
+        const char* fmt;
+        uint8_t     level;     // LogLevel value
+        uint8_t     arg_count;
+        uint8_t     string_used;
+        ArgKind     kinds[MAX_ARGS];
+        uint8_t     str_offsets[MAX_ARGS]; // STRING args: copy in strings
+        union {
+            long long          i;
+            unsigned long long u;
+            double             d;
+            const void*        p;          // POINTER and STRING (as passed)
+        } args[MAX_ARGS];
+        char strings[STRING_BYTES];
+    };
+
+    // Start the drain task; until then push() returns false and callers log directly
+    void start();
+
+    bool running();
+
+    // Claim a free slot (nullptr when the ring is full; counted as dropped) and
+    // hand it back with commit() once filled
+    Record* claim();
+    void commit(Record* record);
+
+    // Records lost to a full ring since boot
+    uint32_t dropped();
+    // Records the drain skipped because they were not committed in time
+    uint32_t abandoned();
+
+    // Render a record as printf would have (also used for CrashLog records)
+    void format(const Record& r, char* out, std::size_t cap);
+
+    namespace detail {
+        inline void addString(Record& r, std::size_t i, const char* s) {
+            r.kinds[i] = ArgKind::STRING;
+            r.args[i].p = s;
+            r.str_offsets[i] = r.string_used;
+            std::size_t n = 0;
+            const std::size_t room = STRING_BYTES - r.string_used - 1U; // string_used < STRING_BYTES
+            if (s == nullptr) {
+                s = "(null)";
+            }
+            while (n < room && s[n] != '\0') {
+                r.strings[r.string_used + n] = s[n];
+                n++;
+            }
+            r.strings[r.string_used + n] = '\0';
+            // Keep one byte free so a later string gets at least a terminator
+            r.string_used = static_cast<uint8_t>((r.string_used + n + 1U < STRING_BYTES) ? r.string_used + n + 1U
+                                                                                          : STRING_BYTES - 1U);
+        }
+
+        template <typename T>
+        inline void add(Record& r, std::size_t i, T value) {
+            using D = std::decay_t<T>;
+            if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+                addString(r, i, value);
+            } else if constexpr (std::is_pointer_v<D> || std::is_null_pointer_v<D>) {
+                r.kinds[i] = ArgKind::POINTER;
+                r.args[i].p = value;
+            } else if constexpr (std::is_floating_point_v<D>) {
+                r.kinds[i] = ArgKind::DOUBLE;
+                r.args[i].d = static_cast<double>(value);
+            } else if constexpr (std::is_enum_v<D> || std::is_signed_v<D>) {
+                r.kinds[i] = ArgKind::INT;
+                r.args[i].i = static_cast<long long>(value);
+            } else {
+                static_assert(std::is_integral_v<D>, "unsupported log argument type");
+                r.kinds[i] = ArgKind::UINT;
+                r.args[i].u = static_cast<unsigned long long>(value);
+            }
+        }
+    }
+
+    // Queue one log call. True when handled: queued, or dropped (and counted) because
+    // the ring is full. False when not running or over MAX_ARGS; log directly then.
+    template <typename... Args>
+    inline bool push(uint8_t level, const char* tag, const char* fmt, Args... args) {
+        if constexpr (sizeof...(Args) > MAX_ARGS) {
+            return false;
+        } else {
+            if (!running()) {
+                return false;
+            }
+            Record* r = claim();
+            if (r == nullptr) {
+                return true;
+            }
+            r->tag = tag;
+            r->fmt = fmt;
+            r->level = level;
+            r->arg_count = static_cast<uint8_t>(sizeof...(Args));
+            r->string_used = 0;
+            std::size_t i = 0;
+            (detail::add(*r, i++, args), ...);
+            commit(r);
+            return true;
+        }
+    }
+}
+
+#endif // DEFERRED_LOG_HPP
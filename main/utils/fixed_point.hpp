@@ -0,0 +1,160 @@
+// Integer-only sensor conversion and formatting.
+// Readings travel through the pipeline in centi-units (0.01 degC, 0.01 %), so the
+// monitor, LCD and cloud paths compare and print them without touching the FPU.
+// The conversion kernels are specialised on the calibration constants at compile
+// time: each scale factor folds into a Q16 multiplier, leaving one multiply and a
+// shift per reading. Any float math below runs in the compiler only.
+#ifndef FIXED_POINT_HPP
+#define FIXED_POINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <inttypes.h>
+
+namespace FixedPoint {
+    static constexpr int32_t CENTI_PER_UNIT = 100;
+    static constexpr int32_t PERCENT_CENTI_MAX = 100 * CENTI_PER_UNIT;
+
+    // Divide rounding half away from zero (den > 0)
+    constexpr int32_t divRound(int64_t num, int64_t den) {
+        return static_cast<int32_t>((num < 0) ? -((-num + den / 2) / den) : (num + den / 2) / den);
+    }
+
+    // Float to centi-units, for thresholds and other values off the sample path
+    constexpr int32_t toCenti(float value) {
+        float scaled = value * static_cast<float>(CENTI_PER_UNIT);
+        if (!(scaled > -2147483520.0f)) {  // also catches NaN
+            return INT32_MIN;
+        }
+        if (scaled > 2147483520.0f) {
+            return INT32_MAX;
+        }
+        return static_cast<int32_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+    }
+
+    // Linear analog front end: raw counts over [0, ADC_MAX] span [0, FULL_SCALE_MV],
+    // then GAIN_PER_MV units per mV (LM35: 0.1 degC/mV)
+    template <uint32_t FULL_SCALE_MV, uint32_t ADC_MAX, float GAIN_PER_MV>
+    struct LinearKernel {
+        static_assert(ADC_MAX > 0 && FULL_SCALE_MV > 0 && GAIN_PER_MV > 0.0f, "invalid calibration");
+
+        // Centi-units per raw count, Q16
+        static constexpr uint32_t SCALE_Q16 = static_cast<uint32_t>(
+            static_cast<double>(GAIN_PER_MV) * FULL_SCALE_MV * CENTI_PER_UNIT * 65536.0 / ADC_MAX + 0.5);
+        static_assert(static_cast<uint64_t>(ADC_MAX) * SCALE_Q16 + 0x8000U <= UINT32_MAX,
+                      "full-scale reading overflows the 32-bit kernel");
+
+        static constexpr int32_t toCenti(uint32_t raw) {
+            if (raw > ADC_MAX) {
+                raw = ADC_MAX;
+            }
+            return static_cast<int32_t>((raw * SCALE_Q16 + 0x8000U) >> 16);
+        }
+
+        // Float formula this kernel replaces (compile-time checks only)
+        static constexpr double reference(uint32_t raw) {
+            return static_cast<double>(GAIN_PER_MV) * (static_cast<double>(raw) / ADC_MAX * FULL_SCALE_MV);
+        }
+    };
+
+    // Calibrated millivolts (adc_cali) to centi-units at GAIN_PER_MV units per mV
+    template <float GAIN_PER_MV>
+    struct MillivoltKernel {
+        static_assert(GAIN_PER_MV > 0.0f, "invalid calibration");
+
+        static constexpr uint32_t MV_MAX = 3900; // above any attenuation's range
+        static constexpr uint32_t SCALE_Q16 = static_cast<uint32_t>(
+            static_cast<double>(GAIN_PER_MV) * CENTI_PER_UNIT * 65536.0 + 0.5);
+        static_assert(static_cast<uint64_t>(MV_MAX) * SCALE_Q16 + 0x8000U <= UINT32_MAX,
+                      "gain too large for the 32-bit kernel");
+
+        static constexpr int32_t toCenti(uint32_t mv) {
+            if (mv > MV_MAX) {
+                mv = MV_MAX;
+            }
+            return static_cast<int32_t>((mv * SCALE_Q16 + 0x8000U) >> 16);
+        }
+    };
+
+    // Two-point moisture calibration, clamped to 0..100 %. Either order works: many
+    // capacitive probes read LOWER when wet (raw_dry > raw_wet).
+    struct MoistureScale {
+        uint16_t raw_dry;
+        bool     inverted;   // raw_dry > raw_wet
+        uint32_t span;       // |raw_dry - raw_wet|, 0 = uncalibrated
+        uint32_t scale_q16;  // centi-percent per count of span, Q16
+
+        constexpr MoistureScale(uint16_t dry, uint16_t wet)
+            : raw_dry(dry),
+              inverted(dry > wet),
+              span(dry > wet ? static_cast<uint32_t>(dry - wet) : static_cast<uint32_t>(wet - dry)),
+              scale_q16(span == 0 ? 0U : (static_cast<uint32_t>(PERCENT_CENTI_MAX) * 65536U + span / 2U) / span) {}
+
+        constexpr int32_t toCenti(uint32_t raw) const {
+            if (span == 0) {
+                return 0;
+            }
+            const int32_t offset = inverted ? static_cast<int32_t>(raw_dry) - static_cast<int32_t>(raw)
+                                            : static_cast<int32_t>(raw) - static_cast<int32_t>(raw_dry);
+            if (offset <= 0) {
+                return 0;
+            }
+            if (static_cast<uint32_t>(offset) >= span) {
+                return PERCENT_CENTI_MAX;
+            }
+            // offset < span, so the product stays below 10000 * 65536
+            return static_cast<int32_t>((static_cast<uint32_t>(offset) * scale_q16 + 0x8000U) >> 16);
+        }
+
+        // Float formula this kernel replaces (compile-time checks only)
+        constexpr double reference(uint32_t raw) const {
+            if (span == 0) {
+                return 0.0;
+            }
+            const double offset = inverted ? static_cast<double>(raw_dry) - raw : static_cast<double>(raw) - raw_dry;
+            const double percent = 100.0 * offset / span;
+            return percent < 0.0 ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+        }
+    };
+
+    template <uint16_t RAW_DRY, uint16_t RAW_WET>
+    struct MoistureKernel {
+        static constexpr MoistureScale SCALE{RAW_DRY, RAW_WET};
+
+        static constexpr int32_t toCenti(uint32_t raw) { return SCALE.toCenti(raw); }
+        static constexpr double reference(uint32_t raw) { return SCALE.reference(raw); }
+    };
+
+    // Largest |kernel - float formula| in centi-units over every raw value in
+    // [0, adc_max]; lets each sensor static_assert its kernel's accuracy
+    template <typename Kernel>
+    constexpr int32_t maxErrorCenti(uint32_t adc_max) {
+        int32_t worst = 0;
+        for (uint32_t raw = 0; raw <= adc_max; ++raw) {
+            const double ref = Kernel::reference(raw) * CENTI_PER_UNIT;
+            const int32_t ref_centi = static_cast<int32_t>(ref < 0.0 ? ref - 0.5 : ref + 0.5);
+            int32_t err = Kernel::toCenti(raw) - ref_centi;
+            err = (err < 0) ? -err : err;
+            worst = (err > worst) ? err : worst;
+        }
+        return worst;
+    }
+
+    // Print centi-units with 1 or 2 decimals ("-3.25", "41.5"), rounding half away
+    // from zero. Returns the snprintf result.
+    inline int formatCenti(char* out, std::size_t size, int32_t centi, unsigned decimals) {
+        const int32_t value = (decimals >= 2) ? centi : divRound(centi, 10);
+        const int32_t unit = (decimals >= 2) ? 100 : 10;
+        const uint32_t mag = (value < 0) ? 0U - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+        return std::snprintf(out, size, (decimals >= 2) ? "%s%" PRIu32 ".%02" PRIu32 : "%s%" PRIu32 ".%" PRIu32,
+                             (value < 0) ? "-" : "", mag / static_cast<uint32_t>(unit), mag % static_cast<uint32_t>(unit));
+    }
+
+    // Centi-units to the binary codec's deci-units
+    constexpr int32_t centiToDeci(int32_t centi) {
+        return divRound(centi, 10);
+    }
+}
+
+#endif // FIXED_POINT_HPP
@@ -1,25 +1,130 @@
 #include <main/utils/logger.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/portmacro.h>
 #include <cstdio>
+#include <cstring>
 
 // Default log level
 LogLevel Logger::s_level = LogLevel::INFO;
+std::atomic<int8_t> Logger::s_tag_levels[Logger::MAX_TAGS + 1];
+
+namespace {
+    // Interned tags: id = index. Names are copied so MQTT-supplied tags can be
+    // registered before the first LOG_* call for them.
+    struct TagEntry {
+        char name[Logger::MAX_TAG_LEN + 1];
+        bool overridden; // level set per tag rather than following setLevel()
+    };
+    static TagEntry s_tags[Logger::MAX_TAGS];
+    static std::size_t s_tag_count = 0;
+    static portMUX_TYPE s_tag_mux = portMUX_INITIALIZER_UNLOCKED;
+
+    static constexpr esp_log_level_t ESP_LEVELS[] = {ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG};
+
+    // Caller holds s_tag_mux
+    static std::size_t findTag(const char* tag) {
+        for (std::size_t i = 0; i < s_tag_count; ++i) {
+            if (std::strncmp(s_tags[i].name, tag, Logger::MAX_TAG_LEN) == 0) {
+                return i;
+            }
+        }
+        return Logger::MAX_TAGS;
+    }
+}
 
 void Logger::setLevel(LogLevel level) {
+    taskENTER_CRITICAL(&s_tag_mux);
     s_level = level;
+    const std::size_t count = s_tag_count;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!s_tags[i].overridden) {
+            s_tag_levels[i].store(static_cast<int8_t>(level), std::memory_order_relaxed);
+        }
+    }
+    s_tag_levels[MAX_TAGS].store(static_cast<int8_t>(level), std::memory_order_relaxed);
+    taskEXIT_CRITICAL(&s_tag_mux);
+
+    // ESP-IDF filters ESP_LOGx (and so every line written here) a second time. Setting
+    // "*" also drops its per-tag levels, so put the overrides back afterwards.
+    // esp_log_level_set() takes a mutex: outside the critical section, one tag at a time.
+    esp_log_level_set("*", ESP_LEVELS[static_cast<int>(level)]);
+    for (std::size_t i = 0; i < count; ++i) {
+        taskENTER_CRITICAL(&s_tag_mux);
+        const bool overridden = s_tags[i].overridden;
+        const int8_t tag_level = s_tag_levels[i].load(std::memory_order_relaxed);
+        taskEXIT_CRITICAL(&s_tag_mux);
+        if (overridden) {
+            // Names never change once interned
+            esp_log_level_set(s_tags[i].name, ESP_LEVELS[tag_level]);
+        }
+    }
 }
 
 LogLevel Logger::getLevel() {
     return s_level;
 }
 
+uint8_t Logger::internTag(const char* tag) {
+    taskENTER_CRITICAL(&s_tag_mux);
+    std::size_t id = findTag(tag);
+    if (id == MAX_TAGS && s_tag_count < MAX_TAGS) {
+        id = s_tag_count++;
+        std::strncpy(s_tags[id].name, tag, MAX_TAG_LEN);
+        s_tags[id].name[MAX_TAG_LEN] = '\0';
+        s_tags[id].overridden = false;
+        s_tag_levels[id].store(static_cast<int8_t>(s_level), std::memory_order_relaxed);
+    } else if (id == MAX_TAGS) {
+        // Table full: share the overflow slot, which always follows setLevel()
+        s_tag_levels[MAX_TAGS].store(static_cast<int8_t>(s_level), std::memory_order_relaxed);
+    }
+    taskEXIT_CRITICAL(&s_tag_mux);
+    return static_cast<uint8_t>(id);
+}
+
+bool Logger::setTagLevel(const char* tag, LogLevel level) {
+    const uint8_t id = internTag(tag);
+    if (id == MAX_TAGS) {
+        return false;
+    }
+    taskENTER_CRITICAL(&s_tag_mux);
+    s_tags[id].overridden = true;
+    s_tag_levels[id].store(static_cast<int8_t>(level), std::memory_order_relaxed);
+    taskEXIT_CRITICAL(&s_tag_mux);
+    esp_log_level_set(tag, ESP_LEVELS[static_cast<int>(level)]);
+    return true;
+}
+
+bool Logger::clearTagLevel(const char* tag) {
+    const uint8_t id = internTag(tag);
+    if (id == MAX_TAGS) {
+        return false;
+    }
+    taskENTER_CRITICAL(&s_tag_mux);
+    s_tags[id].overridden = false;
+    const LogLevel level = s_level;
+    s_tag_levels[id].store(static_cast<int8_t>(level), std::memory_order_relaxed);
+    taskEXIT_CRITICAL(&s_tag_mux);
+    // Back to the global level (ESP-IDF cannot forget a single tag)
+    esp_log_level_set(tag, ESP_LEVELS[static_cast<int>(level)]);
+    return true;
+}
+
+bool Logger::parseLevel(const char* name, LogLevel& out) {
+    static const char* const NAMES[] = {"error", "warn", "info", "debug"};
+    for (std::size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i) {
+        if (std::strcmp(name, NAMES[i]) == 0) {
+            out = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
 void Logger::setEspLogLevel(const char* tag, esp_log_level_t level) {
     esp_log_level_set(tag, level);
 }
 
-void Logger::logFormatted(esp_log_level_t esp_level, LogLevel gate_level, const char* tag, const char* fmt, va_list args) {
-    if (static_cast<int>(s_level) < static_cast<int>(gate_level)) {
-        return;
-    }
+void Logger::write(esp_log_level_t esp_level, const char* tag, const char* fmt, va_list args) {
     char buffer[LOGGER_MAX_MESSAGE_LEN];
     int n = vsnprintf(buffer, sizeof(buffer), fmt, args);
     if (n < 0) {
@@ -45,32 +150,55 @@ void Logger::logFormatted(esp_log_level_t esp_level, LogLevel gate_level, const
     }
 }
 
+// Immediate path behind log() (ERROR, or deferred logging not running)
+void Logger::emit(LogLevel level, const char* tag, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    write(ESP_LEVELS[static_cast<int>(level)], tag, fmt, args);
+    va_end(args);
+}
+
+// Function-style API: same per-tag levels as the macros, without the call-site cache
+bool Logger::tagAllows(LogLevel level, const char* tag) {
+    return static_cast<int>(level) <= s_tag_levels[internTag(tag)].load(std::memory_order_relaxed);
+}
+
 void Logger::error(const char* tag, const char* fmt, ...) {
+    if (!tagAllows(LogLevel::ERROR, tag)) {
+        return;
+    }
     va_list args;
     va_start(args, fmt);
-    logFormatted(ESP_LOG_ERROR, LogLevel::ERROR, tag, fmt, args);
+    write(ESP_LOG_ERROR, tag, fmt, args);
     va_end(args);
 }
 
 void Logger::warn(const char* tag, const char* fmt, ...) {
+    if (!tagAllows(LogLevel::WARN, tag)) {
+        return;
+    }
     va_list args;
     va_start(args, fmt);
-    logFormatted(ESP_LOG_WARN, LogLevel::WARN, tag, fmt, args);
+    write(ESP_LOG_WARN, tag, fmt, args);
     va_end(args);
 }
 
 void Logger::info(const char* tag, const char* fmt, ...) {
+    if (!tagAllows(LogLevel::INFO, tag)) {
+        return;
+    }
     va_list args;
     va_start(args, fmt);
-    logFormatted(ESP_LOG_INFO, LogLevel::INFO, tag, fmt, args);
+    write(ESP_LOG_INFO, tag, fmt, args);
     va_end(args);
 }
 
 void Logger::debug(const char* tag, const char* fmt, ...) {
+    if (!tagAllows(LogLevel::DEBUG, tag)) {
+        return;
+    }
     va_list args;
     va_start(args, fmt);
-    logFormatted(ESP_LOG_DEBUG, LogLevel::DEBUG, tag, fmt, args);
+    write(ESP_LOG_DEBUG, tag, fmt, args);
     va_end(args);
 }
-
-
@@ -1,14 +1,30 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
+#include <atomic>
 #include <cstdarg>
+#include <cstdint>
 #include <esp_log.h>
+#include <sdkconfig.h>
+#include <main/utils/deferred_log.hpp>
+#include <main/utils/crash_log.hpp>
 
 // Fixed-size formatting buffer to avoid heap usage
 #ifndef LOGGER_MAX_MESSAGE_LEN
 #define LOGGER_MAX_MESSAGE_LEN 256
 #endif
 
+// Most verbose LogLevel compiled in; LOG_* calls above it are removed entirely
+// (arguments included). Follows CONFIG_LOG_MAXIMUM_LEVEL, since ESP_LOGx output
+// above that level is compiled out anyway. Override with -DLOGGER_COMPILE_LEVEL=n.
+#ifndef LOGGER_COMPILE_LEVEL
+#if defined(CONFIG_LOG_MAXIMUM_LEVEL)
+#define LOGGER_COMPILE_LEVEL ((CONFIG_LOG_MAXIMUM_LEVEL) >= 4 ? 3 : (CONFIG_LOG_MAXIMUM_LEVEL) - 1)
+#else
+#define LOGGER_COMPILE_LEVEL 3
+#endif
+#endif
+
 enum class LogLevel {
     ERROR = 0,
     WARN  = 1,
@@ -18,9 +34,32 @@ enum class LogLevel {
 
 class Logger {
 public:
+    // Tag id cache at each LOG_* call site, resolved on first use
+    static constexpr uint8_t UNRESOLVED_TAG = 0xFF;
+
+    // Global level, for the LOG_* gate and ESP-IDF's own ("*"); per-tag overrides stay
     static void setLevel(LogLevel level);
     static LogLevel getLevel();
 
+    // Per-tag override of the global level (e.g. DEBUG for "CLOUD_TASK" only);
+    // clearTagLevel() makes the tag follow setLevel() again. Also raises ESP-IDF's
+    // own level for the tag so DEBUG lines are not filtered a second time.
+    static bool setTagLevel(const char* tag, LogLevel level);
+    static bool clearTagLevel(const char* tag);
+
+    // "error" / "warn" / "info" / "debug" -> level; false for anything else
+    static bool parseLevel(const char* name, LogLevel& out);
+
+    // Level gate behind the macros: O(1) after the first call at a site (tag_id)
+    static bool enabled(LogLevel level, const char* tag, std::atomic<uint8_t>& tag_id) {
+        uint8_t id = tag_id.load(std::memory_order_relaxed);
+        if (id == UNRESOLVED_TAG) {
+            id = internTag(tag);
+            tag_id.store(id, std::memory_order_relaxed);
+        }
+        return static_cast<int>(level) <= s_tag_levels[id].load(std::memory_order_relaxed);
+    }
+
     static void error(const char* tag, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
     static void warn(const char* tag, const char* fmt, ...)  __attribute__((format(printf, 2, 3)));
     static void info(const char* tag, const char* fmt, ...)  __attribute__((format(printf, 2, 3)));
@@ -29,17 +68,54 @@ public:
     // Optional helper to align ESP-IDF internal log level for a tag
     static void setEspLogLevel(const char* tag, esp_log_level_t level);
 
+    // Output half of the LOG_* macros (level already checked). Records at
+    // CrashLog::CAPTURE_LEVEL and above (WARN by default) are also kept in the
+    // reset-surviving CrashLog ring. Once DeferredLog is running,
+    // WARN/INFO/DEBUG calls only copy their arguments into the log ring; ERROR is
+    // still formatted and written on the caller so it is out before a possible reset.
+    template <typename... Args>
+    static void log(LogLevel level, const char* tag, const char* fmt, Args... args) {
+        CrashLog::capture(static_cast<uint8_t>(level), tag, fmt, args...);
+        if (level != LogLevel::ERROR && DeferredLog::push(static_cast<uint8_t>(level), tag, fmt, args...)) {
+            return;
+        }
+        emit(level, tag, fmt, args...);
+    }
+
+    // Compile-time printf check for the macros; never called
+    static inline void checkFormat(const char* fmt, ...) __attribute__((format(printf, 1, 2))) {
+        (void)fmt;
+    }
+
+    static constexpr std::size_t MAX_TAGS = 32;
+    static constexpr std::size_t MAX_TAG_LEN = 23;
+
 private:
-    static void logFormatted(esp_log_level_t esp_level, LogLevel gate_level, const char* tag, const char* fmt, va_list args);
+    static void write(esp_log_level_t esp_level, const char* tag, const char* fmt, va_list args);
+    static void emit(LogLevel level, const char* tag, const char* fmt, ...);
+    static uint8_t internTag(const char* tag);
+    static bool tagAllows(LogLevel level, const char* tag);
     static LogLevel s_level;
+    // Effective level per interned tag; slot MAX_TAGS serves tags past the table
+    static std::atomic<int8_t> s_tag_levels[MAX_TAGS + 1];
 };
 
-// Convenience macros (no heap, fixed buffer)
-#define LOG_ERROR(TAG, FMT, ...) Logger::error((TAG), (FMT), ##__VA_ARGS__)
-#define LOG_WARN(TAG, FMT, ...)  Logger::warn((TAG),  (FMT), ##__VA_ARGS__)
-#define LOG_INFO(TAG, FMT, ...)  Logger::info((TAG),  (FMT), ##__VA_ARGS__)
-#define LOG_DEBUG(TAG, FMT, ...) Logger::debug((TAG), (FMT), ##__VA_ARGS__)
+// Convenience macros (no heap, fixed buffer; deferred once DeferredLog::start() runs).
+// Calls above LOGGER_COMPILE_LEVEL compile to nothing; the rest check the tag's
+// level before their arguments are evaluated.
+#define LOGGER_CALL(LEVEL, TAG, FMT, ...) \
+    do { \
+        if (false) { Logger::checkFormat((FMT), ##__VA_ARGS__); } \
+        if (static_cast<int>(LEVEL) <= LOGGER_COMPILE_LEVEL) { \
+            static std::atomic<uint8_t> logger_tag_id_{Logger::UNRESOLVED_TAG}; \
+            if (Logger::enabled((LEVEL), (TAG), logger_tag_id_)) { \
+                Logger::log((LEVEL), (TAG), (FMT), ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+#define LOG_ERROR(TAG, FMT, ...) LOGGER_CALL(LogLevel::ERROR, (TAG), (FMT), ##__VA_ARGS__)
+#define LOG_WARN(TAG, FMT, ...)  LOGGER_CALL(LogLevel::WARN,  (TAG), (FMT), ##__VA_ARGS__)
+#define LOG_INFO(TAG, FMT, ...)  LOGGER_CALL(LogLevel::INFO,  (TAG), (FMT), ##__VA_ARGS__)
+#define LOG_DEBUG(TAG, FMT, ...) LOGGER_CALL(LogLevel::DEBUG, (TAG), (FMT), ##__VA_ARGS__)
 
 #endif // LOGGER_HPP
-
-
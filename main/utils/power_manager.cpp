@@ -0,0 +1,211 @@
+#include <main/utils/power_manager.hpp>
+#include <main/utils/logger.hpp>
+#include <freertos/task.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+#include <inttypes.h>
+
+namespace {
+    static const char* TAG = "POWER";
+
+    static esp_pm_lock_handle_t s_no_sleep_lock = nullptr;
+
+    // Report window state; noteWake() runs on every task, on both cores
+    static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+    static TickType_t s_last_wake_tick = 0;
+    static TickType_t s_window_start_tick = 0;
+    static int64_t s_window_start_us = 0;
+    static uint32_t s_window_wakeups = 0;
+    static uint32_t s_idle_start[portNUM_PROCESSORS] = {};
+    static PowerManager::Stats s_stats{};
+
+    static TickType_t slotTicks() {
+        TickType_t slot = pdMS_TO_TICKS(Config::Power::wake_period_ms);
+        return (slot > 0) ? slot : 1;
+    }
+
+    static uint32_t idleRunTime(BaseType_t core) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        return static_cast<uint32_t>(ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core)));
+#else
+        (void)core;
+        return 0;
+#endif
+    }
+
+    // Idle counters and wall time for a window edge. Read outside s_stats_mux:
+    // ulTaskGetRunTimeCounter() takes the scheduler's own lock.
+    struct Snapshot {
+        int64_t now_us;
+        uint32_t idle[portNUM_PROCESSORS];
+    };
+
+    static Snapshot takeSnapshot() {
+        Snapshot snap{};
+        snap.now_us = esp_timer_get_time();
+        for (BaseType_t core = 0; core < portNUM_PROCESSORS; ++core) {
+            snap.idle[core] = idleRunTime(core);
+        }
+        return snap;
+    }
+
+    // Caller holds s_stats_mux
+    static void startWindow(TickType_t now, const Snapshot& snap) {
+        s_window_start_tick = now;
+        s_window_start_us = snap.now_us;
+        s_window_wakeups = 0;
+        for (BaseType_t core = 0; core < portNUM_PROCESSORS; ++core) {
+            s_idle_start[core] = snap.idle[core];
+        }
+    }
+
+    // Close the report window: idle run time (which includes light sleep under
+    // tickless idle) against wall time gives the awake share per core. Caller holds s_stats_mux.
+    static PowerManager::Stats closeWindow(uint32_t wakeups, const Snapshot& snap) {
+        PowerManager::Stats stats{};
+        int64_t elapsed_us = snap.now_us - s_window_start_us;
+        if (elapsed_us <= 0) {
+            return stats;
+        }
+        uint64_t awake_sum = 0;
+        for (BaseType_t core = 0; core < portNUM_PROCESSORS; ++core) {
+            uint64_t idle_us = static_cast<uint32_t>(snap.idle[core] - s_idle_start[core]);
+            if (idle_us > static_cast<uint64_t>(elapsed_us)) {
+                idle_us = static_cast<uint64_t>(elapsed_us);
+            }
+            awake_sum += ((static_cast<uint64_t>(elapsed_us) - idle_us) * 1000ULL) / static_cast<uint64_t>(elapsed_us);
+        }
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        stats.awake_permille = static_cast<uint32_t>(awake_sum / portNUM_PROCESSORS);
+#else
+        (void)awake_sum;
+#endif
+        stats.wakeups_per_hour = static_cast<uint32_t>((static_cast<uint64_t>(wakeups) * 3600000000ULL) /
+                                                       static_cast<uint64_t>(elapsed_us));
+        stats.valid = true;
+        return stats;
+    }
+}
+
+namespace PowerManager {
+    void init() {
+        if (!enabled()) {
+            return;
+        }
+#if CONFIG_PM_ENABLE
+        esp_pm_config_t pm_config = {
+            .max_freq_mhz = Config::Power::max_cpu_freq_mhz,
+            .min_freq_mhz = Config::Power::min_cpu_freq_mhz,
+            .light_sleep_enable = true
+        };
+        esp_err_t err = esp_pm_configure(&pm_config);
+        if (err != ESP_OK) {
+            LOG_ERROR(TAG, "esp_pm_configure failed: %d", static_cast<int>(err));
+        }
+        err = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "power_hold", &s_no_sleep_lock);
+        if (err != ESP_OK) {
+            LOG_WARN(TAG, "PM lock create failed: %d", static_cast<int>(err));
+            s_no_sleep_lock = nullptr;
+        }
+        LOG_INFO(TAG, "Low-power mode: light sleep, %d-%d MHz, wake slot %" PRIu32 " ms",
+                 Config::Power::min_cpu_freq_mhz, Config::Power::max_cpu_freq_mhz, Config::Power::wake_period_ms);
+#else
+        LOG_WARN(TAG, "%s", "Low-power mode requested but CONFIG_PM_ENABLE is off; slots only "
+                 "(build with sdkconfig.defaults.low_power)");
+#endif
+#if !CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        LOG_WARN(TAG, "%s", "CONFIG_FREERTOS_USE_TICKLESS_IDLE is off; the tick keeps the chip awake");
+#endif
+        const Snapshot snap = takeSnapshot();
+        taskENTER_CRITICAL(&s_stats_mux);
+        startWindow(xTaskGetTickCount(), snap);
+        taskEXIT_CRITICAL(&s_stats_mux);
+    }
+
+    void delayUntilSlot(TickType_t& last_wake, TickType_t period) {
+        if (!enabled()) {
+            vTaskDelayUntil(&last_wake, (period > 0) ? period : 1);
+            return;
+        }
+        const TickType_t slot = slotTicks();
+        const TickType_t slots = (period + slot - 1) / slot;
+        TickType_t now = xTaskGetTickCount();
+        TickType_t deadline = slotStart(now) + ((slots > 0) ? slots : 1) * slot;
+        vTaskDelay(deadline - now);
+        last_wake = deadline;
+        noteWake(xTaskGetTickCount());
+    }
+
+    TickType_t alignWait(TickType_t now, TickType_t wait) {
+        if (!enabled() || wait == portMAX_DELAY) {
+            return wait;
+        }
+        const TickType_t slot = slotTicks();
+        TickType_t target = now + wait;
+        TickType_t aligned = ((target + slot - 1) / slot) * slot;
+        return aligned - now;
+    }
+
+    TickType_t slotStart(TickType_t now) {
+        if (!enabled()) {
+            return now;
+        }
+        const TickType_t slot = slotTicks();
+        return (now / slot) * slot;
+    }
+
+    void noteWake(TickType_t now) {
+        if (!enabled()) {
+            return;
+        }
+        const TickType_t window = pdMS_TO_TICKS(Config::Power::report_period_ms);
+        taskENTER_CRITICAL(&s_stats_mux);
+        // Tasks released by the same slot tick share one chip wakeup
+        if (now != s_last_wake_tick) {
+            s_last_wake_tick = now;
+            s_window_wakeups++;
+        }
+        const TickType_t window_start = s_window_start_tick;
+        taskEXIT_CRITICAL(&s_stats_mux);
+        const bool due = (now - window_start) >= window;
+        if (!due) {
+            return;
+        }
+
+        const Snapshot snap = takeSnapshot();
+        bool closed = false;
+        Stats stats{};
+        taskENTER_CRITICAL(&s_stats_mux);
+        // Another task may have closed this window in between
+        if (s_window_start_tick == window_start) {
+            stats = closeWindow(s_window_wakeups, snap);
+            s_stats = stats;
+            startWindow(now, snap);
+            closed = true;
+        }
+        taskEXIT_CRITICAL(&s_stats_mux);
+        if (closed) {
+            LOG_INFO(TAG, "Awake %" PRIu32 ".%" PRIu32 "%%, wakeups/hour=%" PRIu32,
+                     stats.awake_permille / 10, stats.awake_permille % 10, stats.wakeups_per_hour);
+        }
+    }
+
+    void holdAwake() {
+        if (s_no_sleep_lock != nullptr) {
+            (void)esp_pm_lock_acquire(s_no_sleep_lock);
+        }
+    }
+
+    void releaseAwake() {
+        if (s_no_sleep_lock != nullptr) {
+            (void)esp_pm_lock_release(s_no_sleep_lock);
+        }
+    }
+
+    Stats getStats() {
+        taskENTER_CRITICAL(&s_stats_mux);
+        Stats stats = s_stats;
+        taskEXIT_CRITICAL(&s_stats_mux);
+        return stats;
+    }
+}
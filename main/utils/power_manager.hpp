@@ -0,0 +1,48 @@
+// Low-power operating mode (Config::Features::low_power_mode).
+// Periodic tasks sleep through delayUntilSlot()/alignWait() so their wakeups
+// coincide on a shared Config::Power::wake_period_ms grid; with tickless idle
+// and esp_pm light sleep the chip then sleeps for the whole gap between slots.
+// With the mode off every call degrades to the plain FreeRTOS behavior.
+#ifndef POWER_MANAGER_HPP
+#define POWER_MANAGER_HPP
+
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <main/config/config.hpp>
+
+namespace PowerManager {
+    // Average-current proxies over the last Config::Power::report_period_ms window
+    struct Stats {
+        uint32_t awake_permille;   // non-idle CPU time, averaged over cores (0 without run-time stats)
+        uint32_t wakeups_per_hour; // distinct slot wakeups seen by delayUntilSlot()/noteWake()
+        bool valid;                // false until the first window completes
+    };
+
+    constexpr bool enabled() {
+        return Config::Features::low_power_mode;
+    }
+
+    // Configure DFS + automatic light sleep (call once from app_main)
+    void init();
+
+    // Drop-in for vTaskDelayUntil(&last_wake, period): in low-power mode the
+    // wake is snapped to the slot grid (period rounded up to whole slots)
+    void delayUntilSlot(TickType_t& last_wake, TickType_t period);
+
+    // Ticks to block so that now + wait lands on a slot boundary (rounded up)
+    TickType_t alignWait(TickType_t now, TickType_t wait);
+
+    // Start of the slot containing now; use as the "last run" time of deadline loops
+    TickType_t slotStart(TickType_t now);
+
+    // Count a task wakeup for the report (delayUntilSlot() calls it itself)
+    void noteWake(TickType_t now);
+
+    // Keep the chip out of light sleep (e.g. while LEDC drives the buzzer). Nestable.
+    void holdAwake();
+    void releaseAwake();
+
+    Stats getStats();
+}
+
+#endif // POWER_MANAGER_HPP
@@ -0,0 +1,182 @@
+#ifndef SAMPLE_BUS_HPP
+#define SAMPLE_BUS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Single-producer, multi-subscriber broadcast ring, header-only.
+// - The producer writes each item once into a shared ring; it never blocks and never
+//   waits for subscribers (a slow subscriber loses its oldest unread items instead).
+// - Each subscriber owns a cursor and copies straight out of the ring, so there are
+//   no intermediate queues between the producer and any reader.
+// - A copy is validated against the producer's index afterwards (seqlock style);
+//   items the producer may have overwritten mid-copy are discarded and counted.
+// - Per-subscriber lag (items published but not yet read) is readable from any task.
+// - A display-style reader that wants only the newest items subscribes with
+//   subscribeLatest() and reads with pollLatest(): older items are skipped, not lost.
+// - No dynamic allocation; Capacity must be a power of two.
+template<typename T, std::size_t Capacity, std::size_t MaxSubscribers = 4>
+class SampleBus {
+public:
+    static_assert(Capacity >= 2, "SampleBus capacity must be at least 2");
+    static_assert((Capacity & (Capacity - 1U)) == 0U, "SampleBus capacity must be a power of two");
+    static_assert(Capacity <= UINT32_MAX / 2U, "SampleBus capacity too large for 32-bit sequence numbers");
+
+    static constexpr std::size_t CACHE_LINE_BYTES = 64;
+
+    class Subscriber {
+    public:
+        const char* getName() const { return name; }
+
+    private:
+        friend class SampleBus;
+        const char* name = nullptr;
+        std::atomic<uint32_t> cursor{0};   // next sequence to read (owner stores, anyone loads)
+        std::atomic<uint32_t> max_lag{0};  // largest lag seen at a poll
+        std::atomic<uint32_t> overruns{0}; // items lost to the producer lapping this cursor
+        bool latest_only = false;          // subscribeLatest(): skipped items are not lag
+    };
+
+    struct SubscriberStats {
+        const char* name;
+        uint32_t lag;      // published but unread right now
+        uint32_t max_lag;
+        uint32_t overruns;
+        bool latest_only; // lag capped at Capacity, overruns only from torn copies
+    };
+
+    SampleBus() : head_seq(0), subscriber_count(0) {}
+
+    SampleBus(const SampleBus&) = delete;
+    SampleBus& operator=(const SampleBus&) = delete;
+
+    // Producer side. Never fails; overwrites the oldest item once the ring is full.
+    void publish(const T& value) {
+        const uint32_t head = head_seq.load(std::memory_order_relaxed);
+        // Seqlock writer side: the slot write must not become visible before the
+        // previous head store, or poll() could read a half-overwritten item and still
+        // find head too low to flag it (pairs with the acquire fence in poll())
+        std::atomic_thread_fence(std::memory_order_release);
+        storage[head & MASK] = value;
+        head_seq.store(head + 1U, std::memory_order_release);
+    }
+
+    // Register a reader (setup time, before the owning task starts). The cursor starts
+    // at the current head, so only items published afterwards are seen. Returns
+    // nullptr once MaxSubscribers are registered.
+    Subscriber* subscribe(const char* name) {
+        const std::size_t idx = subscriber_count.fetch_add(1U, std::memory_order_acq_rel);
+        if (idx >= MaxSubscribers) {
+            subscriber_count.store(MaxSubscribers, std::memory_order_release);
+            return nullptr;
+        }
+        Subscriber& sub = subscribers[idx];
+        sub.name = name;
+        sub.cursor.store(head_seq.load(std::memory_order_acquire), std::memory_order_release);
+        return &sub;
+    }
+
+    // Register a reader that only ever wants the newest items (read with pollLatest()).
+    // Its stats never report it as lapped, however long it leaves the ring unread.
+    Subscriber* subscribeLatest(const char* name) {
+        Subscriber* sub = subscribe(name);
+        if (sub != nullptr) {
+            sub->latest_only = true;
+        }
+        return sub;
+    }
+
+    // Subscriber side (owning task only). Copies up to out.size() unread items in
+    // publish order; returns the number copied. Items lapped by the producer are skipped.
+    std::size_t poll(Subscriber& sub, std::span<T> out) {
+        uint32_t cursor = sub.cursor.load(std::memory_order_relaxed);
+        const uint32_t head = head_seq.load(std::memory_order_acquire);
+        uint32_t lag = head - cursor;
+        if (lag > sub.max_lag.load(std::memory_order_relaxed)) {
+            sub.max_lag.store(lag, std::memory_order_relaxed);
+        }
+        if (lag > Capacity) {
+            sub.overruns.fetch_add(lag - static_cast<uint32_t>(Capacity), std::memory_order_relaxed);
+            cursor = head - static_cast<uint32_t>(Capacity);
+            lag = static_cast<uint32_t>(Capacity);
+        }
+        std::size_t n = (out.size() < lag) ? out.size() : lag;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = storage[(cursor + i) & MASK];
+        }
+
+        // The producer writes sequence s (replacing s - Capacity) while head == s, so once
+        // head has reached h, everything at or before h - Capacity may have been torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint32_t head_after = head_seq.load(std::memory_order_relaxed);
+        const uint32_t oldest_safe = head_after + 1U - static_cast<uint32_t>(Capacity);
+        const uint32_t torn = static_cast<int32_t>(oldest_safe - cursor) > 0 ? oldest_safe - cursor : 0U;
+        if (torn > 0U) {
+            const std::size_t drop = (torn < n) ? torn : n;
+            for (std::size_t i = drop; i < n; ++i) {
+                out[i - drop] = out[i];
+            }
+            n -= drop;
+            sub.overruns.fetch_add(torn, std::memory_order_relaxed);
+            cursor += torn;
+        }
+        sub.cursor.store(cursor + static_cast<uint32_t>(n), std::memory_order_release);
+        return n;
+    }
+
+    // Subscriber side (owning task only). Like poll(), but first moves the cursor up to
+    // the newest out.size() items: copies those, oldest first, and skips the rest
+    // without counting them as overruns.
+    std::size_t pollLatest(Subscriber& sub, std::span<T> out) {
+        const uint32_t keep = static_cast<uint32_t>((out.size() < Capacity) ? out.size() : Capacity);
+        const uint32_t head = head_seq.load(std::memory_order_acquire);
+        if (head - sub.cursor.load(std::memory_order_relaxed) > keep) {
+            sub.cursor.store(head - keep, std::memory_order_release);
+        }
+        return poll(sub, out);
+    }
+
+    // Any task. Approximate while the producer and subscriber are running.
+    std::size_t getSubscriberCount() const {
+        return subscriber_count.load(std::memory_order_acquire);
+    }
+
+    SubscriberStats getStats(std::size_t idx) const {
+        const Subscriber& sub = subscribers[idx < MaxSubscribers ? idx : 0U];
+        const uint32_t head = head_seq.load(std::memory_order_acquire);
+        uint32_t lag = head - sub.cursor.load(std::memory_order_acquire);
+        if (sub.latest_only && lag > Capacity) {
+            lag = static_cast<uint32_t>(Capacity);
+        }
+        return SubscriberStats{
+            sub.name,
+            lag,
+            sub.max_lag.load(std::memory_order_relaxed),
+            sub.overruns.load(std::memory_order_relaxed),
+            sub.latest_only,
+        };
+    }
+
+    uint32_t getPublished() const {
+        return head_seq.load(std::memory_order_acquire);
+    }
+
+    std::size_t getCapacity() const {
+        return Capacity;
+    }
+
+private:
+    static constexpr uint32_t MASK = static_cast<uint32_t>(Capacity - 1U);
+
+    // Producer-owned line
+    alignas(CACHE_LINE_BYTES) std::atomic<uint32_t> head_seq;
+    std::atomic<std::size_t> subscriber_count;
+    std::array<Subscriber, MaxSubscribers> subscribers;
+
+    alignas(CACHE_LINE_BYTES) std::array<T, Capacity> storage;
+};
+
+#endif // SAMPLE_BUS_HPP
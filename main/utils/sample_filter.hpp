@@ -0,0 +1,171 @@
+// Streaming filter chain for sensor samples in centi-units (utils/fixed_point.hpp).
+// Each sensor task owns one SampleFilter::Chain and runs every reading through it before
+// pushing to the monitor's ring, so a single ADC glitch cannot start the
+// confirm_crit_ms debounce. Stages, in order:
+//   1. SlewGate      - drops a sample that jumps more than max_step from the last
+//                      accepted one; after max_rejects drops in a row the jump is
+//                      taken as real and the later stages restart from it
+//   2. RollingMedian - median of the last N accepted samples (removes spikes)
+//   3. Ema           - exponential moving average, alpha = 1 / 2^SHIFT
+// Fixed-size state, integer math only, no allocation. Single owner; no locking.
+#ifndef SAMPLE_FILTER_HPP
+#define SAMPLE_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SampleFilter {
+    class SlewGate {
+    public:
+        // max_step <= 0 disables the gate
+        SlewGate(int32_t max_step, uint8_t max_rejects)
+            : max_step(max_step), max_rejects(max_rejects), last(0), seeded(false), rejects(0) {}
+
+        enum class Verdict : uint8_t { ACCEPT, REJECT, RESEED };
+
+        Verdict check(int32_t x) {
+            if (!seeded || max_step <= 0) {
+                seeded = true;
+                last = x;
+                return Verdict::ACCEPT;
+            }
+            const int32_t step = (x > last) ? x - last : last - x;
+            if (step <= max_step) {
+                last = x;
+                rejects = 0;
+                return Verdict::ACCEPT;
+            }
+            if (++rejects <= max_rejects) {
+                return Verdict::REJECT;
+            }
+            // Sustained jump: a genuine step change, not a glitch
+            last = x;
+            rejects = 0;
+            return Verdict::RESEED;
+        }
+
+        void reset() {
+            seeded = false;
+            rejects = 0;
+        }
+
+    private:
+        int32_t max_step;
+        uint8_t max_rejects;
+        int32_t last;
+        bool    seeded;
+        uint8_t rejects;
+    };
+
+    template <std::size_t N>
+    class RollingMedian {
+        static_assert(N >= 1 && N <= 15, "median window must be 1..15");
+
+    public:
+        int32_t push(int32_t x) {
+            window[head] = x;
+            head = (head + 1U) % N;
+            if (count < N) {
+                count++;
+            }
+            // Insertion sort of a copy; N is small and the copy stays on the stack
+            int32_t sorted[N];
+            for (std::size_t i = 0; i < count; ++i) {
+                int32_t v = window[i];
+                std::size_t j = i;
+                while (j > 0 && sorted[j - 1] > v) {
+                    sorted[j] = sorted[j - 1];
+                    --j;
+                }
+                sorted[j] = v;
+            }
+            return sorted[count / 2U];
+        }
+
+        void reset() {
+            head = 0;
+            count = 0;
+        }
+
+    private:
+        int32_t window[N] = {};
+        std::size_t head = 0;
+        std::size_t count = 0;
+    };
+
+    template <unsigned SHIFT>
+    class Ema {
+        static_assert(SHIFT <= 8, "EMA shift out of range");
+
+    public:
+        int32_t push(int32_t x) {
+            if (!seeded) {
+                acc = static_cast<int64_t>(x) * (int64_t{1} << SHIFT);
+                seeded = true;
+            } else {
+                // acc holds the average scaled by 2^SHIFT
+                acc += x - (acc >> SHIFT);
+            }
+            if constexpr (SHIFT == 0) {
+                return static_cast<int32_t>(acc);
+            } else {
+                return static_cast<int32_t>((acc + (int64_t{1} << (SHIFT - 1U))) >> SHIFT);
+            }
+        }
+
+        void reset() {
+            seeded = false;
+        }
+
+    private:
+        int64_t acc = 0;
+        bool seeded = false;
+    };
+
+    struct Stats {
+        uint32_t accepted;
+        uint32_t rejected;  // dropped by the slew gate
+        uint32_t reseeds;   // sustained steps that restarted the chain
+    };
+
+    template <std::size_t MEDIAN_WINDOW, unsigned EMA_SHIFT>
+    class Chain {
+    public:
+        Chain(int32_t max_step, uint8_t max_rejects) : gate(max_step, max_rejects), stats{} {}
+
+        // Filter one sample; false when the gate dropped it (nothing to publish)
+        bool push(int32_t x, int32_t& out) {
+            switch (gate.check(x)) {
+                case SlewGate::Verdict::REJECT:
+                    stats.rejected++;
+                    return false;
+                case SlewGate::Verdict::RESEED:
+                    median.reset();
+                    ema.reset();
+                    stats.reseeds++;
+                    break;
+                case SlewGate::Verdict::ACCEPT:
+                    break;
+            }
+            stats.accepted++;
+            out = ema.push(median.push(x));
+            return true;
+        }
+
+        void reset() {
+            gate.reset();
+            median.reset();
+            ema.reset();
+        }
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        SlewGate gate;
+        RollingMedian<MEDIAN_WINDOW> median;
+        Ema<EMA_SHIFT> ema;
+        Stats stats;
+    };
+}
+
+#endif // SAMPLE_FILTER_HPP
@@ -0,0 +1,118 @@
+#include <main/utils/task_stats.hpp>
+#include <main/utils/logger.hpp>
+#include <main/utils/third-party/mjson.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+#include <inttypes.h>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    static const char* TAG = "TASK_STATS";
+
+    static int64_t s_last_sample_us = 0;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    static TaskStatus_t s_status[TaskStats::MAX_TASKS];
+
+    // Previous sample's counters, matched to tasks by xTaskNumber. 32-bit deltas
+    // survive one counter wrap (~71 min at the 1 MHz esp_timer clock).
+    static UBaseType_t s_prev_number[TaskStats::MAX_TASKS];
+    static uint32_t s_prev_run_time[TaskStats::MAX_TASKS];
+    static std::size_t s_prev_count = 0;
+    static uint32_t s_prev_total = 0;
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    static uint32_t previousRunTime(UBaseType_t number) {
+        for (std::size_t i = 0; i < s_prev_count; ++i) {
+            if (s_prev_number[i] == number) {
+                return s_prev_run_time[i];
+            }
+        }
+        // Created since the last sample: all of its run time falls in the window
+        return 0;
+    }
+#endif
+#endif
+}
+
+namespace TaskStats {
+    void sample(Snapshot& out) {
+        const int64_t now_us = esp_timer_get_time();
+        out.window_ms = static_cast<uint32_t>((now_us - s_last_sample_us) / 1000LL);
+        s_last_sample_us = now_us;
+
+        out.heap_free = static_cast<uint32_t>(heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+        out.heap_min = static_cast<uint32_t>(heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT));
+        out.heap_largest = static_cast<uint32_t>(heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT));
+        out.count = 0;
+        out.task_total = 0;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+        out.task_total = static_cast<uint32_t>(uxTaskGetNumberOfTasks());
+        configRUN_TIME_COUNTER_TYPE total_run_time = 0;
+        // Fills nothing (returns 0) when the array is too small for every task
+        const UBaseType_t n = uxTaskGetSystemState(s_status, MAX_TASKS, &total_run_time);
+        if (n == 0) {
+            LOG_WARN(TAG, "%" PRIu32 " tasks exceed max_tasks=%u", out.task_total, static_cast<unsigned>(MAX_TASKS));
+            return;
+        }
+        const uint32_t window_run_time = static_cast<uint32_t>(total_run_time) - s_prev_total;
+
+        for (UBaseType_t i = 0; i < n; ++i) {
+            const TaskStatus_t& st = s_status[i];
+            Task& t = out.tasks[out.count++];
+            std::strncpy(t.name, st.pcTaskName, sizeof(t.name) - 1);
+            t.name[sizeof(t.name) - 1] = '\0';
+            t.priority = static_cast<uint8_t>(st.uxCurrentPriority);
+            t.stack_free = static_cast<uint32_t>(st.usStackHighWaterMark) * sizeof(StackType_t);
+            t.cpu_permille = 0;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+            if (window_run_time > 0) {
+                const uint32_t ran = static_cast<uint32_t>(st.ulRunTimeCounter) - previousRunTime(st.xTaskNumber);
+                const uint64_t permille = (static_cast<uint64_t>(ran) * 1000ULL) / window_run_time;
+                t.cpu_permille = static_cast<uint16_t>((permille > 1000ULL) ? 1000ULL : permille);
+            }
+#else
+            (void)window_run_time;
+#endif
+            if (t.stack_free < Config::Tasks::Metrics::stack_warn_bytes) {
+                LOG_WARN(TAG, "Stack low: %s has %" PRIu32 " bytes unused", t.name, t.stack_free);
+            }
+        }
+
+        for (UBaseType_t i = 0; i < n; ++i) {
+            s_prev_number[i] = s_status[i].xTaskNumber;
+            s_prev_run_time[i] = static_cast<uint32_t>(s_status[i].ulRunTimeCounter);
+        }
+        s_prev_count = n;
+        s_prev_total = static_cast<uint32_t>(total_run_time);
+#endif
+    }
+
+    int formatJson(const Snapshot& s, char* out, std::size_t cap) {
+        int off = std::snprintf(out, cap,
+                                "{\"window_ms\":%" PRIu32 ",\"heap\":[%" PRIu32 ",%" PRIu32 ",%" PRIu32 "],\"n\":%" PRIu32 ",\"tasks\":[",
+                                s.window_ms, s.heap_free, s.heap_min, s.heap_largest, s.task_total);
+        // Leave room for the closing "]}"
+        if (off < 0 || static_cast<std::size_t>(off) + 3 > cap) {
+            return -1;
+        }
+        for (std::size_t i = 0; i < s.count; ++i) {
+            const Task& t = s.tasks[i];
+            char entry[64];
+            const int len = mjson_snprintf(entry, sizeof(entry), "%s[%Q,%u,%lu,%u]", (i > 0) ? "," : "", t.name,
+                                           static_cast<unsigned>(t.priority), static_cast<unsigned long>(t.stack_free),
+                                           static_cast<unsigned>(t.cpu_permille));
+            if (len <= 0 || static_cast<std::size_t>(off + len) + 3 > cap) {
+                break;
+            }
+            std::memcpy(out + off, entry, static_cast<std::size_t>(len) + 1U);
+            off += len;
+        }
+        off += std::snprintf(out + off, cap - static_cast<std::size_t>(off), "]}");
+        return off;
+    }
+}
@@ -0,0 +1,49 @@
+// Per-task CPU share, stack headroom and heap minimums, for right-sizing the
+// static task stacks and spotting runaway loops in the field.
+// sample() reads uxTaskGetSystemState(): CPU share is each task's run-time counter
+// delta against the total run time since the previous sample, stack headroom is
+// the high-water mark (lowest unused stack since the task started).
+// Needs CONFIG_FREERTOS_USE_TRACE_FACILITY (task list) and
+// CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS (CPU share); without them sample() only
+// fills in the heap figures.
+#ifndef TASK_STATS_HPP
+#define TASK_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <main/config/config.hpp>
+
+namespace TaskStats {
+    static constexpr std::size_t MAX_TASKS = Config::Tasks::Metrics::max_tasks;
+
+    struct Task {
+        char     name[configMAX_TASK_NAME_LEN];
+        uint32_t stack_free;    // bytes never used since the task started
+        uint16_t cpu_permille;  // of one core, over the sample window
+        uint8_t  priority;      // current (possibly inherited) priority
+    };
+
+    struct Snapshot {
+        uint32_t    window_ms;     // since the previous sample (since boot on the first)
+        uint32_t    heap_free;     // default-capability heap, bytes
+        uint32_t    heap_min;      // lowest heap_free since boot
+        uint32_t    heap_largest;  // largest free block (fragmentation)
+        uint32_t    task_total;    // tasks in the system; count < task_total means MAX_TASKS is too low
+        std::size_t count;
+        Task        tasks[MAX_TASKS];
+    };
+
+    // Take a sample (cloud task only; the previous sample's counters are kept
+    // internally). Logs a warning for every task whose stack_free is below
+    // Config::Tasks::Metrics::stack_warn_bytes.
+    void sample(Snapshot& out);
+
+    // Compact JSON for Topics::METRICS:
+    // {"window_ms":..,"heap":[free,min,largest],"n":..,"tasks":[["name",prio,stack_free,cpu_permille],..]}
+    // Tasks that do not fit in cap are left out (n still counts them).
+    // Returns the length written, or -1 if not even the header fits.
+    int formatJson(const Snapshot& s, char* out, std::size_t cap);
+}
+
+#endif // TASK_STATS_HPP
@@ -0,0 +1,75 @@
+#include <main/utils/telemetry_codec.hpp>
+#include <main/utils/fixed_point.hpp>
+
+namespace {
+    static constexpr std::size_t HEADER_BYTES = 4;
+
+    static uint64_t zigzag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+}
+
+namespace TelemetryCodec {
+    FrameEncoder::FrameEncoder(uint8_t* out, std::size_t capacity, Kind kind, bool has_time)
+        : out(out), capacity(capacity), length(HEADER_BYTES), has_time(has_time),
+          overflow(capacity < HEADER_BYTES), count(0), prev_value(0), prev_time(0), prev_delta(0) {
+        if (!overflow) {
+            out[0] = FRAME_VERSION;
+            out[1] = static_cast<uint8_t>(static_cast<uint8_t>(kind) & 0x03U) | (has_time ? FLAG_HAS_TIME : 0U);
+        }
+    }
+
+    bool FrameEncoder::putVarint(uint64_t v) {
+        do {
+            if (length >= capacity) {
+                overflow = true;
+                return false;
+            }
+            uint8_t byte = static_cast<uint8_t>(v & 0x7FU);
+            v >>= 7;
+            out[length++] = byte | (v != 0 ? 0x80U : 0U);
+        } while (v != 0);
+        return true;
+    }
+
+    bool FrameEncoder::putSigned(int64_t v) {
+        return putVarint(zigzag(v));
+    }
+
+    bool FrameEncoder::add(int32_t value_centi, uint64_t epoch_ms) {
+        if (overflow || count == UINT16_MAX) {
+            return false;
+        }
+        const std::size_t rollback = length;
+        const int32_t deci = FixedPoint::centiToDeci(value_centi);
+        int64_t delta = prev_delta;
+        bool ok = true;
+        if (has_time) {
+            if (count == 0) {
+                ok = putVarint(epoch_ms);
+            } else {
+                delta = static_cast<int64_t>(epoch_ms - prev_time);
+                ok = putSigned(delta - prev_delta);
+            }
+        }
+        ok = ok && putSigned(count == 0 ? deci : static_cast<int64_t>(deci) - prev_value);
+        if (!ok) {
+            length = rollback; // the frame stays valid up to the previous sample
+            return false;
+        }
+        prev_time = epoch_ms;
+        prev_delta = delta;
+        prev_value = deci;
+        count++;
+        return true;
+    }
+
+    std::size_t FrameEncoder::finish() {
+        if (count == 0 || capacity < HEADER_BYTES) {
+            return 0;
+        }
+        out[2] = static_cast<uint8_t>(count & 0xFFU);
+        out[3] = static_cast<uint8_t>(count >> 8);
+        return length;
+    }
+}
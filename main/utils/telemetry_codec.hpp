@@ -0,0 +1,63 @@
+// Compact binary telemetry frames, an alternative to the JSON payloads on metered links.
+// Reference decoder: Node_Red_Json/telemetry_decoder.js
+//
+// Frame layout (little-endian, varints are LEB128, signed values zigzag-encoded):
+//   u8   version (FRAME_VERSION)
+//   u8   flags: bits 0-1 kind (0 temperature, 1 moisture), bit 7 has_time
+//   u16  sample count
+//   per sample i:
+//     time  (only when has_time)  i == 0: varint epoch ms
+//                                 i >= 1: zigzag delta-of-delta of epoch ms
+//     value                       i == 0: zigzag deci-units (0.1 degC / 0.1 %)
+//                                 i >= 1: zigzag delta from the previous value
+// A periodic 5 s sample costs ~3 bytes after the first, vs ~12-25 bytes in JSON.
+#ifndef TELEMETRY_CODEC_HPP
+#define TELEMETRY_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TelemetryCodec {
+    static constexpr uint8_t FRAME_VERSION = 1;
+    static constexpr uint8_t FLAG_HAS_TIME = 0x80;
+
+    enum class Kind : uint8_t {
+        TEMPERATURE = 0,
+        MOISTURE = 1
+    };
+
+    // Worst case: 4-byte header, 10-byte time varint and 5-byte value varint per sample
+    constexpr std::size_t maxFrameBytes(std::size_t samples) {
+        return 4U + samples * 15U;
+    }
+
+    // Streams samples into a caller-provided buffer; no allocation, no float formatting.
+    class FrameEncoder {
+    public:
+        FrameEncoder(uint8_t* out, std::size_t capacity, Kind kind, bool has_time);
+
+        // Append one sample in centi-units (0.01 degC / 0.01 %); epoch_ms is ignored
+        // without has_time. False when out of room.
+        bool add(int32_t value_centi, uint64_t epoch_ms);
+
+        // Patch the sample count into the header; returns the frame length (0 if empty).
+        // After add() fails the frame still holds every sample accepted before it.
+        std::size_t finish();
+
+    private:
+        bool putVarint(uint64_t v);
+        bool putSigned(int64_t v);
+
+        uint8_t* out;
+        std::size_t capacity;
+        std::size_t length;
+        bool has_time;
+        bool overflow;
+        uint16_t count;
+        int32_t prev_value;
+        uint64_t prev_time;
+        int64_t prev_delta;
+    };
+}
+
+#endif // TELEMETRY_CODEC_HPP
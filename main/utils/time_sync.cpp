@@ -5,6 +5,7 @@
 #include <sys/time.h>
 #include <esp_sntp.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -12,6 +13,26 @@ namespace {
     static const char* TAG = "TIME_SYNC";
     static bool s_inited = false;
 
+    // Unix epoch ms minus esp_timer ms, captured whenever the wall clock is (re)synced.
+    // 64-bit, so guarded: the SNTP callback runs in the lwIP task.
+    static int64_t s_epoch_offset_ms = 0;
+    static bool s_have_offset = false;
+    static portMUX_TYPE s_offset_mux = portMUX_INITIALIZER_UNLOCKED;
+
+    static void recordEpochOffset(int64_t epoch_ms) {
+        int64_t offset = epoch_ms - (esp_timer_get_time() / 1000LL);
+        taskENTER_CRITICAL(&s_offset_mux);
+        s_epoch_offset_ms = offset;
+        s_have_offset = true;
+        taskEXIT_CRITICAL(&s_offset_mux);
+    }
+
+    static void recordEpochOffsetFromClock() {
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        recordEpochOffset(static_cast<int64_t>(tv.tv_sec) * 1000LL + tv.tv_usec / 1000);
+    }
+
     static bool timeIsReasonable() {
         time_t now = 0;
         time(&now);
@@ -31,7 +52,12 @@ namespace TimeSync {
         // Set explicit servers to improve reliability
         esp_sntp_setservername(0, "pool.ntp.org");
         esp_sntp_setservername(1, "time.google.com");
-        esp_sntp_set_time_sync_notification_cb([](struct timeval*){
+        esp_sntp_set_time_sync_notification_cb([](struct timeval* tv){
+            if (tv != nullptr) {
+                recordEpochOffset(static_cast<int64_t>(tv->tv_sec) * 1000LL + tv->tv_usec / 1000);
+            } else {
+                recordEpochOffsetFromClock();
+            }
             ESP_LOGI(TAG, "SNTP time synchronized");
         });
         esp_sntp_init();
@@ -44,12 +70,20 @@ namespace TimeSync {
             return false;
         }
         if (timeIsReasonable()) {
+            if (!s_have_offset) {
+                // Clock was valid before SNTP reported (RTC kept across reset)
+                recordEpochOffsetFromClock();
+            }
             return true;
         }
         sntp_sync_status_t st = sntp_get_sync_status();
         return st == SNTP_SYNC_STATUS_COMPLETED;
     }
 
+    bool clockIsValid() {
+        return timeIsReasonable();
+    }
+
     bool waitForSync(unsigned int timeout_ms) {
         if (!s_inited) {
             init();
@@ -91,6 +125,20 @@ namespace TimeSync {
         // strftime ensures null-termination if space permits
         (void)strftime(out, out_size, "%Y%m%d%H%M%S", &tm_utc);
     }
-}
-
 
+    bool monotonicToEpochMs(uint32_t mono_ms, uint64_t& out_epoch_ms) {
+        taskENTER_CRITICAL(&s_offset_mux);
+        bool have = s_have_offset;
+        int64_t offset = s_epoch_offset_ms;
+        taskEXIT_CRITICAL(&s_offset_mux);
+        if (!have) {
+            return false;
+        }
+        // Widen the truncated capture time against the current 64-bit uptime;
+        // the unsigned difference stays correct across the 32-bit wrap.
+        int64_t now_ms = esp_timer_get_time() / 1000LL;
+        uint32_t age_ms = static_cast<uint32_t>(now_ms) - mono_ms;
+        out_epoch_ms = static_cast<uint64_t>(now_ms - static_cast<int64_t>(age_ms) + offset);
+        return true;
+    }
+}
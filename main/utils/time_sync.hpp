@@ -3,6 +3,7 @@
 #define TIME_SYNC_HPP
 
 #include <cstddef>
+#include <cstdint>
 
 namespace TimeSync {
     // Initialize SNTP once (idempotent). Safe to call repeatedly.
@@ -11,6 +12,10 @@ namespace TimeSync {
     // Returns true if system time is considered valid (SNTP synced or RTC set).
     bool isSynced();
 
+    // Returns true if the wall clock holds a plausible date, without needing init()
+    // (e.g. set by an earlier SNTP sync and kept by the RTC across deep sleep).
+    bool clockIsValid();
+
     // Block until time is synced or timeout_ms elapses. Returns true if synced.
     bool waitForSync(unsigned int timeout_ms);
 
@@ -18,6 +23,12 @@ namespace TimeSync {
     // Format: YYYYMMDDHHMMSS (14 chars, UTC), e.g. "20251211123045".
     // Always null-terminates when out_size > 0.
     void formatFixedTimestamp(char* out, std::size_t out_size);
+
+    // Converts a capture time in esp_timer milliseconds (as stored in the sample
+    // models' ts_ms, truncated to 32 bits) to Unix epoch milliseconds, using the
+    // monotonic-to-epoch offset recorded at the last SNTP sync.
+    // Returns false until the clock has been synced once.
+    bool monotonicToEpochMs(uint32_t mono_ms, uint64_t& out_epoch_ms);
 }
 
 #endif // TIME_SYNC_HPP
@@ -0,0 +1,105 @@
+#include <main/utils/trace.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_cpu.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+
+namespace {
+    // One slot per core when tracing is compiled out
+    static constexpr std::size_t DEPTH = Trace::enabled() ? Config::Trace::ring_depth : 1;
+    static_assert((DEPTH & (DEPTH - 1)) == 0, "Trace::ring_depth must be a power of two");
+    static constexpr uint32_t MASK = DEPTH - 1;
+
+    // Written only by its own core with interrupts masked; head is published with
+    // release so the exporter on the other core sees complete records
+    struct Ring {
+        uint32_t head;
+        TickType_t last_sync;
+        uint32_t sync_cycles;
+        uint32_t sync_mhz;
+        bool synced;
+        Trace::Record records[DEPTH];
+    };
+    static Ring s_rings[portNUM_PROCESSORS];
+
+    static void put(Ring& ring, Trace::Point p, uint8_t channel, uint32_t id, uint32_t cycles) {
+        // Seqlock writer side: the slot must not be overwritten before the previous
+        // head store is visible, or read() could miss that it was lapped
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        Trace::Record& r = ring.records[ring.head & MASK];
+        r.cycles = cycles;
+        r.id = id;
+        r.point = static_cast<uint8_t>(p);
+        r.channel = channel;
+        r.reserved = 0;
+        __atomic_store_n(&ring.head, ring.head + 1U, __ATOMIC_RELEASE);
+    }
+
+    // A new SYNC is due when the cycles since the last one no longer convert to
+    // time at its MHz: a DFS switch changed the rate, or the core was in light
+    // sleep (counter paused) for at least a tick
+    static bool needSync(const Ring& ring, uint32_t cycles, uint32_t mhz, TickType_t now) {
+        if (!ring.synced || mhz != ring.sync_mhz) {
+            return true;
+        }
+        const TickType_t ticks = now - ring.last_sync;
+        if (ticks >= pdMS_TO_TICKS(Config::Trace::sync_period_ms)) {
+            return true;
+        }
+        const uint32_t cycle_ticks = (cycles - ring.sync_cycles) / (mhz * 1000U * portTICK_PERIOD_MS);
+        return (cycle_ticks + 1U < ticks) || (ticks + 1U < cycle_ticks);
+    }
+}
+
+namespace Trace {
+    void record(Point p, uint8_t channel, uint32_t id) {
+        const UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+        Ring& ring = s_rings[esp_cpu_get_core_id()];
+        const uint32_t cycles = esp_cpu_get_cycle_count();
+        const TickType_t now = xTaskGetTickCount();
+        const uint32_t mhz = esp_rom_get_cpu_ticks_per_us();
+        if (needSync(ring, cycles, mhz, now)) {
+            put(ring, Point::SYNC, static_cast<uint8_t>(mhz), static_cast<uint32_t>(esp_timer_get_time()), cycles);
+            ring.last_sync = now;
+            ring.sync_cycles = cycles;
+            ring.sync_mhz = mhz;
+            ring.synced = true;
+        }
+        put(ring, p, channel, id, cycles);
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+    }
+
+    std::size_t read(int core, uint32_t& cursor, Record* out, std::size_t max, uint32_t& lost) {
+        lost = 0;
+        if (core < 0 || core >= portNUM_PROCESSORS) {
+            return 0;
+        }
+        const Ring& ring = s_rings[core];
+        const uint32_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+        if (head - cursor > DEPTH) {
+            lost = head - cursor - static_cast<uint32_t>(DEPTH);
+            cursor = head - static_cast<uint32_t>(DEPTH);
+        }
+        std::size_t n = 0;
+        while (n < max && cursor + n != head) {
+            out[n] = ring.records[(cursor + n) & MASK];
+            n++;
+        }
+        // Records the writer lapped while they were copied are dropped: the slot of
+        // position p is rewritten as soon as head reaches p + DEPTH
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        const uint32_t after = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+        std::size_t skip = 0;
+        if (after - cursor >= DEPTH) {
+            skip = after - cursor - static_cast<uint32_t>(DEPTH) + 1U;
+            skip = (skip < n) ? skip : n;
+        }
+        for (std::size_t i = skip; i < n; ++i) {
+            out[i - skip] = out[i];
+        }
+        lost += static_cast<uint32_t>(skip);
+        cursor += static_cast<uint32_t>(n);
+        return n - skip;
+    }
+}
@@ -0,0 +1,58 @@
+// Hot-path latency tracepoints (Config::Features::latency_trace).
+// Trace::point() stores a 12-byte record (CPU cycle count, point, channel, sample id)
+// in the ring of the core it runs on. Interrupts are masked for the few instructions
+// of the write, so a core's ring has a single writer and needs no lock.
+// Cycle counters are per core, follow DFS frequency switches and pause in light
+// sleep, so each core also writes a SYNC record (cycle count + esp_timer time + MHz)
+// at least every sync_period_ms, and before the next point after a switch or sleep.
+// tools/trace_report.py uses these to put both cores on one time base.
+// The cloud task exports the rings to Topics::TRACE. With the feature off,
+// point() compiles to nothing.
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <main/config/config.hpp>
+
+namespace Trace {
+    // Record points along one sample's path. Keep in sync with POINTS in
+    // tools/trace_report.py; append only.
+    enum class Point : uint8_t {
+        SYNC = 0,       // id = esp_timer time (us, low 32 bits), channel = CPU MHz
+        READ_BEGIN,     // scheduler: driver read starts (id 0; paired by channel)
+        READ_END,       // scheduler: driver read returned
+        BUS_PUBLISH,    // scheduler: sample written to the bus
+        MONITOR_RX,     // plant monitor: sample taken off the bus
+        CLOUD_RX,       // cloud task: sample taken off the bus
+        PUBLISH_BEGIN,  // cloud task: telemetry deadline reached, payload being built
+        PUBLISH_END,    // cloud task: handed to the MQTT client
+        COUNT
+    };
+
+    struct Record {
+        uint32_t cycles;   // CPU cycle counter of the recording core
+        uint32_t id;       // sample ts_ms (SensorSample::ts_ms), see Point
+        uint8_t  point;
+        uint8_t  channel;  // SensorRegistry index
+        uint16_t reserved;
+    };
+
+    constexpr bool enabled() {
+        return Config::Features::latency_trace;
+    }
+
+    void record(Point p, uint8_t channel, uint32_t id);
+
+    inline void point(Point p, uint8_t channel, uint32_t id) {
+        if constexpr (enabled()) {
+            record(p, channel, id);
+        }
+    }
+
+    // Exporter (cloud task only): copy records of one core from cursor on, up to
+    // max, and advance cursor. lost counts records overwritten before they were read.
+    std::size_t read(int core, uint32_t& cursor, Record* out, std::size_t max, uint32_t& lost);
+}
+
+#endif // TRACE_HPP
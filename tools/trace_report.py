@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Per-stage latency histograms from the firmware's latency trace.
+
+Enable Config::Features::latency_trace, capture the trace topic and feed the
+capture to this script:
+
+    mosquitto_sub -h <broker> -t 'thermometer/+/trace' -v > trace.log
+    python3 tools/trace_report.py trace.log
+
+Each input line is one MQTT payload (an optional leading topic, as printed by
+mosquitto_sub -v, is ignored):
+
+    {"core":0,"lost":0,"r":[[point,channel,id,cycles],...]}
+
+Cycle counts are converted to microseconds per core from the SYNC records
+(esp_timer time + CPU MHz), which puts both cores on the esp_timer time base.
+Samples are matched across tasks by (channel, id), where id is the sample's
+ts_ms. A sensor read is matched to the next BUS_PUBLISH on its channel.
+"""
+
+import argparse
+import json
+import sys
+
+# Trace::Point in main/utils/trace.hpp (same order)
+POINTS = [
+    "SYNC",
+    "READ_BEGIN",
+    "READ_END",
+    "BUS_PUBLISH",
+    "MONITOR_RX",
+    "CLOUD_RX",
+    "PUBLISH_BEGIN",
+    "PUBLISH_END",
+]
+SYNC = 0
+READ_BEGIN = 1
+READ_END = 2
+
+# (name, from point, to point)
+STAGES = [
+    ("read", "READ_BEGIN", "READ_END"),
+    ("filter+bus", "READ_END", "BUS_PUBLISH"),
+    ("bus->monitor", "BUS_PUBLISH", "MONITOR_RX"),
+    ("bus->cloud", "BUS_PUBLISH", "CLOUD_RX"),
+    ("telemetry wait", "CLOUD_RX", "PUBLISH_BEGIN"),
+    ("mqtt publish", "PUBLISH_BEGIN", "PUBLISH_END"),
+    ("end to end", "READ_BEGIN", "PUBLISH_END"),
+]
+
+U32 = 1 << 32
+
+
+def unwrap32(value, reference):
+    """Full value of a 32-bit counter reading closest to reference."""
+    delta = (value - reference) % U32
+    if delta >= U32 // 2:
+        delta -= U32
+    return reference + delta
+
+
+def parse_messages(lines):
+    for lineno, line in enumerate(lines, 1):
+        start = line.find("{")
+        if start < 0:
+            continue
+        try:
+            msg = json.loads(line[start:])
+        except ValueError:
+            print(f"line {lineno}: not JSON, skipped", file=sys.stderr)
+            continue
+        if "core" in msg and "r" in msg:
+            yield msg
+
+
+def to_events(messages):
+    """Convert records to (time_us, point, channel, id), dropping unsynced ones."""
+    sync = {}         # core -> (cycles, time_us, mhz)
+    now_us = None     # latest esp_timer time seen, for unwrapping
+    events = []
+    lost = 0
+    unsynced = 0
+    for msg in messages:
+        core = msg["core"]
+        if msg.get("lost", 0):
+            lost += msg["lost"]
+            # Cycles cannot be carried across a gap; wait for the next SYNC
+            sync.pop(core, None)
+        for point, channel, ident, cycles in msg["r"]:
+            if point == SYNC:
+                t = ident if now_us is None else unwrap32(ident, now_us)
+                now_us = t if now_us is None else max(now_us, t)
+                sync[core] = (cycles, t, channel or 1)
+                continue
+            if core not in sync:
+                unsynced += 1
+                continue
+            s_cycles, s_us, mhz = sync[core]
+            t = s_us + ((cycles - s_cycles) % U32) / mhz
+            if point < len(POINTS):
+                events.append((t, point, channel, ident))
+    events.sort()
+    return events, lost, unsynced
+
+
+def collect(events):
+    """Point times per sample, keyed by (channel, id)."""
+    samples = {}
+    pending_read = {}  # channel -> {"READ_BEGIN": t, "READ_END": t}
+    for t, point, channel, ident in events:
+        name = POINTS[point]
+        if point in (READ_BEGIN, READ_END):
+            if point == READ_BEGIN:
+                pending_read[channel] = {}
+            pending_read.setdefault(channel, {})[name] = t
+            continue
+        times = samples.setdefault((channel, ident), {})
+        times.setdefault(name, t)  # first occurrence only
+        if name == "BUS_PUBLISH":
+            times.update(pending_read.pop(channel, {}))
+    return samples
+
+
+def percentile(sorted_values, pct):
+    idx = max(0, -(-len(sorted_values) * pct // 100) - 1)
+    return sorted_values[idx]
+
+
+def fmt_us(us):
+    return f"{us / 1000.0:.2f} ms" if us >= 1000 else f"{us:.0f} us"
+
+
+def report(samples, channel, width):
+    for name, src, dst in STAGES:
+        values = sorted(
+            times[dst] - times[src]
+            for (ch, _), times in samples.items()
+            if (channel is None or ch == channel) and src in times and dst in times
+        )
+        if not values:
+            continue
+        print(f"\n{name} ({src} -> {dst})  n={len(values)}  min={fmt_us(values[0])}  "
+              f"p50={fmt_us(percentile(values, 50))}  p90={fmt_us(percentile(values, 90))}  "
+              f"p99={fmt_us(percentile(values, 99))}  max={fmt_us(values[-1])}")
+        # Power-of-two microsecond buckets
+        buckets = {}
+        for v in values:
+            b = max(0, int(v)).bit_length()
+            buckets[b] = buckets.get(b, 0) + 1
+        peak = max(buckets.values())
+        for b in range(min(buckets), max(buckets) + 1):
+            count = buckets.get(b, 0)
+            low = 0 if b == 0 else 1 << (b - 1)
+            bar = "#" * (count * width // peak) if count else ""
+            print(f"  >= {fmt_us(low):>10}  {count:6d}  {bar}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("files", nargs="*", help="captured trace payloads (default: stdin)")
+    parser.add_argument("--channel", type=int, help="only this SensorRegistry channel")
+    parser.add_argument("--width", type=int, default=50, help="histogram bar width")
+    args = parser.parse_args()
+
+    lines = []
+    if args.files:
+        for path in args.files:
+            with open(path, encoding="utf-8") as f:
+                lines.extend(f)
+    else:
+        lines = sys.stdin.readlines()
+
+    events, lost, unsynced = to_events(parse_messages(lines))
+    samples = collect(events)
+    print(f"{len(events)} records, {len(samples)} samples, {lost} lost on device, "
+          f"{unsynced} before a SYNC (skipped)")
+    report(samples, args.channel, args.width)
+
+
+if __name__ == "__main__":
+    main()